@@ -1,17 +1,38 @@
 // Copyright gnuwimp@gmail.com
 // Released under the GNU General Public License v3.0
 #include "flw.h"
+#include <atomic>
 #include <cassert>
+#include <climits>
 #include <cstring>
 #include <ctime>
+#include <mutex>
 namespace gnu {
 namespace priv {
+static void         _date_civil_from_days(int64_t days, int& year, int& month, int& day);
+static int64_t      _date_days_from_civil(int year, int month, int day);
 static int          _DATE_DAYS_MONTH[]      = {0, 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
 static int          _DATE_DAYS_MONTH_LEAP[] = {0, 31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
 static const char*  _DATE_WEEKDAYS[]        = {"", "Monday", "Tuesday", "Wednesday", "Thursday", "Friday", "Saturday", "Sunday", ""};
 static const char*  _DATE_WEEKDAYS_SHORT[]  = {"", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat", "Sun", ""};
 static const char*  _DATE_MONTHS[]          = {"", "January", "February", "Mars", "April", "May", "June", "July", "August", "September", "October", "November", "December", ""};
 static const char*  _DATE_MONTHS_SHORT[]    = {"", "Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec", ""};
+struct _DateLayout {
+    const char*     layout;
+    size_t          len;
+    int             count;
+    unsigned char   digit[14];
+    int             seps;
+    unsigned char   sep[5];
+};
+static const _DateLayout _DATE_LAYOUTS[] = {
+    { "YYYYMMDD HHMMSS",     15, 14, { 0, 1, 2, 3, 4, 5, 6, 7, 9, 10, 11, 12, 13, 14 }, 1, { 8 } },
+    { "YYYY-MM-DD HH:MM:SS", 19, 14, { 0, 1, 2, 3, 5, 6, 8, 9, 11, 12, 14, 15, 17, 18 }, 5, { 4, 7, 10, 13, 16 } },
+    { "YYYYMMDD HH:MM:SS",   17, 14, { 0, 1, 2, 3, 4, 5, 6, 7, 9, 10, 12, 13, 15, 16 }, 3, { 8, 11, 14 } },
+    { "YYYY-MM-DD",          10,  8, { 0, 1, 2, 3, 5, 6, 8, 9 }, 2, { 4, 7 } },
+    { "YYYYMMDD",             8,  8, { 0, 1, 2, 3, 4, 5, 6, 7 }, 0, { 0 } },
+};
+static const int _DATE_LAYOUTS_SIZE = static_cast<int>(sizeof(_DATE_LAYOUTS) / sizeof(_DATE_LAYOUTS[0]));
 static int _date_days_in_month(int year, int month) {
     if (year < 1 || year > 9999 || month < 1 || month > 12) {
         return 0;
@@ -21,23 +42,204 @@ static int _date_days_in_month(int year, int month) {
     }
     return _DATE_DAYS_MONTH[month];
 }
+static int64_t _date_parse_fixed(const _DateLayout& layout, const char* string) {
+    unsigned val[14] = { 0 };
+    unsigned bad     = 0;
+    for (int f = 0; f < layout.count; f++) {
+        val[f] = static_cast<unsigned>(static_cast<unsigned char>(string[layout.digit[f]])) - '0';
+        bad   |= (val[f] > 9);
+    }
+    for (int f = 0; f < layout.seps; f++) {
+        bad |= (string[layout.sep[f]] != layout.layout[layout.sep[f]]);
+    }
+    if (bad != 0) {
+        return DateKey::INVALID;
+    }
+    auto year  = static_cast<int>(val[0] * 1000 + val[1] * 100 + val[2] * 10 + val[3]);
+    auto month = static_cast<int>(val[4] * 10 + val[5]);
+    auto day   = static_cast<int>(val[6] * 10 + val[7]);
+    auto hour  = static_cast<int>(val[8] * 10 + val[9]);
+    auto min   = static_cast<int>(val[10] * 10 + val[11]);
+    auto sec   = static_cast<int>(val[12] * 10 + val[13]);
+    auto leap  = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    bad |= (year < 1);
+    bad |= (month < 1 || month > 12);
+    bad |= (day < 1 || day > (leap ? _DATE_DAYS_MONTH_LEAP[month % 13] : _DATE_DAYS_MONTH[month % 13]));
+    bad |= (hour > 23 || min > 59 || sec > 59);
+    if (bad != 0) {
+        return DateKey::INVALID;
+    }
+    return _date_days_from_civil(year, month, day) * Date::SECS_PER_DAY + hour * 3600 + min * 60 + sec;
+}
+static inline char* _date_put_digits(char* buffer, int value, int width) {
+    if (width == 4) {
+        buffer[0] = '0' + (value / 1000) % 10;
+        buffer[1] = '0' + (value / 100) % 10;
+        buffer += 2;
+    }
+    buffer[0] = '0' + (value / 10) % 10;
+    buffer[1] = '0' + value % 10;
+    return buffer + 2;
+}
+static void _date_civil_from_days(int64_t days, int& year, int& month, int& day) {
+    days += 719468;
+    auto era = (days >= 0 ? days : days - 146096) / 146097;
+    auto doe = days - era * 146097;
+    auto yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    auto doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    auto mp  = (5 * doy + 2) / 153;
+    day   = static_cast<int>(doy - (153 * mp + 2) / 5 + 1);
+    month = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+    year  = static_cast<int>(yoe + era * 400 + (month <= 2));
+}
+static int64_t _date_days_from_civil(int year, int month, int day) {
+    int64_t y   = year - (month <= 2);
+    auto    era = (y >= 0 ? y : y - 399) / 400;
+    auto    yoe = y - era * 400;
+    auto    doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    auto    doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+struct _DateZone {
+    int64_t         start;
+    int             offset;
+};
+static const int                _DATE_ZONE_FIRST = 1970;
+static const int                _DATE_ZONE_LAST  = 2199;
+static const int                _DATE_ZONE_YEARS = _DATE_ZONE_LAST - _DATE_ZONE_FIRST + 1;
+static std::atomic<bool>        _DATE_ZONE_READY[_DATE_ZONE_YEARS];
+static std::mutex               _DATE_ZONE_MUTEX;
+static std::vector<_DateZone>   _DATE_ZONE_LOCAL[_DATE_ZONE_YEARS];
+static std::vector<_DateZone>   _DATE_ZONE_UNIX[_DATE_ZONE_YEARS];
+static bool _date_localtime(time_t seconds, tm& res) {
+#ifdef _WIN32
+    return localtime_s(&res, &seconds) == 0;
+#else
+    return localtime_r(&seconds, &res) != nullptr;
+#endif
+}
+static int _date_zone_local_offset(int64_t utc) {
+    tm t;
+    if (_date_localtime(static_cast<time_t>(utc), t) == false) {
+        return INT_MIN;
+    }
+    auto local = _date_days_from_civil(t.tm_year + 1900, t.tm_mon + 1, t.tm_mday) * 86400 + t.tm_hour * 3600 + t.tm_min * 60 + t.tm_sec;
+    return static_cast<int>(local - utc);
+}
+static int _date_zone_unix_offset(int64_t local) {
+    auto days = local / 86400;
+    auto secs = static_cast<int>(local - days * 86400);
+    int  year, month, day;
+    tm   t;
+    _date_civil_from_days(days, year, month, day);
+    memset(&t, '\0', sizeof(t));
+    t.tm_year = year - 1900;
+    t.tm_mon  = month - 1;
+    t.tm_mday = day;
+    t.tm_hour = secs / 3600;
+    t.tm_min  = (secs / 60) % 60;
+    t.tm_sec  = secs % 60;
+    auto utc = static_cast<int64_t>(mktime(&t));
+    return (utc == -1) ? INT_MIN : static_cast<int>(local - utc);
+}
+static bool _date_zone_scan(std::vector<_DateZone>& table, int64_t start, int64_t stop, int (*offset)(int64_t)) {
+    auto prev     = start;
+    auto prev_off = offset(start);
+    if (prev_off == INT_MIN) {
+        return false;
+    }
+    table.push_back({start, prev_off});
+    for (auto next = start + 86400; prev < stop - 1; next += 86400) {
+        next = (next < stop - 1) ? next : stop - 1;
+        auto next_off = offset(next);
+        if (next_off == INT_MIN) {
+            return false;
+        }
+        while (next_off != prev_off) {
+            auto lo = prev;
+            auto hi = next;
+            while (hi - lo > 1) {
+                auto mid = lo + (hi - lo) / 2;
+                if (offset(mid) == prev_off) {
+                    lo = mid;
+                }
+                else {
+                    hi = mid;
+                }
+            }
+            prev     = hi;
+            prev_off = offset(hi);
+            table.push_back({prev, prev_off});
+        }
+        prev = next;
+    }
+    return true;
+}
+static bool _date_zone_year(int year) {
+    if (year < _DATE_ZONE_FIRST || year > _DATE_ZONE_LAST) {
+        return false;
+    }
+    auto index = year - _DATE_ZONE_FIRST;
+    if (_DATE_ZONE_READY[index].load(std::memory_order_acquire) == false) {
+        std::lock_guard<std::mutex> lock(_DATE_ZONE_MUTEX);
+        if (_DATE_ZONE_READY[index].load(std::memory_order_relaxed) == false) {
+            auto  start = _date_days_from_civil(year, 1, 1) * 86400;
+            auto  stop  = _date_days_from_civil(year + 1, 1, 1) * 86400;
+            auto& to_local = _DATE_ZONE_LOCAL[index];
+            auto& to_unix  = _DATE_ZONE_UNIX[index];
+#ifdef _WIN32
+            _tzset();
+#else
+            tzset();
+#endif
+            if (_date_zone_scan(to_local, start, stop, _date_zone_local_offset) == false || _date_zone_scan(to_unix, start, stop, _date_zone_unix_offset) == false) {
+                to_local.clear();
+                to_unix.clear();
+            }
+            _DATE_ZONE_READY[index].store(true, std::memory_order_release);
+        }
+    }
+    return _DATE_ZONE_LOCAL[index].size() > 0;
+}
+static int _date_zone_find(const std::vector<_DateZone>& table, int64_t seconds) {
+    for (auto it = table.rbegin(); it != table.rend(); ++it) {
+        if (seconds >= it->start) {
+            return it->offset;
+        }
+    }
+    return table.front().offset;
+}
 static void _date_from_time(int64_t seconds, gnu::Date::UTC utc, int& year, int& month, int& day, int& hour, int& min, int& sec) {
     year = month = day = 1;
     hour = min = sec = 0;
     if (seconds < 0) {
         return;
     }
-    time_t    rawtime  = seconds;
-    const tm* timeinfo = (utc == gnu::Date::UTC::ON) ? gmtime(&rawtime) : localtime(&rawtime);
-    if (timeinfo == nullptr) {
-        return;
+    if (utc == gnu::Date::UTC::OFF) {
+        int utc_year, utc_month, utc_day;
+        _date_civil_from_days(seconds / 86400, utc_year, utc_month, utc_day);
+        if (_date_zone_year(utc_year) == false) {
+            time_t rawtime = seconds;
+            tm     timeinfo;
+            if (_date_localtime(rawtime, timeinfo) == false) {
+                return;
+            }
+            year  = timeinfo.tm_year + 1900;
+            month = timeinfo.tm_mon + 1;
+            day   = timeinfo.tm_mday;
+            hour  = timeinfo.tm_hour;
+            min   = timeinfo.tm_min;
+            sec   = timeinfo.tm_sec;
+            return;
+        }
+        seconds += _date_zone_find(_DATE_ZONE_LOCAL[utc_year - _DATE_ZONE_FIRST], seconds);
     }
-    year  = timeinfo->tm_year + 1900;
-    month = timeinfo->tm_mon + 1;
-    day   = timeinfo->tm_mday;
-    hour  = timeinfo->tm_hour;
-    min   = timeinfo->tm_min;
-    sec   = timeinfo->tm_sec;
+    auto days = (seconds >= 0) ? seconds / 86400 : (seconds - 86399) / 86400;
+    auto secs = static_cast<int>(seconds - days * 86400);
+    _date_civil_from_days(days, year, month, day);
+    hour = secs / 3600;
+    min  = (secs / 60) % 60;
+    sec  = secs % 60;
 }
 static gnu::Date::Day _date_weekday(int year, int month, int day) {
     if (year > 0 && year < 10000 && month > 0 && month < 13 && day > 0 && day <= _date_days_in_month(year, month)) {
@@ -110,47 +312,15 @@ gnu::Date::Date(const std::string& date, gnu::Date::US us) {
 }
 bool gnu::Date::add_days(const int days) {
     if (days == 0) {
-        return 0;
+        return false;
     }
-    int daym = priv::_date_days_in_month(_year, _month);
-    if (daym == 0) {
+    else if (priv::_date_days_in_month(_year, _month) == 0) {
         return false;
     }
-    int inc = days > 0 ? 1 : -1;
-    int y   = _year;
-    int m   = _month;
-    int d   = _day;
-    for (int f = 0; f < abs(days); f++) {
-        d += inc;
-        if (inc < 0 && d == 0) {
-            m--;
-            if (m == 0) {
-                m = 12;
-                y--;
-                if (y < 1) {
-                    return false;
-                }
-            }
-            d = priv::_date_days_in_month(y, m);
-            if (d == 0) {
-                return false;
-            }
-        }
-        else if (inc > 0 && d > daym) {
-            d = 1;
-            m++;
-            if (m == 13) {
-                m = 1;
-                y++;
-                if (y > 9999) {
-                    return false;
-                }
-            }
-            daym = priv::_date_days_in_month(y, m);
-            if (daym == 0) {
-                return false;
-            }
-        }
+    int y, m, d;
+    priv::_date_civil_from_days(priv::_date_days_from_civil(_year, _month, _day) + days, y, m, d);
+    if (y < 1 || y > 9999) {
+        return false;
     }
     _year  = y;
     _month = m;
@@ -161,27 +331,13 @@ bool gnu::Date::add_months(const int months) {
     if (months == 0) {
         return false;
     }
-    int inc = months > 0 ? 1 : -1;
-    int m   = _month;
-    int y   = _year;
-    for (int f = 0; f < abs(months); f++) {
-        m += inc;
-        if (m == 0) {
-            m = 12;
-            y--;
-            if (y < 1) {
-                return false;
-            }
-        }
-        else if (m > 12) {
-            m = 1;
-            y++;
-            if (y > 9999) {
-                return false;
-            }
-        }
+    auto total = static_cast<int64_t>(_year) * 12 + (_month - 1) + months;
+    if (total < 12 || total >= 10000 * 12) {
+        return false;
     }
-    const int days = priv::_date_days_in_month(y, m);
+    auto y    = static_cast<int>(total / 12);
+    auto m    = static_cast<int>(total % 12) + 1;
+    auto days = priv::_date_days_in_month(y, m);
     if (days <= 0) {
         return false;
     }
@@ -193,47 +349,18 @@ bool gnu::Date::add_months(const int months) {
     return true;
 }
 bool gnu::Date::add_seconds(const int64_t seconds) {
-    if (seconds == 0) {
+    if (seconds == 0 || seconds > 10000LL * 366 * SECS_PER_DAY || seconds < -10000LL * 366 * SECS_PER_DAY) {
         return false;
     }
-    int inc = seconds > 0 ? 1 : -1;
-    int h   = _hour;
-    int m   = _min;
-    int s   = _sec;
-    for (int64_t f = 0; f < llabs(seconds); f++) {
-        s += inc;
-        if (inc < 0 && s == -1) {
-            m--;
-            if (m == -1) {
-                m = 59;
-                h--;
-                if (h == -1) {
-                    h = 23;
-                    if (add_days(-1) == false) {
-                        return false;
-                    }
-                }
-            }
-            s = 59;
-        }
-        else if (inc > 0 && s == 60) {
-            m++;
-            if (m == 60) {
-                m = 0;
-                h++;
-                if (h == 24) {
-                    h = 0;
-                    if (add_days(1) == false) {
-                        return false;
-                    }
-                }
-            }
-            s = 0;
-        }
+    auto total = static_cast<int64_t>(_hour) * 3600 + _min * 60 + _sec + seconds;
+    auto days  = (total >= 0) ? total / SECS_PER_DAY : (total - (SECS_PER_DAY - 1)) / SECS_PER_DAY;
+    auto secs  = static_cast<int>(total - days * SECS_PER_DAY);
+    if (days != 0 && add_days(static_cast<int>(days)) == false) {
+        return false;
     }
-    _hour = h;
-    _min  = m;
-    _sec  = s;
+    _hour = secs / 3600;
+    _min  = (secs / 60) % 60;
+    _sec  = secs % 60;
     return true;
 }
 int gnu::Date::compare(const Date& other, Compare flag) const {
@@ -306,38 +433,13 @@ void gnu::Date::debug() const {
 #endif
 }
 int gnu::Date::diff_days(const Date& date) const {
-    Date d(date);
-    int  res = 0;
-    if (compare(d, Compare::YYYYMMDD) < 0) {
-        while (compare(d, Compare::YYYYMMDD) != 0) {
-            d.add_days(-1);
-            res++;
-        }
-    }
-    else if (compare(d, Compare::YYYYMMDD) > 0) {
-        while (compare(d, Compare::YYYYMMDD) != 0) {
-            d.add_days(1);
-            res--;
-        }
+    if (is_invalid() == true || date.is_invalid() == true) {
+        return 0;
     }
-    return res;
+    return static_cast<int>(priv::_date_days_from_civil(date._year, date._month, date._day) - priv::_date_days_from_civil(_year, _month, _day));
 }
 int gnu::Date::diff_months(const Date& date) const {
-    Date d(date);
-    int  res = 0;
-    if (compare(d, Compare::YYYYMM) < 0) {
-        while (compare(d, Compare::YYYYMM)) {
-            d.add_months(-1);
-            res++;
-        }
-    }
-    else if (compare(d, Compare::YYYYMM) > 0) {
-        while (compare(d, Compare::YYYYMM)) {
-            d.add_months(1);
-            res--;
-        }
-    }
-    return res;
+    return (date._year * 12 + date._month) - (_year * 12 + _month);
 }
 int64_t gnu::Date::diff_seconds(const Date& date) const {
     int64_t unix1 = time();
@@ -349,59 +451,93 @@ int64_t gnu::Date::diff_seconds(const Date& date) const {
 }
 std::string gnu::Date::format(Format format) const {
     char tmp[100];
-    int  n = 0;
-    if (format == Format::ISO) {
-        n = snprintf(tmp, 100, "%04d%02d%02d", _year, _month, _day);
-    }
-    else if (format == Format::ISO_LONG) {
-        n = snprintf(tmp, 100, "%04d-%02d-%02d", _year, _month, _day);
-    }
-    else if (format == Format::ISO_TIME) {
-        n = snprintf(tmp, 100, "%04d%02d%02d %02d%02d%02d", _year, _month, _day, _hour, _min, _sec);
-    }
-    else if (format == Format::ISO_TIME_LONG) {
-        n = snprintf(tmp, 100, "%04d-%02d-%02d %02d:%02d:%02d", _year, _month, _day, _hour, _min, _sec);
+    format_to(tmp, 100, format);
+    return tmp;
+}
+size_t gnu::Date::format_to(char* buffer, size_t size, Format format) const {
+    if (buffer == nullptr || size == 0) {
+        return 0;
     }
-    else if (format == Format::TIME) {
-        n = snprintf(tmp, 100, "%02d%02d%02d", _hour, _min, _sec);
+    int n = 0;
+    if (format == Format::ISO || format == Format::ISO_LONG || format == Format::ISO_TIME || format == Format::ISO_TIME_LONG) {
+        auto sep = (format == Format::ISO_LONG || format == Format::ISO_TIME_LONG);
+        auto tim = (format == Format::ISO_TIME || format == Format::ISO_TIME_LONG);
+        n        = 8 + (sep == true ? 2 : 0) + (tim == true ? (sep == true ? 9 : 7) : 0);
+        if (static_cast<size_t>(n) >= size) {
+            *buffer = 0;
+            return 0;
+        }
+        auto p = buffer;
+        p = priv::_date_put_digits(p, _year, 4);
+        if (sep == true) *p++ = '-';
+        p = priv::_date_put_digits(p, _month, 2);
+        if (sep == true) *p++ = '-';
+        p = priv::_date_put_digits(p, _day, 2);
+        if (tim == true) {
+            *p++ = ' ';
+            p = priv::_date_put_digits(p, _hour, 2);
+            if (sep == true) *p++ = ':';
+            p = priv::_date_put_digits(p, _min, 2);
+            if (sep == true) *p++ = ':';
+            p = priv::_date_put_digits(p, _sec, 2);
+        }
+        *p = 0;
+        return n;
     }
-    else if (format == Format::TIME_LONG) {
-        n = snprintf(tmp, 100, "%02d:%02d:%02d", _hour, _min, _sec);
+    else if (format == Format::TIME || format == Format::TIME_LONG) {
+        auto sep = (format == Format::TIME_LONG);
+        n        = (sep == true) ? 8 : 6;
+        if (static_cast<size_t>(n) >= size) {
+            *buffer = 0;
+            return 0;
+        }
+        auto p = buffer;
+        p = priv::_date_put_digits(p, _hour, 2);
+        if (sep == true) *p++ = ':';
+        p = priv::_date_put_digits(p, _min, 2);
+        if (sep == true) *p++ = ':';
+        p = priv::_date_put_digits(p, _sec, 2);
+        *p = 0;
+        return n;
     }
     else if (format == Format::US) {
-        n = snprintf(tmp, 100, "%d/%d/%04d", _month, _day, _year);
+        n = snprintf(buffer, size, "%d/%d/%04d", _month, _day, _year);
     }
     else if (format == Format::WORLD) {
-        n = snprintf(tmp, 100, "%d/%d/%04d", _day, _month, _year);
+        n = snprintf(buffer, size, "%d/%d/%04d", _day, _month, _year);
     }
     else if (format == Format::DAY_MONTH_YEAR) {
-        n = snprintf(tmp, 100, "%d %s %04d", _day, month_name(), _year);
+        n = snprintf(buffer, size, "%d %s %04d", _day, month_name(), _year);
     }
     else if (format == Format::DAY_MONTH_YEAR_SHORT) {
-        n = snprintf(tmp, 100, "%d %s, %04d", _day, month_name_short(), _year);
+        n = snprintf(buffer, size, "%d %s, %04d", _day, month_name_short(), _year);
     }
     else if (format == Format::WEEKDAY_MONTH_YEAR) {
-        n = snprintf(tmp, 100, "%s %d %s %04d", weekday_name(), _day, month_name(), _year);
+        n = snprintf(buffer, size, "%s %d %s %04d", weekday_name(), _day, month_name(), _year);
     }
     else if (format == Format::WEEKDAY_MONTH_YEAR_SHORT) {
-        n = snprintf(tmp, 100, "%s, %d %s, %04d", weekday_name_short(), _day, month_name_short(), _year);
+        n = snprintf(buffer, size, "%s, %d %s, %04d", weekday_name_short(), _day, month_name_short(), _year);
     }
     else if (format == Format::WEEKDAY) {
-        n = snprintf(tmp, 100, "%s", weekday_name());
+        n = snprintf(buffer, size, "%s", weekday_name());
     }
     else if (format == Format::WEEKDAY_SHORT) {
-        n = snprintf(tmp, 100, "%s", weekday_name_short());
+        n = snprintf(buffer, size, "%s", weekday_name_short());
     }
     else if (format == Format::MONTH) {
-        n = snprintf(tmp, 100, "%s", month_name());
+        n = snprintf(buffer, size, "%s", month_name());
     }
     else if (format == Format::MONTH_SHORT) {
-        n = snprintf(tmp, 100, "%s", month_name_short());
+        n = snprintf(buffer, size, "%s", month_name_short());
     }
-    if (n < 0 || n >= 100) {
-        *tmp = 0;
+    if (n < 0 || static_cast<size_t>(n) >= size) {
+        *buffer = 0;
+        return 0;
     }
-    return tmp;
+    return n;
+}
+gnu::DateKey gnu::Date::key() const {
+    return DateKey(*this);
 }
 bool gnu::Date::is_leapyear() const {
     return priv::_date_is_leapyear(_year);
@@ -644,6 +780,10 @@ int64_t gnu::Date::time() const {
     if (_year < 1970) {
         return -1;
     }
+    if (priv::_date_zone_year(_year) == true) {
+        auto local = priv::_date_days_from_civil(_year, _month, _day) * SECS_PER_DAY + _hour * 3600 + _min * 60 + _sec;
+        return local - priv::_date_zone_find(priv::_DATE_ZONE_UNIX[_year - priv::_DATE_ZONE_FIRST], local);
+    }
     memset(&t, '\0', sizeof(t));
     t.tm_year = _year - 1900;
     t.tm_mon  = _month - 1;
@@ -699,20 +839,218 @@ const char* gnu::Date::weekday_name() const {
 const char* gnu::Date::weekday_name_short() const {
     return priv::_DATE_WEEKDAYS_SHORT[static_cast<int>(priv::_date_weekday(_year, _month, _day))];
 }
+size_t gnu::Date::AddDays(std::vector<Date>& dates, int days) {
+    auto res = (size_t) 0;
+    for (auto& date : dates) {
+        res += date.add_days(days);
+    }
+    return res;
+}
+size_t gnu::Date::AddMonths(std::vector<Date>& dates, int months) {
+    auto res = (size_t) 0;
+    for (auto& date : dates) {
+        res += date.add_months(months);
+    }
+    return res;
+}
+size_t gnu::Date::AddSeconds(std::vector<Date>& dates, int64_t seconds) {
+    auto res = (size_t) 0;
+    for (auto& date : dates) {
+        res += date.add_seconds(seconds);
+    }
+    return res;
+}
+std::vector<int> gnu::Date::DiffDays(const Date& from, const std::vector<Date>& dates) {
+    auto res = std::vector<int>();
+    res.reserve(dates.size());
+    for (const auto& date : dates) {
+        res.push_back(from.diff_days(date));
+    }
+    return res;
+}
+std::vector<gnu::Date> gnu::Date::Serie(const Date& start, const Date& stop, int days) {
+    auto res = std::vector<Date>();
+    if (days < 1 || start.is_invalid() == true || stop.is_invalid() == true || stop < start) {
+        return res;
+    }
+    auto first = priv::_date_days_from_civil(start._year, start._month, start._day);
+    auto last  = priv::_date_days_from_civil(stop._year, stop._month, stop._day);
+    int  y, m, d;
+    res.reserve((last - first) / days + 1);
+    for (auto day = first; day <= last; day += days) {
+        priv::_date_civil_from_days(day, y, m, d);
+        res.push_back(Date(y, m, d, start._hour, start._min, start._sec));
+    }
+    if (res.size() > 0 && res.back() > stop) {
+        res.pop_back();
+    }
+    return res;
+}
+gnu::DateKey::DateKey(const Date& date) {
+    _sec = DateKey::INVALID;
+    if (date.is_invalid() == false) {
+        _sec = priv::_date_days_from_civil(date.year(), date.month(), date.day()) * Date::SECS_PER_DAY + date.hour() * 3600 + date.minute() * 60 + date.second();
+    }
+}
+gnu::DateKey::DateKey(int year, int month, int day, int hour, int min, int sec) {
+    _sec = DateKey::INVALID;
+    if (year < 1 || year > 9999 ||
+        month < 1 || month > 12 ||
+        day < 1 || day > priv::_date_days_in_month(year, month) ||
+        hour < 0 || hour > 23 ||
+        min < 0 || min > 59 ||
+        sec < 0 || sec > 59) {
+        return;
+    }
+    _sec = priv::_date_days_from_civil(year, month, day) * Date::SECS_PER_DAY + hour * 3600 + min * 60 + sec;
+}
+int64_t gnu::DateKey::days() const {
+    return (_sec >= 0) ? _sec / Date::SECS_PER_DAY : (_sec - (Date::SECS_PER_DAY - 1)) / Date::SECS_PER_DAY;
+}
+gnu::Date gnu::DateKey::to_date() const {
+    if (is_invalid() == true) {
+        return Date(0, 0, 0);
+    }
+    auto days = this->days();
+    auto secs = static_cast<int>(_sec - days * Date::SECS_PER_DAY);
+    int  y, m, d;
+    priv::_date_civil_from_days(days, y, m, d);
+    return Date(y, m, d, secs / 3600, (secs / 60) % 60, secs % 60);
+}
+gnu::DateParser::DateParser(Date::US us) {
+    _layout   = -1;
+    _us       = us;
+    _detected = false;
+}
+gnu::DateParser::DateParser(Date::Format format, Date::US us) {
+    _layout   = -1;
+    _us       = us;
+    _detected = true;
+    if (format == Date::Format::ISO_TIME) {
+        _layout = 0;
+    }
+    else if (format == Date::Format::ISO_TIME_LONG) {
+        _layout = 1;
+    }
+    else if (format == Date::Format::ISO_LONG) {
+        _layout = 3;
+    }
+    else if (format == Date::Format::ISO) {
+        _layout = 4;
+    }
+}
+bool gnu::DateParser::detect(const char* sample, size_t len) {
+    _layout   = -1;
+    _detected = true;
+    while (len > 0 && static_cast<unsigned char>(sample[len - 1]) <= ' ') {
+        len--;
+    }
+    for (int f = 0; f < priv::_DATE_LAYOUTS_SIZE; f++) {
+        const auto& layout = priv::_DATE_LAYOUTS[f];
+        if (layout.len == len && priv::_date_parse_fixed(layout, sample) != DateKey::INVALID) {
+            _layout = f;
+            break;
+        }
+    }
+    return _layout >= 0;
+}
+const char* gnu::DateParser::layout() const {
+    return (_layout >= 0) ? priv::_DATE_LAYOUTS[_layout].layout : "";
+}
+gnu::DateKey gnu::DateParser::parse(const char* string, size_t len) const {
+    auto res = parse_fixed(string, len);
+    if (res.is_invalid() == false) {
+        return res;
+    }
+    return Date(std::string(string, len), _us).key();
+}
+std::vector<gnu::DateKey> gnu::DateParser::parse(const std::vector<std::string>& column) {
+    std::vector<DateKey> res;
+    size_t               tries = 0;
+    res.reserve(column.size());
+    for (const auto& string : column) {
+        if (_detected == false && string != "") {
+            if (detect(string) == false && ++tries < 10) {
+                _detected = false;
+            }
+        }
+        res.push_back(parse(string.c_str(), string.length()));
+    }
+    return res;
+}
+gnu::DateKey gnu::DateParser::parse_fixed(const char* string, size_t len) const {
+    if (_layout < 0) {
+        return DateKey();
+    }
+    const auto& layout = priv::_DATE_LAYOUTS[_layout];
+    while (len > 0 && static_cast<unsigned char>(string[len - 1]) <= ' ') {
+        len--;
+    }
+    if (len != layout.len) {
+        return DateKey();
+    }
+    return DateKey::FromSeconds(priv::_date_parse_fixed(layout, string));
+}
+gnu::DateCache::DateCache(size_t size) {
+    size_t slots = 16;
+    while (slots < size) {
+        slots *= 2;
+    }
+    _slots.resize(slots);
+    clear();
+}
+void gnu::DateCache::clear() {
+    for (auto& slot : _slots) {
+        slot.key     = DateKey::INVALID;
+        slot.format  = -1;
+        slot.text[0] = 0;
+    }
+    _hits   = 0;
+    _misses = 0;
+}
+const char* gnu::DateCache::format(const DateKey& key, Date::Format format) {
+    auto hash  = static_cast<uint64_t>(key.seconds()) * 0x9E3779B97F4A7C15ULL + static_cast<uint64_t>(format);
+    auto index = static_cast<size_t>(hash ^ (hash >> 32)) & (_slots.size() - 1);
+    auto& slot = _slots[index];
+    if (slot.key == key.seconds() && slot.format == static_cast<int>(format)) {
+        _hits++;
+        return slot.text;
+    }
+    _misses++;
+    key.to_date().format_to(slot.text, DateCache::TEXT_SIZE, format);
+    slot.key    = key.seconds();
+    slot.format = static_cast<int>(format);
+    return slot.text;
+}
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <filesystem>
 #include <climits>
+#include <cmath>
+#include <cerrno>
 #include <ctime>
 #include <assert.h>
 #include <dirent.h>
 #include <unistd.h>
 #ifdef _WIN32
+    #include <fcntl.h>
+    #include <io.h>
     #include <shlobj.h>
     #include <time.h>
 #else
+    #include <errno.h>
+    #include <fcntl.h>
+    #include <poll.h>
+    #include <signal.h>
+    #include <sys/mman.h>
     #include <sys/stat.h>
+    #include <sys/wait.h>
     #include <utime.h>
 #endif
+#ifdef __linux__
+    #include <sys/inotify.h>
+#endif
 #ifndef PATH_MAX
     #define PATH_MAX 1050
 #endif
@@ -720,13 +1058,43 @@ namespace gnu {
 namespace priv {
 static std::string          _FILE_STDOUT_NAME = "";
 static std::string          _FILE_STDERR_NAME = "";
+static const size_t         _FILE_CACHE_MAX   = 100000;
+struct _FileCache {
+    file::File              file;
+    int64_t                 time;
+};
+struct _FilePipe {
+    file::CallbackLine      callback;
+    void*                   data;
+    int                     fd_orig;
+    int                     fd_read;
+    std::string             line;
+    std::vector<char>       ring;
+    size_t                  start;
+    std::atomic<bool>       stop;
+    size_t                  used;
+    std::thread             thread;
+};
+static std::map<std::string, _FileCache> _FILE_CACHE;
+static std::mutex                        _FILE_CACHE_MUTEX;
+static std::atomic<unsigned>             _FILE_CACHE_TTL(0);
+static _FilePipe*                        _FILE_PIPE[3] = { nullptr, nullptr, nullptr };
 #ifdef _WIN32
 static char*                _file_from_wide(const wchar_t* wstring);
 static int64_t              _file_time(FILETIME* ft);
 static wchar_t*             _file_to_wide(const char* string);
 #endif
+static void                 _file_cache_erase(const std::string& path);
+static bool                 _file_cache_get(const std::string& filename, file::File& file);
+static void                 _file_cache_put(const std::string& filename, const file::File& file);
 static file::Buf            _file_close_redirect(int type);
+#ifndef _WIN32
+static void                 _file_kill(pid_t pid);
+#endif
 static bool                 _file_open_redirect(int type);
+static file::Buf            _file_pipe_close(int type);
+static bool                 _file_pipe_open(int type, size_t max_size, file::CallbackLine callback, void* data);
+static void                 _file_pipe_read(_FilePipe* pipe);
 static unsigned             _file_rand();
 static void                 _file_read(const std::string& path, file::Buf& buf);
 static std::string&         _file_replace_all(std::string& string, const std::string& find, const std::string& replace);
@@ -734,8 +1102,53 @@ static void                 _file_read_dir_rec(file::Files& res, file::Files& fi
 static std::string&         _file_replace_all(std::string& string, const std::string& find, const std::string& replace);
 static void                 _file_split_paths(const std::string& filename, std::string& path, std::string& name, std::string& ext);
 static std::string          _file_substr(const std::string& in, std::string::size_type pos, std::string::size_type size = std::string::npos);
+static void                 _file_sync_dir(const std::string& path);
 static std::string          _file_to_absolute_path(const std::string& filename, bool realpath);
+static std::string          _file_work_dir();
+static size_t               _file_write_batch(std::map<std::string, file::Buf>& jobs, bool atomic, bool flush);
+static void _file_cache_erase(const std::string& path) {
+    if (_FILE_CACHE_TTL == 0 || path == "") {
+        return;
+    }
+    auto filename = _file_to_absolute_path(path, false);
+    auto resolved = _file_to_absolute_path(path, true);
+    std::lock_guard<std::mutex> lock(_FILE_CACHE_MUTEX);
+    _FILE_CACHE.erase(filename);
+    _FILE_CACHE.erase(resolved);
+}
+static bool _file_cache_get(const std::string& filename, file::File& file) {
+    auto ttl = _FILE_CACHE_TTL.load();
+    if (ttl == 0) {
+        return false;
+    }
+    auto now = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    std::lock_guard<std::mutex> lock(_FILE_CACHE_MUTEX);
+    auto it = _FILE_CACHE.find(filename);
+    if (it == _FILE_CACHE.end()) {
+        return false;
+    }
+    else if (now - it->second.time > static_cast<int64_t>(ttl)) {
+        _FILE_CACHE.erase(it);
+        return false;
+    }
+    file = it->second.file;
+    return true;
+}
+static void _file_cache_put(const std::string& filename, const file::File& file) {
+    if (_FILE_CACHE_TTL == 0 || file.type() == file::Type::MISSING) {
+        return;
+    }
+    auto now = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    std::lock_guard<std::mutex> lock(_FILE_CACHE_MUTEX);
+    if (_FILE_CACHE.size() >= _FILE_CACHE_MAX) {
+        _FILE_CACHE.clear();
+    }
+    _FILE_CACHE[filename] = _FileCache{file, now};
+}
 static file::Buf _file_close_redirect(int type) {
+    if (priv::_FILE_PIPE[type] != nullptr) {
+        return priv::_file_pipe_close(type);
+    }
     std::string fname;
     FILE* fhandle;
     if (type == 2) {
@@ -770,10 +1183,20 @@ static char* _file_from_wide(const wchar_t* wstring) {
     return (char*) out;
 }
 #endif
+#ifndef _WIN32
+static void _file_kill(pid_t pid) {
+    if (::kill(-pid, SIGKILL) != 0) {
+        ::kill(pid, SIGKILL);
+    }
+}
+#endif
 static bool _file_open_redirect(int type) {
     bool res = false;
     std::string fname;
     FILE* fhandle = nullptr;
+    if (priv::_FILE_PIPE[type] != nullptr) {
+        return res;
+    }
     if (type == 2) {
         if (priv::_FILE_STDERR_NAME != "") return res;
         fname = priv::_FILE_STDERR_NAME = file::tmp_file("stderr_").filename();
@@ -801,6 +1224,147 @@ static bool _file_open_redirect(int type) {
     }
     return res;
 }
+static file::Buf _file_pipe_close(int type) {
+    auto pipe = priv::_FILE_PIPE[type];
+    if (pipe == nullptr) {
+        return file::Buf();
+    }
+    fflush((type == 2) ? stderr : stdout);
+    ::dup2(pipe->fd_orig, type);
+    pipe->stop = true;
+    pipe->thread.join();
+    ::close(pipe->fd_orig);
+    ::close(pipe->fd_read);
+    auto res = file::Buf(pipe->used);
+    for (size_t f = 0; f < pipe->used; f++) {
+        res.str()[f] = pipe->ring[(pipe->start + f) % pipe->ring.size()];
+    }
+    priv::_FILE_PIPE[type] = nullptr;
+    delete pipe;
+    return res;
+}
+static bool _file_pipe_open(int type, size_t max_size, file::CallbackLine callback, void* data) {
+    auto fhandle = (type == 2) ? stderr : stdout;
+    int  fds[2];
+    if (max_size == 0 || priv::_FILE_PIPE[type] != nullptr || (type == 1 && priv::_FILE_STDOUT_NAME != "") || (type == 2 && priv::_FILE_STDERR_NAME != "")) {
+        return false;
+    }
+    fflush(fhandle);
+#ifdef _WIN32
+    if (_pipe(fds, 65536, _O_BINARY | _O_NOINHERIT) != 0) {
+        return false;
+    }
+#else
+    if (::pipe(fds) != 0) {
+        return false;
+    }
+    ::fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+    ::fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+#endif
+    auto fd_orig = ::dup(type);
+#ifndef _WIN32
+    if (fd_orig >= 0) {
+        ::fcntl(fd_orig, F_SETFD, FD_CLOEXEC);
+    }
+#endif
+    if (fd_orig < 0 || ::dup2(fds[1], type) < 0) {
+        if (fd_orig >= 0) {
+            ::close(fd_orig);
+        }
+        ::close(fds[0]);
+        ::close(fds[1]);
+        return false;
+    }
+    ::close(fds[1]);
+    auto pipe = new _FilePipe();
+    pipe->callback = callback;
+    pipe->data     = data;
+    pipe->fd_orig  = fd_orig;
+    pipe->fd_read  = fds[0];
+    pipe->start    = 0;
+    pipe->stop     = false;
+    pipe->used     = 0;
+    pipe->ring.resize(max_size);
+    pipe->thread   = std::thread(priv::_file_pipe_read, pipe);
+    priv::_FILE_PIPE[type] = pipe;
+    return true;
+}
+static void _file_pipe_read(_FilePipe* pipe) {
+    char    buf[4096];
+    auto    size = pipe->ring.size();
+    int64_t stop = 0;
+#ifdef _WIN32
+    int     idle = 0;
+#endif
+    while (true) {
+#ifdef _WIN32
+        DWORD avail = 0;
+        if (PeekNamedPipe((HANDLE) _get_osfhandle(pipe->fd_read), nullptr, 0, nullptr, &avail, nullptr) == FALSE) {
+            break;
+        }
+        else if (avail == 0) {
+            if (pipe->stop == true) {
+                if (idle >= 100) {
+                    break;
+                }
+                idle += 10;
+            }
+            Sleep(10);
+            continue;
+        }
+        idle = 0;
+#else
+        struct pollfd pfd = { pipe->fd_read, POLLIN, 0 };
+        auto          ready = ::poll(&pfd, 1, 100);
+        if (ready < 0 && errno == EINTR) {
+            continue;
+        }
+        else if (ready == 0) {
+            if (pipe->stop == true) {
+                break;
+            }
+            continue;
+        }
+#endif
+        if (pipe->stop == true) {
+            auto now = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+            if (stop == 0) {
+                stop = now;
+            }
+            else if (now - stop > 2000) {
+                break;
+            }
+        }
+        auto len = ::read(pipe->fd_read, buf, sizeof(buf));
+        if (len <= 0) {
+            break;
+        }
+        for (auto f = 0; f < len; f++) {
+            auto c = buf[f];
+            if (pipe->used < size) {
+                pipe->ring[(pipe->start + pipe->used) % size] = c;
+                pipe->used++;
+            }
+            else {
+                pipe->ring[pipe->start] = c;
+                pipe->start = (pipe->start + 1) % size;
+            }
+            if (pipe->callback != nullptr) {
+                if (c == '\n') {
+                    pipe->callback(pipe->line.c_str(), pipe->line.size(), pipe->data);
+                    pipe->line.clear();
+                }
+                else if (c != '\r') {
+                    pipe->line += c;
+                }
+            }
+        }
+    }
+    if (pipe->callback != nullptr && pipe->line.size() > 0) {
+        pipe->callback(pipe->line.c_str(), pipe->line.size(), pipe->data);
+        pipe->line.clear();
+    }
+}
 static unsigned _file_rand() {
     static bool INIT = false;
     if (INIT == false) {
@@ -915,6 +1479,17 @@ static std::string _file_substr(const std::string& string, std::string::size_typ
         return "";
     }
 }
+static void _file_sync_dir(const std::string& path) {
+#ifdef _WIN32
+    (void) path;
+#else
+    auto fd = ::open(path.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        fsync(fd);
+        ::close(fd);
+    }
+#endif
+}
 #ifdef _WIN32
 static int64_t _file_time(FILETIME* ft) {
     int64_t res = static_cast<int64_t>(ft->dwHighDateTime) << 32 | static_cast<int64_t>(ft->dwLowDateTime);
@@ -940,8 +1515,7 @@ static std::string _file_to_absolute_path(const std::string& filename, bool real
         return name;
     }
     else if (name.size() < 2 || name[1] != ':') {
-        auto work = file::File(file::work_dir());
-        res = work.filename();
+        res = priv::_file_work_dir();
         res += "\\";
         res += name;
     }
@@ -960,8 +1534,7 @@ static std::string _file_to_absolute_path(const std::string& filename, bool real
     }
 #else
     if (name[0] != '/') {
-        auto work = file::File(file::work_dir());
-        res = work.filename();
+        res = priv::_file_work_dir();
         res += "/";
         res += name;
     }
@@ -977,20 +1550,98 @@ static std::string _file_to_absolute_path(const std::string& filename, bool real
     while (res.size() > 1 && res.back() == '/') {
         res.pop_back();
     }
+    if (realpath == true) {
+        auto tmp = ::realpath(res.c_str(), nullptr);
+        if (tmp != nullptr) {
+            res = tmp;
+            free(tmp);
+        }
+        return res;
+    }
 #endif
     return (realpath == true) ? file::canonical(res).filename() : res;
 }
+static std::string _file_work_dir() {
+    auto res = std::string(".");
 #ifdef _WIN32
-static wchar_t* _file_to_wide(const char* string) {
-    auto out_len = MultiByteToWideChar(CP_UTF8, 0, string , -1, nullptr , 0);
-    auto out     = reinterpret_cast<wchar_t*>(file::allocate(nullptr, out_len * sizeof(wchar_t) + sizeof(wchar_t)));
-    MultiByteToWideChar(CP_UTF8, 0, string , -1, out, out_len);
-    return out;
-}
-#endif
-}
-}
-char* gnu::file::allocate(char* resize_or_null, size_t size) {
+    auto wpath = _wgetcwd(nullptr, 0);
+    if (wpath != nullptr) {
+        auto path = priv::_file_from_wide(wpath);
+        res = path;
+        free(wpath);
+        free(path);
+    }
+#else
+    auto path = getcwd(nullptr, 0);
+    if (path != nullptr) {
+        res = path;
+        free(path);
+    }
+#endif
+    return res;
+}
+#ifdef _WIN32
+static wchar_t* _file_to_wide(const char* string) {
+    auto out_len = MultiByteToWideChar(CP_UTF8, 0, string , -1, nullptr , 0);
+    auto out     = reinterpret_cast<wchar_t*>(file::allocate(nullptr, out_len * sizeof(wchar_t) + sizeof(wchar_t)));
+    MultiByteToWideChar(CP_UTF8, 0, string , -1, out, out_len);
+    return out;
+}
+#endif
+static size_t _file_write_batch(std::map<std::string, file::Buf>& jobs, bool atomic, bool flush) {
+    auto dirs    = std::vector<std::string>();
+    auto renames = std::vector<std::string>();
+    auto res     = (size_t) 0;
+    for (auto& job : jobs) {
+        auto dest = file::File(job.first);
+        if (dest.type() == file::Type::DIR) {
+            res++;
+            continue;
+        }
+        auto tmpfile = (atomic == true) ? dest.filename() + ".~tmp" : dest.filename();
+        auto file    = file::open(tmpfile, "wb");
+        if (file == nullptr) {
+            res++;
+            continue;
+        }
+        auto size  = job.second.size();
+        auto wrote = (size > 0) ? fwrite(job.second.c_str(), 1, size, file) : 0;
+        if (flush == true) {
+            file::flush(file);
+        }
+        fclose(file);
+        priv::_file_cache_erase(tmpfile);
+        if (wrote != size) {
+            if (atomic == true) {
+                file::remove(tmpfile);
+            }
+            res++;
+            continue;
+        }
+        if (atomic == true) {
+            renames.push_back(dest.filename());
+        }
+        if (std::find(dirs.begin(), dirs.end(), dest.path()) == dirs.end()) {
+            dirs.push_back(dest.path());
+        }
+    }
+    for (const auto& path : renames) {
+        auto tmpfile = path + ".~tmp";
+        if (file::rename(tmpfile, path) == false) {
+            file::remove(tmpfile);
+            res++;
+        }
+    }
+    if (flush == true) {
+        for (const auto& dir : dirs) {
+            priv::_file_sync_dir(dir);
+        }
+    }
+    return res;
+}
+}
+}
+char* gnu::file::allocate(char* resize_or_null, size_t size) {
     void* res = nullptr;
     if (resize_or_null == nullptr) {
         res = calloc(size, 1);
@@ -1058,6 +1709,7 @@ bool gnu::file::chmod(const std::string& path, int mode) {
 #else
     res = ::chmod(path.c_str(), mode) == 0;
 #endif
+    priv::_file_cache_erase(path);
     return res;
 }
 bool gnu::file::chtime(const std::string& path, int64_t time) {
@@ -1084,6 +1736,7 @@ bool gnu::file::chtime(const std::string& path, int64_t time) {
     ut.modtime = (time_t) time;
     res        = utime(path.c_str(), &ut) == 0;
 #endif
+    priv::_file_cache_erase(path);
     return res;
 }
 gnu::file::Buf gnu::file::close_stderr() {
@@ -1244,6 +1897,28 @@ gnu::file::File gnu::file::linkname(const std::string& path) {
     }
 #endif
 }
+gnu::file::Files gnu::file::make_files(const std::vector<std::string>& paths, bool realpath) {
+    auto res  = Files();
+    auto work = std::string();
+    res.reserve(paths.size());
+    for (const auto& path : paths) {
+#ifdef _WIN32
+        auto relative = path.size() > 0 && (path.size() < 2 || path[1] != ':') && path.find("\\\\") != 0;
+#else
+        auto relative = path.size() > 0 && path[0] != '/';
+#endif
+        if (relative == true) {
+            if (work == "") {
+                work = priv::_file_work_dir();
+            }
+            res.push_back(File(work + "/" + path, realpath));
+        }
+        else {
+            res.push_back(File(path, realpath));
+        }
+    }
+    return res;
+}
 bool gnu::file::mkdir(const std::string& path) {
     bool res = false;
 #ifdef _WIN32
@@ -1253,6 +1928,7 @@ bool gnu::file::mkdir(const std::string& path) {
 #else
     res = ::mkdir(path.c_str(), file::DEFAULT_DIR_MODE) == 0;
 #endif
+    priv::_file_cache_erase(path);
     return res;
 }
 FILE* gnu::file::open(const std::string& path, const std::string& mode) {
@@ -1308,7 +1984,7 @@ gnu::file::Buf* gnu::file::read2(const std::string& path) {
 gnu::file::Files gnu::file::read_dir(const std::string& path) {
     auto file = File(path, false);
     auto res  = Files();
-    if (file.type() != Type::DIR || file::is_circular(path) == true) {
+    if (file.type() != Type::DIR || (file.is_link() == true && file::is_circular(path) == true)) {
         return res;
     }
 #ifdef _WIN32
@@ -1358,9 +2034,15 @@ gnu::file::Files gnu::file::read_dir_rec(const std::string& path) {
 bool gnu::file::redirect_stderr() {
     return priv::_file_open_redirect(2);
 }
+bool gnu::file::redirect_stderr(size_t max_size, CallbackLine callback, void* data) {
+    return priv::_file_pipe_open(2, max_size, callback, data);
+}
 bool gnu::file::redirect_stdout() {
     return priv::_file_open_redirect(1);
 }
+bool gnu::file::redirect_stdout(size_t max_size, CallbackLine callback, void* data) {
+    return priv::_file_pipe_open(1, max_size, callback, data);
+}
 bool gnu::file::remove(const std::string& path) {
     auto f = File(path);
     if (f.type() == Type::MISSING && f.is_link() == false) {
@@ -1397,6 +2079,7 @@ bool gnu::file::remove(const std::string& path) {
         res = ::unlink(path.c_str()) == 0;
     }
 #endif
+    priv::_file_cache_erase(path);
     return res;
 }
 bool gnu::file::remove_rec(const std::string& path) {
@@ -1439,6 +2122,8 @@ bool gnu::file::rename(const std::string& from, const std::string& to) {
     }
     res = ::rename(from_f.filename().c_str(), to_f.filename().c_str()) == 0;
 #endif
+    priv::_file_cache_erase(from);
+    priv::_file_cache_erase(to);
     return res;
 }
 int gnu::file::run(const std::string& cmd, bool background, bool hide_win32_window) {
@@ -1475,6 +2160,21 @@ int gnu::file::run(const std::string& cmd, bool background, bool hide_win32_wind
     return system(cmd2.c_str());
 #endif
 }
+void gnu::file::stat_cache(unsigned ttl_ms) {
+    priv::_FILE_CACHE_TTL = ttl_ms;
+    if (ttl_ms == 0) {
+        file::stat_cache_clear();
+    }
+}
+void gnu::file::stat_cache_clear(const std::string& path) {
+    if (path == "") {
+        std::lock_guard<std::mutex> lock(priv::_FILE_CACHE_MUTEX);
+        priv::_FILE_CACHE.clear();
+    }
+    else {
+        priv::_file_cache_erase(path);
+    }
+}
 gnu::file::File gnu::file::tmp_dir() {
     try {
 #if defined(_WIN32)
@@ -1716,11 +2416,15 @@ gnu::file::File::File(const std::string& path, bool realpath) {
     _type  = Type::MISSING;
     if (path != "") {
         _filename = priv::_file_to_absolute_path(path, realpath);
+        if (priv::_file_cache_get(_filename, *this) == true) {
+            return;
+        }
         priv::_file_split_paths(_filename, _path, _name, _ext);
     }
     else {
         return;
     }
+    auto key = _filename;
 #ifdef _WIN32
     auto wpath = priv::_file_to_wide(_filename.c_str());
     WIN32_FILE_ATTRIBUTE_DATA attr;
@@ -1762,11 +2466,16 @@ gnu::file::File::File(const std::string& path, bool realpath) {
     free(wpath);
 #else
     struct stat st;
-    char        tmp[PATH_MAX + 1];
-    if (::stat(_filename.c_str(), &st) == 0) {
+    auto        found = ::lstat(_filename.c_str(), &st) == 0;
+    if (found == true && S_ISLNK(st.st_mode)) {
+        _link = true;
+        found = ::stat(_filename.c_str(), &st) == 0;
+    }
+    if (found == true) {
         _size  = st.st_size;
         _ctime = st.st_ctime;
         _mtime = st.st_mtime;
+        _mode  = st.st_mode & 0777;
         if (S_ISDIR(st.st_mode)) {
             _type = Type::DIR;
         }
@@ -1776,25 +2485,12 @@ gnu::file::File::File(const std::string& path, bool realpath) {
         else {
             _type = Type::OTHER;
         }
-        snprintf(tmp, PATH_MAX, "%o", st.st_mode);
-        auto l = strlen(tmp);
-        if (l > 2) {
-            _mode = strtol(tmp + (l - 3), nullptr, 8);
-        }
-        if (lstat(_filename.c_str(), &st) == 0 && S_ISLNK(st.st_mode)) {
-            _link = true;
-        }
-    }
-    else {
-        auto tmp_size = readlink(_filename.c_str(), tmp, PATH_MAX);
-        if (tmp_size > 0 && tmp_size < PATH_MAX) {
-            _link = true;
-        }
     }
 #endif
     if (_type == Type::DIR) {
         _ext = "";
     }
+    priv::_file_cache_put(key, *this);
 }
 std::string gnu::file::File::name_without_ext() const {
     try {
@@ -1839,162 +2535,1067 @@ std::string gnu::file::File::type_name() const {
     static std::string NAMES[] = { "Missing", "Directory", "File", "Other", "", };
     return NAMES[static_cast<size_t>(_type)];
 }
-#include <cmath>
-#include <cstdint>
-#include <errno.h>
-#include <climits>
-namespace gnu {
-namespace priv {
-#define _GNU_JSON_ERROR(X,Y) priv::_json_format_error(__LINE__, static_cast<unsigned>(X), Y)
-#define _GNU_JSON_FREE_STRINGS(X,Y) free(X); free(Y); X = Y = nullptr;
-static const char* const _JSON_BOM = "\xef\xbb\xbf";
-static void _json_debug(const json::JS* js, std::string t) {
-    if (js->is_array() == true) {
-        printf("%sARRAY(%u, %u, %p, %p): \"%s\"\n", t.c_str(), js->pos(), static_cast<unsigned>(js->size()), js, js->parent(), js->name().c_str());
-        t += "\t";
-        for (const auto js2 : *js->va()) _json_debug(js2, t);
-        t.pop_back();
-    }
-    else if (js->is_object() == true) {
-        printf("%sOBJECT(%u, %u, %p, %p): \"%s\"\n", t.c_str(), js->pos(), static_cast<unsigned>(js->size()), js, js->parent(), js->name().c_str());
-        t += "\t";
-        for (auto js2 : *js->vo()) _json_debug(js2.second, t);
-        t.pop_back();
-    }
-    else if (js->is_null()) printf("%s%s(%u, %p): \"%s\"\n", t.c_str(), js->type_name().c_str(), js->pos(), js->parent(), js->name_c());
-    else if (js->is_string()) printf("%s%s(%u, %p): \"%s\": \"%s\"\n", t.c_str(), js->type_name().c_str(), js->pos(), js->parent(), js->name_c(), js->vs_c());
-    else if (js->is_number()) printf("%s%s(%u, %p): \"%s\": %f\n", t.c_str(), js->type_name().c_str(), js->pos(), js->parent(), js->name_c(), js->vn());
-    else if (js->is_bool()) printf("%s%s(%u, %p): \"%s\": %s\n", t.c_str(), js->type_name().c_str(), js->pos(), js->parent(), js->name_c(), js->vb() ? "true" : "false");
-    fflush(stdout);
+gnu::file::AsyncWriter::AsyncWriter(bool atomic, bool flush) {
+    _atomic = atomic;
+    _busy   = 0;
+    _errors = 0;
+    _flush  = flush;
+    _stop   = false;
+    _thread = std::thread(&AsyncWriter::_run, this);
 }
-static std::string _json_encode(const json::JS& js, bool ignore_name, json::Encode option) {
-    static const std::string QUOTE = "\"";
-    std::string res;
-    std::string arr    = (option == json::Encode::DEFAULT) ? "\": [" : "\":[";
-    std::string obj    = (option == json::Encode::DEFAULT) ? "\": {" : "\":{";
-    std::string name1  = (option == json::Encode::DEFAULT) ? "\": " : "\":";
-    bool        object = (js.parent() != nullptr && js.parent()->is_object() == true);
-    if (js.is_array() == true) {
-        if (object == false || ignore_name == true) {
-            res = "[";
-        }
-        else {
-            res = QUOTE + js.name() + arr;
-        }
+gnu::file::AsyncWriter::~AsyncWriter() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
     }
-    else if (js.is_object() == true) {
-        if (object == false || ignore_name == true) {
-            res = "{";
+    _work.notify_one();
+    _thread.join();
+}
+void gnu::file::AsyncWriter::_run() {
+    while (true) {
+        auto jobs = std::map<std::string, Buf>();
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _work.wait(lock, [this] { return _stop == true || _jobs.empty() == false; });
+            if (_jobs.empty() == true) {
+                return;
+            }
+            while (_jobs.empty() == false && jobs.size() < AsyncWriter::MAX_BATCH) {
+                jobs.insert(_jobs.extract(_jobs.begin()));
+            }
+            _busy = jobs.size();
         }
-        else {
-            res = QUOTE + js.name() + obj;
+        auto failed = priv::_file_write_batch(jobs, _atomic, _flush);
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _busy    = 0;
+            _errors += failed;
         }
+        _done.notify_all();
     }
-    else {
-        res = (object == false || ignore_name == true) ? "" : (QUOTE + js.name() + name1);
-        if (js.is_string() == true) {
-            res += QUOTE + js.vs() + QUOTE;
-        }
-        else if (js.is_null() == true) {
-            res += "null";
-        }
-        else if (js.is_bool() == true) {
-            res += (js.vb() == true) ? "true" : "false";
-        }
-        else if (js.is_number()) {
-            res += json::format_number(js.vn());
+}
+void gnu::file::AsyncWriter::wait() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _done.wait(lock, [this] { return _jobs.empty() == true && _busy == 0; });
+}
+bool gnu::file::AsyncWriter::write(const std::string& path, Buf&& buf) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_stop == true || path == "") {
+            return false;
         }
+        _jobs[path] = std::move(buf);
     }
-    return res;
+    _work.notify_one();
+    return true;
 }
-static void _json_encode_inline(const json::JS& js, std::string& j, bool comma, json::Encode option) {
-    std::string c = (comma == true) ? "," : "";
-    size_t      f = 0;
-    if (js.is_array() == true) {
-        j += priv::_json_encode(js, false, option);
-        for (const auto n : *js.va()) {
-            priv::_json_encode_inline(*n, j, f < (js.va()->size() - 1), option);
-            f++;
-        }
-        j += "]" + c;
+gnu::file::Watcher::Watcher(CallbackWatch callback, void* data, bool polling) {
+    _callback = callback;
+    _data     = data;
+    _fd       = -1;
+#ifdef __linux__
+    if (polling == false) {
+        _fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
     }
-    else if (js.is_object() == true) {
-        j += priv::_json_encode(js, false, option);
-        for (const auto& n : *js.vo()) {
-            priv::_json_encode_inline(*n.second, j, f < (js.vo()->size() - 1), option);
-            f++;
-        }
-        j += "}" + c;
+#else
+    (void) polling;
+#endif
+}
+gnu::file::Watcher::~Watcher() {
+    if (_fd >= 0) {
+        ::close(_fd);
     }
-    else {
-        j += priv::_json_encode(js, false, option) + c;
+}
+size_t gnu::file::Watcher::_emit(Event event, const std::string& path, const std::string& from) {
+    if (_callback != nullptr) {
+        _callback(event, path, from, _data);
     }
+    return 1;
 }
-static void _json_encode_all(const json::JS& js, std::string& j, std::string& t, bool comma, json::Encode option) {
-    std::string c = (comma == true) ? "," : "";
-    std::string n = (option == json::Encode::FLAT) ? "" : "\n";
-    size_t      f = 0;
-    if (js.is_array() == true) {
-        j += t + priv::_json_encode(js, j == "", option);
-        if (js.has_inline() == false && js.size() > 0) {
-            j += n;
+bool gnu::file::Watcher::_is_watched(const std::string& path) const {
+    if (_paths.find(path) != _paths.end()) {
+        return true;
+    }
+    auto slash = path.find_last_of('/');
+    if (slash == std::string::npos) {
+        return false;
+    }
+    auto parent = _paths.find(path.substr(0, slash));
+    return parent != _paths.end() && parent->second == true;
+}
+size_t gnu::file::Watcher::_poll_inotify() {
+    auto res = (size_t) 0;
+#ifdef __linux__
+    auto last  = std::string();
+    auto moved = std::map<uint32_t, std::string>();
+    alignas(struct inotify_event) char buf[8192];
+    while (true) {
+        auto len = ::read(_fd, buf, sizeof(buf));
+        if (len <= 0) {
+            break;
         }
-        for (const auto n2 : *js.va()) {
-            if (option == json::Encode::DEFAULT) {
-                t += "\t";
+        for (auto p = buf; p < buf + len; ) {
+            auto ev = reinterpret_cast<const struct inotify_event*>(p);
+            p += sizeof(struct inotify_event) + ev->len;
+            if (ev->mask & IN_Q_OVERFLOW) {
+                for (const auto& path : _paths) {
+                    res += _emit(Event::MODIFIED, path.first);
+                }
+                continue;
             }
-            if (js.has_inline() == true) {
-                priv::_json_encode_inline(*n2, j, f < (js.va()->size() - 1), option);
+            auto wd = _wds.find(ev->wd);
+            if (wd == _wds.end()) {
+                continue;
             }
-            else {
-                priv::_json_encode_all(*n2, j, t, f < (js.va()->size() - 1), option);
+            else if (ev->mask & IN_IGNORED) {
+                _wds.erase(wd);
+                continue;
             }
-            if (option == json::Encode::DEFAULT) {
-                t.pop_back();
+            auto dir = wd->second;
+            if (ev->mask & (IN_DELETE_SELF | IN_MOVE_SELF)) {
+                if (_paths.find(dir) != _paths.end()) {
+                    res += _emit(Event::DELETED, dir);
+                }
+                continue;
             }
-            f++;
-        }
-        if (js.has_inline() == true || js.size() == 0) {
-            j += "]" + c + n;
-        }
-        else {
-            j += t + "]" + c + n;
-        }
-    }
-    else if (js.is_object() == true) {
-        j += t + priv::_json_encode(js, j == "", option);
-        if (js.has_inline() == false && js.size() > 0) {
-            j += n;
-        }
-        for (const auto& n2 : *js.vo()) {
-            if (option == json::Encode::DEFAULT) {
-                t += "\t";
+            else if (ev->len == 0) {
+                continue;
             }
-            if (js.has_inline() == true) {
-                priv::_json_encode_inline(*n2.second, j, f < (js.vo()->size() - 1), option);
+            auto path    = dir + "/" + ev->name;
+            auto watched = _is_watched(path);
+            if (ev->mask & IN_MODIFY) {
+                if (watched == true && path != last) {
+                    res += _emit(Event::MODIFIED, path);
+                    last = path;
+                }
+                continue;
             }
-            else {
-                priv::_json_encode_all(*n2.second, j, t, f < (js.vo()->size() - 1), option);
+            last = "";
+            if (ev->mask & IN_MOVED_FROM) {
+                if (watched == true) {
+                    moved[ev->cookie] = path;
+                }
             }
-            if (option == json::Encode::DEFAULT) {
-                t.pop_back();
+            else if (ev->mask & IN_MOVED_TO) {
+                auto from = moved.find(ev->cookie);
+                if (from == moved.end()) {
+                    if (watched == true) {
+                        res += _emit(Event::CREATED, path);
+                    }
+                }
+                else {
+                    if (watched == true) {
+                        res += _emit(Event::RENAMED, path, from->second);
+                    }
+                    else {
+                        res += _emit(Event::DELETED, from->second);
+                    }
+                    moved.erase(from);
+                }
+            }
+            else if (watched == false) {
+            }
+            else if (ev->mask & IN_CREATE) {
+                res += _emit(Event::CREATED, path);
+            }
+            else if (ev->mask & IN_DELETE) {
+                res += _emit(Event::DELETED, path);
             }
-            f++;
         }
-        if (js.has_inline() == true || js.size() == 0) {
-            j += "}" + c + n;
+    }
+    for (const auto& from : moved) {
+        res += _emit(Event::DELETED, from.second);
+    }
+#endif
+    return res;
+}
+size_t gnu::file::Watcher::_poll_stat() {
+    auto res   = (size_t) 0;
+    auto stats = std::map<std::string, Stat>();
+    for (const auto& path : _paths) {
+        _scan(path.first, path.second, stats);
+    }
+    for (const auto& now : stats) {
+        auto old = _stats.find(now.first);
+        if (old == _stats.end()) {
+            res += _emit(Event::CREATED, now.first);
         }
-        else {
-            j += t + "}" + c + n;
+        else if (now.second.type != Type::DIR && (now.second.mtime != old->second.mtime || now.second.size != old->second.size || now.second.type != old->second.type)) {
+            res += _emit(Event::MODIFIED, now.first);
         }
     }
-    else {
-        j += t + priv::_json_encode(js, false, option) + c + n;
+    for (const auto& old : _stats) {
+        if (stats.find(old.first) == stats.end()) {
+            res += _emit(Event::DELETED, old.first);
+        }
     }
+    _stats = std::move(stats);
+    return res;
 }
-static std::string _json_format_error(unsigned source, unsigned pos, unsigned line) {
-    char buf[256];
-    snprintf(buf, 256, "Error: invalid json (%u) at pos %u and line %u", source, pos, line);
+void gnu::file::Watcher::_scan(const std::string& path, bool is_dir, std::map<std::string, Stat>& stats) const {
+    auto file = File(path);
+    if (file.is_missing() == true) {
+        return;
+    }
+    stats[path] = Stat{file.type(), file.mtime(), file.size()};
+    if (is_dir == true && file.is_dir() == true) {
+        for (const auto& child : file::read_dir(path)) {
+            stats[child.filename()] = Stat{child.type(), child.mtime(), child.size()};
+        }
+    }
+}
+bool gnu::file::Watcher::add(const std::string& path) {
+    auto file = File(path);
+    if (file.filename() == "") {
+        return false;
+    }
+    else if (file.is_missing() == true && File(file.path()).is_dir() == false) {
+        return false;
+    }
+    else if (_paths.find(file.filename()) != _paths.end()) {
+        return true;
+    }
+    auto is_dir = file.is_dir();
+#ifdef __linux__
+    if (_fd >= 0) {
+        auto dir = (is_dir == true) ? file.filename() : file.path();
+        auto wd  = inotify_add_watch(_fd, dir.c_str(), IN_CREATE | IN_DELETE | IN_MODIFY | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF);
+        if (wd < 0) {
+            return false;
+        }
+        _wds[wd] = dir;
+        _paths[file.filename()] = is_dir;
+        return true;
+    }
+#endif
+    _paths[file.filename()] = is_dir;
+    _scan(file.filename(), is_dir, _stats);
+    return true;
+}
+std::vector<std::string> gnu::file::Watcher::paths() const {
+    auto res = std::vector<std::string>();
+    for (const auto& path : _paths) {
+        res.push_back(path.first);
+    }
+    return res;
+}
+size_t gnu::file::Watcher::poll() {
+    return (_fd >= 0) ? _poll_inotify() : _poll_stat();
+}
+bool gnu::file::Watcher::remove(const std::string& path) {
+    auto filename = File(path).filename();
+    auto it       = _paths.find(filename);
+    if (it == _paths.end()) {
+        return false;
+    }
+    auto is_dir = it->second;
+    _paths.erase(it);
+#ifdef __linux__
+    if (_fd >= 0) {
+        auto dir = (is_dir == true) ? filename : filename.substr(0, filename.find_last_of('/'));
+        for (const auto& p : _paths) {
+            if ((p.second == true && p.first == dir) || (p.second == false && p.first.substr(0, p.first.find_last_of('/')) == dir)) {
+                return true;
+            }
+        }
+        for (auto wd = _wds.begin(); wd != _wds.end(); ++wd) {
+            if (wd->second == dir) {
+                inotify_rm_watch(_fd, wd->first);
+                _wds.erase(wd);
+                break;
+            }
+        }
+        return true;
+    }
+#endif
+    (void) is_dir;
+    for (auto st = _stats.begin(); st != _stats.end(); ) {
+        if (_is_watched(st->first) == false) {
+            st = _stats.erase(st);
+        }
+        else {
+            ++st;
+        }
+    }
+    return true;
+}
+gnu::file::Process::Process() {
+    _cancel  = false;
+    _cb_err  = nullptr;
+    _cb_out  = nullptr;
+    _data    = nullptr;
+    _exit    = -1;
+    _lines   = true;
+    _status  = ProcessStatus::READY;
+    _timeout = 0;
+    _wake[0] = -1;
+    _wake[1] = -1;
+}
+gnu::file::Process::~Process() {
+    cancel();
+    wait();
+}
+void gnu::file::Process::_deliver(bool is_err, const char* buffer, size_t size) {
+    auto  cb  = (is_err == true) ? _cb_err : _cb_out;
+    auto& str = (is_err == true) ? _err : _out;
+    if (cb == nullptr) {
+        str.append(buffer, size);
+    }
+    else if (_lines == false) {
+        cb(buffer, size, _data);
+    }
+    else {
+        for (size_t f = 0; f < size; f++) {
+            auto c = buffer[f];
+            if (c == '\n') {
+                cb(str.c_str(), str.size(), _data);
+                str.clear();
+            }
+            else if (c != '\r') {
+                str += c;
+            }
+        }
+    }
+}
+void gnu::file::Process::_flush() {
+    if (_lines == true && _cb_out != nullptr && _out.size() > 0) {
+        _cb_out(_out.c_str(), _out.size(), _data);
+        _out.clear();
+    }
+    if (_lines == true && _cb_err != nullptr && _err.size() > 0) {
+        _cb_err(_err.c_str(), _err.size(), _data);
+        _err.clear();
+    }
+}
+void gnu::file::Process::_run(std::string cmd) {
+    char buf[16384];
+    auto start = std::chrono::steady_clock::now();
+    auto state = ProcessStatus::DONE;
+#ifdef _WIN32
+    SECURITY_ATTRIBUTES sa;
+    STARTUPINFOW        startup_info;
+    PROCESS_INFORMATION process_info;
+    HANDLE              pipes[2] = { nullptr, nullptr };
+    HANDLE              writes[2] = { nullptr, nullptr };
+    ZeroMemory(&sa, sizeof(SECURITY_ATTRIBUTES));
+    ZeroMemory(&startup_info, sizeof(STARTUPINFOW));
+    ZeroMemory(&process_info, sizeof(PROCESS_INFORMATION));
+    sa.nLength        = sizeof(SECURITY_ATTRIBUTES);
+    sa.bInheritHandle = TRUE;
+    for (auto f = 0; f < 2; f++) {
+        if (CreatePipe(&pipes[f], &writes[f], &sa, 0) == 0) {
+            pipes[f] = writes[f] = nullptr;
+        }
+        else {
+            SetHandleInformation(pipes[f], HANDLE_FLAG_INHERIT, 0);
+        }
+    }
+    auto null  = CreateFileW(L"NUL", GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, &sa, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    auto cmd_w = priv::_file_to_wide(cmd.c_str());
+    startup_info.cb          = sizeof(STARTUPINFOW);
+    startup_info.dwFlags     = STARTF_USESTDHANDLES | STARTF_USESHOWWINDOW;
+    startup_info.wShowWindow = SW_HIDE;
+    startup_info.hStdInput   = null;
+    startup_info.hStdOutput  = writes[0];
+    startup_info.hStdError   = writes[1];
+    auto started = pipes[0] != nullptr && pipes[1] != nullptr && CreateProcessW(nullptr, cmd_w, nullptr, nullptr, TRUE, CREATE_NO_WINDOW, nullptr, nullptr, &startup_info, &process_info) != 0;
+    free(cmd_w);
+    if (null != INVALID_HANDLE_VALUE) {
+        CloseHandle(null);
+    }
+    for (auto f = 0; f < 2; f++) {
+        if (writes[f] != nullptr) {
+            CloseHandle(writes[f]);
+        }
+    }
+    if (started == false) {
+        for (auto f = 0; f < 2; f++) {
+            if (pipes[f] != nullptr) {
+                CloseHandle(pipes[f]);
+            }
+        }
+        _status = ProcessStatus::FAILED;
+        return;
+    }
+    auto open = 2;
+    while (open > 0) {
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+        if (_cancel == true || (_timeout > 0 && elapsed >= _timeout)) {
+            state = (_cancel == true) ? ProcessStatus::CANCELED : ProcessStatus::TIMEOUT;
+            TerminateProcess(process_info.hProcess, 1);
+            break;
+        }
+        auto got = false;
+        for (auto f = 0; f < 2; f++) {
+            DWORD avail = 0;
+            DWORD read  = 0;
+            if (pipes[f] == nullptr) {
+                continue;
+            }
+            else if (PeekNamedPipe(pipes[f], nullptr, 0, nullptr, &avail, nullptr) == 0) {
+                CloseHandle(pipes[f]);
+                pipes[f] = nullptr;
+                open--;
+            }
+            else if (avail > 0 && ReadFile(pipes[f], buf, (avail < sizeof(buf)) ? avail : sizeof(buf), &read, nullptr) != 0 && read > 0) {
+                _deliver(f == 1, buf, read);
+                got = true;
+            }
+        }
+        if (got == false && open > 0) {
+            Sleep(10);
+        }
+    }
+    for (auto f = 0; f < 2; f++) {
+        if (pipes[f] != nullptr) {
+            CloseHandle(pipes[f]);
+        }
+    }
+    DWORD rc = 0;
+    while (WaitForSingleObject(process_info.hProcess, 10) == WAIT_TIMEOUT) {
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+        if (_cancel == true || (_timeout > 0 && elapsed >= _timeout)) {
+            state = (_cancel == true) ? ProcessStatus::CANCELED : ProcessStatus::TIMEOUT;
+            TerminateProcess(process_info.hProcess, 1);
+            WaitForSingleObject(process_info.hProcess, INFINITE);
+            break;
+        }
+    }
+    GetExitCodeProcess(process_info.hProcess, &rc);
+    CloseHandle(process_info.hThread);
+    CloseHandle(process_info.hProcess);
+    _exit = (int) rc;
+#else
+    int out[2] = { -1, -1 };
+    int err[2] = { -1, -1 };
+    if (::pipe(out) != 0 || ::pipe(err) != 0) {
+        for (auto fd : { out[0], out[1], err[0], err[1] }) {
+            if (fd >= 0) {
+                ::close(fd);
+            }
+        }
+        _status = ProcessStatus::FAILED;
+        return;
+    }
+    for (auto fd : { out[0], out[1], err[0], err[1] }) {
+        ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+    }
+    auto pid = fork();
+    if (pid == 0) {
+        auto null = ::open("/dev/null", O_RDONLY);
+        setpgid(0, 0);
+        ::dup2(null, 0);
+        ::dup2(out[1], 1);
+        ::dup2(err[1], 2);
+        for (auto fd : { null, out[0], out[1], err[0], err[1], _wake[0], _wake[1] }) {
+            ::close(fd);
+        }
+        execl("/bin/sh", "sh", "-c", cmd.c_str(), (char*) nullptr);
+        ::_exit(127);
+    }
+    ::close(out[1]);
+    ::close(err[1]);
+    if (pid < 0) {
+        ::close(out[0]);
+        ::close(err[0]);
+        _status = ProcessStatus::FAILED;
+        return;
+    }
+    setpgid(pid, pid);
+    struct pollfd fds[3];
+    fds[0].fd     = out[0];
+    fds[0].events = POLLIN;
+    fds[1].fd     = err[0];
+    fds[1].events = POLLIN;
+    fds[2].fd     = _wake[0];
+    fds[2].events = POLLIN;
+    for (auto& fd : fds) {
+        ::fcntl(fd.fd, F_SETFL, ::fcntl(fd.fd, F_GETFL) | O_NONBLOCK);
+    }
+    auto open = 2;
+    while (open > 0) {
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+        auto wait    = -1;
+        if (_timeout > 0) {
+            wait = (elapsed >= _timeout) ? 0 : static_cast<int>(_timeout - elapsed);
+        }
+        if (_cancel == true || (_timeout > 0 && elapsed >= _timeout)) {
+            state = (_cancel == true) ? ProcessStatus::CANCELED : ProcessStatus::TIMEOUT;
+            priv::_file_kill(pid);
+            break;
+        }
+        auto n = ::poll(fds, 3, wait);
+        if (n < 0 && errno != EINTR) {
+            break;
+        }
+        else if (n <= 0) {
+            continue;
+        }
+        if (fds[2].revents != 0) {
+            while (::read(_wake[0], buf, sizeof(buf)) > 0) {
+            }
+        }
+        for (auto f = 0; f < 2; f++) {
+            if (fds[f].fd < 0 || fds[f].revents == 0) {
+                continue;
+            }
+            while (true) {
+                auto len = ::read(fds[f].fd, buf, sizeof(buf));
+                if (len > 0) {
+                    _deliver(f == 1, buf, len);
+                }
+                else if (len < 0 && (errno == EAGAIN || errno == EINTR)) {
+                    break;
+                }
+                else {
+                    ::close(fds[f].fd);
+                    fds[f].fd = -1;
+                    open--;
+                    break;
+                }
+            }
+        }
+    }
+    for (auto f = 0; f < 2; f++) {
+        if (fds[f].fd >= 0) {
+            ::close(fds[f].fd);
+        }
+    }
+    auto rc     = 0;
+    auto killed = state != ProcessStatus::DONE;
+    while (true) {
+        auto res = waitpid(pid, &rc, (killed == true) ? 0 : WNOHANG);
+        if (res == pid || (res < 0 && errno != EINTR)) {
+            break;
+        }
+        else if (res < 0) {
+            continue;
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+        if (_cancel == true || (_timeout > 0 && elapsed >= _timeout)) {
+            state  = (_cancel == true) ? ProcessStatus::CANCELED : ProcessStatus::TIMEOUT;
+            killed = true;
+            priv::_file_kill(pid);
+            continue;
+        }
+        if (::poll(&fds[2], 1, 10) > 0) {
+            while (::read(_wake[0], buf, sizeof(buf)) > 0) {
+            }
+        }
+    }
+    _exit = (WIFEXITED(rc) != 0) ? WEXITSTATUS(rc) : -1;
+#endif
+    _flush();
+    _status = state;
+}
+void gnu::file::Process::cancel() {
+    if (is_running() == false) {
+        return;
+    }
+    _cancel = true;
+#ifndef _WIN32
+    if (_wake[1] >= 0) {
+        auto r = ::write(_wake[1], "x", 1);
+        (void) r;
+    }
+#endif
+}
+bool gnu::file::Process::start(const std::string& cmd, CallbackLine cb_out, CallbackLine cb_err, void* data, unsigned timeout_ms, bool lines) {
+    if (is_running() == true) {
+        return false;
+    }
+    wait();
+    _cancel  = false;
+    _cb_err  = cb_err;
+    _cb_out  = cb_out;
+    _data    = data;
+    _err     = "";
+    _exit    = -1;
+    _lines   = lines;
+    _out     = "";
+    _timeout = timeout_ms;
+#ifndef _WIN32
+    if (::pipe(_wake) != 0) {
+        _wake[0] = _wake[1] = -1;
+        _status  = ProcessStatus::FAILED;
+        return false;
+    }
+    ::fcntl(_wake[0], F_SETFL, ::fcntl(_wake[0], F_GETFL) | O_NONBLOCK);
+    ::fcntl(_wake[0], F_SETFD, FD_CLOEXEC);
+    ::fcntl(_wake[1], F_SETFD, FD_CLOEXEC);
+#endif
+    _status = ProcessStatus::RUNNING;
+    _thread = std::thread(&Process::_run, this, cmd);
+    return true;
+}
+gnu::file::ProcessStatus gnu::file::Process::wait() {
+    if (_thread.joinable() == true) {
+        _thread.join();
+    }
+#ifndef _WIN32
+    for (auto& fd : _wake) {
+        if (fd >= 0) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+#endif
+    return _status;
+}
+gnu::file::MMap::MMap(const std::string& path) {
+    _open = false;
+    _data = nullptr;
+    _size = 0;
+    _file = nullptr;
+    _map  = nullptr;
+    if (path != "") {
+        open(path);
+    }
+}
+void gnu::file::MMap::advise(size_t offset, size_t size, bool need) const {
+    if (_data == nullptr || offset >= _size || size == 0) {
+        return;
+    }
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    const size_t PAGE = info.dwPageSize;
+#else
+    const size_t PAGE = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+    const size_t START = offset / PAGE * PAGE;
+    const size_t STOP  = std::min(_size, offset + size);
+    auto         addr  = const_cast<char*>(_data) + START;
+#ifdef _WIN32
+    if (need == false) {
+        VirtualUnlock(addr, STOP - START);
+    }
+#else
+    madvise(addr, STOP - START, (need == true) ? MADV_WILLNEED : MADV_DONTNEED);
+#endif
+}
+void gnu::file::MMap::close() {
+#ifdef _WIN32
+    if (_data != nullptr) {
+        UnmapViewOfFile(_data);
+    }
+    if (_map != nullptr) {
+        CloseHandle(_map);
+    }
+    if (_file != nullptr) {
+        CloseHandle(_file);
+    }
+#else
+    if (_data != nullptr) {
+        munmap(const_cast<char*>(_data), _size);
+    }
+#endif
+    _open = false;
+    _data = nullptr;
+    _size = 0;
+    _file = nullptr;
+    _map  = nullptr;
+}
+bool gnu::file::MMap::open(const std::string& path) {
+    close();
+#ifdef _WIN32
+    auto wpath = priv::_file_to_wide(path.c_str());
+    auto file  = CreateFileW(wpath, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    LARGE_INTEGER size;
+    free(wpath);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    else if (GetFileSizeEx(file, &size) == 0) {
+        CloseHandle(file);
+        return false;
+    }
+    _file = file;
+    _size = static_cast<size_t>(size.QuadPart);
+    _open = true;
+    if (_size == 0) {
+        return true;
+    }
+    _map = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (_map == nullptr) {
+        close();
+        return false;
+    }
+    _data = static_cast<const char*>(MapViewOfFile(_map, FILE_MAP_READ, 0, 0, 0));
+    if (_data == nullptr) {
+        close();
+        return false;
+    }
+#else
+    auto fd = ::open(path.c_str(), O_RDONLY);
+    struct stat st;
+    if (fd < 0) {
+        return false;
+    }
+    else if (fstat(fd, &st) != 0 || S_ISREG(st.st_mode) == 0) {
+        ::close(fd);
+        return false;
+    }
+    _size = static_cast<size_t>(st.st_size);
+    _open = true;
+    if (_size > 0) {
+        auto data = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            ::close(fd);
+            close();
+            return false;
+        }
+        _data = static_cast<const char*>(data);
+        madvise(data, _size, MADV_SEQUENTIAL);
+    }
+    ::close(fd);
+#endif
+    return true;
+}
+double gnu::file::CSVField::to_double() const {
+    char  buf[64];
+    char* end = nullptr;
+    if (len == 0) {
+        return INFINITY;
+    }
+    else if (len >= sizeof(buf)) {
+        auto tmp = to_string();
+        errno = 0;
+        auto res = strtod(tmp.c_str(), &end);
+        return (end == tmp.c_str() || errno == ERANGE) ? INFINITY : res;
+    }
+    memcpy(buf, str, len);
+    buf[len] = 0;
+    errno    = 0;
+    auto res = strtod(buf, &end);
+    return (end == buf || errno == ERANGE) ? INFINITY : res;
+}
+int64_t gnu::file::CSVField::to_int(int64_t def) const {
+    char  buf[64];
+    char* end = nullptr;
+    if (len == 0 || len >= sizeof(buf)) {
+        return def;
+    }
+    memcpy(buf, str, len);
+    buf[len] = 0;
+    errno    = 0;
+    auto res = strtoll(buf, &end, 10);
+    return (end == buf || errno == ERANGE) ? def : static_cast<int64_t>(res);
+}
+std::string gnu::file::CSVField::to_string() const {
+    if (quote == 0) {
+        return std::string(str, len);
+    }
+    std::string res;
+    res.reserve(len);
+    for (size_t f = 0; f < len; f++) {
+        res += str[f];
+        if (str[f] == quote && f + 1 < len && str[f + 1] == quote) {
+            f++;
+        }
+    }
+    return res;
+}
+gnu::file::CSVReader::CSVReader(const std::string& sep, char quote) {
+    _buf   = nullptr;
+    _quote = quote;
+    _sep   = (sep == "") ? "," : sep;
+    _size  = 0;
+}
+std::vector<std::string> gnu::file::CSVReader::column(size_t column, size_t max_rows) const {
+    std::vector<std::string> res;
+    std::vector<CSVField>    fields;
+    size_t                   pos = 0;
+    while (pos < _size && max_rows > 0) {
+        auto end = static_cast<const char*>(memchr(_buf + pos, '\n', _size - pos));
+        auto len = (end != nullptr) ? static_cast<size_t>(end - (_buf + pos)) : _size - pos;
+        if (_row(_buf + pos, len, fields) > column) {
+            res.push_back(fields[column].to_string());
+        }
+        pos += len + 1;
+        max_rows--;
+    }
+    return res;
+}
+bool gnu::file::CSVReader::open(const std::string& path) {
+    if (_mmap.open(path) == false) {
+        set_buffer(nullptr, 0);
+        return false;
+    }
+    set_buffer(_mmap.data(), _mmap.size());
+    return true;
+}
+void gnu::file::CSVReader::parse(CallbackCSV callback, void* data) {
+    std::vector<std::thread> threads;
+    if (_chunks.size() == 0) {
+        split(1);
+    }
+    for (size_t f = 1; f < _chunks.size(); f++) {
+        threads.push_back(std::thread(&CSVReader::_parse, this, f, callback, data));
+    }
+    if (_chunks.size() > 0) {
+        _parse(0, callback, data);
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+}
+void gnu::file::CSVReader::_parse(size_t chunk, CallbackCSV callback, void* data) const {
+    std::vector<CSVField> fields;
+    size_t                pos  = _chunks[chunk].first;
+    const size_t          stop = _chunks[chunk].second;
+    while (pos < stop) {
+        auto end = static_cast<const char*>(memchr(_buf + pos, '\n', stop - pos));
+        auto len = (end != nullptr) ? static_cast<size_t>(end - (_buf + pos)) : stop - pos;
+        auto num = _row(_buf + pos, len, fields);
+        if (num > 0) {
+            callback(chunk, fields.data(), num, data);
+        }
+        pos += len + 1;
+    }
+}
+size_t gnu::file::CSVReader::_row(const char* row, size_t len, std::vector<CSVField>& fields) const {
+    const char*  end  = row + len;
+    const char*  pos  = row;
+    const char   SEP  = _sep[0];
+    const size_t SLEN = _sep.length();
+    fields.clear();
+    if (len > 0 && row[len - 1] == '\r') {
+        end--;
+    }
+    if (pos == end) {
+        return 0;
+    }
+    while (true) {
+        CSVField field  = { pos, 0, 0 };
+        bool     quoted = false;
+        if (_quote != 0 && pos < end && *pos == _quote) {
+            auto stop = ++pos;
+            while (stop < end) {
+                if (*stop != _quote) {
+                    stop++;
+                }
+                else if (stop + 1 < end && stop[1] == _quote) {
+                    field.quote = _quote;
+                    stop += 2;
+                }
+                else {
+                    break;
+                }
+            }
+            field.str = pos;
+            field.len = static_cast<size_t>(stop - pos);
+            pos       = (stop < end) ? stop + 1 : end;
+            quoted    = true;
+        }
+        auto next = pos;
+        while (next < end) {
+            next = static_cast<const char*>(memchr(next, SEP, static_cast<size_t>(end - next)));
+            if (next == nullptr) {
+                next = end;
+            }
+            else if (SLEN == 1 || (static_cast<size_t>(end - next) >= SLEN && memcmp(next, _sep.c_str(), SLEN) == 0)) {
+                break;
+            }
+            else {
+                next++;
+            }
+        }
+        if (quoted == false) {
+            field.len = static_cast<size_t>(next - pos);
+        }
+        fields.push_back(field);
+        if (next >= end) {
+            break;
+        }
+        pos = next + SLEN;
+    }
+    return fields.size();
+}
+void gnu::file::CSVReader::set_buffer(const char* buffer, size_t size) {
+    _buf  = buffer;
+    _size = (buffer != nullptr) ? size : 0;
+    if (_size >= 3 && memcmp(_buf, "\xEF\xBB\xBF", 3) == 0) {
+        _buf  += 3;
+        _size -= 3;
+    }
+    split(1);
+}
+size_t gnu::file::CSVReader::split(unsigned threads) {
+    size_t count = (threads == 0) ? std::thread::hardware_concurrency() : threads;
+    size_t pos   = 0;
+    count = std::max(static_cast<size_t>(1), std::min(count, _size / MIN_CHUNK));
+    _chunks.clear();
+    for (size_t f = 1; f <= count && pos < _size; f++) {
+        auto stop = (f == count) ? _size : _size / count * f;
+        if (stop < pos) {
+            stop = pos;
+        }
+        if (stop < _size) {
+            auto nl = static_cast<const char*>(memchr(_buf + stop, '\n', _size - stop));
+            stop = (nl != nullptr) ? static_cast<size_t>(nl - _buf) + 1 : _size;
+        }
+        _chunks.push_back(std::make_pair(pos, stop));
+        pos = stop;
+    }
+    return _chunks.size();
+}
+#include <cmath>
+#include <cstdint>
+#include <errno.h>
+#include <climits>
+namespace gnu {
+namespace priv {
+#define _GNU_JSON_ERROR(X,Y) priv::_json_format_error(__LINE__, static_cast<unsigned>(X), Y)
+#define _GNU_JSON_FREE_STRINGS(X,Y) free(X); free(Y); X = Y = nullptr;
+static const char* const _JSON_BOM = "\xef\xbb\xbf";
+static void _json_debug(const json::JS* js, std::string t) {
+    if (js->is_array() == true) {
+        printf("%sARRAY(%u, %u, %p, %p): \"%s\"\n", t.c_str(), js->pos(), static_cast<unsigned>(js->size()), js, js->parent(), js->name().c_str());
+        t += "\t";
+        for (const auto js2 : *js->va()) _json_debug(js2, t);
+        t.pop_back();
+    }
+    else if (js->is_object() == true) {
+        printf("%sOBJECT(%u, %u, %p, %p): \"%s\"\n", t.c_str(), js->pos(), static_cast<unsigned>(js->size()), js, js->parent(), js->name().c_str());
+        t += "\t";
+        for (auto js2 : *js->vo()) _json_debug(js2.second, t);
+        t.pop_back();
+    }
+    else if (js->is_null()) printf("%s%s(%u, %p): \"%s\"\n", t.c_str(), js->type_name().c_str(), js->pos(), js->parent(), js->name_c());
+    else if (js->is_string()) printf("%s%s(%u, %p): \"%s\": \"%s\"\n", t.c_str(), js->type_name().c_str(), js->pos(), js->parent(), js->name_c(), js->vs_c());
+    else if (js->is_number()) printf("%s%s(%u, %p): \"%s\": %f\n", t.c_str(), js->type_name().c_str(), js->pos(), js->parent(), js->name_c(), js->vn());
+    else if (js->is_bool()) printf("%s%s(%u, %p): \"%s\": %s\n", t.c_str(), js->type_name().c_str(), js->pos(), js->parent(), js->name_c(), js->vb() ? "true" : "false");
+    fflush(stdout);
+}
+static std::string _json_encode(const json::JS& js, bool ignore_name, json::Encode option) {
+    static const std::string QUOTE = "\"";
+    std::string res;
+    std::string arr    = (option == json::Encode::DEFAULT) ? "\": [" : "\":[";
+    std::string obj    = (option == json::Encode::DEFAULT) ? "\": {" : "\":{";
+    std::string name1  = (option == json::Encode::DEFAULT) ? "\": " : "\":";
+    bool        object = (js.parent() != nullptr && js.parent()->is_object() == true);
+    if (js.is_array() == true) {
+        if (object == false || ignore_name == true) {
+            res = "[";
+        }
+        else {
+            res = QUOTE + js.name() + arr;
+        }
+    }
+    else if (js.is_object() == true) {
+        if (object == false || ignore_name == true) {
+            res = "{";
+        }
+        else {
+            res = QUOTE + js.name() + obj;
+        }
+    }
+    else {
+        res = (object == false || ignore_name == true) ? "" : (QUOTE + js.name() + name1);
+        if (js.is_string() == true) {
+            res += QUOTE + js.vs() + QUOTE;
+        }
+        else if (js.is_null() == true) {
+            res += "null";
+        }
+        else if (js.is_bool() == true) {
+            res += (js.vb() == true) ? "true" : "false";
+        }
+        else if (js.is_number()) {
+            res += json::format_number(js.vn());
+        }
+    }
+    return res;
+}
+static void _json_encode_inline(const json::JS& js, std::string& j, bool comma, json::Encode option) {
+    std::string c = (comma == true) ? "," : "";
+    size_t      f = 0;
+    if (js.is_array() == true) {
+        j += priv::_json_encode(js, false, option);
+        for (const auto n : *js.va()) {
+            priv::_json_encode_inline(*n, j, f < (js.va()->size() - 1), option);
+            f++;
+        }
+        j += "]" + c;
+    }
+    else if (js.is_object() == true) {
+        j += priv::_json_encode(js, false, option);
+        for (const auto& n : *js.vo()) {
+            priv::_json_encode_inline(*n.second, j, f < (js.vo()->size() - 1), option);
+            f++;
+        }
+        j += "}" + c;
+    }
+    else {
+        j += priv::_json_encode(js, false, option) + c;
+    }
+}
+static void _json_encode_all(const json::JS& js, std::string& j, std::string& t, bool comma, json::Encode option) {
+    std::string c = (comma == true) ? "," : "";
+    std::string n = (option == json::Encode::FLAT) ? "" : "\n";
+    size_t      f = 0;
+    if (js.is_array() == true) {
+        j += t + priv::_json_encode(js, j == "", option);
+        if (js.has_inline() == false && js.size() > 0) {
+            j += n;
+        }
+        for (const auto n2 : *js.va()) {
+            if (option == json::Encode::DEFAULT) {
+                t += "\t";
+            }
+            if (js.has_inline() == true) {
+                priv::_json_encode_inline(*n2, j, f < (js.va()->size() - 1), option);
+            }
+            else {
+                priv::_json_encode_all(*n2, j, t, f < (js.va()->size() - 1), option);
+            }
+            if (option == json::Encode::DEFAULT) {
+                t.pop_back();
+            }
+            f++;
+        }
+        if (js.has_inline() == true || js.size() == 0) {
+            j += "]" + c + n;
+        }
+        else {
+            j += t + "]" + c + n;
+        }
+    }
+    else if (js.is_object() == true) {
+        j += t + priv::_json_encode(js, j == "", option);
+        if (js.has_inline() == false && js.size() > 0) {
+            j += n;
+        }
+        for (const auto& n2 : *js.vo()) {
+            if (option == json::Encode::DEFAULT) {
+                t += "\t";
+            }
+            if (js.has_inline() == true) {
+                priv::_json_encode_inline(*n2.second, j, f < (js.vo()->size() - 1), option);
+            }
+            else {
+                priv::_json_encode_all(*n2.second, j, t, f < (js.vo()->size() - 1), option);
+            }
+            if (option == json::Encode::DEFAULT) {
+                t.pop_back();
+            }
+            f++;
+        }
+        if (js.has_inline() == true || js.size() == 0) {
+            j += "}" + c + n;
+        }
+        else {
+            j += t + "}" + c + n;
+        }
+    }
+    else {
+        j += t + priv::_json_encode(js, false, option) + c + n;
+    }
+}
+static std::string _json_format_error(unsigned source, unsigned pos, unsigned line) {
+    char buf[256];
+    snprintf(buf, 256, "Error: invalid json (%u) at pos %u and line %u", source, pos, line);
     return buf;
 }
 static bool _json_parse_number(const char* json, size_t len, size_t& pos, double& nVal) {
@@ -4135,11 +5736,13 @@ void* flw::util::zero_memory(char* mem, size_t size) {
 }
 #include <FL/Fl_File_Chooser.H>
 #include <FL/Fl_Hor_Slider.H>
+#include <FL/Fl_Image_Surface.H>
 #include <FL/Fl_Menu_Button.H>
 #include <FL/Fl_Scrollbar.H>
 #include <FL/fl_draw.H>
 #include <FL/fl_show_colormap.H>
 #include <algorithm>
+#include <atomic>
 namespace flw {
 namespace priv {
 #define _FLW_CHART_CB(X)        [](Fl_Widget*, void* o) { static_cast<Chart*>(o)->X; }, this
@@ -4149,10 +5752,12 @@ static const char* const _CHART_LABEL_ADD_CSV         = "Add Line from CSV File.
 static const char* const _CHART_LABEL_ADD_LINE        = "Create Line...";
 static const char* const _CHART_LABEL_CLEAR           = "Clear Chart";
 static const char* const _CHART_LABEL_LOAD_JSON       = "Load Chart from JSON...";
+static const char* const _CHART_LABEL_LOAD_SNAPSHOT   = "Load Chart from Snapshot...";
 static const char* const _CHART_LABEL_PRINT           = "Print to PostScript File...";
 static const char* const _CHART_LABEL_SAVE_CSV        = "Save Line to CSV...";
 static const char* const _CHART_LABEL_SAVE_JSON       = "Save Chart to JSON...";
 static const char* const _CHART_LABEL_SAVE_PNG        = "Save to PNG File...";
+static const char* const _CHART_LABEL_SAVE_SNAPSHOT   = "Save Chart to Snapshot...";
 static const char* const _CHART_LABEL_SETUP_AREA      = "Number of Areas...";
 static const char* const _CHART_LABEL_SETUP_DELETE    = "Delete Lines...";
 static const char* const _CHART_LABEL_SETUP_LABEL     = "Label...";
@@ -4164,6 +5769,7 @@ static const char* const _CHART_LABEL_SETUP_RANGE     = "Date Range...";
 static const char* const _CHART_LABEL_SETUP_SHOW      = "Show or Hide Lines...";
 static const char* const _CHART_LABEL_SHOW_HLINES     = "Show Horizontal Lines";
 static const char* const _CHART_LABEL_SHOW_LABELS     = "Show Line Labels";
+static const char* const _CHART_LABEL_SHOW_LOD        = "Aggregate Dates When Zoomed Out";
 static const char* const _CHART_LABEL_SHOW_VLINES     = "Show Vertical Lines";
 static const int         _CHART_MIN_MARGIN            =  3;
 static const int         _CHART_MIN_AREA_SIZE         = 10;
@@ -4173,11 +5779,492 @@ static const std::string _CHART_LABEL_SYMBOL          = "@-> ";
 static const char* const _CHART_LABEL_DEBUG           = "Debug Chart";
 static const char* const _CHART_LABEL_DEBUG_LINE      = "Print Visible Values";
 #endif
+static const gnu::DateParser _CHART_DATE_PARSER(gnu::Date::Format::ISO_TIME);
+static std::atomic<unsigned> _CHART_LINE_ID(0);
+static const char            _CHART_SNAPSHOT_MAGIC[8] = { 'F', 'L', 'W', 'C', 'H', 'A', 'R', 'T' };
+static const uint32_t        _CHART_SNAPSHOT_ORDER    = 0x01020304;
+static std::string _chart_date(const std::string& date) {
+    if (_CHART_DATE_PARSER.parse_fixed(date).is_invalid() == false) {
+        return date.substr(0, 15);
+    }
+    auto valid_date = gnu::Date(date);
+    return (valid_date.is_invalid() == true) ? "" : valid_date.format(gnu::Date::Format::ISO_TIME);
+}
+static std::string _chart_key_date(const gnu::DateKey& key) {
+    if (key.is_invalid() == true) {
+        return "";
+    }
+    char buf[40];
+    auto len = key.to_date().format_to(buf, sizeof(buf), gnu::Date::Format::ISO_TIME);
+    return std::string(buf, len);
+}
+static bool _chart_is_value(double value) {
+    return std::isfinite(value) == true && fabs(value) < chart::MAX_VALUE;
+}
+static bool _chart_series_check(const int64_t* keys, const double* high, const double* low, const double* close, size_t first, size_t end, int64_t prev) {
+    for (size_t f = first; f < end; f++) {
+        if (keys[f] == gnu::DateKey::INVALID) {
+            if (high[f] != 0.0 || low[f] != 0.0 || close[f] != 0.0) {
+                return false;
+            }
+            continue;
+        }
+        else if (prev != gnu::DateKey::INVALID && keys[f] <= prev) {
+            return false;
+        }
+        prev = keys[f];
+        if (_chart_is_value(high[f]) == false ||
+            _chart_is_value(low[f]) == false ||
+            _chart_is_value(close[f]) == false ||
+            low[f] > close[f] ||
+            close[f] > high[f]) {
+            return false;
+        }
+    }
+    return true;
+}
+struct _ChartCSV {
+    const gnu::DateParser*      parser;
+    std::vector<chart::Series>  series;
+};
+static void _chart_csv_row(size_t chunk, const gnu::file::CSVField* fields, size_t count, void* data) {
+    auto csv = static_cast<_ChartCSV*>(data);
+    if (count != 2 && count < 4) {
+        return;
+    }
+    auto key = csv->parser->parse(fields[0].str, fields[0].len);
+    if (key.is_invalid() == true) {
+        return;
+    }
+    else if (count == 2) {
+        auto value = fields[1].to_double();
+        if (_chart_is_value(value) == true) {
+            csv->series[chunk].push_back(key, value);
+        }
+    }
+    else {
+        auto high  = fields[1].to_double();
+        auto low   = fields[2].to_double();
+        auto close = fields[3].to_double();
+        if (_chart_is_value(high) == true && _chart_is_value(low) == true && _chart_is_value(close) == true) {
+            csv->series[chunk].push_back(key, high, low, close);
+        }
+    }
+}
+class _ChartSnapshotReader {
+public:
+    _ChartSnapshotReader(const char* data, size_t size) {
+        _data = data;
+        _size = size;
+        _pos  = 0;
+        _err  = false;
+    }
+    void align() {
+        _pos = (_pos + 7) & ~static_cast<size_t>(7);
+    }
+    template<typename T>
+    const T* array(size_t count) {
+        align();
+        if (_err == true || count > (_size - std::min(_pos, _size)) / sizeof(T)) {
+            _err = true;
+            return nullptr;
+        }
+        auto res = reinterpret_cast<const T*>(_data + _pos);
+        _pos += count * sizeof(T);
+        return res;
+    }
+    bool err() const {
+        return _err;
+    }
+    template<typename T>
+    T get() {
+        T res = T();
+        if (_err == true || _pos + sizeof(T) > _size) {
+            _err = true;
+        }
+        else {
+            memcpy(&res, _data + _pos, sizeof(T));
+            _pos += sizeof(T);
+        }
+        return res;
+    }
+    std::string str() {
+        auto len = get<uint32_t>();
+        if (_err == true || len > _size - _pos) {
+            _err = true;
+            return "";
+        }
+        auto res = std::string(_data + _pos, len);
+        _pos += len;
+        return res;
+    }
+private:
+    const char*                 _data;
+    size_t                      _size;
+    size_t                      _pos;
+    bool                        _err;
+};
+static void _chart_snapshot_align(std::string& buf) {
+    while (buf.length() % 8 != 0) {
+        buf += '\0';
+    }
+}
+static void _chart_snapshot_put(std::string& buf, const void* data, size_t size) {
+    buf.append(static_cast<const char*>(data), size);
+}
+template<typename T>
+static void _chart_snapshot_put(std::string& buf, T value) {
+    _chart_snapshot_put(buf, &value, sizeof(T));
+}
+static void _chart_snapshot_put(std::string& buf, const std::string& value) {
+    _chart_snapshot_put(buf, static_cast<uint32_t>(value.length()));
+    _chart_snapshot_put(buf, value.c_str(), value.length());
+}
+static int64_t _chart_floor_div(int64_t a, int64_t b) {
+    return (a >= 0) ? a / b : (a - (b - 1)) / b;
+}
+static int64_t _chart_weekdays(int64_t days) {
+    auto n    = days + 3;
+    auto week = _chart_floor_div(n, 7);
+    auto rem  = n - week * 7;
+    return week * 5 + ((rem < 5) ? rem : 5);
+}
+static int64_t _chart_weekday_to_days(int64_t count) {
+    auto week = _chart_floor_div(count, 5);
+    auto rem  = count - week * 5;
+    return week * 7 + rem - 3;
+}
+static void _chart_resample_bucket(int64_t seconds, chart::DateRange range, int64_t count, int weekday, int64_t& first, int64_t& end, int64_t& label) {
+    if (range == chart::DateRange::FRIDAY || range == chart::DateRange::SUNDAY) {
+        const auto DAYS   = _chart_floor_div(seconds, gnu::Date::SECS_PER_DAY);
+        const auto ANCHOR = static_cast<int64_t>((weekday + 4) % 7);
+        const auto WEEK   = -_chart_floor_div(ANCHOR - DAYS, 7);
+        const auto LAST   = ANCHOR + (_chart_floor_div(WEEK, count) * count + count - 1) * 7;
+        first = (LAST - count * 7 + 1) * gnu::Date::SECS_PER_DAY;
+        end   = (LAST + 1) * gnu::Date::SECS_PER_DAY;
+        label = LAST * gnu::Date::SECS_PER_DAY;
+    }
+    else if (range == chart::DateRange::MONTH) {
+        const auto DATE  = gnu::DateKey::FromSeconds(seconds).to_date();
+        const auto MONTH = _chart_floor_div(DATE.year() * 12 + DATE.month() - 1, count) * count;
+        auto       stop  = gnu::Date(static_cast<int>((MONTH + count - 1) / 12), static_cast<int>((MONTH + count - 1) % 12) + 1, 1);
+        stop.set_day_to_last_in_month();
+        first = gnu::Date(static_cast<int>(MONTH / 12), static_cast<int>(MONTH % 12) + 1, 1).key().seconds();
+        label = stop.key().seconds();
+        end   = label + gnu::Date::SECS_PER_DAY;
+    }
+    else {
+        int64_t step = gnu::Date::SECS_PER_DAY;
+        if (range == chart::DateRange::HOUR) {
+            step = gnu::Date::SECS_PER_HOUR;
+        }
+        else if (range == chart::DateRange::MIN) {
+            step = 60;
+        }
+        else if (range == chart::DateRange::SEC) {
+            step = 1;
+        }
+        step  *= count;
+        first  = _chart_floor_div(seconds, step) * step;
+        end    = first + step;
+        label  = first;
+    }
+}
+static bool _chart_resample(const chart::Series& in, chart::DateRange range, int64_t count, int weekday, bool sum, chart::Series* out) {
+    const auto& keys  = in.keys();
+    const auto& high  = in.high();
+    const auto& low   = in.low();
+    const auto& close = in.close();
+    int64_t     first = 0;
+    int64_t     end   = 0;
+    int64_t     label = 0;
+    bool        open  = false;
+    double      h     = 0.0;
+    double      l     = 0.0;
+    double      c     = 0.0;
+    count = std::max(count, static_cast<int64_t>(1));
+    for (size_t f = 0; f < in.size(); f++) {
+        if (keys[f].is_invalid() == true || in.check(f, f) == false) {
+            continue;
+        }
+        const auto SECONDS = keys[f].seconds();
+        if (open == false || SECONDS < first || SECONDS >= end) {
+            if (open == true && out != nullptr) {
+                out->push_back(gnu::DateKey::FromSeconds(label), h, l, c);
+            }
+            _chart_resample_bucket(SECONDS, range, count, weekday, first, end, label);
+            if (out == nullptr && SECONDS != label) {
+                return false;
+            }
+            open = true;
+            h    = high[f];
+            l    = low[f];
+            c    = close[f];
+        }
+        else if (out == nullptr) {
+            return false;
+        }
+        else if (sum == true) {
+            h += high[f];
+            l += low[f];
+            c += close[f];
+        }
+        else {
+            h = std::max(h, high[f]);
+            l = std::min(l, low[f]);
+            c = close[f];
+        }
+    }
+    if (open == true && out != nullptr) {
+        out->push_back(gnu::DateKey::FromSeconds(label), h, l, c);
+    }
+    return true;
+}
+static bool _chart_resample_append(const chart::Series& in, size_t index, chart::DateRange range, bool sum, chart::Series& out) {
+    const auto LAST  = index;
+    const auto KEY   = in.key(LAST);
+    int64_t    first = 0;
+    int64_t    end   = 0;
+    int64_t    label = 0;
+    if (KEY.is_invalid() == true) {
+        return true;
+    }
+    _chart_resample_bucket(KEY.seconds(), range, 1, (range == chart::DateRange::FRIDAY) ? 4 : 6, first, end, label);
+    if (out.size() == 0) {
+        return KEY.seconds() == label;
+    }
+    const auto BACK = out.keys().back().seconds();
+    if (BACK == label && sum == true) {
+        const auto HIGH  = out.high().back() + in.high()[LAST];
+        const auto LOW   = out.low().back() + in.low()[LAST];
+        const auto CLOSE = out.close().back() + in.close()[LAST];
+        out.pop_back(1);
+        out.push_back(gnu::DateKey::FromSeconds(label), HIGH, LOW, CLOSE);
+        return true;
+    }
+    else if (BACK == label) {
+        const auto HIGH = std::max(out.high().back(), in.high()[LAST]);
+        const auto LOW  = std::min(out.low().back(), in.low()[LAST]);
+        out.pop_back(1);
+        out.push_back(gnu::DateKey::FromSeconds(label), HIGH, LOW, in.close()[LAST]);
+        return true;
+    }
+    else if (BACK < label) {
+        out.push_back(gnu::DateKey::FromSeconds(label), in.high()[LAST], in.low()[LAST], in.close()[LAST]);
+        return true;
+    }
+    return false;
+}
+static void _chart_lod_add(const chart::SeriesColumn<int64_t>& prev_index, const chart::Series& prev, size_t first, chart::SeriesColumn<int64_t>& index, chart::Series& out) {
+    const auto& high   = prev.high();
+    const auto& low    = prev.low();
+    const auto& close  = prev.close();
+    auto        bucket = static_cast<int64_t>(-1);
+    auto        key    = gnu::DateKey();
+    auto        h      = 0.0;
+    auto        l      = 0.0;
+    auto        c      = 0.0;
+    for (size_t f = first; f < prev_index.size(); f++) {
+        if (prev_index[f] < 0) {
+            continue;
+        }
+        else if ((prev_index[f] >> 1) != bucket) {
+            if (bucket >= 0) {
+                index.push_back(bucket);
+                out.push_back(key, h, l, c);
+            }
+            bucket = prev_index[f] >> 1;
+            h      = high[f];
+            l      = low[f];
+        }
+        else {
+            h = std::max(h, high[f]);
+            l = std::min(l, low[f]);
+        }
+        key = prev.key(f);
+        c   = close[f];
+    }
+    if (bucket >= 0) {
+        index.push_back(bucket);
+        out.push_back(key, h, l, c);
+    }
+}
+static void _chart_lod_mapped(const chart::Series& in, const chart::DateGenerator& dates, int level, chart::SeriesColumn<int64_t>& index, chart::Series& out) {
+    const auto& high   = in.high();
+    const auto& low    = in.low();
+    const auto& close  = in.close();
+    auto        bucket = static_cast<int64_t>(-1);
+    auto        key    = gnu::DateKey();
+    auto        h      = 0.0;
+    auto        l      = 0.0;
+    auto        c      = 0.0;
+    for (size_t f = 0; f < in.size(); f++) {
+        const auto TICK = static_cast<int64_t>(dates.index(in.key(f)));
+        if (TICK < 0 || in.check(f, f) == false) {
+            continue;
+        }
+        else if ((TICK >> level) != bucket) {
+            if (bucket >= 0) {
+                index.push_back(bucket);
+                out.push_back(key, h, l, c);
+            }
+            bucket = TICK >> level;
+            h      = high[f];
+            l      = low[f];
+        }
+        else {
+            h = std::max(h, high[f]);
+            l = std::min(l, low[f]);
+        }
+        key = in.key(f);
+        c   = close[f];
+    }
+    if (bucket >= 0) {
+        index.push_back(bucket);
+        out.push_back(key, h, l, c);
+    }
+}
+typedef std::deque<std::pair<size_t, double>> _ChartExtreme;
+static double _chart_extreme(_ChartExtreme& window, size_t index, double value, bool max, size_t days) {
+    if (max == true) {
+        while (window.size() > 0 && window.back().second <= value) {
+            window.pop_back();
+        }
+    }
+    else {
+        while (window.size() > 0 && window.back().second >= value) {
+            window.pop_back();
+        }
+    }
+    window.push_back(std::make_pair(index, value));
+    while (window.front().first + days <= index) {
+        window.pop_front();
+    }
+    return window.front().second;
+}
+static inline double _chart_true_range(double high, double low, double prev_close) {
+    return std::max(high - low, std::max(fabs(high - prev_close), fabs(low - prev_close)));
+}
+static inline void _chart_variance_add(double& mean, double& m2, size_t count, double value) {
+    auto delta = value - mean;
+    mean += delta / count;
+    m2   += delta * (value - mean);
+}
+template <typename It>
+static double _chart_variance_exact(It begin, It end, size_t count, double& mean, double& m2) {
+    double sum = 0.0;
+    for (auto it = begin; it != end; ++it) {
+        sum += *it;
+    }
+    mean = sum / count;
+    m2   = 0.0;
+    for (auto it = begin; it != end; ++it) {
+        auto tmp = *it - mean;
+        m2 += tmp * tmp;
+    }
+    return m2 / count;
+}
+static inline double _chart_variance_replace(double& mean, double& m2, size_t count, double old_val, double value) {
+    auto delta = value - old_val;
+    auto prev  = mean;
+    mean += delta / count;
+    m2   += delta * (value - mean + old_val - prev);
+    if (m2 < 0.0) {
+        m2 = 0.0;
+    }
+    return m2 / count;
+}
+template <typename Out>
+static void _chart_indicator(const chart::Series& in, chart::Algorithm formula, size_t days, Out out) {
+    if (days < 2 || days >= in.size()) {
+        return;
+    }
+    auto ind = chart::Indicator(formula, days);
+    auto res = chart::Series();
+    for (size_t f = 0; f < in.size(); f++) {
+        if (in.check(f, f) == true && ind.add(in.key(f), in.high()[f], in.low()[f], in.close()[f], res) == true) {
+            out(f, res.close()[0]);
+            res.clear();
+        }
+    }
+}
+static void _chart_update_lines(const std::vector<chart::Line*>& lines, const chart::Line* changed) {
+    std::vector<bool>               done(lines.size(), false);
+    std::vector<const chart::Line*> stack = { changed };
+    while (stack.size() > 0) {
+        auto source = stack.back();
+        stack.pop_back();
+        for (size_t f = 0; f < lines.size(); f++) {
+            if (done[f] == false && lines[f] != changed && lines[f]->update(*source) == true) {
+                done[f] = true;
+                stack.push_back(lines[f]);
+            }
+        }
+    }
+}
+class _ChartWalk {
+public:
+    const chart::DateGenerator& _dates;
+    const chart::SeriesColumn<int64_t>& _index;
+    const chart::Series&        _series;
+    int                         _level;
+    size_t                      _pos;
+    bool                        _valid;
+    _ChartWalk(const chart::Line& line, const chart::DateGenerator& dates, int start, int level = 0) :
+    _dates(dates),
+    _index(line.lod_index(level)),
+    _series(line.lod_series(level)) {
+        _level = level;
+        _pos   = 0;
+        _valid = _index.size() == _series.size();
+        if (start <= 0 || (_valid == false && level > 0)) {
+            return;
+        }
+        else if (level > 0) {
+            _pos = std::lower_bound(_index.begin(), _index.end(), static_cast<int64_t>(start)) - _index.begin();
+        }
+        else if (start < static_cast<int>(dates.size())) {
+            const auto& keys = _series.keys();
+            _pos = std::lower_bound(keys.begin(), keys.end(), dates.key(start)) - keys.begin();
+        }
+    }
+    size_t find(int date) {
+        if (_valid == false && _level > 0) {
+            return static_cast<size_t>(-1);
+        }
+        else if (_valid == false) {
+            const auto& keys = _series.keys();
+            const auto  KEY  = _dates.key(date);
+            auto        end  = _pos;
+            for (size_t step = 1; end < keys.size() && keys[end] < KEY; step *= 2) {
+                _pos = end + 1;
+                end += step;
+            }
+            end  = std::min(end, keys.size());
+            _pos = std::lower_bound(keys.begin() + _pos, keys.begin() + end, KEY) - keys.begin();
+            if (_pos < keys.size() && keys[_pos] == KEY && _series.check(_pos, _pos) == true) {
+                return _pos++;
+            }
+            return static_cast<size_t>(-1);
+        }
+        while (_pos < _index.size() && _index[_pos] < date) {
+            _pos++;
+        }
+        if (_pos < _index.size() && _index[_pos] == date) {
+            return _pos++;
+        }
+        return static_cast<size_t>(-1);
+    }
+    const chart::Series& series() const {
+        return _series;
+    }
+};
 class _ChartLineSetup : public Fl_Double_Window {
 public:
     chart::Line&                _line;
     Fl_Button*                  _close;
     Fl_Button*                  _color;
+    Fl_Choice*                  _aggregate;
     Fl_Choice*                  _align;
     Fl_Choice*                  _type;
     Fl_Hor_Slider*              _width;
@@ -4189,22 +6276,30 @@ public:
     Fl_Double_Window(0, 0, 10, 10, "Chart - Line Properties"),
     _line(line) {
         end();
-        _align  = new Fl_Choice(0, 0, 0, 0, "Align");
-        _close  = new Fl_Return_Button(0, 0, 0, 0, flw::labels::CLOSE.c_str());
-        _color  = new Fl_Button(0, 0, 0, 0, "Color");
-        _grid   = new GridGroup(0, 0, w(), h());
-        _label  = new Fl_Input(0, 0, 0, 0, "Label");
-        _type   = new Fl_Choice(0, 0, 0, 0, "Type");
-        _width  = new Fl_Hor_Slider(0, 0, 0, 0);
-        _line   = line;
-        _run    = false;
+        _aggregate = new Fl_Choice(0, 0, 0, 0, "Resample");
+        _align     = new Fl_Choice(0, 0, 0, 0, "Align");
+        _close     = new Fl_Return_Button(0, 0, 0, 0, flw::labels::CLOSE.c_str());
+        _color     = new Fl_Button(0, 0, 0, 0, "Color");
+        _grid      = new GridGroup(0, 0, w(), h());
+        _label     = new Fl_Input(0, 0, 0, 0, "Label");
+        _type      = new Fl_Choice(0, 0, 0, 0, "Type");
+        _width     = new Fl_Hor_Slider(0, 0, 0, 0);
+        _line      = line;
+        _run       = false;
         _grid->add(_label,     12,   1,  -1,  4);
         _grid->add(_type,      12,   6,  -1,  4);
         _grid->add(_align,     12,  11,  -1,  4);
         _grid->add(_color,     12,  16,  -1,  4);
         _grid->add(_width,     12,  21,  -1,  4);
+        _grid->add(_aggregate, 12,  26,  -1,  4);
         _grid->add(_close,    -17,  -5,  16,  4);
         add(_grid);
+        _aggregate->add("None");
+        _aggregate->add("High, Low And Last Close");
+        _aggregate->add("Sum");
+        _aggregate->textfont(flw::PREF_FONT);
+        _aggregate->textsize(flw::PREF_FONTSIZE);
+        _aggregate->tooltip("Resample data points to the chart date range.");
         _align->add("Left");
         _align->add("Right");
         _align->textfont(flw::PREF_FONT);
@@ -4233,7 +6328,7 @@ public:
         resizable(_grid);
         util::labelfont(this);
         callback(_ChartLineSetup::Callback, this);
-        size(30 * flw::PREF_FONTSIZE, 16 * flw::PREF_FONTSIZE);
+        size(30 * flw::PREF_FONTSIZE, 19 * flw::PREF_FONTSIZE);
         set_modal();
         util::center_window(this, parent);
         _grid->do_layout();
@@ -4280,6 +6375,7 @@ public:
         else if (_type->value() == 7) _line.set_type(chart::LineType::EXPAND_HORIZONTAL_FIRST);
         if (_align->value() == 0) _line.set_align(FL_ALIGN_LEFT);
         else                      _line.set_align(FL_ALIGN_RIGHT);
+        _line.set_aggregate(static_cast<chart::Aggregate>(_aggregate->value()));
     }
     void update_widgets() {
         _label->value(_line.label().c_str());
@@ -4295,6 +6391,7 @@ public:
         else if (_line.type() == chart::LineType::EXPAND_HORIZONTAL_FIRST) _type->value(7);
         if (_line.align() == FL_ALIGN_LEFT) _align->value(0);
         else                                _align->value(1);
+        _aggregate->value(static_cast<int>(_line.aggregate()));
     }
 };
 }
@@ -4307,6 +6404,17 @@ bool flw::chart::Area::add_line(const Line& chart_line) {
     Fl::redraw();
     return true;
 }
+bool flw::chart::Area::append(size_t index, const gnu::DateKey& key, double high, double low, double close) {
+    if (index >= _lines.size() || _lines[index].append(key, high, low, close) == false) {
+        return false;
+    }
+    std::vector<Line*> lines;
+    for (auto& line : _lines) {
+        lines.push_back(&line);
+    }
+    priv::_chart_update_lines(lines, &_lines[index]);
+    return true;
+}
 std::optional<double> flw::chart::Area::clamp_max() const {
     if (std::isfinite(_clamp_max) == true) {
         return _clamp_max;
@@ -4377,11 +6485,11 @@ flw::chart::Point::Point() {
     high = low = close = 0.0;
 }
 flw::chart::Point::Point(const std::string& date, double value) {
-    auto valid_date = gnu::Date(date.c_str());
+    auto valid_date = priv::_chart_date(date);
     if (std::isfinite(value) == true &&
         fabs(value) < chart::MAX_VALUE &&
-        valid_date.is_invalid() == false) {
-        this->date = valid_date.format(gnu::Date::Format::ISO_TIME);
+        valid_date != "") {
+        this->date = valid_date;
         this->high = this->low = this->close = value;
     }
     else {
@@ -4389,14 +6497,14 @@ flw::chart::Point::Point(const std::string& date, double value) {
     }
 }
 flw::chart::Point::Point(const std::string& date, double high, double low, double close) {
-    auto valid_date = gnu::Date(date.c_str());
+    auto valid_date = priv::_chart_date(date);
     if (std::isfinite(high) == true &&
         std::isfinite(low) == true &&
         std::isfinite(close) == true &&
         fabs(high) < chart::MAX_VALUE &&
         fabs(low) < chart::MAX_VALUE &&
         fabs(close) < chart::MAX_VALUE &&
-        valid_date.is_invalid() == false) {
+        valid_date != "") {
         if (low > high) {
             auto tmp = low;
             low = high;
@@ -4412,7 +6520,7 @@ flw::chart::Point::Point(const std::string& date, double high, double low, doubl
             low = close;
             close = tmp;
         }
-        this->date  = valid_date.format(gnu::Date::Format::ISO_TIME);
+        this->date  = valid_date;
         this->high  = high;
         this->low   = low;
         this->close = close;
@@ -4423,467 +6531,1078 @@ flw::chart::Point::Point(const std::string& date, double high, double low, doubl
 }
 flw::chart::PointVector flw::chart::Point::ATR(const PointVector& in, size_t days) {
     PointVector res;
-    if (days > 1 && days < in.size()) {
-        double tot        = 0.0;
-        double prev_close = 0.0;
-        double prev_range = 0.0;
-        size_t f          = 0;
-        days--;
-        for (const auto& data : in) {
-            if (f == 0) {
-                tot += data.high - data.low;
+    auto        series = Series(in);
+    priv::_chart_indicator(series, Algorithm::ATR, days, [&](size_t f, double value) { res.push_back(Point(in[f].date, value)); });
+    return res;
+}
+flw::chart::Series flw::chart::Point::ATR(const Series& in, size_t days) {
+    Series res;
+    priv::_chart_indicator(in, Algorithm::ATR, days, [&](size_t f, double value) { res.push_back(in.key(f), value); });
+    return res;
+}
+size_t flw::chart::Point::BinarySearch(const PointVector& in, const Point& key) {
+    auto it = std::lower_bound(in.begin(), in.end(), key);
+    if (it == in.end() || *it != key) {
+        return static_cast<size_t>(-1);
+    }
+    else {
+        return std::distance(in.begin(), it);
+    }
+}
+flw::chart::PointVector flw::chart::Point::DateSerie(const std::string& start_date, const std::string& stop_date, DateRange range, const PointVector& block) {
+    return DateGenerator(start_date, stop_date, range, block).points();
+}
+flw::chart::PointVector flw::chart::Point::DayToMonth(const PointVector& in, bool sum) {
+    return Series::Resample(Series(in), DateRange::MONTH, 1, sum).points();
+}
+flw::chart::PointVector flw::chart::Point::DayToWeek(const PointVector& in, gnu::Date::Day weekday, bool sum) {
+    auto res = Series();
+    if (weekday == gnu::Date::Day::INVALID) {
+        return PointVector();
+    }
+    priv::_chart_resample(Series(in), DateRange::SUNDAY, 1, static_cast<int>(weekday) - 1, sum, &res);
+    return res.points();
+}
+void flw::chart::Point::debug() const {
+#ifdef DEBUG
+    printf("%s, %20.8f, %20.8f, %20.8f\n", date.c_str(), high, low, close);
+#endif
+}
+void flw::chart::Point::Debug(const PointVector& in) {
+#ifdef DEBUG
+    printf("\nPointVector(%u)\n", static_cast<unsigned>(in.size()));
+    for (const auto& data : in) {
+        data.debug();
+    }
+    fflush(stdout);
+#else
+    (void) in;
+#endif
+}
+flw::chart::PointVector flw::chart::Point::ExponentialMovingAverage(const PointVector& in, size_t days) {
+    PointVector res;
+    auto        series = Series(in);
+    priv::_chart_indicator(series, Algorithm::EXP_MOVING_AVERAGE, days, [&](size_t f, double value) { res.push_back(Point(in[f].date, value)); });
+    return res;
+}
+flw::chart::Series flw::chart::Point::ExponentialMovingAverage(const Series& in, size_t days) {
+    Series res;
+    priv::_chart_indicator(in, Algorithm::EXP_MOVING_AVERAGE, days, [&](size_t f, double value) { res.push_back(in.key(f), value); });
+    return res;
+}
+flw::chart::PointVector flw::chart::Point::Fixed(const PointVector& in, double value) {
+    PointVector res;
+    for (const auto& data : in) {
+        res.push_back(Point(data.date, value));
+    }
+    return res;
+}
+flw::chart::Series flw::chart::Point::Fixed(const Series& in, double value) {
+    Series res;
+    res.reserve(in.size());
+    for (const auto& key : in.keys()) {
+        res.push_back(key, value);
+    }
+    return res;
+}
+flw::chart::PointVector flw::chart::Point::LoadCSV(const std::string& filename, const std::string& sep) {
+    return Series::LoadCSV(filename, sep).points();
+}
+flw::chart::PointVector flw::chart::Point::Modify(const PointVector& in, Modifier modify, double value) {
+    PointVector res;
+    if (fabs(value) < chart::MIN_VALUE) {
+        return res;
+    }
+    for (const auto& data : in) {
+        switch (modify) {
+            case Modifier::ADDITION:
+                res.push_back(Point(data.date, data.high + value, data.low + value, data.close + value));
+                break;
+            case Modifier::SUBTRACTION:
+                res.push_back(Point(data.date, data.high - value, data.low - value, data.close - value));
+                break;
+            case Modifier::MULTIPLICATION:
+                res.push_back(Point(data.date, data.high * value, data.low * value, data.close * value));
+                break;
+            case Modifier::DIVISION:
+                res.push_back(Point(data.date, data.high / value, data.low / value, data.close / value));
+                break;
+        }
+    }
+    return res;
+}
+flw::chart::Series flw::chart::Point::Modify(const Series& in, Modifier modify, double value) {
+    Series res;
+    if (fabs(value) < chart::MIN_VALUE) {
+        return res;
+    }
+    res.reserve(in.size());
+    for (size_t f = 0; f < in.size(); f++) {
+        auto high  = in.high()[f];
+        auto low   = in.low()[f];
+        auto close = in.close()[f];
+        switch (modify) {
+            case Modifier::ADDITION:
+                res.push_back(in.key(f), high + value, low + value, close + value);
+                break;
+            case Modifier::SUBTRACTION:
+                res.push_back(in.key(f), high - value, low - value, close - value);
+                break;
+            case Modifier::MULTIPLICATION:
+                res.push_back(in.key(f), high * value, low * value, close * value);
+                break;
+            case Modifier::DIVISION:
+                res.push_back(in.key(f), high / value, low / value, close / value);
+                break;
+        }
+    }
+    return res;
+}
+flw::chart::PointVector flw::chart::Point::Momentum(const PointVector& in, size_t days) {
+    PointVector res;
+    auto        series = Series(in);
+    priv::_chart_indicator(series, Algorithm::MOMENTUM, days, [&](size_t f, double value) { res.push_back(Point(in[f].date, value)); });
+    return res;
+}
+flw::chart::Series flw::chart::Point::Momentum(const Series& in, size_t days) {
+    Series res;
+    priv::_chart_indicator(in, Algorithm::MOMENTUM, days, [&](size_t f, double value) { res.push_back(in.key(f), value); });
+    return res;
+}
+flw::chart::PointVector flw::chart::Point::MovingAverage(const PointVector& in, size_t days) {
+    PointVector res;
+    auto        series = Series(in);
+    priv::_chart_indicator(series, Algorithm::MOVING_AVERAGE, days, [&](size_t f, double value) { res.push_back(Point(in[f].date, value)); });
+    return res;
+}
+flw::chart::Series flw::chart::Point::MovingAverage(const Series& in, size_t days) {
+    Series res;
+    priv::_chart_indicator(in, Algorithm::MOVING_AVERAGE, days, [&](size_t f, double value) { res.push_back(in.key(f), value); });
+    return res;
+}
+std::string flw::chart::Point::RangeToString(DateRange range) {
+    static const std::string NAMES[] = { "DAY", "WEEKDAY", "FRIDAY", "SUNDAY", "MONTH", "HOUR", "MIN", "SEC", "", };
+    return NAMES[static_cast<unsigned>(range)];
+}
+flw::chart::PointVector flw::chart::Point::RSI(const PointVector& in, size_t days) {
+    PointVector res;
+    auto        series = Series(in);
+    priv::_chart_indicator(series, Algorithm::RSI, days, [&](size_t f, double value) { res.push_back(Point(in[f].date, value)); });
+    return res;
+}
+flw::chart::Series flw::chart::Point::RSI(const Series& in, size_t days) {
+    Series res;
+    priv::_chart_indicator(in, Algorithm::RSI, days, [&](size_t f, double value) { res.push_back(in.key(f), value); });
+    return res;
+}
+bool flw::chart::Point::SaveCSV(const PointVector& in, const std::string& filename, const std::string& sep) {
+    std::string csv;
+    csv.reserve(in.size() * 40 + 256);
+    for (const auto& data : in) {
+        char buffer[2'000];
+        snprintf(buffer, 2'000, "%s%s%s%s%s%s%s\n", data.date.c_str(), sep.c_str(), gnu::json::format_number(data.high).c_str(), sep.c_str(), gnu::json::format_number(data.low).c_str(), sep.c_str(), gnu::json::format_number(data.close).c_str());
+        csv += buffer;
+    }
+    return gnu::file::write(filename, csv.c_str(), csv.size());
+}
+flw::chart::PointVector flw::chart::Point::StdDev(const PointVector& in, size_t days) {
+    PointVector res;
+    auto        series = Series(in);
+    priv::_chart_indicator(series, Algorithm::STD_DEV, days, [&](size_t f, double value) { res.push_back(Point(in[f].date, value)); });
+    return res;
+}
+flw::chart::Series flw::chart::Point::StdDev(const Series& in, size_t days) {
+    Series res;
+    priv::_chart_indicator(in, Algorithm::STD_DEV, days, [&](size_t f, double value) { res.push_back(in.key(f), value); });
+    return res;
+}
+flw::chart::PointVector flw::chart::Point::Stochastics(const PointVector& in, size_t days) {
+    PointVector res;
+    auto        series = Series(in);
+    priv::_chart_indicator(series, Algorithm::STOCHASTICS, days, [&](size_t f, double value) { res.push_back(Point(in[f].date, value)); });
+    return res;
+}
+flw::chart::Series flw::chart::Point::Stochastics(const Series& in, size_t days) {
+    Series res;
+    priv::_chart_indicator(in, Algorithm::STOCHASTICS, days, [&](size_t f, double value) { res.push_back(in.key(f), value); });
+    return res;
+}
+flw::chart::DateRange flw::chart::Point::StringToRange(const std::string& range) {
+    if (range == "WEEKDAY")     return DateRange::WEEKDAY;
+    else if (range == "FRIDAY") return DateRange::FRIDAY;
+    else if (range == "SUNDAY") return DateRange::SUNDAY;
+    else if (range == "MONTH")  return DateRange::MONTH;
+    else if (range == "HOUR")   return DateRange::HOUR;
+    else if (range == "MIN")    return DateRange::MIN;
+    else if (range == "SEC")    return DateRange::SEC;
+    else                        return DateRange::DAY;
+}
+namespace flw {
+namespace chart {
+class SeriesPages {
+public:
+    typedef std::pair<size_t, size_t> Range;
+    SeriesPages(const std::string& filename, size_t budget) : _file(filename) {
+        _budget = budget;
+        _cold   = true;
+        _used   = 0;
+    }
+    const gnu::file::MMap& file() const {
+        return _file;
+    }
+    size_t offset(const void* data) const {
+        return static_cast<size_t>(static_cast<const char*>(data) - _file.data());
+    }
+    void use(const std::vector<Range>& ranges) {
+        for (auto it = _lru.begin(); it != _lru.end(); ++it) {
+            if (_contains(*it, ranges) == true) {
+                auto used = *it;
+                _lru.erase(it);
+                _lru.push_back(used);
+                return;
             }
-            else {
-                double t1 = data.high - data.low;
-                double t2 = fabs(data.high - prev_close);
-                double t3 = fabs(data.low - prev_close);
-                double ra = 0.0;
-                if (t1 > t2 && t1 > t3) {
-                    ra = t1;
-                }
-                else if (t2 > t1 && t2 > t3) {
-                    ra = t2;
-                }
-                else {
-                    ra = t3;
-                }
-                tot += ra;
-                if (f == days) {
-                    prev_range = tot / (days + 1);
-                    res.push_back(Point(data.date, prev_range));
-                }
-                else if (f > days) {
-                    prev_range = ((prev_range * days) + ra) / (days + 1);
-                    res.push_back(Point(data.date, prev_range));
+        }
+        for (const auto& range : ranges) {
+            _file.advise(range.first, range.second, true);
+            _used += range.second;
+        }
+        auto drop = _cold;
+        _lru.push_back(ranges);
+        _cold = false;
+        while (_used > _budget && _lru.size() > 1) {
+            for (const auto& range : _lru.front()) {
+                _used -= range.second;
+            }
+            _lru.pop_front();
+            drop = true;
+        }
+        if (drop == true) {
+            _drop();
+        }
+    }
+private:
+    static bool _contains(const std::vector<Range>& outer, const std::vector<Range>& inner) {
+        for (const auto& i : inner) {
+            auto found = false;
+            for (const auto& o : outer) {
+                if (i.first >= o.first && i.first + i.second <= o.first + o.second) {
+                    found = true;
+                    break;
                 }
             }
-            prev_close = data.close;
-            f++;
+            if (found == false) {
+                return false;
+            }
+        }
+        return true;
+    }
+    void _drop() const {
+        std::vector<Range> keep;
+        size_t             pos = 0;
+        for (const auto& ranges : _lru) {
+            keep.insert(keep.end(), ranges.begin(), ranges.end());
+        }
+        std::sort(keep.begin(), keep.end());
+        for (const auto& range : keep) {
+            if (range.first > pos) {
+                _file.advise(pos, range.first - pos, false);
+            }
+            pos = std::max(pos, range.first + range.second);
+        }
+        if (pos < _file.size()) {
+            _file.advise(pos, _file.size() - pos, false);
+        }
+    }
+    gnu::file::MMap             _file;
+    std::deque<std::vector<Range>> _lru;
+    bool                        _cold;
+    size_t                      _budget;
+    size_t                      _used;
+};
+}
+}
+flw::chart::Series::Series(const PointVector& in) {
+    reserve(in.size());
+    for (const auto& point : in) {
+        push_back(priv::_CHART_DATE_PARSER.parse(point.date), point.high, point.low, point.close);
+    }
+}
+flw::chart::Series flw::chart::Series::LoadCSV(const std::string& filename, const std::string& sep) {
+    gnu::file::CSVReader reader(sep);
+    gnu::DateParser      parser;
+    priv::_ChartCSV      csv;
+    Series               res;
+    size_t               size = 0;
+    if (reader.open(filename) == false || reader.size() < 10) {
+        return res;
+    }
+    parser.parse(reader.column(0, 10));
+    csv.parser = &parser;
+    csv.series.resize(reader.split());
+    for (auto& series : csv.series) {
+        series.reserve(reader.size() / 20 / csv.series.size());
+    }
+    reader.parse(priv::_chart_csv_row, &csv);
+    for (const auto& series : csv.series) {
+        size += series.size();
+    }
+    res.reserve(size);
+    for (const auto& series : csv.series) {
+        res._key.vec().insert(res._key.vec().end(), series._key.begin(), series._key.end());
+        res._high.vec().insert(res._high.vec().end(), series._high.begin(), series._high.end());
+        res._low.vec().insert(res._low.vec().end(), series._low.begin(), series._low.end());
+        res._close.vec().insert(res._close.vec().end(), series._close.begin(), series._close.end());
+    }
+    return res;
+}
+flw::chart::Series flw::chart::Series::Resample(const Series& in, DateRange range, unsigned count, bool sum) {
+    auto res = Series();
+    priv::_chart_resample(in, range, count, (range == DateRange::FRIDAY) ? 4 : 6, sum, &res);
+    return res;
+}
+bool flw::chart::Series::assign(const int64_t* keys, const double* high, const double* low, const double* close, size_t size, std::shared_ptr<SeriesPages> pages) {
+    static_assert(sizeof(gnu::DateKey) == sizeof(int64_t), "DateKey must be a 64 bit integer");
+    clear();
+    if (pages != nullptr) {
+        _key.map(reinterpret_cast<const gnu::DateKey*>(keys), size);
+        _high.map(high, size);
+        _low.map(low, size);
+        _close.map(close, size);
+        _checked.assign((size + chart::SERIES_BLOCK - 1) / chart::SERIES_BLOCK, 0);
+        _pages = pages;
+        return true;
+    }
+    else if (priv::_chart_series_check(keys, high, low, close, 0, size, gnu::DateKey::INVALID) == false) {
+        return false;
+    }
+    auto& key = _key.vec();
+    key.resize(size);
+    _high.vec().assign(high, high + size);
+    _low.vec().assign(low, low + size);
+    _close.vec().assign(close, close + size);
+    for (size_t f = 0; f < size; f++) {
+        key[f] = gnu::DateKey::FromSeconds(keys[f]);
+    }
+    return true;
+}
+bool flw::chart::Series::check(size_t first, size_t last) const {
+    if (_checked.size() == 0 || first > last || first >= size()) {
+        return true;
+    }
+    const auto* keys = reinterpret_cast<const int64_t*>(_key.data());
+    auto        res  = true;
+    last = std::min(last, size() - 1);
+    for (auto block = first / chart::SERIES_BLOCK; block <= last / chart::SERIES_BLOCK; block++) {
+        if (_checked[block] == 0) {
+            const auto START = block * chart::SERIES_BLOCK;
+            const auto END   = std::min(size(), START + chart::SERIES_BLOCK);
+            auto       prev  = gnu::DateKey::INVALID;
+            for (auto f = START; f > START - std::min(START, chart::SERIES_BLOCK) && prev == gnu::DateKey::INVALID; f--) {
+                prev = keys[f - 1];
+            }
+            _checked[block] = (priv::_chart_series_check(keys, _high.data(), _low.data(), _close.data(), START, END, prev) == true) ? 1 : 2;
+        }
+        if (_checked[block] != 1) {
+            res = false;
+        }
+    }
+    return res;
+}
+void flw::chart::Series::clear() {
+    _key.clear();
+    _high.clear();
+    _low.clear();
+    _close.clear();
+    _pages.reset();
+    _checked.clear();
+}
+std::string flw::chart::Series::date(size_t index) const {
+    return priv::_chart_key_date(_key[index]);
+}
+gnu::DateKey flw::chart::Series::first_key() const {
+    for (size_t f = 0; f < _key.size(); f++) {
+        if (_key[f].is_invalid() == false && check(f, f) == true) {
+            return _key[f];
+        }
+    }
+    return gnu::DateKey();
+}
+size_t flw::chart::Series::find(const gnu::DateKey& key) const {
+    auto it = std::lower_bound(_key.begin(), _key.end(), key);
+    if (it == _key.end() || *it != key) {
+        return static_cast<size_t>(-1);
+    }
+    else {
+        return std::distance(_key.begin(), it);
+    }
+}
+void flw::chart::Series::_own() {
+    if (_pages != nullptr) {
+        const auto SIZE = size();
+        check(0, SIZE);
+        _key.vec();
+        _high.vec();
+        _low.vec();
+        _close.vec();
+        for (size_t f = 0; f < SIZE; f++) {
+            if (_checked[f / chart::SERIES_BLOCK] != 1) {
+                _key.set(f, gnu::DateKey());
+                _high.set(f, 0.0);
+                _low.set(f, 0.0);
+                _close.set(f, 0.0);
+            }
         }
+        _checked.clear();
+        _pages.reset();
+    }
+}
+gnu::DateKey flw::chart::Series::last_key() const {
+    for (auto f = _key.size(); f > 0; f--) {
+        if (_key[f - 1].is_invalid() == false && check(f - 1, f - 1) == true) {
+            return _key[f - 1];
+        }
+    }
+    return gnu::DateKey();
+}
+flw::chart::Point flw::chart::Series::point(size_t index) const {
+    auto res = Point();
+    res.date  = date(index);
+    res.high  = _high[index];
+    res.low   = _low[index];
+    res.close = _close[index];
+    return res;
+}
+flw::chart::PointVector flw::chart::Series::points() const {
+    PointVector res;
+    res.reserve(size());
+    for (size_t f = 0; f < size(); f++) {
+        res.push_back(point(f));
     }
     return res;
 }
-size_t flw::chart::Point::BinarySearch(const PointVector& in, const Point& key) {
-    auto it = std::lower_bound(in.begin(), in.end(), key);
-    if (it == in.end() || *it != key) {
-        return static_cast<size_t>(-1);
+void flw::chart::Series::pop_back(size_t count) {
+    _own();
+    _key.pop_back(count);
+    _high.pop_back(count);
+    _low.pop_back(count);
+    _close.pop_back(count);
+}
+void flw::chart::Series::pop_front(size_t count) {
+    _own();
+    _key.pop_front(count);
+    _high.pop_front(count);
+    _low.pop_front(count);
+    _close.pop_front(count);
+}
+void flw::chart::Series::prefetch(size_t first, size_t last) const {
+    if (_pages == nullptr || size() == 0 || first > last || first >= size()) {
+        return;
+    }
+    last = std::min(last, size() - 1);
+    const auto MARGIN = last - first + 1;
+    const auto START  = (first > MARGIN) ? first - MARGIN : 0;
+    const auto STOP   = std::min(size(), last + MARGIN + 1);
+    const auto COUNT  = STOP - START;
+    _pages->use({
+        SeriesPages::Range(_pages->offset(_key.data() + START), COUNT * sizeof(gnu::DateKey)),
+        SeriesPages::Range(_pages->offset(_high.data() + START), COUNT * sizeof(double)),
+        SeriesPages::Range(_pages->offset(_low.data() + START), COUNT * sizeof(double)),
+        SeriesPages::Range(_pages->offset(_close.data() + START), COUNT * sizeof(double)),
+    });
+}
+void flw::chart::Series::push_back(const gnu::DateKey& key, double high, double low, double close) {
+    _own();
+    if (std::isfinite(high) == true &&
+        std::isfinite(low) == true &&
+        std::isfinite(close) == true &&
+        fabs(high) < chart::MAX_VALUE &&
+        fabs(low) < chart::MAX_VALUE &&
+        fabs(close) < chart::MAX_VALUE &&
+        key.is_invalid() == false) {
+        if (low > high) {
+            std::swap(low, high);
+        }
+        if (close > high) {
+            std::swap(close, high);
+        }
+        if (close < low) {
+            std::swap(close, low);
+        }
+        _key.push_back(key);
+        _high.push_back(high);
+        _low.push_back(low);
+        _close.push_back(close);
     }
     else {
-        return std::distance(in.begin(), it);
+        _key.push_back(gnu::DateKey());
+        _high.push_back(0.0);
+        _low.push_back(0.0);
+        _close.push_back(0.0);
+    }
+}
+void flw::chart::Series::reserve(size_t size) {
+    _own();
+    _key.vec().reserve(size);
+    _high.vec().reserve(size);
+    _low.vec().reserve(size);
+    _close.vec().reserve(size);
+}
+bool flw::chart::Series::set(size_t index, double high, double low, double close) {
+    if (index >= size() ||
+        priv::_chart_is_value(high) == false ||
+        priv::_chart_is_value(low) == false ||
+        priv::_chart_is_value(close) == false) {
+        return false;
     }
+    if (low > high) {
+        std::swap(low, high);
+    }
+    if (close > high) {
+        std::swap(close, high);
+    }
+    if (close < low) {
+        std::swap(close, low);
+    }
+    _own();
+    _high.set(index, high);
+    _low.set(index, low);
+    _close.set(index, close);
+    return true;
 }
-flw::chart::PointVector flw::chart::Point::DateSerie(const std::string& start_date, const std::string& stop_date, DateRange range, const PointVector& block) {
-    auto       month   = -1;
-    auto       current = gnu::Date(start_date.c_str());
-    auto const stop    = gnu::Date(stop_date.c_str());
-    auto       res     = PointVector();
-    if (range == DateRange::FRIDAY) {
-        while (current.weekday() != gnu::Date::Day::FRIDAY)
-            current.add_days(1);
+flw::chart::Indicator::Indicator(Algorithm formula, size_t days, double value, Modifier modify) {
+    _formula = formula;
+    _days    = days;
+    _value   = value;
+    _modify  = modify;
+    reset();
+}
+bool flw::chart::Indicator::add(const gnu::DateKey& key, double high, double low, double close, Series& out) {
+    const auto f    = _count++;
+    const auto days = _days;
+    auto       res  = false;
+    if (is_valid() == false) {
+        return false;
     }
-    else if (range == DateRange::SUNDAY) {
-        while (current.weekday() != gnu::Date::Day::SUNDAY) {
-            current.add_days(1);
-        }
+    else if (_formula == Algorithm::FIXED) {
+        out.push_back(key, _value);
+        return true;
     }
-    while (current <= stop) {
-        gnu::Date date(1, 1, 1);
-        if (range == DateRange::DAY) {
-            date = gnu::Date(current);
-            current.add_days(1);
+    else if (_formula == Algorithm::MODIFY) {
+        if (fabs(_value) < chart::MIN_VALUE) {
+            return false;
         }
-        else if (range == DateRange::WEEKDAY) {
-            gnu::Date::Day weekday = current.weekday();
-            if (weekday >= gnu::Date::Day::MONDAY && weekday <= gnu::Date::Day::FRIDAY) {
-                date = gnu::Date(current);
-            }
-            current.add_days(1);
+        switch (_modify) {
+            case Modifier::ADDITION:
+                out.push_back(key, high + _value, low + _value, close + _value);
+                break;
+            case Modifier::SUBTRACTION:
+                out.push_back(key, high - _value, low - _value, close - _value);
+                break;
+            case Modifier::MULTIPLICATION:
+                out.push_back(key, high * _value, low * _value, close * _value);
+                break;
+            case Modifier::DIVISION:
+                out.push_back(key, high / _value, low / _value, close / _value);
+                break;
         }
-        else if (range == DateRange::FRIDAY || range == DateRange::SUNDAY) {
-            date = gnu::Date(current);
-            current.add_days(7);
+        return true;
+    }
+    else if (days < 2) {
+        return false;
+    }
+    else if (_formula == Algorithm::ATR) {
+        if (f == 0) {
+            _sum = high - low;
         }
-        else if (range == DateRange::MONTH) {
-            if (current.month() != month) {
-                current.set_day_to_last_in_month();
-                date = gnu::Date(current);
-                month = current.month();
+        else {
+            double ra = priv::_chart_true_range(high, low, _prev_close);
+            if (f < days - 1) {
+                _sum += ra;
+            }
+            else if (f == days - 1) {
+                _prev = (_sum + ra) / days;
+                res   = true;
+            }
+            else {
+                _prev = ((_prev * (days - 1)) + ra) / days;
+                res   = true;
             }
-            current.add_months(1);
         }
-        else if (range == DateRange::HOUR) {
-            date = gnu::Date(current);
-            current.add_seconds(3600);
+    }
+    else if (_formula == Algorithm::EXP_MOVING_AVERAGE) {
+        if (f < (days - 1)) {
+            _sum += close;
         }
-        else if (range == DateRange::MIN) {
-            date = gnu::Date(current);
-            current.add_seconds(60);
+        else if (f == (days - 1)) {
+            _sum  += close;
+            _prev  = _sum / days;
+            res    = true;
         }
-        else if (range == DateRange::SEC) {
-            date = gnu::Date(current);
-            current.add_seconds(1);
+        else {
+            _prev = ((close - _prev) * (2.0 / static_cast<double>(days + 1.0))) + _prev;
+            res   = true;
         }
-        if (date.year() > 1) {
-            Point price(date.format(gnu::Date::Format::ISO_TIME_LONG));
-            if (block.size() == 0 || std::binary_search(block.begin(), block.end(), price) == false) {
-                res.push_back(price);
-            }
+    }
+    else if (_formula == Algorithm::MOMENTUM) {
+        _win_close.push_back(close);
+        if (_win_close.size() > days) {
+            _win_close.pop_front();
+        }
+        if (_win_close.size() == days) {
+            _prev = close - _win_close.front();
+            res   = true;
         }
     }
-    return res;
-}
-flw::chart::PointVector flw::chart::Point::DayToMonth(const PointVector& in, bool sum) {
-    size_t          f = 0;
-    PointVector res;
-    Point       current;
-    gnu::Date       stop;
-    gnu::Date       pdate;
-    for (const auto& data : in) {
-        if (f == 0) {
-            current = data;
-            stop = gnu::Date(current.date.c_str());
-            stop.set_day_to_last_in_month();
+    else if (_formula == Algorithm::MOVING_AVERAGE) {
+        if (_win_close.size() == days) {
+            _sum -= _win_close.front();
+            _win_close.pop_front();
         }
-        else {
-            pdate = gnu::Date(data.date.c_str());
-            if (stop < pdate) {
-                current.date = stop.format(gnu::Date::Format::ISO_TIME);
-                res.push_back(current);
-                current = data;
-                stop = gnu::Date(current.date.c_str());
-                stop.set_day_to_last_in_month();
-            }
-            else if (sum == true) {
-                current.high  += data.high;
-                current.low   += data.low;
-                current.close += data.close;
-            }
-            else {
-                if (data.high > current.high) {
-                    current.high = data.high;
+        _sum += close;
+        _win_close.push_back(close);
+        if (_win_close.size() == days) {
+            _prev = _sum / days;
+            res   = true;
+        }
+    }
+    else if (_formula == Algorithm::RSI) {
+        if (f > 0) {
+            double diff = close - _prev_close;
+            if (f <= days) {
+                if (diff > 0) {
+                    _gain += diff;
                 }
-                if (data.low < current.low) {
-                    current.low = data.low;
+                else {
+                    _loss += fabs(diff);
                 }
-                current.close  = data.close;
+            }
+            if (f == days) {
+                _gain = _gain / days;
+                _loss = _loss / days;
+                _prev = 100 - (100 / (1 + (_gain / _loss)));
+                res   = true;
+            }
+            else if (f > days) {
+                _gain = ((_gain * (days - 1)) + ((diff > 0) ? fabs(diff) : 0)) / days;
+                _loss = ((_loss * (days - 1)) + ((diff < 0) ? fabs(diff) : 0)) / days;
+                _prev = 100 - (100 / (1 + (_gain / _loss)));
+                res   = true;
             }
         }
-        if (f + 1 == in.size()) {
-            auto s = stop.format(gnu::Date::Format::ISO_TIME);
-            stop.set_day_to_last_in_month();
-            current.date = s;
-            res.push_back(current);
-        }
-        f++;
     }
-    return res;
-}
-flw::chart::PointVector flw::chart::Point::DayToWeek(const PointVector& in, gnu::Date::Day weekday, bool sum) {
-    size_t          f = 0;
-    PointVector res;
-    Point       current;
-    gnu::Date       stop;
-    gnu::Date       pdate;
-    for (const auto& data : in) {
-        if (f == 0) {
-            stop = gnu::Date(data.date.c_str());
-            if (weekday > stop.weekday()) {
-                stop.set_weekday(weekday);
+    else if (_formula == Algorithm::STD_DEV) {
+        if (_win_close.size() < days) {
+            _win_close.push_back(close);
+            priv::_chart_variance_add(_sum, _m2, _win_close.size(), close);
+            if (_win_close.size() == days) {
+                _prev = sqrt(_m2 / days);
+                res   = true;
             }
-            else if (weekday < stop.weekday()) {
-                stop.set_weekday(weekday);
-                stop.add_days(7);
-            }
-            current = data;
         }
         else {
-            pdate = gnu::Date(data.date.c_str());
-            if (stop < pdate) {
-                current.date = stop.format(gnu::Date::Format::ISO_TIME);
-                res.push_back(current);
-                current = data;
-            }
-            else if (sum == true) {
-                current.high  += data.high;
-                current.low   += data.low;
-                current.close += data.close;
+            auto old_val = _win_close.front();
+            _win_close.pop_front();
+            _win_close.push_back(close);
+            if ((f + 1) % days == 0) {
+                _prev = sqrt(priv::_chart_variance_exact(_win_close.begin(), _win_close.end(), days, _sum, _m2));
             }
             else {
-                if (data.high > current.high) {
-                    current.high = data.high;
-                }
-                if (data.low < current.low) {
-                    current.low = data.low;
-                }
-                current.close  = data.close;
+                _prev = sqrt(priv::_chart_variance_replace(_sum, _m2, days, old_val, close));
             }
-            while (stop < pdate) {
-                stop.add_days(7);
-            }
-            current.date = stop.format(gnu::Date::Format::ISO_TIME);
+            res = true;
         }
-        if (f + 1 == in.size()) {
-            current.date = stop.format(gnu::Date::Format::ISO_TIME);
-            res.push_back(current);
+    }
+    else if (_formula == Algorithm::STOCHASTICS) {
+        auto max = priv::_chart_extreme(_win_high, f, high, true, days);
+        auto min = priv::_chart_extreme(_win_low, f, low, false, days);
+        if (f + 1 >= days && max - min > chart::MIN_VALUE) {
+            _prev = 100.0 * ((close - min) / (max - min));
+            res   = true;
         }
-        f++;
     }
-    return res;
-}
-void flw::chart::Point::debug() const {
-#ifdef DEBUG
-    printf("%s, %20.8f, %20.8f, %20.8f\n", date.c_str(), high, low, close);
-#endif
-}
-void flw::chart::Point::Debug(const PointVector& in) {
-#ifdef DEBUG
-    printf("\nPointVector(%u)\n", static_cast<unsigned>(in.size()));
-    for (const auto& data : in) {
-        data.debug();
+    _prev_close = close;
+    if (res == true) {
+        out.push_back(key, _prev);
     }
-    fflush(stdout);
-#else
-    (void) in;
-#endif
+    return res;
 }
-flw::chart::PointVector flw::chart::Point::ExponentialMovingAverage(const PointVector& in, size_t days) {
-    PointVector res;
-    if (days > 1 && days < in.size()) {
-        double sma   = 0.0;
-        double prev  = 0.0;
-        double multi = 2.0 / static_cast<double>(days + 1.0);
-        size_t f     = 0;
-        for (const auto& data : in) {
-            if (f < (days - 1)) {
-                sma += data.close;
-            }
-            else if (f == (days - 1)) {
-                sma += data.close;
-                prev = sma / days;
-                res.push_back(Point(data.date, prev));
-            }
-            else {
-                prev = ((data.close - prev) * multi) + prev;
-                res.push_back(Point(data.date, prev));
-            }
-            f++;
+bool flw::chart::Indicator::is_valid() const {
+    return _formula != Algorithm::DAY_TO_WEEK && _formula != Algorithm::DAY_TO_MONTH;
+}
+void flw::chart::Indicator::reset() {
+    _count      = 0;
+    _sum        = 0.0;
+    _prev       = 0.0;
+    _prev_close = 0.0;
+    _gain       = 0.0;
+    _loss       = 0.0;
+    _m2         = 0.0;
+    _win_close.clear();
+    _win_high.clear();
+    _win_low.clear();
+}
+flw::chart::Series flw::chart::Indicator::run(const Series& in) {
+    Series res;
+    reset();
+    for (size_t f = 0; f < in.size(); f++) {
+        if (in.check(f, f) == true) {
+            add(in.key(f), in.high()[f], in.low()[f], in.close()[f], res);
         }
     }
     return res;
 }
-flw::chart::PointVector flw::chart::Point::Fixed(const PointVector& in, double value) {
-    PointVector res;
-    for (const auto& data : in) {
-        res.push_back(Point(data.date, value));
-    }
-    return res;
+flw::chart::DateGenerator::DateGenerator() {
+    clear();
 }
-flw::chart::PointVector flw::chart::Point::LoadCSV(const std::string& filename, const std::string& sep) {
-    auto buf = gnu::file::read(filename);
-    if (buf.size() < 10) {
-        return PointVector();
+flw::chart::DateGenerator::DateGenerator(const std::string& start_date, const std::string& stop_date, DateRange range, const PointVector& block) {
+    clear();
+    const auto START = gnu::Date(start_date);
+    const auto STOP  = gnu::Date(stop_date);
+    const auto KEY1  = START.key();
+    const auto KEY2  = STOP.key();
+    _range = range;
+    if (KEY1.is_invalid() == true || KEY2.is_invalid() == true || KEY1 > KEY2) {
+        return;
+    }
+    if (range == DateRange::WEEKDAY) {
+        const auto DAYS1 = KEY1.days();
+        const auto DAYS2 = KEY2.days();
+        _time     = KEY1.seconds() - DAYS1 * gnu::Date::SECS_PER_DAY;
+        _first    = priv::_chart_weekdays(DAYS1);
+        _raw_size = priv::_chart_weekdays((KEY2.seconds() - DAYS2 * gnu::Date::SECS_PER_DAY >= _time) ? DAYS2 + 1 : DAYS2) - _first;
+    }
+    else if (range == DateRange::MONTH) {
+        _time     = KEY1.seconds() - KEY1.days() * gnu::Date::SECS_PER_DAY;
+        _first    = START.year() * 12 + START.month() - 1;
+        _raw_size = (STOP.year() * 12 + STOP.month() - 1) - _first;
+        if (_raw_size > 0) {
+            auto prev = gnu::Date(STOP.year(), STOP.month(), 1);
+            prev.add_months(-1);
+            auto check = gnu::Date(STOP.year(), STOP.month(), std::min(prev.days_in_month(), STOP.days_in_month()), START.hour(), START.minute(), START.second());
+            _raw_size += (check <= STOP) ? 1 : 0;
+        }
+        else {
+            _raw_size = 1;
+        }
     }
-    std::string  str   = buf.c_str();
-    StringVector lines = util::split_string(str, "\n");
-    PointVector  res;
-    for (const auto& l : lines) {
-        StringVector line = util::split_string(l, sep);
-        Point    data;
-        if (line.size() == 2) {
-            data = Point(line[0], util::to_double(line[1]));
+    else {
+        int64_t step = gnu::Date::SECS_PER_DAY;
+        _first = KEY1.seconds();
+        if (range == DateRange::FRIDAY || range == DateRange::SUNDAY) {
+            const auto DAY = (range == DateRange::FRIDAY) ? 4 : 6;
+            const auto WD  = (KEY1.days() + 3) - priv::_chart_floor_div(KEY1.days() + 3, 7) * 7;
+            _first += ((DAY - WD + 7) % 7) * gnu::Date::SECS_PER_DAY;
+            step    = gnu::Date::SECS_PER_WEEK;
+        }
+        else if (range == DateRange::HOUR) {
+            step = gnu::Date::SECS_PER_HOUR;
         }
-        else if (line.size() > 3) {
-            data = Point(line[0], util::to_double(line[1]), util::to_double(line[2]), util::to_double(line[3]));
+        else if (range == DateRange::MIN) {
+            step = 60;
         }
-        if (data.date != "") {
-            res.push_back(data);
+        else if (range == DateRange::SEC) {
+            step = 1;
         }
+        _time     = step;
+        _raw_size = (_first <= KEY2.seconds()) ? (KEY2.seconds() - _first) / step + 1 : 0;
     }
-    return res;
+    if (_raw_size < 0) {
+        _raw_size = 0;
+    }
+    for (const auto& b : block) {
+        auto raw = _raw_index(priv::_CHART_DATE_PARSER.parse(b.date));
+        if (raw >= 0) {
+            _block.push_back(raw);
+        }
+    }
+    std::sort(_block.begin(), _block.end());
+    _block.erase(std::unique(_block.begin(), _block.end()), _block.end());
+    for (size_t f = 0; f < _block.size(); f++) {
+        _shift.push_back(_block[f] - static_cast<int64_t>(f));
+    }
+    _size = static_cast<size_t>(_raw_size) - _block.size();
 }
-flw::chart::PointVector flw::chart::Point::Modify(const PointVector& in, Modifier modify, double value) {
-    PointVector res;
-    if (fabs(value) < chart::MIN_VALUE) {
-        return res;
+void flw::chart::DateGenerator::clear() {
+    _range    = DateRange::DAY;
+    _first    = 0;
+    _raw_size = 0;
+    _time     = 0;
+    _size     = 0;
+    _block.clear();
+    _shift.clear();
+}
+std::string flw::chart::DateGenerator::date(size_t index) const {
+    auto key = this->key(index);
+    char buffer[40];
+    if (key.is_invalid() == true) {
+        return "";
     }
-    for (const auto& data : in) {
-        switch (modify) {
-            case Modifier::ADDITION:
-                res.push_back(Point(data.date, data.high + value, data.low + value, data.close + value));
-                break;
-            case Modifier::SUBTRACTION:
-                res.push_back(Point(data.date, data.high - value, data.low - value, data.close - value));
-                break;
-            case Modifier::MULTIPLICATION:
-                res.push_back(Point(data.date, data.high * value, data.low * value, data.close * value));
-                break;
-            case Modifier::DIVISION:
-                res.push_back(Point(data.date, data.high / value, data.low / value, data.close / value));
-                break;
+    key.to_date().format_to(buffer, 40, gnu::Date::Format::ISO_TIME);
+    return buffer;
+}
+bool flw::chart::DateGenerator::extend(const gnu::DateKey& last, const PointVector& block) {
+    if (_raw_size == 0 || last.is_invalid() == true || last <= _raw_key(_raw_size - 1)) {
+        return false;
+    }
+    const auto tmp = DateGenerator(priv::_chart_key_date(_raw_key(0)), priv::_chart_key_date(last), _range);
+    if (tmp._first != _first || tmp._time != _time || tmp._raw_size <= _raw_size) {
+        return false;
+    }
+    const auto OLD   = _raw_size;
+    auto       added = std::vector<int64_t>();
+    _raw_size = tmp._raw_size;
+    for (const auto& b : block) {
+        auto raw = _raw_index(priv::_CHART_DATE_PARSER.parse(b.date));
+        if (raw >= OLD) {
+            added.push_back(raw);
         }
     }
-    return res;
+    std::sort(added.begin(), added.end());
+    added.erase(std::unique(added.begin(), added.end()), added.end());
+    for (auto raw : added) {
+        _shift.push_back(raw - static_cast<int64_t>(_block.size()));
+        _block.push_back(raw);
+    }
+    _size = static_cast<size_t>(_raw_size) - _block.size();
+    return true;
 }
-flw::chart::PointVector flw::chart::Point::Momentum(const PointVector& in, size_t days) {
-    size_t          start = days - 1;
+size_t flw::chart::DateGenerator::index(const gnu::DateKey& key) const {
+    auto raw = _raw_index(key);
+    if (raw < 0 || std::binary_search(_block.begin(), _block.end(), raw) == true) {
+        return static_cast<size_t>(-1);
+    }
+    return static_cast<size_t>(raw - (std::lower_bound(_block.begin(), _block.end(), raw) - _block.begin()));
+}
+size_t flw::chart::DateGenerator::index(const std::string& date) const {
+    return index(priv::_CHART_DATE_PARSER.parse(date));
+}
+gnu::DateKey flw::chart::DateGenerator::key(size_t index) const {
+    if (index >= _size) {
+        return gnu::DateKey();
+    }
+    auto i   = static_cast<int64_t>(index);
+    auto raw = i + (std::upper_bound(_shift.begin(), _shift.end(), i) - _shift.begin());
+    return _raw_key(raw);
+}
+flw::chart::PointVector flw::chart::DateGenerator::points() const {
     PointVector res;
-    if (days > 1 && days < in.size()) {
-        for (auto f = start; f < in.size(); f++) {
-            const auto& data1 = in[f];
-            const auto& data2 = in[f - start];
-            res.push_back(Point(data1.date, data1.close - data2.close));
-        }
+    res.reserve(_size);
+    for (size_t f = 0; f < _size; f++) {
+        res.push_back(point(f));
     }
     return res;
 }
-flw::chart::PointVector flw::chart::Point::MovingAverage(const PointVector& in, size_t days) {
-    PointVector res;
-    if (days > 1 && days < in.size()) {
-        size_t count = 0;
-        double sum   = 0.0;
-        auto   tmp   = new double[in.size() + 1];
-        for (const auto& data : in) {
-            count++;
-            if (count < days) {
-                tmp[count - 1] = data.close;
-                sum += data.close;
-            }
-            else if (count == days) {
-                tmp[count - 1] = data.close;
-                sum += data.close;
-                res.push_back(Point(data.date, sum / days));
+int64_t flw::chart::DateGenerator::_raw_index(const gnu::DateKey& key) const {
+    int64_t raw = -1;
+    if (key.is_invalid() == true || _raw_size == 0) {
+        return -1;
+    }
+    else if (_range == DateRange::WEEKDAY || _range == DateRange::MONTH) {
+        const auto DAYS = key.days();
+        if (key.seconds() - DAYS * gnu::Date::SECS_PER_DAY != _time) {
+            return -1;
+        }
+        else if (_range == DateRange::WEEKDAY) {
+            if ((DAYS + 3) - priv::_chart_floor_div(DAYS + 3, 7) * 7 >= 5) {
+                return -1;
             }
-            else {
-                tmp[count - 1] = data.close;
-                sum -= tmp[count - (days + 1)];
-                sum += data.close;
-                res.push_back(Point(data.date, sum / days));
+            raw = priv::_chart_weekdays(DAYS) - _first;
+        }
+        else {
+            const auto DATE = key.to_date();
+            if (DATE.day() != DATE.days_in_month()) {
+                return -1;
             }
+            raw = DATE.year() * 12 + DATE.month() - 1 - _first;
         }
-        delete []tmp;
     }
-    return res;
+    else {
+        const auto DIFF = key.seconds() - _first;
+        if (DIFF < 0 || DIFF % _time != 0) {
+            return -1;
+        }
+        raw = DIFF / _time;
+    }
+    return (raw >= 0 && raw < _raw_size) ? raw : -1;
 }
-std::string flw::chart::Point::RangeToString(DateRange range) {
-    static const std::string NAMES[] = { "DAY", "WEEKDAY", "FRIDAY", "SUNDAY", "MONTH", "HOUR", "MIN", "SEC", "", };
-    return NAMES[static_cast<unsigned>(range)];
+gnu::DateKey flw::chart::DateGenerator::_raw_key(int64_t raw) const {
+    if (_range == DateRange::WEEKDAY) {
+        return gnu::DateKey::FromSeconds(priv::_chart_weekday_to_days(_first + raw) * gnu::Date::SECS_PER_DAY + _time);
+    }
+    else if (_range == DateRange::MONTH) {
+        const auto MONTH = _first + raw;
+        auto       date  = gnu::Date(static_cast<int>(MONTH / 12), static_cast<int>(MONTH % 12) + 1, 1);
+        date.set_day_to_last_in_month();
+        return gnu::DateKey::FromSeconds(date.key().seconds() + _time);
+    }
+    return gnu::DateKey::FromSeconds(_first + raw * _time);
 }
-flw::chart::PointVector flw::chart::Point::RSI(const PointVector& in, size_t days) {
-    PointVector res;
-    if (days > 1 && days < in.size()) {
-        double avg_gain = 0.0;
-        double avg_loss = 0.0;
-        for (size_t f = 1; f < in.size(); f++) {
-            double      diff = 0.0;
-            const auto& data = in[f];
-            const auto& prev = in[f - 1];
-            diff = data.close - prev.close;
-            if (f <= days) {
-                if (diff > 0) {
-                    avg_gain += diff;
-                }
-                else {
-                    avg_loss += fabs(diff);
-                }
-            }
-            if (f == days) {
-                avg_gain = avg_gain / days;
-                avg_loss = avg_loss / days;
-                res.push_back(Point(data.date, 100 - (100 / (1 + (avg_gain / avg_loss)))));
-            }
-            else if (f > days) {
-                avg_gain = ((avg_gain * (days - 1)) + ((diff > 0) ? fabs(diff) : 0)) / days;
-                avg_loss = ((avg_loss * (days - 1)) + ((diff < 0) ? fabs(diff) : 0)) / days;
-                res.push_back(Point(data.date, 100 - (100 / (1 + (avg_gain / avg_loss)))));
-            }
+flw::chart::Line::Line(const PointVector& data, const std::string& label, LineType type) {
+    reset();
+    set_data(data);
+    set_label(label);
+    set_type(type);
+}
+void flw::chart::Line::_added(size_t first) {
+    const auto* view_before = &view();
+    const auto  changed     = (view_before == &_series) ? first : (view_before->size() > 0) ? view_before->size() - 1 : 0;
+    for (auto it = _resampled.begin(); it != _resampled.end();) {
+        auto ok = true;
+        for (auto f = first; f < _series.size() && ok == true; f++) {
+            ok = priv::_chart_resample_append(_series, f, it->first, _aggregate == Aggregate::SUM, it->second);
+        }
+        if (ok == true) {
+            ++it;
+        }
+        else {
+            it = _resampled.erase(it);
         }
     }
-    return res;
+    if (&view() != view_before) {
+        _clear_index();
+    }
+    else if (_index.size() > changed) {
+        _index.pop_back(_index.size() - changed);
+    }
 }
-bool flw::chart::Point::SaveCSV(const PointVector& in, const std::string& filename, const std::string& sep) {
-    std::string csv;
-    csv.reserve(in.size() * 40 + 256);
-    for (const auto& data : in) {
-        char buffer[2'000];
-        snprintf(buffer, 2'000, "%s%s%s%s%s%s%s\n", data.date.c_str(), sep.c_str(), gnu::json::format_number(data.high).c_str(), sep.c_str(), gnu::json::format_number(data.low).c_str(), sep.c_str(), gnu::json::format_number(data.close).c_str());
-        csv += buffer;
+void flw::chart::Line::_block_range(size_t block) const {
+    if (std::isnan(_block_max[block]) == false) {
+        return;
+    }
+    const auto& series = view();
+    const auto& max    = (_range_hl == true) ? series.high() : series.close();
+    const auto& min    = (_range_hl == true) ? series.low() : series.close();
+    const auto  START  = block * SERIES_BLOCK;
+    const auto  END    = std::min(series.size(), START + SERIES_BLOCK);
+    _block_max[block] = -INFINITY;
+    _block_min[block] = INFINITY;
+    if (series.check(START, END - 1) == false) {
+        return;
+    }
+    for (auto f = START; f < END; f++) {
+        if (_mapped_dates.index(series.key(f)) != static_cast<size_t>(-1)) {
+            _block_max[block] = std::max(_block_max[block], max[f]);
+            _block_min[block] = std::min(_block_min[block], min[f]);
+        }
     }
-    return gnu::file::write(filename, csv.c_str(), csv.size());
 }
-flw::chart::PointVector flw::chart::Point::StdDev(const PointVector& in, size_t days) {
-    PointVector res;
-    if (days > 1 && days < in.size()) {
-        size_t    count = 0;
-        double    sum   = 0.0;
-        Point data2;
-        for (const auto& data : in) {
-            count++;
-            sum += data.close;
-            if (count >= days) {
-                double mean = sum / days;
-                double dev  = 0.0;
-                for (size_t j = count - days; j < count; j++) {
-                    data2 = in[j];
-                    auto tmp = data2.close - mean;
-                    tmp *= tmp;
-                    dev  += tmp;
-                }
-                dev /= days;
-                dev = sqrt(dev);
-                data2 = in[count - days];
-                sum -= data2.close;
-                data2 = in[count - 1];
-                res.push_back(Point(data2.date, dev));
-            }
+void flw::chart::Line::_calc_range(bool force) {
+    const auto& series = view();
+    const auto  SIZE   = _index.size();
+    const auto  HL     = type_has_high_and_low();
+    if (series.is_mapped() == true) {
+        if (force == true || HL != _range_hl) {
+            _range_hl = HL;
+            std::fill(_block_max.begin(), _block_max.end(), NAN);
+            std::fill(_block_min.begin(), _block_min.end(), NAN);
         }
+        return;
     }
-    return res;
+    else if (SIZE == 0 || SIZE > series.size()) {
+        _range_max.clear();
+        _range_min.clear();
+        _range_first = 0;
+        return;
+    }
+    else if (force == false && HL == _range_hl && _range_min.size() > 0) {
+        return;
+    }
+    const auto& max  = (HL == true) ? series.high() : series.close();
+    const auto& min  = (HL == true) ? series.low() : series.close();
+    const auto  LEAF = SIZE + SIZE / 2 + 16;
+    _range_hl    = HL;
+    _range_first = 0;
+    _range_max.assign(LEAF * 2, -INFINITY);
+    _range_min.assign(LEAF * 2, INFINITY);
+    for (size_t f = 0; f < SIZE; f++) {
+        if (_index[f] >= 0) {
+            _range_max[LEAF + f] = max[f];
+            _range_min[LEAF + f] = min[f];
+        }
+    }
+    for (size_t f = LEAF - 1; f > 0; f--) {
+        _range_max[f] = std::max(_range_max[f * 2], _range_max[f * 2 + 1]);
+        _range_min[f] = std::min(_range_min[f * 2], _range_min[f * 2 + 1]);
+    }
+}
+bool flw::chart::Line::append(const gnu::DateKey& key, double high, double low, double close) {
+    const auto last = _series.last_key();
+    if (key.is_invalid() == true ||
+        (last.is_invalid() == false && key <= last) ||
+        priv::_chart_is_value(high) == false ||
+        priv::_chart_is_value(low) == false ||
+        priv::_chart_is_value(close) == false) {
+        return false;
+    }
+    const auto SIZE = _series.size();
+    _series.push_back(key, high, low, close);
+    _added(SIZE);
+    _trim();
+    return true;
 }
-flw::chart::PointVector flw::chart::Point::Stochastics(const PointVector& in, size_t days) {
-    double          high = 0.0;
-    double          low  = 0.0;
-    PointVector res;
-    if (days > 1 && days < in.size()) {
-        for (size_t f = 0; f < in.size(); f++) {
-            const auto& data = in[f];
-            if ((f + 1) >= days) {
-                high = data.high;
-                low  = data.low;
-                for (size_t j = (f + 1) - days; j < (f + 1) - 1; j++) {
-                    const auto& data2 = in[j];
-                    if (data2.high > high) {
-                        high = data2.high;
-                    }
-                    if (data2.low < low) {
-                        low = data2.low;
-                    }
-                }
-                double diff1 = data.close - low;
-                double diff2 = high - low;
-                if (diff2 > chart::MIN_VALUE) {
-                    double kval  = 100.0 * (diff1 / diff2);
-                    res.push_back(Point(data.date, kval));
-                }
-            }
+void flw::chart::Line::calc_index(const DateGenerator& dates, bool all) {
+    const auto& series = view();
+    const auto& keys   = series.keys();
+    if (series.is_mapped() == true) {
+        if (all == true || _block_max.size() == 0) {
+            const auto BLOCKS = (series.size() + SERIES_BLOCK - 1) / SERIES_BLOCK;
+            _clear_index();
+            _mapped_dates = dates;
+            _range_hl     = type_has_high_and_low();
+            _block_max.assign(BLOCKS, NAN);
+            _block_min.assign(BLOCKS, NAN);
         }
+        return;
+    }
+    else if (all == true || _index.size() > keys.size() || _block_max.size() > 0) {
+        _clear_index();
+    }
+    const auto FIRST = _index.size();
+    if (FIRST == keys.size()) {
+        return;
     }
-    return res;
-}
-flw::chart::DateRange flw::chart::Point::StringToRange(const std::string& range) {
-    if (range == "WEEKDAY")     return DateRange::WEEKDAY;
-    else if (range == "FRIDAY") return DateRange::FRIDAY;
-    else if (range == "SUNDAY") return DateRange::SUNDAY;
-    else if (range == "MONTH")  return DateRange::MONTH;
-    else if (range == "HOUR")   return DateRange::HOUR;
-    else if (range == "MIN")    return DateRange::MIN;
-    else if (range == "SEC")    return DateRange::SEC;
-    else                        return DateRange::DAY;
+    for (auto f = FIRST; f < keys.size(); f++) {
+        _index.push_back(static_cast<int64_t>(dates.index(keys[f])));
+    }
+    _update_range(FIRST);
+    _lod_added(FIRST);
 }
-flw::chart::Line::Line(const PointVector& data, const std::string& label, LineType type) {
-    reset();
-    set_data(data);
-    set_label(label);
-    set_type(type);
+void flw::chart::Line::calc_lod(int level) {
+    if (_has_index() == false || (view().is_mapped() == true && level <= 0)) {
+        _lod_index.clear();
+        _lod_series.clear();
+        return;
+    }
+    else if (view().is_mapped() == true) {
+        if (static_cast<int>(_lod_series.size()) != level) {
+            _lod_index.assign(level, SeriesColumn<int64_t>());
+            _lod_series.assign(level, Series());
+            priv::_chart_lod_mapped(view(), _mapped_dates, level, _lod_index.back(), _lod_series.back());
+        }
+        return;
+    }
+    while (static_cast<int>(_lod_series.size()) < level) {
+        auto index  = SeriesColumn<int64_t>();
+        auto series = Series();
+        priv::_chart_lod_add(lod_index(static_cast<int>(_lod_series.size())), lod_series(static_cast<int>(_lod_series.size())), 0, index, series);
+        _lod_index.push_back(std::move(index));
+        _lod_series.push_back(std::move(series));
+    }
+}
+void flw::chart::Line::_clear_index() {
+    _index.clear();
+    _lod_index.clear();
+    _lod_series.clear();
+    _range_max.clear();
+    _range_min.clear();
+    _range_first = 0;
+    _block_max.clear();
+    _block_min.clear();
+    _mapped_dates.clear();
+}
+bool flw::chart::Line::_has_index() const {
+    const auto& series = view();
+    return (series.is_mapped() == true) ? _block_max.size() > 0 || series.size() == 0 : _index.size() == series.size();
 }
 void flw::chart::Line::debug(size_t num) const {
 #ifdef DEBUG
@@ -4897,18 +7616,205 @@ void flw::chart::Line::debug(size_t num) const {
     printf("\t\t\tvisible:    %25s\n", _visible ? "YES" : "NO");
     printf("\t\t\tprices:     %25d\n", static_cast<int>(size()));
     if (size() > 1) {
-        printf("\t\t\tfirst:      %25s\n", _data.front().date.c_str());
-        printf("\t\t\tfirst:      %25f\n", _data.front().close);
-        printf("\t\t\tlast:       %25s\n", _data.back().date.c_str());
-        printf("\t\t\tlast:       %25f\n", _data.back().close);
+        printf("\t\t\tfirst:      %25s\n", _series.date(0).c_str());
+        printf("\t\t\tfirst:      %25f\n", _series.close().front());
+        printf("\t\t\tlast:       %25s\n", _series.date(size() - 1).c_str());
+        printf("\t\t\tlast:       %25f\n", _series.close().back());
     }
     fflush(stdout);
 #else
     (void) num;
 #endif
 }
+const flw::chart::SeriesColumn<int64_t>& flw::chart::Line::lod_index(int level) const {
+    static const SeriesColumn<int64_t> EMPTY;
+    if (level == 0) {
+        return _index;
+    }
+    else if (level < 0 || level > static_cast<int>(_lod_index.size()) || _has_index() == false) {
+        return EMPTY;
+    }
+    return _lod_index[level - 1];
+}
+const flw::chart::Series& flw::chart::Line::lod_series(int level) const {
+    static const Series EMPTY;
+    if (level == 0) {
+        return view();
+    }
+    else if (level < 0 || level > static_cast<int>(_lod_series.size()) || _has_index() == false) {
+        return EMPTY;
+    }
+    return _lod_series[level - 1];
+}
+void flw::chart::Line::_lod_added(size_t first) {
+    if (std::all_of(_index.begin() + std::min(first, _index.size()), _index.end(), [](int64_t tick) { return tick < 0; }) == true) {
+        return;
+    }
+    for (size_t level = 0; level < _lod_series.size(); level++) {
+        const auto& prev_index = (level == 0) ? _index : _lod_index[level - 1];
+        const auto& prev       = (level == 0) ? view() : _lod_series[level - 1];
+        auto&       index      = _lod_index[level];
+        auto&       series     = _lod_series[level];
+        auto        last       = std::min(first, prev_index.size());
+        while (last > 0 && prev_index[last - 1] < 0) {
+            last--;
+        }
+        if (last == 0) {
+            index.clear();
+            series.clear();
+            first = 0;
+            priv::_chart_lod_add(prev_index, prev, 0, index, series);
+            continue;
+        }
+        const auto BUCKET = prev_index[last - 1] >> 1;
+        auto       start  = last - 1;
+        size_t     count  = 0;
+        while (start > 0 && (prev_index[start - 1] < 0 || (prev_index[start - 1] >> 1) == BUCKET)) {
+            start--;
+        }
+        while (count < index.size() && index[index.size() - count - 1] >= BUCKET) {
+            count++;
+        }
+        index.pop_back(count);
+        series.pop_back(count);
+        first = index.size();
+        priv::_chart_lod_add(prev_index, prev, start, index, series);
+    }
+}
+void flw::chart::Line::_lod_trim(int64_t tick) {
+    for (size_t level = 0; level < _lod_series.size(); level++) {
+        const auto& prev_index = (level == 0) ? _index : _lod_index[level - 1];
+        const auto& prev       = (level == 0) ? view() : _lod_series[level - 1];
+        auto&       index      = _lod_index[level];
+        auto&       series     = _lod_series[level];
+        const auto  BUCKET     = tick >> (level + 1);
+        size_t      count      = 0;
+        while (count < index.size() && index[count] < BUCKET) {
+            count++;
+        }
+        index.pop_front(count);
+        series.pop_front(count);
+        if (index.size() == 0 || index.front() != BUCKET) {
+            continue;
+        }
+        double h = -INFINITY;
+        double l = INFINITY;
+        double c = 0.0;
+        for (size_t f = 0; f < prev_index.size() && (prev_index[f] < 0 || (prev_index[f] >> 1) == BUCKET); f++) {
+            if (prev_index[f] >= 0) {
+                h = std::max(h, prev.high()[f]);
+                l = std::min(l, prev.low()[f]);
+                c = prev.close()[f];
+            }
+        }
+        if (series.set(0, h, l, c) == false) {
+            index.pop_front(1);
+            series.pop_front(1);
+        }
+    }
+}
+bool flw::chart::Line::minmax(const gnu::DateKey& first, const gnu::DateKey& last, double& min, double& max) const {
+    const auto& keys = view().keys();
+    const auto  SIZE = keys.size();
+    const auto  LEAF = _range_min.size() / 2 + _range_first;
+    if (view().is_mapped() == true) {
+        if (_block_max.size() == 0) {
+            return false;
+        }
+        const auto& hi = (_range_hl == true) ? view().high() : view().close();
+        const auto& lo = (_range_hl == true) ? view().low() : view().close();
+        auto        l  = static_cast<size_t>(std::lower_bound(keys.begin(), keys.end(), first) - keys.begin());
+        const auto  r  = static_cast<size_t>(std::upper_bound(keys.begin(), keys.end(), last) - keys.begin());
+        min = INFINITY;
+        max = -INFINITY;
+        while (l < r) {
+            const auto BLOCK = l / SERIES_BLOCK;
+            const auto END   = std::min(r, (BLOCK + 1) * SERIES_BLOCK);
+            if (l == BLOCK * SERIES_BLOCK && END == std::min(SIZE, (BLOCK + 1) * SERIES_BLOCK)) {
+                _block_range(BLOCK);
+                min = std::min(min, _block_min[BLOCK]);
+                max = std::max(max, _block_max[BLOCK]);
+            }
+            else if (view().check(l, END - 1) == true) {
+                for (auto f = l; f < END; f++) {
+                    if (_mapped_dates.index(keys[f]) != static_cast<size_t>(-1)) {
+                        min = std::min(min, lo[f]);
+                        max = std::max(max, hi[f]);
+                    }
+                }
+            }
+            l = END;
+        }
+        return min <= max;
+    }
+    else if (_index.size() != SIZE || _range_min.size() == 0) {
+        return false;
+    }
+    auto        l    = static_cast<size_t>(std::lower_bound(keys.begin(), keys.end(), first) - keys.begin()) + LEAF;
+    auto        r    = static_cast<size_t>(std::upper_bound(keys.begin(), keys.end(), last) - keys.begin()) + LEAF;
+    min = INFINITY;
+    max = -INFINITY;
+    while (l < r) {
+        if (l & 1) {
+            min = std::min(min, _range_min[l]);
+            max = std::max(max, _range_max[l]);
+            l++;
+        }
+        if (r & 1) {
+            r--;
+            min = std::min(min, _range_min[r]);
+            max = std::max(max, _range_max[r]);
+        }
+        l /= 2;
+        r /= 2;
+    }
+    return min <= max;
+}
+void flw::chart::Line::prefetch(const gnu::DateKey& first, const gnu::DateKey& last) const {
+    if (_series.is_mapped() == false || &view() != &_series) {
+        return;
+    }
+    const auto& keys = _series.keys();
+    auto        l    = static_cast<size_t>(std::lower_bound(keys.begin(), keys.end(), first) - keys.begin());
+    auto        r    = static_cast<size_t>(std::upper_bound(keys.begin(), keys.end(), last) - keys.begin());
+    if (l < r) {
+        _series.prefetch(l, r - 1);
+    }
+}
+bool flw::chart::Line::resample(DateRange range) {
+    auto changed = (_resample.has_value() == false || _resample.value() != range);
+    if (_aggregate == Aggregate::NONE) {
+        changed = _resample.has_value();
+        _resample.reset();
+    }
+    else {
+        if (_resampled.find(range) == _resampled.end()) {
+            auto res = Series();
+            if (priv::_chart_resample(_series, range, 1, (range == DateRange::FRIDAY) ? 4 : 6, false, nullptr) == false) {
+                res = Series::Resample(_series, range, 1, _aggregate == Aggregate::SUM);
+            }
+            _resampled[range] = std::move(res);
+            changed           = true;
+        }
+        _resample = range;
+    }
+    if (changed == true) {
+        _clear_index();
+    }
+    return changed;
+}
 void flw::chart::Line::reset() {
-    _data.clear();
+    _series.clear();
+    _source_key = gnu::DateKey();
+    _clear_index();
+    _resampled.clear();
+    _resample.reset();
+    _indicator.reset();
+    _id       = ++priv::_CHART_LINE_ID;
+    _max_size = 0;
+    _source   = 0;
+    _range_hl = false;
+    _aggregate = Aggregate::NONE;
     _align   = FL_ALIGN_LEFT;
     _color   = FL_FOREGROUND_COLOR;
     _label   = "";
@@ -4917,6 +7823,30 @@ void flw::chart::Line::reset() {
     _visible = true;
     _width   = 1;
 }
+flw::chart::Line& flw::chart::Line::set_aggregate(Aggregate val) {
+    if (val == _aggregate) {
+        return *this;
+    }
+    _aggregate = val;
+    _resampled.clear();
+    _resample.reset();
+    _clear_index();
+    return *this;
+}
+bool flw::chart::Line::set_indicator(const Indicator& indicator, const Line& source) {
+    if (indicator.is_valid() == false || source.id() == _id || source.source() == _id) {
+        return false;
+    }
+    auto ind = indicator;
+    _series = ind.run(source.series());
+    _clear_index();
+    _resampled.clear();
+    _indicator  = ind;
+    _source     = source.id();
+    _source_key = source.series().last_key();
+    _trim();
+    return true;
+}
 flw::chart::Line& flw::chart::Line::set_type_from_string(const std::string&  val) {
     if (val == "LINE_DOT")                     _type = LineType::LINE_DOT;
     else if (val == "BAR")                     _type = LineType::BAR;
@@ -4927,12 +7857,85 @@ flw::chart::Line& flw::chart::Line::set_type_from_string(const std::string&  val
     else if (val == "EXPAND_HORIZONTAL_ALL")   _type = LineType::EXPAND_HORIZONTAL_ALL;
     else if (val == "EXPAND_HORIZONTAL_FIRST") _type = LineType::EXPAND_HORIZONTAL_FIRST;
     else                                       _type = LineType::LINE;
+    _calc_range(false);
     return *this;
 }
+void flw::chart::Line::_trim() {
+    if (_max_size == 0 || _series.size() <= _max_size) {
+        return;
+    }
+    const auto COUNT = _series.size() - _max_size;
+    auto       tick  = static_cast<int64_t>(-1);
+    for (auto it = _resampled.begin(); it != _resampled.end();) {
+        it = (it->second.size() > 0) ? _resampled.erase(it) : std::next(it);
+    }
+    if (&view() != &_series || _index.size() < COUNT) {
+        _clear_index();
+    }
+    else {
+        for (size_t f = 0; f < COUNT; f++) {
+            tick = (_index[f] >= 0) ? _index[f] : tick;
+        }
+        _index.pop_front(COUNT);
+        _range_first += COUNT;
+    }
+    _series.pop_front(COUNT);
+    if (tick >= 0) {
+        _lod_trim(tick);
+    }
+}
 std::string flw::chart::Line::type_to_string() const {
     static const std::string NAMES[] = { "LINE", "LINE_DOT", "BAR", "BAR_CLAMP", "BAR_HLC", "HORIZONTAL", "EXPAND_VERTICAL", "EXPAND_HORIZONTAL_ALL", "EXPAND_HORIZONTAL_FIRST", "", };
     return NAMES[static_cast<unsigned>(_type)];
 }
+bool flw::chart::Line::update(const Line& source) {
+    if (_indicator.has_value() == false || source.id() != _source) {
+        return false;
+    }
+    auto&       ind    = _indicator.value();
+    const auto& series = source.series();
+    const auto& keys   = series.keys();
+    const auto  last   = _series.last_key();
+    const auto  SIZE   = _series.size();
+    auto        f      = (_source_key.is_invalid() == true) ? 0 : static_cast<size_t>(std::upper_bound(keys.begin(), keys.end(), _source_key) - keys.begin());
+    for (; f < series.size(); f++) {
+        if (series.check(f, f) == true) {
+            ind.add(series.key(f), series.high()[f], series.low()[f], series.close()[f], _series);
+            _source_key = series.key(f);
+        }
+    }
+    _added(SIZE);
+    _trim();
+    return _series.last_key().is_invalid() == false && (last.is_invalid() == true || _series.last_key() > last);
+}
+void flw::chart::Line::_update_range(size_t first) {
+    const auto LEAF = _range_min.size() / 2;
+    if (LEAF == 0 || _range_first + _index.size() > LEAF || _range_hl != type_has_high_and_low()) {
+        _calc_range(true);
+        return;
+    }
+    const auto& series = view();
+    const auto& max    = (_range_hl == true) ? series.high() : series.close();
+    const auto& min    = (_range_hl == true) ? series.low() : series.close();
+    for (auto f = first; f < _index.size(); f++) {
+        auto leaf = LEAF + _range_first + f;
+        _range_max[leaf] = (_index[f] >= 0) ? max[f] : -INFINITY;
+        _range_min[leaf] = (_index[f] >= 0) ? min[f] : INFINITY;
+        for (leaf /= 2; leaf > 0; leaf /= 2) {
+            _range_max[leaf] = std::max(_range_max[leaf * 2], _range_max[leaf * 2 + 1]);
+            _range_min[leaf] = std::min(_range_min[leaf * 2], _range_min[leaf * 2 + 1]);
+        }
+    }
+}
+const flw::chart::Series& flw::chart::Line::view() const {
+    if (_resample.has_value() == true) {
+        auto it = _resampled.find(_resample.value());
+        if (it != _resampled.end() && it->second.size() > 0) {
+            return it->second;
+        }
+    }
+    return _series;
+}
 flw::chart::Scale::Scale() {
     reset();
 }
@@ -5051,7 +8054,7 @@ _CW(14) {
     labelcolor(FL_FOREGROUND_COLOR);
     box(FL_BORDER_BOX);
     tooltip(
-        "Press ctrl + scroll wheel to change tick width.\n"
+        "Press ctrl + scroll wheel to change tick width (or level of detail if it is turned on).\n"
         "Press ctrl + left button to show value for selected line.\n"
         "Press left button to show Y value.\n"
         "Press middle button on label to select that line.\n"
@@ -5065,7 +8068,8 @@ _CW(14) {
     _scroll->callback(Chart::_CallbackScrollbar, this);
     _menu->add(priv::_CHART_LABEL_SHOW_LABELS,      0, _FLW_CHART_CB(setup_view_options()), FL_MENU_TOGGLE);
     _menu->add(priv::_CHART_LABEL_SHOW_HLINES,      0, _FLW_CHART_CB(setup_view_options()), FL_MENU_TOGGLE);
-    _menu->add(priv::_CHART_LABEL_SHOW_VLINES,      0, _FLW_CHART_CB(setup_view_options()), FL_MENU_TOGGLE | FL_MENU_DIVIDER);
+    _menu->add(priv::_CHART_LABEL_SHOW_VLINES,      0, _FLW_CHART_CB(setup_view_options()), FL_MENU_TOGGLE);
+    _menu->add(priv::_CHART_LABEL_SHOW_LOD,         0, _FLW_CHART_CB(setup_view_options()), FL_MENU_TOGGLE | FL_MENU_DIVIDER);
     _menu->add(priv::_CHART_LABEL_CLEAR,            0, _FLW_CHART_CB(reset()));
     _menu->add(priv::_CHART_LABEL_SETUP_LABEL,      0, _FLW_CHART_CB(setup_label()));
     _menu->add(priv::_CHART_LABEL_SETUP_AREA,       0, _FLW_CHART_CB(setup_area()));
@@ -5080,7 +8084,9 @@ _CW(14) {
     _menu->add(priv::_CHART_LABEL_SAVE_CSV,         0, _FLW_CHART_CB(save_line_to_csv()), FL_MENU_DIVIDER);
     _menu->add(priv::_CHART_LABEL_ADD_CSV,          0, _FLW_CHART_CB(load_line_from_csv()));
     _menu->add(priv::_CHART_LABEL_LOAD_JSON,        0, _FLW_CHART_CB(load_json()));
-    _menu->add(priv::_CHART_LABEL_SAVE_JSON,        0, _FLW_CHART_CB(save_json()), FL_MENU_DIVIDER);
+    _menu->add(priv::_CHART_LABEL_SAVE_JSON,        0, _FLW_CHART_CB(save_json()));
+    _menu->add(priv::_CHART_LABEL_LOAD_SNAPSHOT,    0, _FLW_CHART_CB(load_snapshot()));
+    _menu->add(priv::_CHART_LABEL_SAVE_SNAPSHOT,    0, _FLW_CHART_CB(save_snapshot()), FL_MENU_DIVIDER);
     _menu->add(priv::_CHART_LABEL_PRINT,            0, _FLW_CHART_CB(print_to_postscript()));
     _menu->add(priv::_CHART_LABEL_SAVE_PNG,         0, _FLW_CHART_CB(save_png()));
 #ifdef DEBUG
@@ -5097,9 +8103,67 @@ _CW(14) {
     _areas.push_back(Area(AreaNum::FOUR));
     _areas.push_back(Area(AreaNum::FIVE));
     _disable_menu = false;
+    _offscreen    = 0;
     reset();
     update_pref();
 }
+flw::chart::Chart::~Chart() {
+    if (_offscreen != 0) {
+        fl_delete_offscreen(_offscreen);
+    }
+}
+bool flw::chart::Chart::append(AreaNum area, size_t line, const Point& point) {
+    const auto key    = priv::_CHART_DATE_PARSER.parse(point.date);
+    const bool follow = _date_start + _ticks >= _tick_count() - 1;
+    auto changed = _areas[static_cast<size_t>(area)].line(line);
+    if (changed == nullptr || changed->append(key, point.high, point.low, point.close) == false) {
+        return false;
+    }
+    std::vector<Line*> lines;
+    for (auto& a : _areas) {
+        for (size_t f = 0; f < a.size(); f++) {
+            lines.push_back(a.line(f));
+        }
+    }
+    priv::_chart_update_lines(lines, changed);
+    gnu::DateKey min;
+    gnu::DateKey max;
+    for (auto& a : _areas) {
+        for (size_t f = 0; f < a.size(); f++) {
+            auto line = a.line(f);
+            line->resample(_date_range);
+            const auto first = line->view().first_key();
+            const auto last  = line->view().last_key();
+            if (first.is_invalid() == false && line->is_visible() == true) {
+                if (min.is_invalid() == true || first < min) {
+                    min = first;
+                }
+                if (max.is_invalid() == true || last > max) {
+                    max = last;
+                }
+            }
+        }
+    }
+    if (min.is_invalid() == true) {
+        return true;
+    }
+    else if (_dates.size() == 0 ||
+        min < _dates.key(0) ||
+        min > _dates.key(_dates.size() / 2) ||
+        _dates_block != _block_dates) {
+        if (_calc_dates() == true) {
+            _calc_index(true);
+        }
+    }
+    else if (max > _dates_max && _dates.extend(max, _block_dates) == true) {
+        _dates_max = max;
+    }
+    if (follow == true) {
+        static_cast<Fl_Slider*>(_scroll)->value(_tick_count());
+    }
+    init();
+    return true;
+}
 void flw::chart::Chart::_calc_area_height() {
     auto last   = 0;
     auto addh   = 0;
@@ -5132,14 +8196,24 @@ void flw::chart::Chart::_calc_area_height() {
 void flw::chart::Chart::_calc_area_width() {
     const double width = w() - (_margin_left * _CH + _margin_right * _CH);
     _ticks = static_cast<int>(width / _tick_width);
-    if (static_cast<int>(_dates.size()) > _ticks) {
-        const double slider_size = _ticks / (_dates.size() + 1.0);
+    if (_lod == false) {
+        _lod_level = 0;
+    }
+    else if (_lod_fit == true) {
+        _lod_level = 0;
+        while (_tick_count() > _ticks && _ticks > 0) {
+            _lod_level++;
+        }
+    }
+    const int count = _tick_count();
+    if (count > _ticks) {
+        const double slider_size = _ticks / (count + 1.0);
         _scroll->activate();
         _scroll->slider_size((slider_size > 0.05) ? slider_size : 0.05);
-        _scroll->range(0, _dates.size() - _ticks);
+        _scroll->range(0, count - _ticks);
         if (_scroll->value() > _scroll->maximum()) {
             static_cast<Fl_Slider*>(_scroll)->value(_scroll->maximum());
-            _date_start = _dates.size() - _ticks - 1;
+            _date_start = count - _ticks - 1;
         }
     }
     else {
@@ -5154,31 +8228,63 @@ void flw::chart::Chart::_calc_area_width() {
         area.rect().w(width);
     }
 }
-void flw::chart::Chart::_calc_dates() {
-    std::string min;
-    std::string max;
+bool flw::chart::Chart::_calc_dates() {
+    gnu::DateKey min;
+    gnu::DateKey max;
     for (auto& area : _areas) {
-        for (auto& line : area.lines()) {
-            if (line.size() > 0 && line.is_visible() == true) {
-                const auto& first = line.data().front();
-                const auto& last  = line.data().back();
-                if (min == "") {
-                    min = "99991231 232359";
-                    max = "01010101 000000";
+        for (size_t f = 0; f < area.size(); f++) {
+            auto line = area.line(f);
+            line->resample(_date_range);
+            const auto first = line->view().first_key();
+            const auto last  = line->view().last_key();
+            if (first.is_invalid() == false && line->is_visible() == true) {
+                if (min.is_invalid() == true || first < min) {
+                    min = first;
                 }
-                if (first.date < min) {
-                    min = first.date;
-                }
-                if (last.date > max) {
-                    max = last.date;
+                if (max.is_invalid() == true || last > max) {
+                    max = last;
                 }
             }
         }
     }
-    _dates.clear();
-    if (min != "") {
-        _dates = Point::DateSerie(min, max, _date_range, _block_dates);
-        redraw();
+    if (min.is_invalid() == true) {
+        _dates.clear();
+        _dates_block.clear();
+        _dates_max = gnu::DateKey();
+        _dates_min = gnu::DateKey();
+        return true;
+    }
+    else if (_dates.size() > 0 && _dates.range() == _date_range && min == _dates_min && max >= _dates_max && _dates_block == _block_dates) {
+        if (max == _dates_max) {
+            return false;
+        }
+        else if (_dates.extend(max, _block_dates) == true) {
+            _dates_max = max;
+            redraw();
+            return false;
+        }
+    }
+    _dates       = DateGenerator(priv::_chart_key_date(min), priv::_chart_key_date(max), _date_range, _block_dates);
+    _dates_block = _block_dates;
+    _dates_max   = max;
+    _dates_min   = min;
+    redraw();
+    return true;
+}
+void flw::chart::Chart::_calc_index(bool all) {
+    for (auto& area : _areas) {
+        for (size_t f = 0; f < area.size(); f++) {
+            auto line = area.line(f);
+            line->resample(_date_range);
+            line->calc_index(_dates, all);
+        }
+    }
+}
+void flw::chart::Chart::_calc_lod() {
+    for (auto& area : _areas) {
+        for (size_t f = 0; f < area.size(); f++) {
+            area.line(f)->calc_lod(_lod_level);
+        }
     }
 }
 void flw::chart::Chart::_calc_margins() {
@@ -5225,68 +8331,39 @@ void flw::chart::Chart::_calc_margins() {
     }
 }
 void flw::chart::Chart::_calc_ymin_ymax() {
+    const int start = _date_start << _lod_level;
+    const int stop  = _last_date(_date_start + _ticks);
     for (auto& area : _areas) {
         auto min_clamp = area.clamp_min();
         auto max_clamp = area.clamp_max();
         area.left_scale().reset();
         area.right_scale().reset();
         for (const auto& line : area.lines()) {
-            if (line.size() == 0 || line.is_visible() == false) {
+            if (line.size() == 0 || line.is_visible() == false || start > stop) {
+                continue;
+            }
+            double max = 0.0;
+            double min = 0.0;
+            if (_lod_level == 0) {
+                line.prefetch(_dates.key(start), _dates.key(stop));
+            }
+            if (line.minmax(_dates.key(start), _dates.key(stop), min, max) == false) {
                 continue;
             }
-            const int stop    = _date_start + _ticks;
-            int       current = _date_start;
-            double    minimum = INFINITY;
-            double    maximum = INFINITY;
-            double    max     = 0.0;
-            double    min     = 0.0;
             if (min_clamp.has_value() == true) {
-                minimum = min_clamp.value();
+                min = min_clamp.value();
             }
             if (max_clamp.has_value() == true) {
-                maximum = max_clamp.value();
+                max = max_clamp.value();
             }
-            while (current <= stop && current < static_cast<int>(_dates.size())) {
-                const Point& date  = _dates[current];
-                const size_t     index = Point::BinarySearch(line.data(), date);
-                if (index != static_cast<size_t>(-1)) {
-                    const Point& data = line.data()[index];
-                    if (line.type_has_high_and_low() == true) {
-                        min = data.low;
-                        max = data.high;
-                    }
-                    else {
-                        min = data.close;
-                        max = data.close;
-                    }
-                    if (std::isfinite(minimum) == true) {
-                        min = minimum;
-                    }
-                    if (std::isfinite(maximum) == true) {
-                        max = maximum;
-                    }
-                    if (line.align() == FL_ALIGN_LEFT) {
-                        auto scale_min = area.left_scale().min();
-                        auto scale_max = area.left_scale().max();
-                        if (scale_min.has_value() == false || min < scale_min.value()) {
-                            area.left_scale().set_min(min);
-                        }
-                        if (scale_max.has_value() == false || max > scale_max.value()) {
-                            area.left_scale().set_max(max);
-                        }
-                    }
-                    else {
-                        auto scale_min = area.right_scale().min();
-                        auto scale_max = area.right_scale().max();
-                        if (scale_min.has_value() == false || min < scale_min.value()) {
-                            area.right_scale().set_min(min);
-                        }
-                        if (scale_max.has_value() == false || max > scale_max.value()) {
-                            area.right_scale().set_max(max);
-                        }
-                    }
-                }
-                current++;
+            auto& scale     = (line.align() == FL_ALIGN_LEFT) ? area.left_scale() : area.right_scale();
+            auto  scale_min = scale.min();
+            auto  scale_max = scale.max();
+            if (scale_min.has_value() == false || min < scale_min.value()) {
+                scale.set_min(min);
+            }
+            if (scale_max.has_value() == false || max > scale_max.value()) {
+                scale.set_max(max);
             }
         }
         area.left_scale().fix_height();
@@ -5327,9 +8404,10 @@ bool flw::chart::Chart::create_line(Algorithm formula, bool support) {
     auto line1  = Line();
     auto line2  = Line();
     auto line3  = Line();
-    auto vec1   = PointVector();
-    auto vec2   = PointVector();
-    auto vec3   = PointVector();
+    auto vec1   = Series();
+    auto ind1   = std::optional<Indicator>();
+    auto ind2   = std::optional<Indicator>();
+    auto ind3   = std::optional<Indicator>();
     auto label1 = std::string();
     auto label2 = std::string();
     auto label3 = std::string();
@@ -5346,18 +8424,18 @@ bool flw::chart::Chart::create_line(Algorithm formula, bool support) {
             flw::dlg::msg_alert("Chart", "Days are out of range!");
             return false;
         }
-        vec1   = Point::ATR(line0->data(), days);
+        ind1   = Indicator(Algorithm::ATR, days);
         label1 = util::format("ATR %d Days", days);
     }
     else if (formula == Algorithm::DAY_TO_WEEK) {
         auto answer = dlg::msg_ask("Chart", "Would you like to use highest/lowest and last close value per week?\nOr sum values per week?", "Sum", "High/Low");
-        vec1   = Point::DayToWeek(line0->data(), gnu::Date::Day::SUNDAY, answer == "Sum");
+        vec1   = Series::Resample(line0->series(), DateRange::SUNDAY, 1, answer == "Sum");
         label1 = "Weekly (Sunday)";
         type1  = line0->type();
     }
     else if (formula == Algorithm::DAY_TO_MONTH) {
         auto answer = dlg::msg_ask("Chart", "Would you like to use highest/lowest and last close value per month?\nOr sum values per month?", "Sum", "High/Low");
-        vec1   = Point::DayToMonth(line0->data(), answer == "Sum");
+        vec1   = Series::Resample(line0->series(), DateRange::MONTH, 1, answer == "Sum");
         label1 = "Monthly";
         type1  = line0->type();
     }
@@ -5367,7 +8445,7 @@ bool flw::chart::Chart::create_line(Algorithm formula, bool support) {
         if (answer == flw::labels::CANCEL || days < 2 || days > 365) {
             return false;
         }
-        vec1   = Point::ExponentialMovingAverage(line0->data(), days);
+        ind1   = Indicator(Algorithm::EXP_MOVING_AVERAGE, days);
         label1 = util::format("Exponential Moving Average %d Days", days);
     }
     else if (formula == Algorithm::FIXED) {
@@ -5376,7 +8454,7 @@ bool flw::chart::Chart::create_line(Algorithm formula, bool support) {
         if (answer == flw::labels::CANCEL || std::isinf(value) == true) {
             return false;
         }
-        vec1   = Point::Fixed(line0->data(), value);
+        ind1   = Indicator(Algorithm::FIXED, 0, value);
         label1 = util::format("Horizontal %f", value);
         type1  = LineType::EXPAND_HORIZONTAL_FIRST;
     }
@@ -5396,7 +8474,7 @@ bool flw::chart::Chart::create_line(Algorithm formula, bool support) {
             dlg::msg_alert("Chart", "To small value!");
             return false;
         }
-        vec1   = Point::Modify(line0->data(), modify, value);
+        ind1   = Indicator(Algorithm::MODIFY, 0, value, modify);
         label1 = util::format("Modified %s", line0->label().c_str());
         type1  = line0->type();
     }
@@ -5406,10 +8484,10 @@ bool flw::chart::Chart::create_line(Algorithm formula, bool support) {
         if (answer == flw::labels::CANCEL || days < 2 || days > 365) {
             return false;
         }
-        vec1   = Point::Momentum(line0->data(), days);
+        ind1   = Indicator(Algorithm::MOMENTUM, days);
         label1 = util::format("Momentum %d Days", days);
         if (support == true) {
-            vec2   = Point::Fixed(line0->data(), 0.0);
+            ind2   = Indicator(Algorithm::FIXED, 0, 0.0);
             label2 = "Momentum Zero";
             type2  = LineType::EXPAND_HORIZONTAL_FIRST;
         }
@@ -5420,7 +8498,7 @@ bool flw::chart::Chart::create_line(Algorithm formula, bool support) {
         if (answer == flw::labels::CANCEL || days < 2 || days > 365) {
             return false;
         }
-        vec1   = Point::MovingAverage(line0->data(), days);
+        ind1   = Indicator(Algorithm::MOVING_AVERAGE, days);
         label1 = util::format("Moving Average %d Days", days);
     }
     else if (formula == Algorithm::RSI) {
@@ -5429,13 +8507,13 @@ bool flw::chart::Chart::create_line(Algorithm formula, bool support) {
         if (answer == flw::labels::CANCEL || days < 2 || days > 365) {
             return false;
         }
-        vec1   = Point::RSI(line0->data(), days);
+        ind1   = Indicator(Algorithm::RSI, days);
         label1 = util::format("RSI %d Days", days);
         if (support == true) {
-            vec2   = Point::Fixed(line0->data(), 30.0);
+            ind2   = Indicator(Algorithm::FIXED, 0, 30.0);
             label2 = "RSI 30";
             type2  = LineType::EXPAND_HORIZONTAL_FIRST;
-            vec3   = Point::Fixed(line0->data(), 70.0);
+            ind3   = Indicator(Algorithm::FIXED, 0, 70.0);
             label3 = "RSI 70";
             type3  = LineType::EXPAND_HORIZONTAL_FIRST;
         }
@@ -5446,7 +8524,7 @@ bool flw::chart::Chart::create_line(Algorithm formula, bool support) {
         if (answer == flw::labels::CANCEL || days < 2 || days > 365) {
             return false;
         }
-        vec1   = Point::StdDev(line0->data(), days);
+        ind1   = Indicator(Algorithm::STD_DEV, days);
         label1 = util::format("Std. dev. %d Days", days);
     }
     else if (formula == Algorithm::STOCHASTICS) {
@@ -5455,30 +8533,42 @@ bool flw::chart::Chart::create_line(Algorithm formula, bool support) {
         if (answer == flw::labels::CANCEL || days < 2 || days > 365) {
             return false;
         }
-        vec1   = Point::Stochastics(line0->data(), days);
+        ind1   = Indicator(Algorithm::STOCHASTICS, days);
         label1 = util::format("Stochastics %d Days", days);
         if (support == true) {
-            vec2   = Point::Fixed(line0->data(), 20.0);
+            ind2   = Indicator(Algorithm::FIXED, 0, 20.0);
             label2 = "Stochastics 20";
             type2  = LineType::EXPAND_HORIZONTAL_FIRST;
-            vec3   = Point::Fixed(line0->data(), 80.0);
+            ind3   = Indicator(Algorithm::FIXED, 0, 80.0);
             label3 = "Stochastics 80";
             type3  = LineType::EXPAND_HORIZONTAL_FIRST;
         }
     }
-    if (vec1.size() == 0) {
+    if (ind1.has_value() == true) {
+        line1.set_indicator(ind1.value(), *line0);
+    }
+    else {
+        line1.set_data(std::move(vec1));
+    }
+    if (line1.size() == 0) {
         dlg::msg_alert("Chart", "No data!");
         return false;
     }
-    line1.set_data(vec1).set_label(label1).set_type(type1).set_align(line0->align()).set_color(FL_BLUE);
+    line1.set_label(label1).set_type(type1).set_align(line0->align()).set_color(FL_BLUE);
     priv::_ChartLineSetup(top_window(), line1).run();
+    if (ind2.has_value() == true) {
+        line2.set_indicator(ind2.value(), *line0);
+        line2.set_label(label2).set_type(type2).set_align(line1.align()).set_color(FL_BLACK);
+    }
+    if (ind3.has_value() == true) {
+        line3.set_indicator(ind3.value(), *line0);
+        line3.set_label(label3).set_type(type3).set_align(line1.align()).set_color(FL_BLACK);
+    }
     _area->add_line(line1);
-    if (vec2.size() > 0) {
-        line2.set_data(vec2).set_label(label2).set_type(type2).set_align(line1.align()).set_color(FL_BLACK);
+    if (line2.size() > 0) {
         _area->add_line(line2);
     }
-    if (vec3.size() > 0) {
-        line3.set_data(vec3).set_label(label3).set_type(type3).set_align(line1.align()).set_color(FL_BLACK);
+    if (line3.size() > 0) {
         _area->add_line(line3);
     }
     init_new_data();
@@ -5504,13 +8594,14 @@ void flw::chart::Chart::_create_tooltip(bool ctrl) {
     if (_area->right_scale().tick() < 10.0 ) {
         right_dec = util::count_decimals(_area->right_scale().tick()) + 1;
     }
-    while (start <= STOP && start < static_cast<int>(_dates.size())) {
+    while (start <= STOP && start < _tick_count()) {
         if (X >= x1 && X <= x1 + _tick_width - 1) {
             const Line* LINE = _area->selected_line();
-            const auto       DATE = gnu::Date(_dates[start].date);
-            std::string      date = DATE.format(gnu::Date::Format::DAY_MONTH_YEAR);
+            const auto       KEY  = _dates.key(start << _lod_level);
+            std::string      date = _date_cache.format(KEY, gnu::Date::Format::DAY_MONTH_YEAR);
             if (_date_range == DateRange::HOUR || _date_range == DateRange::MIN || _date_range == DateRange::SEC) {
-                 date += " - " + DATE.format(gnu::Date::Format::TIME_LONG);
+                 date += " - ";
+                 date += _date_cache.format(KEY, gnu::Date::Format::TIME_LONG);
             }
             _tooltip = date + "\n \n \n ";
             if (ctrl == false || LINE == nullptr || LINE->size() == 0 || LINE->is_visible() == false) {
@@ -5537,10 +8628,11 @@ void flw::chart::Chart::_create_tooltip(bool ctrl) {
                 }
             }
             else {
-                const size_t index = Point::BinarySearch(LINE->data(), _dates[start]);
+                auto         walk  = priv::_ChartWalk(*LINE, _dates, start, _lod_level);
+                const size_t index = walk.find(start);
                 if (index != static_cast<size_t>(-1)) {
                     const int         DEC   = (LINE->align() == FL_ALIGN_RIGHT) ? right_dec : left_dec;
-                    const Point&  DATA  = LINE->data()[index];
+                    const Point       DATA  = walk.series().point(index);
                     const std::string HIGH  = util::format_double(DATA.high, DEC, '\'');
                     const std::string LOW   = util::format_double(DATA.low, DEC, '\'');
                     const std::string CLOSE = util::format_double(DATA.close, DEC, '\'');
@@ -5554,23 +8646,21 @@ void flw::chart::Chart::_create_tooltip(bool ctrl) {
         start += 1;
     }
     if (_tooltip != "" || old != "") {
-        redraw();
+        damage(FL_DAMAGE_USER1);
     }
 }
 void flw::chart::Chart::debug() const {
 #ifdef DEBUG
     Point first, last, start, end;
     if (_dates.size() > 0) {
-        first = _dates.front();
+        first = _dates.point(0);
     }
     if (_dates.size() > 1) {
-        last = _dates.back();
-    }
-    if (static_cast<int>(_dates.size()) > _date_start) {
-        start = _dates[_date_start];
+        last = _dates.point(_dates.size() - 1);
     }
-    if (_ticks >= 0 && static_cast<int>(_dates.size()) > (_date_start + _ticks)) {
-        end = _dates[_date_start + _ticks];
+    if (_tick_count() > _date_start) {
+        start = _dates.point(_date_start << _lod_level);
+        end   = _dates.point(_last_date(_date_start + _ticks));
     }
     printf("\n");
     printf("--------------------------------------------\n");
@@ -5586,6 +8676,8 @@ void flw::chart::Chart::debug() const {
     printf("\tblock_dates:     %19d\n", static_cast<int>(_block_dates.size()));
     printf("\tdate_start:      %19d\n", _date_start);
     printf("\tdate_end:        %19d\n", _date_start + _ticks);
+    printf("\tlod:             %19s\n", _lod ? "YES" : "NO");
+    printf("\tlod_level:       %19d\n", _lod_level);
     printf("\tlabels:          %19s\n", _labels ? "YES" : "NO");
     printf("\thorizontal:      %19s\n", _horizontal ? "YES" : "NO");
     printf("\tvertical:        %19s\n", _vertical ? "YES" : "NO");
@@ -5607,19 +8699,19 @@ void flw::chart::Chart::debug_line() const {
         return;
     }
     const auto* line = _area->selected_line();
-    const auto& data = line->data();
-    int         curr = _date_start;
-    const int   stop = _date_start + _ticks;
+    const auto& data = line->view();
+    int         curr = _date_start << _lod_level;
+    const int   stop = _last_date(_date_start + _ticks);
     double      min  = 999'999'999'999'999;
     double      max  = -999'999'999'999'999;
     puts("");
     printf("%5s: %15s %23s %23s %23s\n", "COUNT", "DATE", "HIGH", "LOW", "CLOSE");
+    auto walk = priv::_ChartWalk(*line, _dates, curr);
     while (curr <= stop && curr < static_cast<int>(_dates.size())) {
-        auto& date  = _dates[curr];
-        auto  index = Point::BinarySearch(data, date);
+        auto index = walk.find(curr);
         if (index != static_cast<size_t>(-1)) {
-            auto& d = line->data()[index];
-            printf("%5d: %15s %23.8f %23.8f %23.8f\n", curr, date.date.c_str(), d.high, d.low, d.close);
+            auto d = data.point(index);
+            printf("%5d: %15s %23.8f %23.8f %23.8f\n", curr, d.date.c_str(), d.high, d.low, d.close);
             if (d.high > max) {
                 max = d.high;
             }
@@ -5643,10 +8735,56 @@ void flw::chart::Chart::draw() {
     if (_printing == true) {
         fl_line_style(FL_SOLID, 1);
         fl_rectf(x(), y(), w(), h(), FL_BACKGROUND2_COLOR);
+        _draw_layer();
+        _draw_tooltip();
+        fl_line_style(0);
+        return;
     }
-    else {
-        Fl_Group::draw();
+    const auto rect = Fl_Rect(x(), y(), w(), h() - _scroll->h());
+    if (rect.w() < 1 || rect.h() < 1) {
+        draw_children();
+        return;
+    }
+    if (_offscreen == 0 ||
+        (damage() & FL_DAMAGE_ALL) != 0 ||
+        rect.x() != _offscreen_rect.x() ||
+        rect.y() != _offscreen_rect.y() ||
+        rect.w() != _offscreen_rect.w() ||
+        rect.h() != _offscreen_rect.h()) {
+        if (_offscreen != 0 && (rect.w() != _offscreen_rect.w() || rect.h() != _offscreen_rect.h())) {
+            fl_delete_offscreen(_offscreen);
+            _offscreen = 0;
+        }
+        Fl_Image_Surface surface(rect.w(), rect.h(), 1, _offscreen);
+        if (_offscreen != 0) {
+            surface.rescale();
+        }
+        Fl_Surface_Device::push_current(&surface);
+        surface.origin(-rect.x(), -rect.y());
+        draw_box();
+        draw_label();
+        _draw_layer();
+        Fl_Surface_Device::pop_current();
+        _offscreen      = surface.get_offscreen_before_delete();
+        _offscreen_rect = rect;
+    }
+    fl_copy_offscreen(rect.x(), rect.y(), rect.w(), rect.h(), _offscreen, 0, 0);
+    draw_children();
+    _draw_tooltip();
+    fl_line_style(0);
+#ifdef DEBUG
+#endif
+}
+void flw::chart::Chart::_draw_label() {
+    if (_label == "") {
+        return;
     }
+    fl_color(FL_FOREGROUND_COLOR);
+    fl_font(flw::PREF_FIXED_FONT, _CH * 1.5);
+    fl_draw(_label.c_str(), x() + _areas[0].rect().x(), y(), _areas[0].rect().w(), _top_space, FL_ALIGN_CENTER | FL_ALIGN_INSIDE | FL_ALIGN_CLIP);
+    _FLW_CHART_DEBUG(fl_rect(x() + _areas[0].rect().x(), y(), _areas[0].rect().w() + 1, _top_space))
+}
+void flw::chart::Chart::_draw_layer() {
     if (_areas[0].rect().w() < 40 || h() < _top_space + _bottom_space + _CH) {
         fl_line_style(FL_SOLID, 1);
         fl_rect(x() + 12, y() + 12, w() - 24, h() - 36, FL_FOREGROUND_COLOR);
@@ -5671,19 +8809,6 @@ void flw::chart::Chart::draw() {
             _FLW_CHART_CLIP(fl_pop_clip())
         }
     }
-    _draw_tooltip();
-    fl_line_style(0);
-#ifdef DEBUG
-#endif
-}
-void flw::chart::Chart::_draw_label() {
-    if (_label == "") {
-        return;
-    }
-    fl_color(FL_FOREGROUND_COLOR);
-    fl_font(flw::PREF_FIXED_FONT, _CH * 1.5);
-    fl_draw(_label.c_str(), x() + _areas[0].rect().x(), y(), _areas[0].rect().w(), _top_space, FL_ALIGN_CENTER | FL_ALIGN_INSIDE | FL_ALIGN_CLIP);
-    _FLW_CHART_DEBUG(fl_rect(x() + _areas[0].rect().x(), y(), _areas[0].rect().w() + 1, _top_space))
 }
 void flw::chart::Chart::_draw_lines(Area& area) {
     for (const auto& line : area.lines()) {
@@ -5717,13 +8842,17 @@ void flw::chart::Chart::_draw_lines(Area& area) {
             fl_color(line.color());
             fl_line_style(style, width);
             width2 = (width > 1) ? width / 2 : width2;
-            while (date_c <= DATE_END && date_c < static_cast<int>(_dates.size())) {
-                const size_t INDEX = Point::BinarySearch(line.data(), _dates[date_c]);
+            auto        walk  = priv::_ChartWalk(line, _dates, date_c, _lod_level);
+            const auto& HIGH  = walk.series().high();
+            const auto& LOW   = walk.series().low();
+            const auto& CLOSE = walk.series().close();
+            const int   COUNT = _tick_count();
+            while (date_c <= DATE_END && date_c < COUNT) {
+                const size_t INDEX = walk.find(date_c);
                 if (INDEX != static_cast<size_t>(-1)) {
-                    const auto&  DATA = line.data()[INDEX];
-                    const double YH   = (DATA.high - SCALE_MIN) * SCALE_PIXEL;
-                    const double YL   = (DATA.low - SCALE_MIN) * SCALE_PIXEL;
-                    const double YC   = (DATA.close - SCALE_MIN) * SCALE_PIXEL;
+                    const double YH   = (HIGH[INDEX] - SCALE_MIN) * SCALE_PIXEL;
+                    const double YL   = (LOW[INDEX] - SCALE_MIN) * SCALE_PIXEL;
+                    const double YC   = (CLOSE[INDEX] - SCALE_MIN) * SCALE_PIXEL;
                     const int    YH2  = static_cast<int>(B1 - YH);
                     const int    YL2  = static_cast<int>(B1 - YL);
                     const int    YC2  = static_cast<int>(B1 - YC);
@@ -5896,8 +9025,9 @@ void flw::chart::Chart::_draw_xlabels() {
     _ver_pos[0] = -1;
     fl_font(flw::PREF_FIXED_FONT, CH2);
     cw2 = fl_width("X");
-    while (date_c <= DATE_END && date_c < static_cast<int>(_dates.size())) {
-        const auto date  = gnu::Date(_dates[date_c].date.c_str());
+    const int  COUNT    = _tick_count();
+    while (date_c <= DATE_END && date_c < COUNT) {
+        const auto date  = _dates.key(date_c << _lod_level).to_date();
         bool       addv  = false;
         int        month = 1;
         *buffer1 = 0;
@@ -5934,7 +9064,7 @@ void flw::chart::Chart::_draw_xlabels() {
                 addv = true;
                 last = date.day();
                 if (x1 >= x_last) {
-                    snprintf(buffer1, 100, "%04d-%02d-%02d", date.year(), date.month(), date.day());
+                    date.format_to(buffer1, 100, gnu::Date::Format::ISO_LONG);
                 }
                 else {
                     month = 3;
@@ -6107,11 +9237,11 @@ int flw::chart::Chart::handle(int event) {
     else if (event == FL_MOVE) {
         if (_tooltip != "") {
             _tooltip = "";
-            redraw();
+            damage(FL_DAMAGE_USER1);
         }
     }
     else if (event == FL_MOUSEWHEEL) {
-        const double size = _dates.size() - _ticks;
+        const double size = _tick_count() - _ticks;
         const double pos  = _scroll->value();
         const double dy   = (Fl::event_dy() * 10.0);
         const double dx   = (Fl::event_dx() * 10.0);
@@ -6122,10 +9252,22 @@ int flw::chart::Chart::handle(int event) {
         }
         else if (Fl::event_ctrl() > 0) {
             const int width = (adj > 0.0) ? _tick_width + 1 : _tick_width - 1;
-            if (width >= chart::MIN_TICK && width <= chart::MAX_TICK) {
+            if (_lod == true && adj > 0.0 && _lod_level > 0) {
+                _lod_level--;
+                _date_start *= 2;
+                static_cast<Fl_Slider*>(_scroll)->value(_date_start);
+                init();
+            }
+            else if (width >= chart::MIN_TICK && width <= chart::MAX_TICK) {
                 set_tick_width(width);
                 init();
             }
+            else if (_lod == true && width < chart::MIN_TICK && _tick_count() > _ticks) {
+                _lod_level++;
+                _date_start /= 2;
+                static_cast<Fl_Slider*>(_scroll)->value(_date_start);
+                init();
+            }
             return 1;
         }
         else {
@@ -6161,11 +9303,17 @@ void flw::chart::Chart::_init(bool calc_dates) {
     *const_cast<int*>(&_CH) = flw::PREF_FIXED_FONTSIZE;
     if (calc_dates == true) {
         WaitCursor wc;
-        _calc_dates();
+        if (_calc_dates() == true) {
+            _calc_index(true);
+        }
         _margin_left  = priv::_CHART_MIN_MARGIN;
         _margin_right = priv::_CHART_MIN_MARGIN;
         kludge++;
     }
+    _calc_index(false);
+    if (calc_dates == true && _lod == true) {
+        _lod_fit = true;
+    }
     while (kludge <= 1) {
         _calc_area_width();
         _calc_area_height();
@@ -6175,6 +9323,8 @@ void flw::chart::Chart::_init(bool calc_dates) {
         _calc_area_width();
         kludge--;
     }
+    _lod_fit = false;
+    _calc_lod();
     redraw();
 #ifdef DEBUG
 #endif
@@ -6197,6 +9347,10 @@ flw::StringVector flw::chart::Chart::_label_array(const Area& area, LabelType la
     }
     return res;
 }
+int flw::chart::Chart::_last_date(int tick) const {
+    const int64_t last = ((static_cast<int64_t>(tick) + 1) << _lod_level) - 1;
+    return static_cast<int>(std::min(last, static_cast<int64_t>(_dates.size()) - 1));
+}
 bool flw::chart::Chart::load_json() {
     auto filename = util::to_string(fl_file_chooser("Select JSON File", "All Files (*)\tJSON Files (*.json)", ""));
     if (util::is_empty(filename) == true) {
@@ -6235,6 +9389,7 @@ bool flw::chart::Chart::load_json(const std::string& filename) {
                 else if (j2->name() == "labels" && j2->is_bool() == true)       set_line_labels(j2->vb());
                 else if (j2->name() == "horizontal" && j2->is_bool() == true)   set_hor_lines(j2->vb());
                 else if (j2->name() == "vertical" && j2->is_bool() == true)     set_ver_lines(j2->vb());
+                else if (j2->name() == "lod" && j2->is_bool() == true)          set_lod(j2->vb());
                 else _FLW_CHART_ERROR(j2)
             }
         }
@@ -6263,7 +9418,7 @@ bool flw::chart::Chart::load_json(const std::string& filename) {
         }
         else if (j->name() == "flw::chart::lines" && j->is_array() == true) {
             for (const auto j2 : *j->va()) {
-                int             line[5]  = { 0, 0, 0, 0, 1 };
+                int             line[6]  = { 0, 0, 0, 0, 1, 0 };
                 std::string     label;
                 std::string     type;
                 PointVector vec;
@@ -6273,6 +9428,10 @@ bool flw::chart::Chart::load_json(const std::string& filename) {
                             line[1] = l->vn_i();
                             if (line[1] < 0 || line[1] > static_cast<int>(AreaNum::LAST)) _FLW_CHART_ERROR(l)
                         }
+                        else if (l->name() == "aggregate" && l->is_number() == true) {
+                            line[5] = l->vn_i();
+                            if (line[5] < 0 || line[5] > static_cast<int>(Aggregate::LAST)) _FLW_CHART_ERROR(l)
+                        }
                         else if (l->name() == "align" && l->is_number() == true)      line[0]  = l->vn_i();
                         else if (l->name() == "color" && l->is_number() == true)      line[2]  = l->vn_i();
                         else if (l->name() == "label" && l->is_string() == true)      label    = l->vs_u();
@@ -6293,6 +9452,7 @@ bool flw::chart::Chart::load_json(const std::string& filename) {
                 auto l = Line(vec, label);
                 auto a = static_cast<AreaNum>(line[1]);
                 l.set_align(line[0]).set_color(line[2]).set_label(label).set_width(line[3]).set_type_from_string(type).set_visible(line[4]);
+                l.set_aggregate(static_cast<Aggregate>(line[5]));
                 area(a).add_line(l);
             }
         }
@@ -6319,18 +9479,103 @@ bool flw::chart::Chart::load_line_from_csv() {
     if (util::is_empty(filename) == true) {
         return false;
     }
-    auto vec = Point::LoadCSV(filename);
-    if (vec.size() == 0) {
+    auto series = Series::LoadCSV(filename);
+    if (series.size() == 0) {
         dlg::msg_alert("Chart", "No data!");
         return false;
     }
-    auto line = Line(vec, filename);
+    auto line = Line();
+    line.set_data(std::move(series)).set_label(filename);
     line.set_color(FL_BLUE);
     priv::_ChartLineSetup(top_window(), line).run();
     _area->add_line(line);
     init_new_data();
     return true;
 }
+bool flw::chart::Chart::load_snapshot() {
+    auto filename = util::to_string(fl_file_chooser("Select Snapshot File", "All Files (*)\tSnapshot Files (*.flwc)", ""));
+    if (util::is_empty(filename) == true) {
+        return false;
+    }
+    return load_snapshot(filename);
+}
+bool flw::chart::Chart::load_snapshot(const std::string& filename, size_t page_budget) {
+    #define _FLW_CHART_SNAPSHOT_ERROR() { dlg::msg_alert("Chart", util::format("Illegal chart snapshot %s", filename.c_str())); reset(); return false; }
+    _filename = "";
+    reset();
+    redraw();
+    auto wc    = WaitCursor();
+    auto pages = std::make_shared<SeriesPages>(filename, page_budget);
+    if (pages->file().is_open() == false) {
+        dlg::msg_alert("Chart", util::format("Failed to load %s", filename.c_str()));
+        return false;
+    }
+    auto reader = priv::_ChartSnapshotReader(pages->file().data(), pages->file().size());
+    auto magic  = reader.array<char>(sizeof(priv::_CHART_SNAPSHOT_MAGIC));
+    if (magic == nullptr || memcmp(magic, priv::_CHART_SNAPSHOT_MAGIC, sizeof(priv::_CHART_SNAPSHOT_MAGIC)) != 0) _FLW_CHART_SNAPSHOT_ERROR()
+    auto version = reader.get<uint32_t>();
+    if (reader.get<uint32_t>() != priv::_CHART_SNAPSHOT_ORDER) _FLW_CHART_SNAPSHOT_ERROR()
+    else if (version != chart::SNAPSHOT_VERSION) { dlg::msg_alert("Chart", util::format("Wrong chart version!\nI expected version %d but the snapshot file had version %u!", chart::SNAPSHOT_VERSION, version)); reset(); return false; }
+    auto tick_width = reader.get<int32_t>();
+    auto range      = reader.get<int32_t>();
+    if (range < 0 || range > static_cast<int>(DateRange::LAST)) _FLW_CHART_SNAPSHOT_ERROR()
+    set_tick_width(tick_width);
+    set_date_range(static_cast<DateRange>(range));
+    set_line_labels(reader.get<uint8_t>() != 0);
+    set_hor_lines(reader.get<uint8_t>() != 0);
+    set_ver_lines(reader.get<uint8_t>() != 0);
+    set_lod(reader.get<uint8_t>() != 0);
+    set_main_label(reader.str());
+    unsigned percent[5] = { 0 };
+    if (reader.get<uint32_t>() != _areas.size()) _FLW_CHART_SNAPSHOT_ERROR()
+    for (size_t f = 0; f < _areas.size(); f++) {
+        percent[f] = reader.get<uint32_t>();
+        auto has_min = reader.get<uint8_t>();
+        auto min     = reader.get<double>();
+        auto has_max = reader.get<uint8_t>();
+        auto max     = reader.get<double>();
+        if (has_min != 0) _areas[f].set_min_clamp(min);
+        if (has_max != 0) _areas[f].set_max_clamp(max);
+    }
+    if (reader.err() == true || set_area_size(percent[0], percent[1], percent[2], percent[3], percent[4]) == false) _FLW_CHART_SNAPSHOT_ERROR()
+    auto lines = reader.get<uint32_t>();
+    for (uint32_t f = 0; f < lines && reader.err() == false; f++) {
+        auto area    = reader.get<int32_t>();
+        auto align   = reader.get<int32_t>();
+        auto color   = reader.get<uint32_t>();
+        auto width   = reader.get<uint32_t>();
+        auto visible = reader.get<uint8_t>();
+        auto resamp  = reader.get<uint8_t>();
+        auto label   = reader.str();
+        auto type    = reader.str();
+        auto size    = reader.get<uint64_t>();
+        auto keys    = reader.array<int64_t>(size);
+        auto high    = reader.array<double>(size);
+        auto low     = reader.array<double>(size);
+        auto close   = reader.array<double>(size);
+        auto series  = Series();
+        if (reader.err() == true || area < 0 || area > static_cast<int>(AreaNum::LAST) || resamp > static_cast<int>(Aggregate::LAST)) _FLW_CHART_SNAPSHOT_ERROR()
+        else if (series.assign(keys, high, low, close, size, (page_budget > 0) ? pages : nullptr) == false) _FLW_CHART_SNAPSHOT_ERROR()
+        auto line = Line();
+        line.set_data(std::move(series)).set_align(align).set_color(color).set_label(label).set_width(width).set_type_from_string(type).set_visible(visible != 0);
+        line.set_aggregate(static_cast<Aggregate>(resamp));
+        this->area(static_cast<AreaNum>(area)).add_line(line);
+    }
+    auto blocks = reader.get<uint64_t>();
+    auto keys   = reader.array<int64_t>(blocks);
+    auto dates  = PointVector();
+    if (reader.err() == true) _FLW_CHART_SNAPSHOT_ERROR()
+    for (uint64_t f = 0; f < blocks; f++) {
+        auto date = priv::_chart_key_date(gnu::DateKey::FromSeconds(keys[f]));
+        if (date == "") _FLW_CHART_SNAPSHOT_ERROR()
+        dates.push_back(Point(date));
+    }
+    set_block_dates(dates);
+    init_new_data();
+    _filename = filename;
+    return true;
+    #undef _FLW_CHART_SNAPSHOT_ERROR
+}
 bool flw::chart::Chart::_move_or_delete_line(Area* area, size_t index, bool move, AreaNum destination) {
     if (area == nullptr || index >= area->size()) {
         return false;
@@ -6363,6 +9608,7 @@ void flw::chart::Chart::reset() {
     static_cast<Fl_Valuator*>(_scroll)->value(0);
     _block_dates.clear();
     _dates.clear();
+    _dates_block.clear();
     for (auto& area : _areas) {
         area.reset();
     }
@@ -6386,6 +9632,7 @@ void flw::chart::Chart::reset() {
     set_hor_lines();
     set_main_label();
     set_line_labels();
+    set_lod(false);
     set_tick_width();
     set_ver_lines();
     init();
@@ -6419,6 +9666,7 @@ bool flw::chart::Chart::save_json(const std::string& filename, double max_diff_h
                 jsb << gnu::json::Builder::MakeBool(_labels, "labels");
                 jsb << gnu::json::Builder::MakeBool(_horizontal, "horizontal");
                 jsb << gnu::json::Builder::MakeBool(_vertical, "vertical");
+                jsb << gnu::json::Builder::MakeBool(_lod, "lod");
             jsb.end();
             jsb << gnu::json::Builder::MakeObject("flw::chart::areas");
             for (size_t f = 0; f <= static_cast<int>(AreaNum::LAST); f++) {
@@ -6445,8 +9693,10 @@ bool flw::chart::Chart::save_json(const std::string& filename, double max_diff_h
                                 jsb << gnu::json::Builder::MakeNumber(line.color(), "color");
                                 jsb << gnu::json::Builder::MakeNumber(line.width(), "width");
                                 jsb << gnu::json::Builder::MakeBool(line.is_visible(), "visible");
+                                if (line.aggregate() != Aggregate::NONE) jsb << gnu::json::Builder::MakeNumber(static_cast<int>(line.aggregate()), "aggregate");
                                 jsb << gnu::json::Builder::MakeArray("yx");
-                                for (const auto& data : line.data()) {
+                                for (size_t f = 0; f < line.size(); f++) {
+                                    const auto data = line.series().point(f);
                                     jsb << gnu::json::Builder::MakeArrayInline();
                                         jsb << gnu::json::Builder::MakeString(data.date);
                                         if (fabs(data.close - data.low) > max_diff_high_low || fabs(data.close - data.high) > max_diff_high_low) {
@@ -6490,21 +9740,21 @@ bool flw::chart::Chart::save_line_to_csv() {
     const auto* line   = _area->selected_line();
     const auto  answer = dlg::msg_ask("Chart", "Select range.\nSave all data or only those in view?", "View", "All");
     auto        data   = PointVector();
-    const auto& ldata  = line->data();
+    const auto& ldata  = line->view();
     if (answer == "View") {
-        auto curr = _date_start;
-        auto stop = _date_start + _ticks;
+        auto curr = _date_start << _lod_level;
+        auto stop = _last_date(_date_start + _ticks);
+        auto walk = priv::_ChartWalk(*line, _dates, curr);
         while (curr <= stop && curr < static_cast<int>(_dates.size())) {
-            auto& date  = _dates[curr];
-            auto  index = Point::BinarySearch(ldata, date);
+            auto index = walk.find(curr);
             if (index != static_cast<size_t>(-1)) {
-                data.push_back(ldata[index]);
+                data.push_back(ldata.point(index));
             }
             curr++;
         }
     }
     else {
-        data = ldata;
+        data = line->points();
     }
     if (data.size() == 0) {
         dlg::msg_alert("Chart", "No data!");
@@ -6517,6 +9767,88 @@ bool flw::chart::Chart::save_line_to_csv() {
 bool flw::chart::Chart::save_png() {
     return util::png_save(top_window(), "", x() + 1,  y() + 1,  w() - 2,  h() - _scroll->h() - 1);
 }
+bool flw::chart::Chart::save_snapshot() {
+    auto filename = util::to_string(fl_file_chooser("Save To Snapshot File", "All Files (*)\tSnapshot Files (*.flwc)", ""));
+    if (util::is_empty(filename) == true) {
+        return false;
+    }
+    return save_snapshot(filename);
+}
+bool flw::chart::Chart::save_snapshot(const std::string& filename) {
+    auto     wc    = WaitCursor();
+    auto     buf   = std::string();
+    size_t   size  = 256;
+    uint32_t lines = 0;
+    for (const auto& area : _areas) {
+        for (const auto& line : area.lines()) {
+            if (line.size() > 0) {
+                size += line.size() * 32 + line.label().length() + 64;
+                lines++;
+            }
+        }
+    }
+    buf.reserve(size + _block_dates.size() * 8);
+    priv::_chart_snapshot_put(buf, priv::_CHART_SNAPSHOT_MAGIC, sizeof(priv::_CHART_SNAPSHOT_MAGIC));
+    priv::_chart_snapshot_put(buf, static_cast<uint32_t>(chart::SNAPSHOT_VERSION));
+    priv::_chart_snapshot_put(buf, priv::_CHART_SNAPSHOT_ORDER);
+    priv::_chart_snapshot_put(buf, static_cast<int32_t>(_tick_width));
+    priv::_chart_snapshot_put(buf, static_cast<int32_t>(_date_range));
+    priv::_chart_snapshot_put(buf, static_cast<uint8_t>(_labels));
+    priv::_chart_snapshot_put(buf, static_cast<uint8_t>(_horizontal));
+    priv::_chart_snapshot_put(buf, static_cast<uint8_t>(_vertical));
+    priv::_chart_snapshot_put(buf, static_cast<uint8_t>(_lod));
+    priv::_chart_snapshot_put(buf, _label);
+    priv::_chart_snapshot_put(buf, static_cast<uint32_t>(_areas.size()));
+    for (const auto& area : _areas) {
+        auto min = area.clamp_min();
+        auto max = area.clamp_max();
+        priv::_chart_snapshot_put(buf, static_cast<uint32_t>(area.percent()));
+        priv::_chart_snapshot_put(buf, static_cast<uint8_t>(min.has_value()));
+        priv::_chart_snapshot_put(buf, min.value_or(0.0));
+        priv::_chart_snapshot_put(buf, static_cast<uint8_t>(max.has_value()));
+        priv::_chart_snapshot_put(buf, max.value_or(0.0));
+    }
+    priv::_chart_snapshot_put(buf, lines);
+    for (const auto& area : _areas) {
+        for (const auto& line : area.lines()) {
+            if (line.size() == 0) {
+                continue;
+            }
+            const auto& series = line.series();
+            priv::_chart_snapshot_put(buf, static_cast<int32_t>(area.area()));
+            priv::_chart_snapshot_put(buf, static_cast<int32_t>(line.align()));
+            priv::_chart_snapshot_put(buf, static_cast<uint32_t>(line.color()));
+            priv::_chart_snapshot_put(buf, static_cast<uint32_t>(line.width()));
+            priv::_chart_snapshot_put(buf, static_cast<uint8_t>(line.is_visible()));
+            priv::_chart_snapshot_put(buf, static_cast<uint8_t>(line.aggregate()));
+            priv::_chart_snapshot_put(buf, line.label());
+            priv::_chart_snapshot_put(buf, line.type_to_string());
+            priv::_chart_snapshot_put(buf, static_cast<uint64_t>(series.size()));
+            priv::_chart_snapshot_align(buf);
+            priv::_chart_snapshot_put(buf, series.keys().data(), series.size() * sizeof(int64_t));
+            priv::_chart_snapshot_put(buf, series.high().data(), series.size() * sizeof(double));
+            priv::_chart_snapshot_put(buf, series.low().data(), series.size() * sizeof(double));
+            priv::_chart_snapshot_put(buf, series.close().data(), series.size() * sizeof(double));
+        }
+    }
+    std::vector<int64_t> blocks;
+    for (const auto& block : _block_dates) {
+        auto key = priv::_CHART_DATE_PARSER.parse(block.date);
+        if (key.is_invalid() == false) {
+            blocks.push_back(key.seconds());
+        }
+    }
+    priv::_chart_snapshot_put(buf, static_cast<uint64_t>(blocks.size()));
+    priv::_chart_snapshot_align(buf);
+    for (auto key : blocks) {
+        priv::_chart_snapshot_put(buf, key);
+    }
+    auto res = gnu::file::write(filename, buf.c_str(), buf.length());
+    if (res == true) {
+        _filename = filename;
+    }
+    return res;
+}
 bool flw::chart::Chart::set_area_size(unsigned area1, unsigned area2, unsigned area3, unsigned area4, unsigned area5) {
     _area = nullptr;
     _areas[0].set_percent(100);
@@ -6551,6 +9883,13 @@ bool flw::chart::Chart::set_area_size(unsigned area1, unsigned area2, unsigned a
     }
     return false;
 }
+void flw::chart::Chart::set_lod(bool val) {
+    static_cast<Fl_Valuator*>(_scroll)->value(0);
+    _date_start = 0;
+    _lod        = val;
+    _lod_fit    = val;
+    _lod_level  = 0;
+}
 void flw::chart::Chart::setup_area() {
     auto list = StringVector() = {"One", "Two Equal Size", "Two (60%, 40%)", "Three Equal Size", "Three (50%, 25%, 25%)", "Four Equal Size", "Four (40%, 20%, 20%, 20%)", "Five Equal Size", "Five (40%, 15%, 15%, 15%, 15%)"};
     switch (dlg::select_choice("Chart", "Select number of chart areas", list, 0)) {
@@ -6757,10 +10096,17 @@ void flw::chart::Chart::setup_show_or_hide_lines() {
     init_new_data();
 }
 void flw::chart::Chart::setup_view_options() {
+    const bool lod = menu::item_value(_menu, priv::_CHART_LABEL_SHOW_LOD);
     _labels     = menu::item_value(_menu, priv::_CHART_LABEL_SHOW_LABELS);
     _vertical   = menu::item_value(_menu, priv::_CHART_LABEL_SHOW_VLINES);
     _horizontal = menu::item_value(_menu, priv::_CHART_LABEL_SHOW_HLINES);
-    redraw();
+    if (lod != _lod) {
+        set_lod(lod);
+        init();
+    }
+    else {
+        redraw();
+    }
 }
 void flw::chart::Chart::_show_menu() {
     if (_disable_menu == true) {
@@ -6780,6 +10126,7 @@ void flw::chart::Chart::_show_menu() {
 #endif
     menu::set_item(_menu, priv::_CHART_LABEL_SHOW_HLINES, _horizontal);
     menu::set_item(_menu, priv::_CHART_LABEL_SHOW_LABELS, _labels);
+    menu::set_item(_menu, priv::_CHART_LABEL_SHOW_LOD, _lod);
     menu::set_item(_menu, priv::_CHART_LABEL_SHOW_VLINES, _vertical);
     if (_area != nullptr) {
         menu::enable_item(_menu, priv::_CHART_LABEL_ADD_CSV, true);
@@ -6801,6 +10148,10 @@ void flw::chart::Chart::_show_menu() {
     }
     _menu->popup();
 }
+int flw::chart::Chart::_tick_count() const {
+    const int64_t size = static_cast<int64_t>(_dates.size());
+    return static_cast<int>((size + (static_cast<int64_t>(1) << _lod_level) - 1) >> _lod_level);
+}
 void flw::chart::Chart::update_pref() {
     _menu->textfont(flw::PREF_FONT);
     _menu->textsize(flw::PREF_FONTSIZE);
@@ -10240,6 +13591,16 @@ static const int         _PLOT_TICK_SIZE          = 4;
 static const char* const _PLOT_LABEL_DEBUG        = "Debug";
 static const char* const _PLOT_LABEL_DEBUG_LINE   = "Debug Line";
 #endif
+static void _plot_csv_row(size_t chunk, const gnu::file::CSVField* fields, size_t count, void* data) {
+    if (count != 2) {
+        return;
+    }
+    auto vec   = static_cast<std::vector<plot::PointVector>*>(data);
+    auto point = plot::Point(fields[0].to_double(), fields[1].to_double());
+    if (point.is_valid() == true) {
+        (*vec)[chunk].push_back(point);
+    }
+}
 class _PlotLineSetup : public Fl_Double_Window {
 public:
     plot::Line&                 _line;
@@ -10392,21 +13753,21 @@ void flw::plot::Point::Debug(const PointVector& in) {
 #endif
 }
 flw::plot::PointVector flw::plot::Point::LoadCSV(const std::string& filename, const std::string& sep) {
-    auto buf = gnu::file::read(filename);
-    if (buf.size() < 3) {
-        return PointVector();
+    gnu::file::CSVReader     reader(sep);
+    std::vector<PointVector> chunks;
+    PointVector              res;
+    size_t                   size = 0;
+    if (reader.open(filename) == false || reader.size() < 3) {
+        return res;
     }
-    std::string  str   = buf.c_str();
-    StringVector lines = util::split_string(str, "\n");
-    PointVector  res;
-    for (const auto& l : lines) {
-        StringVector line = util::split_string(l, sep);
-        if (line.size() == 2) {
-            auto data = Point(util::to_double(line[0]), util::to_double(line[1]));
-            if (data.is_valid() == true) {
-                res.push_back(data);
-            }
-        }
+    chunks.resize(reader.split());
+    reader.parse(priv::_plot_csv_row, &chunks);
+    for (const auto& chunk : chunks) {
+        size += chunk.size();
+    }
+    res.reserve(size);
+    for (const auto& chunk : chunks) {
+        res.insert(res.end(), chunk.begin(), chunk.end());
     }
     return res;
 }
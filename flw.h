@@ -3,8 +3,11 @@
 #ifndef FLW_H
 #define FLW_H
 #include <cstdint>
+#include <functional>
 #include <string>
+#include <vector>
 namespace gnu {
+class DateKey;
 class Date {
 public:
     enum class UTC {
@@ -91,8 +94,10 @@ public:
     int                         diff_months(const Date& other) const;
     int64_t                     diff_seconds(const Date& other) const;
     std::string                 format(Format format = Format::ISO) const;
+    size_t                      format_to(char* buffer, size_t size, Format format = Format::ISO) const;
     int                         hour() const
                                     { return _hour; }
+    DateKey                     key() const;
     bool                        is_invalid() const
                                     { return _year == 0 || _month == 0 || _day == 0; }
     bool                        is_leapyear() const;
@@ -123,8 +128,13 @@ public:
     const char*                 weekday_name_short() const;
     int                         year() const
                                     { return _year; }
+    static size_t               AddDays(std::vector<Date>& dates, int days);
+    static size_t               AddMonths(std::vector<Date>& dates, int months);
+    static size_t               AddSeconds(std::vector<Date>& dates, int64_t seconds);
     static inline bool          CompareDates(const Date& a, const Date& b)
                                     { return a.compare(b) < 0; }
+    static std::vector<int>     DiffDays(const Date& from, const std::vector<Date>& dates);
+    static std::vector<Date>    Serie(const Date& start, const Date& stop, int days = 1);
 private:
     short                       _year;
     char                        _month;
@@ -133,6 +143,93 @@ private:
     char                        _min;
     char                        _sec;
 };
+class DateKey {
+public:
+    static const int64_t        INVALID = INT64_MIN;
+                                DateKey()
+                                    { _sec = DateKey::INVALID; }
+    explicit                    DateKey(const Date& date);
+                                DateKey(int year, int month, int day, int hour = 0, int min = 0, int sec = 0);
+    bool                        operator<(const DateKey& other) const
+                                    { return _sec < other._sec; }
+    bool                        operator<=(const DateKey& other) const
+                                    { return _sec <= other._sec; }
+    bool                        operator>(const DateKey& other) const
+                                    { return _sec > other._sec; }
+    bool                        operator>=(const DateKey& other) const
+                                    { return _sec >= other._sec; }
+    bool                        operator==(const DateKey& other) const
+                                    { return _sec == other._sec; }
+    bool                        operator!=(const DateKey& other) const
+                                    { return _sec != other._sec; }
+    int64_t                     days() const;
+    size_t                      hash() const
+                                    { return std::hash<int64_t>()(_sec); }
+    bool                        is_invalid() const
+                                    { return _sec == DateKey::INVALID; }
+    int64_t                     seconds() const
+                                    { return _sec; }
+    Date                        to_date() const;
+    static inline DateKey       FromSeconds(int64_t seconds)
+                                    { auto res = DateKey(); res._sec = seconds; return res; }
+private:
+    int64_t                     _sec;
+};
+class DateParser {
+public:
+    explicit                    DateParser(Date::US us = Date::US::OFF);
+    explicit                    DateParser(Date::Format format, Date::US us = Date::US::OFF);
+    bool                        detect(const std::string& sample)
+                                    { return detect(sample.c_str(), sample.length()); }
+    bool                        detect(const char* sample, size_t len);
+    bool                        is_fixed() const
+                                    { return _layout >= 0; }
+    const char*                 layout() const;
+    DateKey                     parse(const std::string& string) const
+                                    { return parse(string.c_str(), string.length()); }
+    DateKey                     parse(const char* string, size_t len) const;
+    std::vector<DateKey>        parse(const std::vector<std::string>& column);
+    DateKey                     parse_fixed(const std::string& string) const
+                                    { return parse_fixed(string.c_str(), string.length()); }
+    DateKey                     parse_fixed(const char* string, size_t len) const;
+    void                        reset()
+                                    { _layout = -1; _detected = false; }
+private:
+    int                         _layout;
+    Date::US                    _us;
+    bool                        _detected;
+};
+class DateCache {
+public:
+    static const size_t         TEXT_SIZE = 40;
+    explicit                    DateCache(size_t size = 256);
+    void                        clear();
+    const char*                 format(const DateKey& key, Date::Format format = Date::Format::ISO);
+    const char*                 format(const Date& date, Date::Format format = Date::Format::ISO)
+                                    { return this->format(date.key(), format); }
+    size_t                      hits() const
+                                    { return _hits; }
+    size_t                      misses() const
+                                    { return _misses; }
+    size_t                      size() const
+                                    { return _slots.size(); }
+private:
+    struct Slot {
+        int64_t                 key;
+        int                     format;
+        char                    text[TEXT_SIZE];
+    };
+    size_t                      _hits;
+    size_t                      _misses;
+    std::vector<Slot>           _slots;
+};
+}
+namespace std {
+    template<>
+    struct hash<gnu::DateKey> {
+        size_t operator()(const gnu::DateKey& key) const
+            { return key.hash(); }
+    };
 }
 #include <cassert>
 #include <cstdint>
@@ -140,11 +237,39 @@ private:
 #include <string>
 #include <vector>
 #include <array>
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
 namespace gnu {
 namespace file {
+class AsyncWriter;
+class CSVReader;
 class File;
 class Buf;
+class MMap;
+class Process;
+class Watcher;
+struct CSVField;
+enum class Event {
+    CREATED,
+    MODIFIED,
+    DELETED,
+    RENAMED,
+};
+enum class ProcessStatus {
+    READY,
+    RUNNING,
+    DONE,
+    TIMEOUT,
+    CANCELED,
+    FAILED,
+};
 typedef bool (*CallbackCopy)(int64_t size, int64_t copied, void* data);
+typedef void (*CallbackLine)(const char* line, size_t size, void* data);
+typedef void (*CallbackWatch)(Event event, const std::string& path, const std::string& from, void* data);
+typedef void (*CallbackCSV)(size_t chunk, const CSVField* fields, size_t count, void* data);
 typedef std::vector<File> Files;
 enum class Type {
     MISSING,
@@ -173,6 +298,7 @@ void                            flush(FILE* file);
 File                            home_dir();
 bool                            is_circular(const std::string& path);
 File                            linkname(const std::string& path);
+Files                           make_files(const std::vector<std::string>& paths, bool realpath = false);
 bool                            mkdir(const std::string& path);
 FILE*                           open(const std::string& path, const std::string& mode);
 std::string                     os();
@@ -182,11 +308,15 @@ Buf*                            read2(const std::string& path);
 Files                           read_dir(const std::string& path);
 Files                           read_dir_rec(const std::string& path);
 bool                            redirect_stderr();
+bool                            redirect_stderr(size_t max_size, CallbackLine callback = nullptr, void* data = nullptr);
 bool                            redirect_stdout();
+bool                            redirect_stdout(size_t max_size, CallbackLine callback = nullptr, void* data = nullptr);
 bool                            remove(const std::string& path);
 bool                            remove_rec(const std::string& path);
 bool                            rename(const std::string& from, const std::string& to);
 int                             run(const std::string& cmd, bool background, bool hide_win32_window = false);
+void                            stat_cache(unsigned ttl_ms);
+void                            stat_cache_clear(const std::string& path = "");
 File                            tmp_dir();
 File                            tmp_file(const std::string& prepend = "");
 File                            work_dir();
@@ -324,6 +454,172 @@ private:
     std::string                 _name;
     std::string                 _path;
 };
+class AsyncWriter {
+public:
+    static const size_t         MAX_BATCH = 64;
+    explicit                    AsyncWriter(bool atomic = true, bool flush = true);
+                                ~AsyncWriter();
+                                AsyncWriter(const AsyncWriter&) = delete;
+                                AsyncWriter(AsyncWriter&&) = delete;
+    AsyncWriter&                operator=(const AsyncWriter&) = delete;
+    AsyncWriter&                operator=(AsyncWriter&&) = delete;
+    bool                        atomic() const
+                                    { return _atomic; }
+    size_t                      errors() const
+                                    { std::lock_guard<std::mutex> lock(_mutex); return _errors; }
+    size_t                      pending() const
+                                    { std::lock_guard<std::mutex> lock(_mutex); return _jobs.size() + _busy; }
+    void                        wait();
+    bool                        write(const std::string& path, Buf&& buf);
+    bool                        write(const std::string& path, const char* buffer, size_t size)
+                                    { return write(path, Buf(buffer, size)); }
+private:
+    void                        _run();
+    bool                        _atomic;
+    bool                        _flush;
+    bool                        _stop;
+    mutable std::mutex          _mutex;
+    size_t                      _busy;
+    size_t                      _errors;
+    std::condition_variable     _done;
+    std::condition_variable     _work;
+    std::map<std::string, Buf>  _jobs;
+    std::thread                 _thread;
+};
+class Process {
+public:
+                                Process();
+                                ~Process();
+                                Process(const Process&) = delete;
+                                Process(Process&&) = delete;
+    Process&                    operator=(const Process&) = delete;
+    Process&                    operator=(Process&&) = delete;
+    void                        cancel();
+    std::string                 err() const
+                                    { return (is_running() == false) ? _err : ""; }
+    int                         exit_code() const
+                                    { return _exit; }
+    bool                        is_running() const
+                                    { return _status == ProcessStatus::RUNNING; }
+    std::string                 out() const
+                                    { return (is_running() == false) ? _out : ""; }
+    bool                        start(const std::string& cmd, CallbackLine cb_out = nullptr, CallbackLine cb_err = nullptr, void* data = nullptr, unsigned timeout_ms = 0, bool lines = true);
+    ProcessStatus               status() const
+                                    { return _status; }
+    ProcessStatus               wait();
+private:
+    void                        _deliver(bool is_err, const char* buffer, size_t size);
+    void                        _flush();
+    void                        _run(std::string cmd);
+    CallbackLine                _cb_err;
+    CallbackLine                _cb_out;
+    bool                        _lines;
+    int                         _exit;
+    int                         _wake[2];
+    std::atomic<bool>           _cancel;
+    std::atomic<ProcessStatus>  _status;
+    std::string                 _err;
+    std::string                 _out;
+    std::thread                 _thread;
+    unsigned                    _timeout;
+    void*                       _data;
+};
+class Watcher {
+public:
+    explicit                    Watcher(CallbackWatch callback, void* data = nullptr, bool polling = false);
+                                ~Watcher();
+                                Watcher(const Watcher&) = delete;
+                                Watcher(Watcher&&) = delete;
+    Watcher&                    operator=(const Watcher&) = delete;
+    Watcher&                    operator=(Watcher&&) = delete;
+    bool                        add(const std::string& path);
+    int                         fd() const
+                                    { return _fd; }
+    bool                        is_polling() const
+                                    { return _fd < 0; }
+    std::vector<std::string>    paths() const;
+    size_t                      poll();
+    bool                        remove(const std::string& path);
+private:
+    struct Stat {
+        Type                    type;
+        int64_t                 mtime;
+        int64_t                 size;
+    };
+    size_t                      _emit(Event event, const std::string& path, const std::string& from = "");
+    bool                        _is_watched(const std::string& path) const;
+    size_t                      _poll_inotify();
+    size_t                      _poll_stat();
+    void                        _scan(const std::string& path, bool is_dir, std::map<std::string, Stat>& stats) const;
+    CallbackWatch               _callback;
+    int                         _fd;
+    void*                       _data;
+    std::map<std::string, bool> _paths;
+    std::map<std::string, Stat> _stats;
+    std::map<int, std::string>  _wds;
+};
+class MMap {
+public:
+    explicit                    MMap(const std::string& path = "");
+                                ~MMap()
+                                    { close(); }
+                                MMap(const MMap&) = delete;
+                                MMap(MMap&&) = delete;
+    MMap&                       operator=(const MMap&) = delete;
+    MMap&                       operator=(MMap&&) = delete;
+    void                        advise(size_t offset, size_t size, bool need) const;
+    void                        close();
+    const char*                 data() const
+                                    { return _data; }
+    bool                        is_open() const
+                                    { return _open; }
+    bool                        open(const std::string& path);
+    size_t                      size() const
+                                    { return _size; }
+private:
+    bool                        _open;
+    const char*                 _data;
+    size_t                      _size;
+    void*                       _file;
+    void*                       _map;
+};
+struct CSVField {
+    const char*                 str;
+    size_t                      len;
+    char                        quote;
+    double                      to_double() const;
+    int64_t                     to_int(int64_t def = 0) const;
+    std::string                 to_string() const;
+};
+class CSVReader {
+public:
+    static const size_t         MIN_CHUNK = 1 << 20;
+    explicit                    CSVReader(const std::string& sep = ",", char quote = '"');
+                                CSVReader(const CSVReader&) = delete;
+                                CSVReader(CSVReader&&) = delete;
+    CSVReader&                  operator=(const CSVReader&) = delete;
+    CSVReader&                  operator=(CSVReader&&) = delete;
+    size_t                      chunks() const
+                                    { return _chunks.size(); }
+    std::vector<std::string>    column(size_t column, size_t max_rows) const;
+    const char*                 data() const
+                                    { return _buf; }
+    bool                        open(const std::string& path);
+    void                        parse(CallbackCSV callback, void* data = nullptr);
+    void                        set_buffer(const char* buffer, size_t size);
+    size_t                      size() const
+                                    { return _size; }
+    size_t                      split(unsigned threads = 0);
+private:
+    void                        _parse(size_t chunk, CallbackCSV callback, void* data) const;
+    size_t                      _row(const char* row, size_t len, std::vector<CSVField>& fields) const;
+    MMap                        _mmap;
+    char                        _quote;
+    const char*                 _buf;
+    size_t                      _size;
+    std::string                 _sep;
+    std::vector<std::pair<size_t, size_t>> _chunks;
+};
 }
 }
 #include <assert.h>
@@ -868,23 +1164,37 @@ private:
 class Fl_Menu_Button;
 class Fl_Scrollbar;
 #include <cmath>
+#include <deque>
+#include <map>
+#include <memory>
 #include <FL/Fl_Group.H>
 #include <FL/Fl_Rect.H>
+#include <FL/platform_types.h>
 #include <optional>
 namespace flw {
 namespace chart {
 class  Area;
 struct Point;
 class  Line;
+class  Series;
+class  SeriesPages;
 typedef std::vector<Point> PointVector;
 typedef std::vector<Line>  LineVector;
 typedef std::vector<Area>  AreaVector;
-static constexpr const double MAX_VALUE      = 9223372036854775807.0;
-static constexpr const double MIN_VALUE      = 0.0000001;
-static constexpr const int    MAX_LINE_WIDTH = 14;
-static constexpr const int    VERSION        = 6;
-static constexpr const int    MIN_TICK       = 3;
-static constexpr const int    MAX_TICK       = MAX_LINE_WIDTH * 5;
+static constexpr const double MAX_VALUE        = 9223372036854775807.0;
+static constexpr const double MIN_VALUE        = 0.0000001;
+static constexpr const int    MAX_LINE_WIDTH   = 14;
+static constexpr const int    VERSION          = 6;
+static constexpr const int    SNAPSHOT_VERSION = 2;
+static constexpr const int    MIN_TICK         = 3;
+static constexpr const int    MAX_TICK         = MAX_LINE_WIDTH * 5;
+static constexpr const size_t SERIES_BLOCK     = 4096;
+enum class Aggregate {
+    NONE,
+    OHLC,
+    SUM,
+    LAST = SUM,
+};
 enum class Algorithm {
     ATR,
     DAY_TO_MONTH,
@@ -951,77 +1261,299 @@ struct Point {
     bool                        operator==(const Point& other) const { return date == other.date; }
     bool                        operator!=(const Point& other) const { return date != other.date; }
     static PointVector          ATR(const PointVector& in, size_t days);
+    static Series               ATR(const Series& in, size_t days);
     static size_t               BinarySearch(const PointVector& in, const Point& key);
     static PointVector          DateSerie(const std::string& start_date, const std::string& stop_date, DateRange range, const PointVector& block = PointVector());
     static PointVector          DayToMonth(const PointVector& in, bool sum = false);
     static PointVector          DayToWeek(const PointVector& in, gnu::Date::Day weekday, bool sum = false);
     static void                 Debug(const PointVector& in);
     static PointVector          ExponentialMovingAverage(const PointVector& in, size_t days);
+    static Series               ExponentialMovingAverage(const Series& in, size_t days);
     static PointVector          Fixed(const PointVector& in, double value);
+    static Series               Fixed(const Series& in, double value);
     static PointVector          LoadCSV(const std::string& filename, const std::string& sep = ",");
     static PointVector          Modify(const PointVector& in, Modifier modify, double value);
+    static Series               Modify(const Series& in, Modifier modify, double value);
     static PointVector          Momentum(const PointVector& in, size_t days);
+    static Series               Momentum(const Series& in, size_t days);
     static PointVector          MovingAverage(const PointVector& in, size_t days);
+    static Series               MovingAverage(const Series& in, size_t days);
     static std::string          RangeToString(DateRange range);
     static PointVector          RSI(const PointVector& in, size_t days);
+    static Series               RSI(const Series& in, size_t days);
     static bool                 SaveCSV(const PointVector& in, const std::string& filename, const std::string& sep = ",");
     static PointVector          StdDev(const PointVector& in, size_t days);
+    static Series               StdDev(const Series& in, size_t days);
     static PointVector          Stochastics(const PointVector& in, size_t days);
+    static Series               Stochastics(const Series& in, size_t days);
     static DateRange            StringToRange(const std::string& range);
 };
+template<typename T>
+class SeriesColumn {
+public:
+                                SeriesColumn()
+                                    { _map = nullptr; _map_size = 0; _start = 0; }
+    explicit                    SeriesColumn(std::vector<T>&& values)
+                                    { _vec = std::move(values); _map = nullptr; _map_size = 0; _start = 0; }
+    const T&                    back() const
+                                    { return data()[size() - 1]; }
+    const T*                    begin() const
+                                    { return data(); }
+    void                        clear()
+                                    { _vec.clear(); _map = nullptr; _map_size = 0; _start = 0; }
+    const T*                    data() const
+                                    { return (_map != nullptr) ? _map : _vec.data() + _start; }
+    bool                        empty() const
+                                    { return size() == 0; }
+    const T*                    end() const
+                                    { return data() + size(); }
+    const T&                    front() const
+                                    { return data()[0]; }
+    bool                        is_mapped() const
+                                    { return _map != nullptr; }
+    void                        map(const T* values, size_t size)
+                                    { _vec = std::vector<T>(); _map = values; _map_size = size; _start = 0; }
+    void                        pop_back(size_t count)
+                                    { _own(); _vec.resize(_vec.size() - std::min(count, size())); }
+    void                        pop_front(size_t count)
+                                    { _own(); _start += std::min(count, size()); if (_start > _vec.size() / 2) vec(); }
+    void                        push_back(const T& value)
+                                    { _own(); _vec.push_back(value); }
+    void                        set(size_t index, const T& value)
+                                    { _own(); _vec[_start + index] = value; }
+    size_t                      size() const
+                                    { return (_map != nullptr) ? _map_size : _vec.size() - _start; }
+    std::vector<T>&             vec()
+                                    { _own(); if (_start > 0) { _vec.erase(_vec.begin(), _vec.begin() + _start); _start = 0; } return _vec; }
+    const T&                    operator[](size_t index) const
+                                    { return data()[index]; }
+private:
+    void                        _own()
+                                    { if (_map != nullptr) { _vec.assign(_map, _map + _map_size); _map = nullptr; _map_size = 0; _start = 0; } }
+    std::vector<T>              _vec;
+    const T*                    _map;
+    size_t                      _map_size;
+    size_t                      _start;
+};
+class Series {
+public:
+    explicit                    Series()
+                                    { }
+    explicit                    Series(const PointVector& in);
+    bool                        assign(const int64_t* keys, const double* high, const double* low, const double* close, size_t size, std::shared_ptr<SeriesPages> pages = nullptr);
+    static Series               LoadCSV(const std::string& filename, const std::string& sep = ",");
+    static Series               Resample(const Series& in, DateRange range, unsigned count = 1, bool sum = false);
+    bool                        check(size_t first, size_t last) const;
+    void                        clear();
+    const SeriesColumn<double>& close() const
+                                    { return _close; }
+    std::string                 date(size_t index) const;
+    size_t                      find(const gnu::DateKey& key) const;
+    gnu::DateKey                first_key() const;
+    const SeriesColumn<double>& high() const
+                                    { return _high; }
+    bool                        is_mapped() const
+                                    { return _pages != nullptr; }
+    gnu::DateKey                key(size_t index) const
+                                    { return _key[index]; }
+    const SeriesColumn<gnu::DateKey>& keys() const
+                                    { return _key; }
+    gnu::DateKey                last_key() const;
+    const SeriesColumn<double>& low() const
+                                    { return _low; }
+    Point                       point(size_t index) const;
+    PointVector                 points() const;
+    void                        pop_back(size_t count);
+    void                        pop_front(size_t count);
+    void                        prefetch(size_t first, size_t last) const;
+    void                        push_back(const gnu::DateKey& key, double value)
+                                    { push_back(key, value, value, value); }
+    void                        push_back(const gnu::DateKey& key, double high, double low, double close);
+    void                        reserve(size_t size);
+    bool                        set(size_t index, double high, double low, double close);
+    size_t                      size() const
+                                    { return _key.size(); }
+private:
+    void                        _own();
+    SeriesColumn<gnu::DateKey>  _key;
+    SeriesColumn<double>        _high;
+    SeriesColumn<double>        _low;
+    SeriesColumn<double>        _close;
+    std::shared_ptr<SeriesPages> _pages;
+    mutable std::vector<uint8_t> _checked;
+};
+class Indicator {
+public:
+    explicit                    Indicator(Algorithm formula = Algorithm::FIXED, size_t days = 14, double value = 0.0, Modifier modify = Modifier::ADDITION);
+    bool                        add(const gnu::DateKey& key, double high, double low, double close, Series& out);
+    size_t                      count() const
+                                    { return _count; }
+    size_t                      days() const
+                                    { return _days; }
+    Algorithm                   formula() const
+                                    { return _formula; }
+    bool                        is_valid() const;
+    void                        reset();
+    Series                      run(const Series& in);
+private:
+    Algorithm                   _formula;
+    Modifier                    _modify;
+    double                      _value;
+    size_t                      _days;
+    size_t                      _count;
+    double                      _sum;
+    double                      _prev;
+    double                      _prev_close;
+    double                      _gain;
+    double                      _loss;
+    double                      _m2;
+    std::deque<double>          _win_close;
+    std::deque<std::pair<size_t, double>> _win_high;
+    std::deque<std::pair<size_t, double>> _win_low;
+};
+class DateGenerator {
+public:
+    explicit                    DateGenerator();
+    explicit                    DateGenerator(const std::string& start_date, const std::string& stop_date, DateRange range, const PointVector& block = PointVector());
+    void                        clear();
+    std::string                 date(size_t index) const;
+    bool                        extend(const gnu::DateKey& last, const PointVector& block = PointVector());
+    size_t                      index(const gnu::DateKey& key) const;
+    size_t                      index(const std::string& date) const;
+    gnu::DateKey                key(size_t index) const;
+    Point                       point(size_t index) const
+                                    { return Point(date(index)); }
+    PointVector                 points() const;
+    DateRange                   range() const
+                                    { return _range; }
+    size_t                      size() const
+                                    { return _size; }
+private:
+    int64_t                     _raw_index(const gnu::DateKey& key) const;
+    gnu::DateKey                _raw_key(int64_t raw) const;
+    DateRange                   _range;
+    int64_t                     _first;
+    int64_t                     _raw_size;
+    int64_t                     _time;
+    size_t                      _size;
+    std::vector<int64_t>        _block;
+    std::vector<int64_t>        _shift;
+};
 class Line {
 public:
     explicit                    Line()
                                     { reset(); }
     explicit                    Line(const PointVector& data, const std::string& label = "", LineType type = LineType::LINE);
+    Aggregate                   aggregate() const
+                                    { return _aggregate; }
     Fl_Align                    align() const
                                     { return _align; }
     Fl_Color                    color() const
                                     { return _color; }
-    const PointVector&          data() const
-                                    { return _data; }
+    [[deprecated("use points() for a copy or series() to read data without copying")]]
+    PointVector                 data() const
+                                    { return _series.points(); }
+    bool                        append(const gnu::DateKey& key, double high, double low, double close);
+    void                        calc_index(const DateGenerator& dates, bool all = false);
+    void                        calc_lod(int level);
     void                        debug(size_t num) const;
+    bool                        has_indicator() const
+                                    { return _indicator.has_value(); }
+    unsigned                    id() const
+                                    { return _id; }
+    const SeriesColumn<int64_t>& index() const
+                                    { return _index; }
     bool                        is_visible() const
                                     { return _visible; }
     std::string                 label() const
                                     { return _label; }
+    bool                        minmax(const gnu::DateKey& first, const gnu::DateKey& last, double& min, double& max) const;
+    void                        prefetch(const gnu::DateKey& first, const gnu::DateKey& last) const;
     const Fl_Rect&              label_rect() const
                                     { return _rect; }
+    const SeriesColumn<int64_t>& lod_index(int level) const;
+    const Series&               lod_series(int level) const;
+    size_t                      max_size() const
+                                    { return _max_size; }
+    PointVector                 points() const
+                                    { return _series.points(); }
+    bool                        resample(DateRange range);
     void                        reset();
+    Line&                       set_aggregate(Aggregate val);
     Line&                       set_align(Fl_Align val)
                                     { if (val == FL_ALIGN_LEFT || val == FL_ALIGN_RIGHT) _align = val; return *this; }
     Line&                       set_color(Fl_Color val)
                                     { _color = val; return *this; }
     Line&                       set_data(const PointVector& val)
-                                    { _data = val; return *this; }
+                                    { _series = Series(val); _clear_index(); _resampled.clear(); _indicator.reset(); _source = 0; return *this; }
+    Line&                       set_data(Series&& val)
+                                    { _series = std::move(val); _clear_index(); _resampled.clear(); _indicator.reset(); _source = 0; return *this; }
+    bool                        set_indicator(const Indicator& indicator, const Line& source);
+    Line&                       set_index(std::vector<int64_t>&& val)
+                                    { _index = SeriesColumn<int64_t>(std::move(val)); _lod_index.clear(); _lod_series.clear(); _calc_range(true); return *this; }
     Line&                       set_label(const std::string& val)
                                     { _label = val; return *this; }
     Line&                       set_label_rect(int x, int y, int w, int h)
                                     { _rect = Fl_Rect(x, y, w, h); return *this; }
+    Line&                       set_max_size(size_t val = 0)
+                                    { _max_size = val; _trim(); return *this; }
     Line&                       set_type(LineType val)
-                                    { _type = val; return *this; }
+                                    { _type = val; _calc_range(false); return *this; }
     Line&                       set_type_from_string(const std::string& val);
     Line&                       set_visible(bool val)
                                     { _visible = val; return *this; }
     Line&                       set_width(unsigned val = 1)
                                     { if (val > 0 && val <= chart::MAX_LINE_WIDTH) _width = val; return *this; }
+    const Series&               series() const
+                                    { return _series; }
     size_t                      size() const
-                                    { return _data.size(); }
+                                    { return _series.size(); }
+    unsigned                    source() const
+                                    { return _source; }
     LineType                    type() const
                                     { return _type; }
     bool                        type_has_high_and_low() const
                                     { return _type == LineType::BAR || _type == LineType::BAR_CLAMP || _type == LineType::BAR_HLC; }
     std::string                 type_to_string() const;
+    bool                        update(const Line& source);
+    const Series&               view() const;
     unsigned                    width() const
                                     { return _width; }
 private:
-    PointVector                 _data;
+    void                        _added(size_t first);
+    void                        _block_range(size_t block) const;
+    void                        _calc_range(bool force);
+    void                        _clear_index();
+    bool                        _has_index() const;
+    void                        _lod_added(size_t first);
+    void                        _lod_trim(int64_t tick);
+    void                        _trim();
+    void                        _update_range(size_t first);
+    Series                      _series;
     Fl_Align                    _align;
     Fl_Color                    _color;
     Fl_Rect                     _rect;
     LineType                    _type;
     bool                        _visible;
     std::string                 _label;
+    SeriesColumn<int64_t>       _index;
+    std::vector<double>         _range_max;
+    std::vector<double>         _range_min;
+    size_t                      _range_first;
+    bool                        _range_hl;
+    DateGenerator               _mapped_dates;
+    mutable std::vector<double> _block_max;
+    mutable std::vector<double> _block_min;
+    std::vector<SeriesColumn<int64_t>> _lod_index;
+    std::vector<Series>         _lod_series;
+    std::map<DateRange, Series> _resampled;
+    std::optional<DateRange>    _resample;
+    Aggregate                   _aggregate;
+    std::optional<Indicator>    _indicator;
+    gnu::DateKey                _source_key;
+    size_t                      _max_size;
+    unsigned                    _id;
+    unsigned                    _source;
     unsigned                    _width;
 };
 class Scale {
@@ -1055,6 +1587,7 @@ public:
     explicit                    Area(AreaNum area)
                                     { _area = area; reset(); }
     bool                        add_line(const Line& chart_line);
+    bool                        append(size_t index, const gnu::DateKey& key, double high, double low, double close);
     AreaNum                     area() const
                                     { return _area; }
     std::optional<double>       clamp_max() const;
@@ -1102,8 +1635,10 @@ class Chart : public Fl_Group {
     static const size_t         MAX_VLINES = 1600;
 public:
     explicit                    Chart(int X = 0, int Y = 0, int W = 0, int H = 0, const char* l = nullptr);
+                                ~Chart();
     double                      alt_size() const
                                     { return _alt_size; }
+    bool                        append(AreaNum area, size_t line, const Point& point);
     Area&                       area(AreaNum area)
                                     { return _areas[static_cast<size_t>(area)]; }
     bool                        create_line(Algorithm formula, bool support = false);
@@ -1127,9 +1662,15 @@ public:
                                     { _init(true); }
     bool                        line_labels() const
                                     { return _labels; }
+    bool                        lod() const
+                                    { return _lod; }
+    int                         lod_level() const
+                                    { return _lod_level; }
     bool                        load_json();
     bool                        load_json(const std::string& filename);
     bool                        load_line_from_csv();
+    bool                        load_snapshot();
+    bool                        load_snapshot(const std::string& filename, size_t page_budget = 0);
     std::string                 main_label() const
                                     { return _label; }
     void                        print_to_postscript();
@@ -1139,6 +1680,8 @@ public:
     bool                        save_json(const std::string& filename, double max_diff_high_low = 0.001);
     bool                        save_line_to_csv();
     bool                        save_png();
+    bool                        save_snapshot();
+    bool                        save_snapshot(const std::string& filename);
     void                        set_alt_size(double val = 0.8)
                                     { if (val >= 0.6 && val <= 1.2) _alt_size = val; }
     bool                        set_area_size(unsigned area1 = 100, unsigned area2 = 0, unsigned area3 = 0, unsigned area4 = 0, unsigned area5 = 0);
@@ -1150,6 +1693,7 @@ public:
                                     { _horizontal = val; }
     void                        set_line_labels(bool val = true)
                                     { _labels = val; }
+    void                        set_lod(bool val = true);
     void                        set_main_label(std::string label = "")
                                     { _label = label; }
     void                        set_tick_width(int val = chart::MIN_TICK)
@@ -1178,12 +1722,15 @@ private:
     };
     void                        _calc_area_height();
     void                        _calc_area_width();
-    void                        _calc_dates();
+    bool                        _calc_dates();
+    void                        _calc_index(bool all);
+    void                        _calc_lod();
     void                        _calc_margins();
     void                        _calc_ymin_ymax();
     void                        _calc_yscale();
     void                        _create_tooltip(bool ctrl);
     void                        _draw_label();
+    void                        _draw_layer();
     void                        _draw_lines(Area& area);
     void                        _draw_line_labels(Area& area);
     void                        _draw_tooltip();
@@ -1193,21 +1740,31 @@ private:
     Area*                       _get_active_area(int X, int Y);
     void                        _init(bool calc_dates);
     StringVector                _label_array(const Area& area, LabelType labeltype) const;
+    int                         _last_date(int tick) const;
     bool                        _move_or_delete_line(Area* area, size_t index, bool move, AreaNum destination = AreaNum::ONE);
     void                        _show_menu();
+    int                         _tick_count() const;
     static bool                 _CallbackPrinter(void* data, int pw, int ph, unsigned page);
     static void                 _CallbackScrollbar(Fl_Widget*, void* widget);
     Area*                       _area;
     AreaVector                  _areas;
     DateRange                   _date_range;
     PointVector                 _block_dates;
-    PointVector                 _dates;
+    DateGenerator               _dates;
+    PointVector                 _dates_block;
+    gnu::DateKey                _dates_max;
+    gnu::DateKey                _dates_min;
+    gnu::DateCache              _date_cache;
     Fl_Menu_Button*             _menu;
     Fl_Rect                     _old;
+    Fl_Offscreen                _offscreen;
+    Fl_Rect                     _offscreen_rect;
     Fl_Scrollbar*               _scroll;
     bool                        _disable_menu;
     bool                        _horizontal;
     bool                        _labels;
+    bool                        _lod;
+    bool                        _lod_fit;
     bool                        _printing;
     bool                        _vertical;
     const int                   _CH;
@@ -1215,6 +1772,7 @@ private:
     double                      _alt_size;
     int                         _bottom_space;
     int                         _date_start;
+    int                         _lod_level;
     int                         _margin_left;
     int                         _margin_right;
     int                         _tick_width;
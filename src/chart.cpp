@@ -18,11 +18,13 @@
 
 #include <FL/Fl_File_Chooser.H>
 #include <FL/Fl_Hor_Slider.H>
+#include <FL/Fl_Image_Surface.H>
 #include <FL/Fl_Menu_Button.H>
 #include <FL/Fl_Scrollbar.H>
 #include <FL/fl_draw.H>
 #include <FL/fl_show_colormap.H>
 #include <algorithm>
+#include <atomic>
 
 namespace flw {
 namespace priv {
@@ -38,10 +40,12 @@ static const char* const _CHART_LABEL_ADD_CSV         = "Add Line from CSV File.
 static const char* const _CHART_LABEL_ADD_LINE        = "Create Line...";
 static const char* const _CHART_LABEL_CLEAR           = "Clear Chart";
 static const char* const _CHART_LABEL_LOAD_JSON       = "Load Chart from JSON...";
+static const char* const _CHART_LABEL_LOAD_SNAPSHOT   = "Load Chart from Snapshot...";
 static const char* const _CHART_LABEL_PRINT           = "Print to PostScript File...";
 static const char* const _CHART_LABEL_SAVE_CSV        = "Save Line to CSV...";
 static const char* const _CHART_LABEL_SAVE_JSON       = "Save Chart to JSON...";
 static const char* const _CHART_LABEL_SAVE_PNG        = "Save to PNG File...";
+static const char* const _CHART_LABEL_SAVE_SNAPSHOT   = "Save Chart to Snapshot...";
 static const char* const _CHART_LABEL_SETUP_AREA      = "Number of Areas...";
 static const char* const _CHART_LABEL_SETUP_DELETE    = "Delete Lines...";
 static const char* const _CHART_LABEL_SETUP_LABEL     = "Label...";
@@ -53,6 +57,7 @@ static const char* const _CHART_LABEL_SETUP_RANGE     = "Date Range...";
 static const char* const _CHART_LABEL_SETUP_SHOW      = "Show or Hide Lines...";
 static const char* const _CHART_LABEL_SHOW_HLINES     = "Show Horizontal Lines";
 static const char* const _CHART_LABEL_SHOW_LABELS     = "Show Line Labels";
+static const char* const _CHART_LABEL_SHOW_LOD        = "Aggregate Dates When Zoomed Out";
 static const char* const _CHART_LABEL_SHOW_VLINES     = "Show Vertical Lines";
 static const int         _CHART_MIN_MARGIN            =  3;
 static const int         _CHART_MIN_AREA_SIZE         = 10;
@@ -64,1157 +69,3554 @@ static const char* const _CHART_LABEL_DEBUG           = "Debug Chart";
 static const char* const _CHART_LABEL_DEBUG_LINE      = "Print Visible Values";
 #endif
 
+static const gnu::DateParser _CHART_DATE_PARSER(gnu::Date::Format::ISO_TIME);
+static std::atomic<unsigned> _CHART_LINE_ID(0);
+static const char            _CHART_SNAPSHOT_MAGIC[8] = { 'F', 'L', 'W', 'C', 'H', 'A', 'R', 'T' };
+static const uint32_t        _CHART_SNAPSHOT_ORDER    = 0x01020304;
+
+/** @brief Convert date string to "YYYYMMDD HHMMSS".
+*
+* Strings that already are in that format are only checked and copied.
+*
+* @param[in] date  Date string.
+*
+* @return Date string or "" for an invalid date.
+*/
+static std::string _chart_date(const std::string& date) {
+    if (_CHART_DATE_PARSER.parse_fixed(date).is_invalid() == false) {
+        return date.substr(0, 15);
+    }
+
+    auto valid_date = gnu::Date(date);
+    return (valid_date.is_invalid() == true) ? "" : valid_date.format(gnu::Date::Format::ISO_TIME);
+}
+
+/** @brief Convert date key to "YYYYMMDD HHMMSS".
+*
+* @param[in] key  Date key.
+*
+* @return Date string or "" for an invalid key.
+*/
+static std::string _chart_key_date(const gnu::DateKey& key) {
+    if (key.is_invalid() == true) {
+        return "";
+    }
+
+    char buf[40];
+    auto len = key.to_date().format_to(buf, sizeof(buf), gnu::Date::Format::ISO_TIME);
+
+    return std::string(buf, len);
+}
+
+/** @brief Check that a number can be used as a chart value.
+*
+* @param[in] value  Number.
+*
+* @return True if value is finite and inside chart::MAX_VALUE.
+*
+* @private
+*/
+static bool _chart_is_value(double value) {
+    return std::isfinite(value) == true && fabs(value) < chart::MAX_VALUE;
+}
+
+/** @brief Check raw data points.
+*
+* An invalid key must have zero values.\n
+* Valid keys must be in ascending order and values must be in size order (low <= close <= high).\n
+*
+* @param[in] keys   Dates as seconds since 1970-01-01 00:00:00.
+* @param[in] high   High values.
+* @param[in] low    Low values.
+* @param[in] close  Close values.
+* @param[in] first  First index.
+* @param[in] end    Index after last.
+* @param[in] prev   Last valid key before first or gnu::DateKey::INVALID.
+*
+* @return True if all data points are valid.
+*
+* @private
+*/
+static bool _chart_series_check(const int64_t* keys, const double* high, const double* low, const double* close, size_t first, size_t end, int64_t prev) {
+    for (size_t f = first; f < end; f++) {
+        if (keys[f] == gnu::DateKey::INVALID) {
+            if (high[f] != 0.0 || low[f] != 0.0 || close[f] != 0.0) {
+                return false;
+            }
+
+            continue;
+        }
+        else if (prev != gnu::DateKey::INVALID && keys[f] <= prev) {
+            return false;
+        }
+
+        prev = keys[f];
+
+        if (_chart_is_value(high[f]) == false ||
+            _chart_is_value(low[f]) == false ||
+            _chart_is_value(close[f]) == false ||
+            low[f] > close[f] ||
+            close[f] > high[f]) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/** @brief Data for CSV row callback.
+*
+* @private
+*/
+struct _ChartCSV {
+    const gnu::DateParser*      parser;
+    std::vector<chart::Series>  series;     // One serie for every chunk.
+};
+
+/** @brief Add one CSV row to the serie for current chunk.
+*
+* Rows with 2 columns are date and value, rows with 4 or more columns are date, high, low and close.\n
+* Other rows and rows with invalid dates or values are skipped.\n
+*
+* @private
+*/
+static void _chart_csv_row(size_t chunk, const gnu::file::CSVField* fields, size_t count, void* data) {
+    auto csv = static_cast<_ChartCSV*>(data);
+
+    if (count != 2 && count < 4) {
+        return;
+    }
+
+    auto key = csv->parser->parse(fields[0].str, fields[0].len);
+
+    if (key.is_invalid() == true) {
+        return;
+    }
+    else if (count == 2) {
+        auto value = fields[1].to_double();
+
+        if (_chart_is_value(value) == true) {
+            csv->series[chunk].push_back(key, value);
+        }
+    }
+    else {
+        auto high  = fields[1].to_double();
+        auto low   = fields[2].to_double();
+        auto close = fields[3].to_double();
+
+        if (_chart_is_value(high) == true && _chart_is_value(low) == true && _chart_is_value(close) == true) {
+            csv->series[chunk].push_back(key, high, low, close);
+        }
+    }
+}
+
+/** @brief Read values from a binary chart snapshot.
+*
+* All reads are range checked and after the first error every read returns zero values.\n
+* Arrays are returned as pointers into the buffer, so they are valid as long as the buffer is.\n
+*
+* @private
+*/
+class _ChartSnapshotReader {
+public:
+    _ChartSnapshotReader(const char* data, size_t size) {
+        _data = data;
+        _size = size;
+        _pos  = 0;
+        _err  = false;
+    }
+
+    void align() {
+        _pos = (_pos + 7) & ~static_cast<size_t>(7);
+    }
+
+    template<typename T>
+    const T* array(size_t count) {
+        align();
+
+        if (_err == true || count > (_size - std::min(_pos, _size)) / sizeof(T)) {
+            _err = true;
+            return nullptr;
+        }
+
+        auto res = reinterpret_cast<const T*>(_data + _pos);
+        _pos += count * sizeof(T);
+        return res;
+    }
+
+    bool err() const {
+        return _err;
+    }
+
+    template<typename T>
+    T get() {
+        T res = T();
+
+        if (_err == true || _pos + sizeof(T) > _size) {
+            _err = true;
+        }
+        else {
+            memcpy(&res, _data + _pos, sizeof(T));
+            _pos += sizeof(T);
+        }
+
+        return res;
+    }
+
+    std::string str() {
+        auto len = get<uint32_t>();
+
+        if (_err == true || len > _size - _pos) {
+            _err = true;
+            return "";
+        }
+
+        auto res = std::string(_data + _pos, len);
+        _pos += len;
+        return res;
+    }
+
+private:
+    const char*                 _data;
+    size_t                      _size;
+    size_t                      _pos;
+    bool                        _err;
+};
+
+/** @brief Append 8 byte alignment padding to snapshot buffer.
+*
+* @private
+*/
+static void _chart_snapshot_align(std::string& buf) {
+    while (buf.length() % 8 != 0) {
+        buf += '\0';
+    }
+}
+
+/** @brief Append raw bytes to snapshot buffer.
+*
+* @private
+*/
+static void _chart_snapshot_put(std::string& buf, const void* data, size_t size) {
+    buf.append(static_cast<const char*>(data), size);
+}
+
+/** @brief Append one value to snapshot buffer.
+*
+* @private
+*/
+template<typename T>
+static void _chart_snapshot_put(std::string& buf, T value) {
+    _chart_snapshot_put(buf, &value, sizeof(T));
+}
+
+/** @brief Append string with a 32 bit length prefix to snapshot buffer.
+*
+* @private
+*/
+static void _chart_snapshot_put(std::string& buf, const std::string& value) {
+    _chart_snapshot_put(buf, static_cast<uint32_t>(value.length()));
+    _chart_snapshot_put(buf, value.c_str(), value.length());
+}
+
+/** @brief Floor division.
+*
+*/
+static int64_t _chart_floor_div(int64_t a, int64_t b) {
+    return (a >= 0) ? a / b : (a - (b - 1)) / b;
+}
+
+/** @brief Number of weekdays (mon - fri) before a day.
+*
+* Counted from monday 1969-12-29.
+*
+* @param[in] days  Days since 1970-01-01.
+*
+* @return Number of weekdays.
+*/
+static int64_t _chart_weekdays(int64_t days) {
+    auto n    = days + 3;
+    auto week = _chart_floor_div(n, 7);
+    auto rem  = n - week * 7;
+
+    return week * 5 + ((rem < 5) ? rem : 5);
+}
+
+/** @brief Get day for a weekday count, inverse of _chart_weekdays().
+*
+* @param[in] count  Number of weekdays.
+*
+* @return Days since 1970-01-01.
+*/
+static int64_t _chart_weekday_to_days(int64_t count) {
+    auto week = _chart_floor_div(count, 5);
+    auto rem  = count - week * 5;
+
+    return week * 7 + rem - 3;
+}
+
+/** @brief Get time bucket for a date.
+*
+* SEC, MIN, HOUR, DAY and WEEKDAY buckets start at count units since 1970-01-01 and are labeled with the first second.\n
+* FRIDAY and SUNDAY buckets are count weeks that ends with the weekday and are labeled with that day.\n
+* MONTH buckets are count months (counted from year 0) and are labeled with the last day in the last month.\n
+* All day buckets are labeled at 00:00:00.\n
+*
+* @param[in]  seconds  Date in seconds.
+* @param[in]  range    Bucket unit.
+* @param[in]  count    Number of units in every bucket.
+* @param[in]  weekday  Last day in week buckets (0 for monday to 6 for sunday).
+* @param[out] first    First second in bucket.
+* @param[out] end      First second after bucket.
+* @param[out] label    Date key for bucket in seconds.
+*/
+static void _chart_resample_bucket(int64_t seconds, chart::DateRange range, int64_t count, int weekday, int64_t& first, int64_t& end, int64_t& label) {
+    if (range == chart::DateRange::FRIDAY || range == chart::DateRange::SUNDAY) {
+        const auto DAYS   = _chart_floor_div(seconds, gnu::Date::SECS_PER_DAY);
+        const auto ANCHOR = static_cast<int64_t>((weekday + 4) % 7);    // First day since 1970-01-01 with weekday.
+        const auto WEEK   = -_chart_floor_div(ANCHOR - DAYS, 7);        // Week with the first label on or after DAYS.
+        const auto LAST   = ANCHOR + (_chart_floor_div(WEEK, count) * count + count - 1) * 7;
+
+        first = (LAST - count * 7 + 1) * gnu::Date::SECS_PER_DAY;
+        end   = (LAST + 1) * gnu::Date::SECS_PER_DAY;
+        label = LAST * gnu::Date::SECS_PER_DAY;
+    }
+    else if (range == chart::DateRange::MONTH) {
+        const auto DATE  = gnu::DateKey::FromSeconds(seconds).to_date();
+        const auto MONTH = _chart_floor_div(DATE.year() * 12 + DATE.month() - 1, count) * count;
+        auto       stop  = gnu::Date(static_cast<int>((MONTH + count - 1) / 12), static_cast<int>((MONTH + count - 1) % 12) + 1, 1);
+
+        stop.set_day_to_last_in_month();
+        first = gnu::Date(static_cast<int>(MONTH / 12), static_cast<int>(MONTH % 12) + 1, 1).key().seconds();
+        label = stop.key().seconds();
+        end   = label + gnu::Date::SECS_PER_DAY;
+    }
+    else {
+        int64_t step = gnu::Date::SECS_PER_DAY;
+
+        if (range == chart::DateRange::HOUR) {
+            step = gnu::Date::SECS_PER_HOUR;
+        }
+        else if (range == chart::DateRange::MIN) {
+            step = 60;
+        }
+        else if (range == chart::DateRange::SEC) {
+            step = 1;
+        }
+
+        step  *= count;
+        first  = _chart_floor_div(seconds, step) * step;
+        end    = first + step;
+        label  = first;
+    }
+}
+
+/** @brief Aggregate data points into time buckets in one pass.
+*
+* Input must be sorted by date, data points with invalid dates are skipped.\n
+* Without an output serie it only checks if every data point is alone in its bucket and has the bucket date.\n
+*
+* @param[in]  in       Input serie.
+* @param[in]  range    Bucket unit.
+* @param[in]  count    Number of units in every bucket.
+* @param[in]  weekday  Last day in week buckets (0 for monday to 6 for sunday).
+* @param[in]  sum      True to add values, false to use highest/lowest and last close value.
+* @param[out] out      Output serie or nullptr.
+*
+* @return False if output would be different from the input (only when out is nullptr).
+*/
+static bool _chart_resample(const chart::Series& in, chart::DateRange range, int64_t count, int weekday, bool sum, chart::Series* out) {
+    const auto& keys  = in.keys();
+    const auto& high  = in.high();
+    const auto& low   = in.low();
+    const auto& close = in.close();
+    int64_t     first = 0;
+    int64_t     end   = 0;
+    int64_t     label = 0;
+    bool        open  = false;
+    double      h     = 0.0;
+    double      l     = 0.0;
+    double      c     = 0.0;
+
+    count = std::max(count, static_cast<int64_t>(1));
+
+    for (size_t f = 0; f < in.size(); f++) {
+        if (keys[f].is_invalid() == true || in.check(f, f) == false) {
+            continue;
+        }
+
+        const auto SECONDS = keys[f].seconds();
+
+        if (open == false || SECONDS < first || SECONDS >= end) {
+            if (open == true && out != nullptr) {
+                out->push_back(gnu::DateKey::FromSeconds(label), h, l, c);
+            }
+
+            _chart_resample_bucket(SECONDS, range, count, weekday, first, end, label);
+
+            if (out == nullptr && SECONDS != label) {
+                return false;
+            }
+
+            open = true;
+            h    = high[f];
+            l    = low[f];
+            c    = close[f];
+        }
+        else if (out == nullptr) {
+            return false;
+        }
+        else if (sum == true) {
+            h += high[f];
+            l += low[f];
+            c += close[f];
+        }
+        else {
+            h = std::max(h, high[f]);
+            l = std::min(l, low[f]);
+            c = close[f];
+        }
+    }
+
+    if (open == true && out != nullptr) {
+        out->push_back(gnu::DateKey::FromSeconds(label), h, l, c);
+    }
+
+    return true;
+}
+
+/** @brief Add one data point in input serie to resampled data.
+*
+* @param[in]     in     Input serie.
+* @param[in]     index  New data point, all earlier points must have been added.
+* @param[in]     range  Bucket unit.
+* @param[in]     sum    True to add values, false to use highest/lowest and last close value.
+* @param[in,out] out    Result from Series::Resample() before the new point was added, empty if it was the same as the input.
+*
+* @return False if output must be calculated again.
+*/
+static bool _chart_resample_append(const chart::Series& in, size_t index, chart::DateRange range, bool sum, chart::Series& out) {
+    const auto LAST  = index;
+    const auto KEY   = in.key(LAST);
+    int64_t    first = 0;
+    int64_t    end   = 0;
+    int64_t    label = 0;
+
+    if (KEY.is_invalid() == true) {
+        return true;
+    }
+
+    _chart_resample_bucket(KEY.seconds(), range, 1, (range == chart::DateRange::FRIDAY) ? 4 : 6, first, end, label);
+
+    if (out.size() == 0) { // Still same as input if the new point has the bucket date.
+        return KEY.seconds() == label;
+    }
+
+    const auto BACK = out.keys().back().seconds();
+
+    if (BACK == label && sum == true) {
+        const auto HIGH  = out.high().back() + in.high()[LAST];
+        const auto LOW   = out.low().back() + in.low()[LAST];
+        const auto CLOSE = out.close().back() + in.close()[LAST];
+
+        out.pop_back(1);
+        out.push_back(gnu::DateKey::FromSeconds(label), HIGH, LOW, CLOSE);
+        return true;
+    }
+    else if (BACK == label) {
+        const auto HIGH = std::max(out.high().back(), in.high()[LAST]);
+        const auto LOW  = std::min(out.low().back(), in.low()[LAST]);
+
+        out.pop_back(1);
+        out.push_back(gnu::DateKey::FromSeconds(label), HIGH, LOW, in.close()[LAST]);
+        return true;
+    }
+    else if (BACK < label) {
+        out.push_back(gnu::DateKey::FromSeconds(label), in.high()[LAST], in.low()[LAST], in.close()[LAST]);
+        return true;
+    }
+
+    return false;
+}
+
+/** @brief Aggregate data points into the next level of detail.
+*
+* Points with the same bucket (index / 2) are merged into one point with the highest high, lowest low and last close value.\n
+* Date is the date of the last data point in the bucket.\n
+*
+* @param[in]     prev_index  Bucket index for the previous level, -1 for points that are not in the reference dates.
+* @param[in]     prev        Data for the previous level.
+* @param[in]     first       First data point in the previous level to use, it must be the first point in its bucket.
+* @param[in,out] index       New buckets are added to this index.
+* @param[in,out] out         New data points are added to this serie.
+*
+* @private
+*/
+static void _chart_lod_add(const chart::SeriesColumn<int64_t>& prev_index, const chart::Series& prev, size_t first, chart::SeriesColumn<int64_t>& index, chart::Series& out) {
+    const auto& high   = prev.high();
+    const auto& low    = prev.low();
+    const auto& close  = prev.close();
+    auto        bucket = static_cast<int64_t>(-1);
+    auto        key    = gnu::DateKey();
+    auto        h      = 0.0;
+    auto        l      = 0.0;
+    auto        c      = 0.0;
+
+    for (size_t f = first; f < prev_index.size(); f++) {
+        if (prev_index[f] < 0) {
+            continue;
+        }
+        else if ((prev_index[f] >> 1) != bucket) {
+            if (bucket >= 0) {
+                index.push_back(bucket);
+                out.push_back(key, h, l, c);
+            }
+
+            bucket = prev_index[f] >> 1;
+            h      = high[f];
+            l      = low[f];
+        }
+        else {
+            h = std::max(h, high[f]);
+            l = std::min(l, low[f]);
+        }
+
+        key = prev.key(f);
+        c   = close[f];
+    }
+
+    if (bucket >= 0) {
+        index.push_back(bucket);
+        out.push_back(key, h, l, c);
+    }
+}
+
+/** @brief Aggregate mapped data points directly into one level of detail.
+*
+* Same result as calling _chart_lod_add() level times but no index or data is stored for the levels in between.\n
+* Data points in illegal blocks are skipped.\n
+*
+* @param[in]     in     Mapped data.
+* @param[in]     dates  Reference dates.
+* @param[in]     level  Level of detail, every bucket is 2^level reference dates.
+* @param[in,out] index  New buckets are added to this index.
+* @param[in,out] out    New data points are added to this serie.
+*
+* @private
+*/
+static void _chart_lod_mapped(const chart::Series& in, const chart::DateGenerator& dates, int level, chart::SeriesColumn<int64_t>& index, chart::Series& out) {
+    const auto& high   = in.high();
+    const auto& low    = in.low();
+    const auto& close  = in.close();
+    auto        bucket = static_cast<int64_t>(-1);
+    auto        key    = gnu::DateKey();
+    auto        h      = 0.0;
+    auto        l      = 0.0;
+    auto        c      = 0.0;
+
+    for (size_t f = 0; f < in.size(); f++) {
+        const auto TICK = static_cast<int64_t>(dates.index(in.key(f)));
+
+        if (TICK < 0 || in.check(f, f) == false) {
+            continue;
+        }
+        else if ((TICK >> level) != bucket) {
+            if (bucket >= 0) {
+                index.push_back(bucket);
+                out.push_back(key, h, l, c);
+            }
+
+            bucket = TICK >> level;
+            h      = high[f];
+            l      = low[f];
+        }
+        else {
+            h = std::max(h, high[f]);
+            l = std::min(l, low[f]);
+        }
+
+        key = in.key(f);
+        c   = close[f];
+    }
+
+    if (bucket >= 0) {
+        index.push_back(bucket);
+        out.push_back(key, h, l, c);
+    }
+}
+
+/*
+ * Rolling window kernels, shared by the batch algorithms and Indicator.
+ */
+
+typedef std::deque<std::pair<size_t, double>> _ChartExtreme;
+
+/** @brief Add value to a monotonic window for max or min values.
+*
+* Values that can never be the extreme value again are removed so every value is added and removed once.
+*
+* @param[in,out] window  Window with index and value pairs.
+* @param[in]     index   Index of value, must be larger than last.
+* @param[in]     value   Value.
+* @param[in]     max     True for max value, false for min value.
+* @param[in]     days    Window size, older values are removed.
+*
+* @return Current max or min value.
+*/
+static double _chart_extreme(_ChartExtreme& window, size_t index, double value, bool max, size_t days) {
+    if (max == true) {
+        while (window.size() > 0 && window.back().second <= value) {
+            window.pop_back();
+        }
+    }
+    else {
+        while (window.size() > 0 && window.back().second >= value) {
+            window.pop_back();
+        }
+    }
+
+    window.push_back(std::make_pair(index, value));
+
+    while (window.front().first + days <= index) {
+        window.pop_front();
+    }
+
+    return window.front().second;
+}
+
+/** @brief True range for one data point.
+*
+* @param[in] high        High value.
+* @param[in] low         Low value.
+* @param[in] prev_close  Previous close value.
+*
+* @return Largest of high - low, |high - prev_close| and |low - prev_close|.
+*/
+static inline double _chart_true_range(double high, double low, double prev_close) {
+    return std::max(high - low, std::max(fabs(high - prev_close), fabs(low - prev_close)));
+}
+
+/** @brief Add value to rolling variance (Welford).
+*
+* @param[in,out] mean   Mean value.
+* @param[in,out] m2     Sum of squared differences from mean.
+* @param[in]     count  Number of values including the new value.
+* @param[in]     value  New value.
+*/
+static inline void _chart_variance_add(double& mean, double& m2, size_t count, double value) {
+    auto delta = value - mean;
+
+    mean += delta / count;
+    m2   += delta * (value - mean);
+}
+
+/** @brief Calculate mean and variance for a full window with two passes.
+*
+* Used to remove accumulated rounding errors from the rolling variance once every window length.
+*
+* @param[in]  begin  First value.
+* @param[in]  end    End of values.
+* @param[in]  count  Number of values.
+* @param[out] mean   Mean value.
+* @param[out] m2     Sum of squared differences from mean.
+*
+* @return Population variance.
+*/
+template <typename It>
+static double _chart_variance_exact(It begin, It end, size_t count, double& mean, double& m2) {
+    double sum = 0.0;
+
+    for (auto it = begin; it != end; ++it) {
+        sum += *it;
+    }
+
+    mean = sum / count;
+    m2   = 0.0;
+
+    for (auto it = begin; it != end; ++it) {
+        auto tmp = *it - mean;
+        m2 += tmp * tmp;
+    }
+
+    return m2 / count;
+}
+
+/** @brief Replace oldest value in a full rolling variance window.
+*
+* @param[in,out] mean     Mean value.
+* @param[in,out] m2       Sum of squared differences from mean.
+* @param[in]     count    Window size.
+* @param[in]     old_val  Value that leaves the window.
+* @param[in]     value    New value.
+*
+* @return Population variance.
+*/
+static inline double _chart_variance_replace(double& mean, double& m2, size_t count, double old_val, double value) {
+    auto delta = value - old_val;
+    auto prev  = mean;
+
+    mean += delta / count;
+    m2   += delta * (value - mean + old_val - prev);
+
+    if (m2 < 0.0) { // Rounding errors.
+        m2 = 0.0;
+    }
+
+    return m2 / count;
+}
+
+/** @brief Calculate indicator for a complete serie.
+*
+* Same calculation as Indicator::run() so lines created with Point functions and indicator lines are equal.\n
+* Nothing is returned if days are less than 2 or if there are not more data points than days.\n
+*
+* @param[in] in       Source serie.
+* @param[in] formula  Algorithm.
+* @param[in] days     Number of days.
+* @param[in] out      Called with input index and result value.
+*
+* @private
+*/
+template <typename Out>
+static void _chart_indicator(const chart::Series& in, chart::Algorithm formula, size_t days, Out out) {
+    if (days < 2 || days >= in.size()) {
+        return;
+    }
+
+    auto ind = chart::Indicator(formula, days);
+    auto res = chart::Series();
+
+    for (size_t f = 0; f < in.size(); f++) {
+        if (in.check(f, f) == true && ind.add(in.key(f), in.high()[f], in.low()[f], in.close()[f], res) == true) {
+            out(f, res.close()[0]);
+            res.clear();
+        }
+    }
+}
+
+/** @brief Update indicator lines after a data point has been added to a line.
+*
+* Lines that are calculated from a changed line are updated, also in several steps.\n
+* Every line is updated at most once so lines that are linked in a circle can not loop forever.\n
+*
+* @param[in] lines    All lines that can be linked.
+* @param[in] changed  Line that got a new data point.
+*
+* @private
+*/
+static void _chart_update_lines(const std::vector<chart::Line*>& lines, const chart::Line* changed) {
+    std::vector<bool>               done(lines.size(), false);
+    std::vector<const chart::Line*> stack = { changed };
+
+    while (stack.size() > 0) {
+        auto source = stack.back();
+
+        stack.pop_back();
+
+        for (size_t f = 0; f < lines.size(); f++) {
+            if (done[f] == false && lines[f] != changed && lines[f]->update(*source) == true) {
+                done[f] = true;
+                stack.push_back(lines[f]);
+            }
+        }
+    }
+}
+
+/*
+ *       _____ _                _ __          __   _ _
+ *      / ____| |              | |\ \        / /  | | |
+ *     | |    | |__   __ _ _ __| |_\ \  /\  / /_ _| | | __
+ *     | |    | '_ \ / _` | '__| __|\ \/  \/ / _` | | |/ /
+ *     | |____| | | | (_| | |  | |_  \  /\  / (_| | |   <
+ *      \_____|_| |_|\__,_|_|   \__|  \/  \/ \__,_|_|_|\_\
+ *      ______
+ *     |______|
+ */
+
+/** @brief Find data points for reference dates in increasing order.
+*
+* Uses the reference date index in the line so every lookup is a step forward instead of a binary search.\n
+* Mapped data and lines where the index is not up to date are searched by date instead, with an exponential search forward from the last found point.\n
+* For levels above 0 the aggregated data in the line is used and every tick is 2^level reference dates.\n
+*
+* @private
+*/
+class _ChartWalk {
+public:
+    const chart::DateGenerator& _dates;
+    const chart::SeriesColumn<int64_t>& _index;
+    const chart::Series&        _series;
+    int                         _level;
+    size_t                      _pos;
+    bool                        _valid;
+
+    /** @brief Start walk.
+    *
+    * @param[in] line   Chart line.
+    * @param[in] dates  Reference dates.
+    * @param[in] start  First tick.
+    * @param[in] level  Level of detail.
+    */
+    _ChartWalk(const chart::Line& line, const chart::DateGenerator& dates, int start, int level = 0) :
+    _dates(dates),
+    _index(line.lod_index(level)),
+    _series(line.lod_series(level)) {
+        _level = level;
+        _pos   = 0;
+        _valid = _index.size() == _series.size();
+
+        if (start <= 0 || (_valid == false && level > 0)) {
+            return;
+        }
+        else if (level > 0) {
+            _pos = std::lower_bound(_index.begin(), _index.end(), static_cast<int64_t>(start)) - _index.begin();
+        }
+        else if (start < static_cast<int>(dates.size())) {
+            const auto& keys = _series.keys();
+            _pos = std::lower_bound(keys.begin(), keys.end(), dates.key(start)) - keys.begin();
+        }
+    }
+
+    /** @brief Find data point for a tick.
+    *
+    * @param[in] date  Tick index, must be larger than last call.
+    *
+    * @return Index in series() or -1.
+    */
+    size_t find(int date) {
+        if (_valid == false && _level > 0) {
+            return static_cast<size_t>(-1);
+        }
+        else if (_valid == false) {
+            const auto& keys = _series.keys();
+            const auto  KEY  = _dates.key(date);
+            auto        end  = _pos;
+
+            for (size_t step = 1; end < keys.size() && keys[end] < KEY; step *= 2) {
+                _pos = end + 1;
+                end += step;
+            }
+
+            end  = std::min(end, keys.size());
+            _pos = std::lower_bound(keys.begin() + _pos, keys.begin() + end, KEY) - keys.begin();
+
+            if (_pos < keys.size() && keys[_pos] == KEY && _series.check(_pos, _pos) == true) {
+                return _pos++;
+            }
+
+            return static_cast<size_t>(-1);
+        }
+
+        while (_pos < _index.size() && _index[_pos] < date) {
+            _pos++;
+        }
+
+        if (_pos < _index.size() && _index[_pos] == date) {
+            return _pos++;
+        }
+
+        return static_cast<size_t>(-1);
+    }
+
+    /** @brief Get data that find() is returning index for.
+    *
+    * @return Line data or aggregated data.
+    */
+    const chart::Series& series() const {
+        return _series;
+    }
+};
+
+/*
+ *           _____ _                _   _      _             _____      _               
+ *          / ____| |              | | | |    (_)           / ____|    | |              
+ *         | |    | |__   __ _ _ __| |_| |     _ _ __   ___| (___   ___| |_ _   _ _ __  
+ *         | |    | '_ \ / _` | '__| __| |    | | '_ \ / _ \\___ \ / _ \ __| | | | '_ \ 
+ *         | |____| | | | (_| | |  | |_| |____| | | | |  __/____) |  __/ |_| |_| | |_) |
+ *          \_____|_| |_|\__,_|_|   \__|______|_|_| |_|\___|_____/ \___|\__|\__,_| .__/ 
+ *      ______                                                                   | |    
+ *     |______|                                                                  |_|    
+ */
+
+/** @brief Chart line settings dialog.
+*
+* @private
+*/
+class _ChartLineSetup : public Fl_Double_Window {
+public:
+    chart::Line&                _line;
+    Fl_Button*                  _close;
+    Fl_Button*                  _color;
+    Fl_Choice*                  _aggregate;
+    Fl_Choice*                  _align;
+    Fl_Choice*                  _type;
+    Fl_Hor_Slider*              _width;
+    Fl_Input*                   _label;
+    GridGroup*                  _grid;
+    bool                        _run;
+
+public:
+    /** @brief Create dialog but don't show it.
+    *
+    */
+    _ChartLineSetup(Fl_Window* parent, chart::Line& line) :
+    Fl_Double_Window(0, 0, 10, 10, "Chart - Line Properties"),
+    _line(line) {
+        end();
+
+        _aggregate = new Fl_Choice(0, 0, 0, 0, "Resample");
+        _align     = new Fl_Choice(0, 0, 0, 0, "Align");
+        _close     = new Fl_Return_Button(0, 0, 0, 0, flw::labels::CLOSE.c_str());
+        _color     = new Fl_Button(0, 0, 0, 0, "Color");
+        _grid      = new GridGroup(0, 0, w(), h());
+        _label     = new Fl_Input(0, 0, 0, 0, "Label");
+        _type      = new Fl_Choice(0, 0, 0, 0, "Type");
+        _width     = new Fl_Hor_Slider(0, 0, 0, 0);
+        _line      = line;
+        _run       = false;
+
+        _grid->add(_label,     12,   1,  -1,  4);
+        _grid->add(_type,      12,   6,  -1,  4);
+        _grid->add(_align,     12,  11,  -1,  4);
+        _grid->add(_color,     12,  16,  -1,  4);
+        _grid->add(_width,     12,  21,  -1,  4);
+        _grid->add(_aggregate, 12,  26,  -1,  4);
+        _grid->add(_close,    -17,  -5,  16,  4);
+        add(_grid);
+
+        _aggregate->add("None");
+        _aggregate->add("High, Low And Last Close");
+        _aggregate->add("Sum");
+        _aggregate->textfont(flw::PREF_FONT);
+        _aggregate->textsize(flw::PREF_FONTSIZE);
+        _aggregate->tooltip("Resample data points to the chart date range.");
+        _align->add("Left");
+        _align->add("Right");
+        _align->textfont(flw::PREF_FONT);
+        _align->textsize(flw::PREF_FONTSIZE);
+        _close->callback(_ChartLineSetup::Callback, this);
+        _color->align(FL_ALIGN_LEFT);
+        _color->callback(_ChartLineSetup::Callback, this);
+        _label->textfont(flw::PREF_FONT);
+        _label->textsize(flw::PREF_FONTSIZE);
+        _type->add("Line");
+        _type->add("Dotted Line");
+        _type->add("Bar");
+        _type->add("Bar Clamp");
+        _type->add("Bar HLC");
+        _type->add("Horizontal");
+        _type->add("Expand All Horizontal Points");
+        _type->add("Expand First Horizontal Point");
+        _type->textfont(flw::PREF_FONT);
+        _type->textsize(flw::PREF_FONTSIZE);
+        _width->align(FL_ALIGN_LEFT);
+        _width->callback(_ChartLineSetup::Callback, this);
+        _width->precision(0);
+        _width->range(1, chart::MAX_LINE_WIDTH);
+        _width->value(_line.width());
+        _width->tooltip("Max Line Width.");
+
+        resizable(_grid);
+        util::labelfont(this);
+        callback(_ChartLineSetup::Callback, this);
+        size(30 * flw::PREF_FONTSIZE, 19 * flw::PREF_FONTSIZE);
+        set_modal();
+        util::center_window(this, parent);
+        _grid->do_layout();
+        _ChartLineSetup::Callback(_width, this);
+        update_widgets();
+    }
+
+    /** @brief Callback for all widgets.
+    *
+    */
+    static void Callback(Fl_Widget* w, void* o) {
+        auto self = static_cast<_ChartLineSetup*>(o);
+
+        if (w == self) {
+        }
+        else if (w == self->_color) {
+            self->_color->color(fl_show_colormap(self->_line.color()));
+        }
+        else if (w == self->_width) {
+            auto l = util::format("Width %u", static_cast<unsigned>(static_cast<Fl_Hor_Slider*>(w)->value()));
+            w->copy_label(l.c_str());
+            self->redraw();
+        }
+        else if (w == self->_close) {
+            self->_run = false;
+            self->update_line();
+            self->hide();
+        }
+    }
+
+    /** @brief Show dialog.
+    *
+    */
+    void run() {
+        _run = true;
+        show();
+
+        while (_run == true) {
+            Fl::wait();
+            Fl::flush();
+        }
+    }
+
+    /** @brief Update input chart line.
+    *
+    */
+    void update_line() {
+        _line.set_label(_label->value());
+        _line.set_width(_width->value());
+        _line.set_color(_color->color());
+
+        if (_type->value() == 0)      _line.set_type(chart::LineType::LINE);
+        else if (_type->value() == 1) _line.set_type(chart::LineType::LINE_DOT);
+        else if (_type->value() == 2) _line.set_type(chart::LineType::BAR);
+        else if (_type->value() == 3) _line.set_type(chart::LineType::BAR_CLAMP);
+        else if (_type->value() == 4) _line.set_type(chart::LineType::BAR_HLC);
+        else if (_type->value() == 5) _line.set_type(chart::LineType::HORIZONTAL);
+        else if (_type->value() == 6) _line.set_type(chart::LineType::EXPAND_HORIZONTAL_ALL);
+        else if (_type->value() == 7) _line.set_type(chart::LineType::EXPAND_HORIZONTAL_FIRST);
+
+        if (_align->value() == 0) _line.set_align(FL_ALIGN_LEFT);
+        else                      _line.set_align(FL_ALIGN_RIGHT);
+
+        _line.set_aggregate(static_cast<chart::Aggregate>(_aggregate->value()));
+    }
+
+    /** @brief Update widgets with chart line data.
+    *
+    */
+    void update_widgets() {
+        _label->value(_line.label().c_str());
+        _color->color(_line.color());
+        _ChartLineSetup::Callback(_width, this);
+
+        if (_line.type() == chart::LineType::LINE)                         _type->value(0);
+        else if (_line.type() == chart::LineType::LINE_DOT)                _type->value(1);
+        else if (_line.type() == chart::LineType::BAR)                     _type->value(2);
+        else if (_line.type() == chart::LineType::BAR_CLAMP)               _type->value(3);
+        else if (_line.type() == chart::LineType::BAR_HLC)                 _type->value(4);
+        else if (_line.type() == chart::LineType::HORIZONTAL)              _type->value(5);
+        else if (_line.type() == chart::LineType::EXPAND_HORIZONTAL_ALL)   _type->value(6);
+        else if (_line.type() == chart::LineType::EXPAND_HORIZONTAL_FIRST) _type->value(7);
+
+        if (_line.align() == FL_ALIGN_LEFT) _align->value(0);
+        else                                _align->value(1);
+
+        _aggregate->value(static_cast<int>(_line.aggregate()));
+    }
+};
+
+} // flw::priv
+} // flw
+
+/*
+ *
+ *         /\
+ *        /  \   _ __ ___  __ _
+ *       / /\ \ | '__/ _ \/ _` |
+ *      / ____ \| | |  __/ (_| |
+ *     /_/    \_\_|  \___|\__,_|
+ *
+ *
+ */
+
+/** @brief Add one chart line.
+*
+* Max flw::chart::Area::MAX_LINES lines.
+*
+* @param[in] chart_line  Line object.
+*
+* @return True if added. false if there are to many already.
+*/
+bool flw::chart::Area::add_line(const Line& chart_line) {
+    if (_lines.size() >= flw::chart::Area::MAX_LINES) {
+        return false;
+    }
+
+    _lines.push_back(chart_line);
+    Fl::redraw();
+
+    return true;
+}
+
+/** @brief Add one data point to a line.
+*
+* All lines in this area that are calculated from the line (also in several steps) are updated.\n
+* Use Chart::append() to also update lines in other areas.\n
+*
+* @param[in] index  Line index.
+* @param[in] key    Date key, must be later than last date in the line.
+* @param[in] high   High Y value.
+* @param[in] low    Low Y value.
+* @param[in] close  Close Y value.
+*
+* @return True if point was added.
+*/
+bool flw::chart::Area::append(size_t index, const gnu::DateKey& key, double high, double low, double close) {
+    if (index >= _lines.size() || _lines[index].append(key, high, low, close) == false) {
+        return false;
+    }
+
+    std::vector<Line*> lines;
+
+    for (auto& line : _lines) {
+        lines.push_back(&line);
+    }
+
+    priv::_chart_update_lines(lines, &_lines[index]);
+    return true;
+}
+
+/** @brief Return max clamp value.
+*
+* @return Value or nullopt.
+*/
+std::optional<double> flw::chart::Area::clamp_max() const {
+    if (std::isfinite(_clamp_max) == true) {
+        return _clamp_max;
+    }
+
+    return std::nullopt;
+}
+
+/** @brief Return min clamp value.
+*
+* @return Value or nullopt.
+*/
+std::optional<double> flw::chart::Area::clamp_min() const {
+    if (std::isfinite(_clamp_min) == true) {
+        return _clamp_min;
+    }
+
+    return std::nullopt;
+}
+
+/** @brief Print debug info to terminal.
+*/
+void flw::chart::Area::debug() const {
+#ifdef DEBUG
+    printf("\t--------------------------------------\n");
+    printf("\tArea: %d\n", static_cast<int>(_area));
+
+    if (_percent >= priv::_CHART_MIN_AREA_SIZE) {
+        printf("\t\tx, y:       %12d, %4d\n", _rect.x(), _rect.y());
+        printf("\t\tw, h:       %12d, %4d\n", _rect.w(), _rect.h());
+        printf("\t\tclamp_max:  %18.4f\n", _clamp_max);
+        printf("\t\tclamp_min:  %18.4f\n", _clamp_min);
+        printf("\t\tpercent:    %18d\n", _percent);
+        printf("\t\tlines:      %18d\n", static_cast<int>(_lines.size()));
+        printf("\t\tselected:   %18d\n", static_cast<int>(_selected));
+
+        _left.debug("left");
+        _right.debug("right");
+        auto c = 0;
+
+        for (const auto& l : _lines) {
+            l.debug(c++);
+        }
+
+        fflush(stdout);
+    }
+#endif
+}
+
+/** @brief Delete chart line
+*
+* @param[in] index  Line index.
+*/
+void flw::chart::Area::delete_line(size_t index) {
+    size_t count = 0;
+
+    for (auto it = _lines.begin(); it != _lines.end(); ++it) {
+        if (index == count) {
+            _lines.erase(it);
+
+            if (_lines.size() == 0) {
+                _selected = 0;
+            }
+            else if (_selected >= _lines.size()) {
+                _selected = _lines.size() - 1;
+            }
+
+            break;
+        }
+
+        count++;
+    }
+}
+
+/** @brief Reset all data and values to default value.
+*
+*/
+void flw::chart::Area::reset() {
+    _clamp_max = INFINITY;
+    _clamp_min = INFINITY;
+    _percent   = 0;
+    _rect      = Fl_Rect();
+    _selected  = 0;
+
+    _left.reset();
+    _right.reset();
+    _lines.clear();
+}
+
+/** @brief Return current selected line.
+*
+* @return Line or NULL.
+*/
+flw::chart::Line* flw::chart::Area::selected_line() {
+    if (_selected >= _lines.size()) {
+        return nullptr;
+    }
+
+    return &_lines[_selected];
+}
+
+/*
+ *      _____      _       _
+ *     |  __ \    (_)     | |
+ *     | |__) |__  _ _ __ | |_
+ *     |  ___/ _ \| | '_ \| __|
+ *     | |  | (_) | | | | | |_
+ *     |_|   \___/|_|_| |_|\__|
+ *
+ *
+ */
+
+/** @brief Create empty point.
+*
+*/
+flw::chart::Point::Point() {
+    high = low = close = 0.0;
+}
+
+/** @brief Create point.
+*
+* @param[in] date   Valid date.
+* @param[in] value  Y value for high, low and close.
+*/
+flw::chart::Point::Point(const std::string& date, double value) {
+    auto valid_date = priv::_chart_date(date);
+
+    if (std::isfinite(value) == true &&
+        fabs(value) < chart::MAX_VALUE &&
+        valid_date != "") {
+
+        this->date = valid_date;
+        this->high = this->low = this->close = value;
+    }
+    else {
+        high = low = close = 0.0;
+    }
+}
+
+/** @brief Create point.
+*
+* Values are moved if they are out of size order.\n
+* Invalid date sets all values to 0.0.\n
+*
+* @param[in] date   Valid date.
+* @param[in] high   High Y value.
+* @param[in] low    Low Y value.
+* @param[in] close  Close Y value.
+*/
+flw::chart::Point::Point(const std::string& date, double high, double low, double close) {
+    auto valid_date = priv::_chart_date(date);
+
+    if (std::isfinite(high) == true &&
+        std::isfinite(low) == true &&
+        std::isfinite(close) == true &&
+        fabs(high) < chart::MAX_VALUE &&
+        fabs(low) < chart::MAX_VALUE &&
+        fabs(close) < chart::MAX_VALUE &&
+        valid_date != "") {
+
+        if (low > high) {
+            auto tmp = low;
+            low = high;
+            high = tmp;
+        }
+
+        if (close > high) {
+            auto tmp = high;
+            high = close;
+            close = tmp;
+        }
+
+        if (close < low) {
+            auto tmp = low;
+            low = close;
+            close = tmp;
+        }
+
+        this->date  = valid_date;
+        this->high  = high;
+        this->low   = low;
+        this->close = close;
+    }
+    else {
+        this->high = this->low = this->close = 0.0;
+    }
+}
+
+/** @brief Convert data serie using ATR algorithm.
+*
+* @param[in] in    Vector with Point objects.
+* @param[in] days  Number of days.
+*
+* @return Result vector with Point objects.
+*/
+flw::chart::PointVector flw::chart::Point::ATR(const PointVector& in, size_t days) {
+    PointVector res;
+    auto        series = Series(in);
+
+    priv::_chart_indicator(series, Algorithm::ATR, days, [&](size_t f, double value) { res.push_back(Point(in[f].date, value)); });
+    return res;
+}
+
+/** @brief Convert data serie using ATR algorithm.
+*
+* @param[in] in    Data serie.
+* @param[in] days  Number of days.
+*
+* @return Result serie.
+*/
+flw::chart::Series flw::chart::Point::ATR(const Series& in, size_t days) {
+    Series res;
+
+    priv::_chart_indicator(in, Algorithm::ATR, days, [&](size_t f, double value) { res.push_back(in.key(f), value); });
+    return res;
+}
+
+/** @brief Do a binary search for a date/time.
+*
+* @param[in] in   Vector with Point objects.
+* @param[in] key  Date to search for.
+*
+* @return Result vector with Point objects.
+*/
+size_t flw::chart::Point::BinarySearch(const PointVector& in, const Point& key) {
+    auto it = std::lower_bound(in.begin(), in.end(), key);
+
+    if (it == in.end() || *it != key) {
+        return static_cast<size_t>(-1);
+    }
+    else {
+        return std::distance(in.begin(), it);
+    }
+}
+
+/** @brief Create date serie.
+*
+* @param[in] start_date  Start date.
+* @param[in] stop_date   Stop date.
+* @param[in] range       Date range.
+* @param[in] block       Optional list of dates to remove from reference date serie.
+*
+* @return Result vector with Point objects.
+*
+* @see DateGenerator for a serie that does not store the dates.
+*/
+flw::chart::PointVector flw::chart::Point::DateSerie(const std::string& start_date, const std::string& stop_date, DateRange range, const PointVector& block) {
+    return DateGenerator(start_date, stop_date, range, block).points();
+}
+
+/** @brief Convert data serie to monthly data.
+*
+* Same as Series::Resample() with DateRange::MONTH.\n
+*
+* @param[in] in   Vector with Point objects.
+* @param[in] sum  True to add values for a month, false to use highest/lowest and last close data.
+*
+* @return Result vector with Point objects, date is last day in month.
+*/
+flw::chart::PointVector flw::chart::Point::DayToMonth(const PointVector& in, bool sum) {
+    return Series::Resample(Series(in), DateRange::MONTH, 1, sum).points();
+}
+
+/** @brief Convert data serie to weekly data.
+*
+* Same as Series::Resample() with DateRange::FRIDAY or DateRange::SUNDAY but any day can be used as the last day in week.\n
+*
+* @param[in] in       Vector with Point objects.
+* @param[in] weekday  What day to use in week.
+* @param[in] sum      True to add values for a week, false to use highest/lowest and last close data.
+*
+* @return Result vector with Point objects, date is the weekday on or after the data points.
+*/
+flw::chart::PointVector flw::chart::Point::DayToWeek(const PointVector& in, gnu::Date::Day weekday, bool sum) {
+    auto res = Series();
+
+    if (weekday == gnu::Date::Day::INVALID) {
+        return PointVector();
+    }
+
+    priv::_chart_resample(Series(in), DateRange::SUNDAY, 1, static_cast<int>(weekday) - 1, sum, &res);
+    return res.points();
+}
+
+/** @brief Print value.
+*
+*/
+void flw::chart::Point::debug() const {
+#ifdef DEBUG
+    printf("%s, %20.8f, %20.8f, %20.8f\n", date.c_str(), high, low, close);
+#endif
+}
+
+/** @brief Print values.
+*
+* @param[in] in  Vector with Point objects.
+*/
+void flw::chart::Point::Debug(const PointVector& in) {
+#ifdef DEBUG
+    printf("\nPointVector(%u)\n", static_cast<unsigned>(in.size()));
+
+    for (const auto& data : in) {
+        data.debug();
+    }
+
+    fflush(stdout);
+#else
+    (void) in;
+#endif
+}
+
+/** @brief Convert data serie using exponential moving average algorithm.
+*
+* @param[in] in    Vector with Point objects.
+* @param[in] days  Number of days.
+*
+* @return Result vector with Point objects.
+*/
+flw::chart::PointVector flw::chart::Point::ExponentialMovingAverage(const PointVector& in, size_t days) {
+    PointVector res;
+    auto        series = Series(in);
+
+    priv::_chart_indicator(series, Algorithm::EXP_MOVING_AVERAGE, days, [&](size_t f, double value) { res.push_back(Point(in[f].date, value)); });
+    return res;
+}
+
+/** @brief Convert data serie using exponential moving average.
+*
+* @param[in] in    Data serie.
+* @param[in] days  Number of days.
+*
+* @return Result serie.
+*/
+flw::chart::Series flw::chart::Point::ExponentialMovingAverage(const Series& in, size_t days) {
+    Series res;
+
+    priv::_chart_indicator(in, Algorithm::EXP_MOVING_AVERAGE, days, [&](size_t f, double value) { res.push_back(in.key(f), value); });
+    return res;
+}
+
+/** @brief Create a data serie with fixed Y value.
+*
+* @param[in] in     Vector with Point objects (only date is used).
+* @param[in] value  Y values.
+*
+* @return Result vector with Point objects.
+*/
+flw::chart::PointVector flw::chart::Point::Fixed(const PointVector& in, double value) {
+    PointVector res;
+
+    for (const auto& data : in) {
+        res.push_back(Point(data.date, value));
+    }
+
+    return res;
+}
+
+/** @brief Create a data serie with fixed Y value.
+*
+* @param[in] in     Data serie (only dates are used).
+* @param[in] value  Y values.
+*
+* @return Result serie.
+*/
+flw::chart::Series flw::chart::Point::Fixed(const Series& in, double value) {
+    Series res;
+
+    res.reserve(in.size());
+
+    for (const auto& key : in.keys()) {
+        res.push_back(key, value);
+    }
+
+    return res;
+}
+
+/** @brief Load data from csv file.
+*
+* @param[in] filename  Valid text file name.
+* @param[in] sep       Column separator.
+*
+* @return Result vector with Point objects.
+*/
+flw::chart::PointVector flw::chart::Point::LoadCSV(const std::string& filename, const std::string& sep) {
+    return Series::LoadCSV(filename, sep).points();
+}
+
+/** @brief Modify chart data.
+*
+* @param[in] in      Vector with Point objects.
+* @param[in] modify  Type of modify.
+* @param[in] value   Value to use.
+*
+* @return Result vector with Point objects.
+*/
+flw::chart::PointVector flw::chart::Point::Modify(const PointVector& in, Modifier modify, double value) {
+    PointVector res;
+
+    if (fabs(value) < chart::MIN_VALUE) {
+        return res;
+    }
+
+    for (const auto& data : in) {
+        switch (modify) {
+            case Modifier::ADDITION:
+                res.push_back(Point(data.date, data.high + value, data.low + value, data.close + value));
+                break;
+
+            case Modifier::SUBTRACTION:
+                res.push_back(Point(data.date, data.high - value, data.low - value, data.close - value));
+                break;
+
+            case Modifier::MULTIPLICATION:
+                res.push_back(Point(data.date, data.high * value, data.low * value, data.close * value));
+                break;
+
+            case Modifier::DIVISION:
+                res.push_back(Point(data.date, data.high / value, data.low / value, data.close / value));
+                break;
+        }
+    }
+
+    return res;
+}
+
+/** @brief Modify chart data.
+*
+* @param[in] in      Data serie.
+* @param[in] modify  Type of modify.
+* @param[in] value   Value to use.
+*
+* @return Result serie.
+*/
+flw::chart::Series flw::chart::Point::Modify(const Series& in, Modifier modify, double value) {
+    Series res;
+
+    if (fabs(value) < chart::MIN_VALUE) {
+        return res;
+    }
+
+    res.reserve(in.size());
+
+    for (size_t f = 0; f < in.size(); f++) {
+        auto high  = in.high()[f];
+        auto low   = in.low()[f];
+        auto close = in.close()[f];
+
+        switch (modify) {
+            case Modifier::ADDITION:
+                res.push_back(in.key(f), high + value, low + value, close + value);
+                break;
+
+            case Modifier::SUBTRACTION:
+                res.push_back(in.key(f), high - value, low - value, close - value);
+                break;
+
+            case Modifier::MULTIPLICATION:
+                res.push_back(in.key(f), high * value, low * value, close * value);
+                break;
+
+            case Modifier::DIVISION:
+                res.push_back(in.key(f), high / value, low / value, close / value);
+                break;
+        }
+    }
+
+    return res;
+}
+
+/** @brief Convert data serie using momentum algorithm.
+*
+* @param[in] in    Vector with Point objects.
+* @param[in] days  Number of days.
+*
+* @return Result vector with Point objects.
+*/
+flw::chart::PointVector flw::chart::Point::Momentum(const PointVector& in, size_t days) {
+    PointVector res;
+    auto        series = Series(in);
+
+    priv::_chart_indicator(series, Algorithm::MOMENTUM, days, [&](size_t f, double value) { res.push_back(Point(in[f].date, value)); });
+    return res;
+}
+
+/** @brief Convert data serie using momentum algorithm.
+*
+* @param[in] in    Data serie.
+* @param[in] days  Number of days.
+*
+* @return Result serie.
+*/
+flw::chart::Series flw::chart::Point::Momentum(const Series& in, size_t days) {
+    Series res;
+
+    priv::_chart_indicator(in, Algorithm::MOMENTUM, days, [&](size_t f, double value) { res.push_back(in.key(f), value); });
+    return res;
+}
+
+/** @brief Convert data serie using moving average algorithm.
+*
+* @param[in] in    Vector with Point objects.
+* @param[in] days  Number of days.
+*
+* @return Result vector with Point objects.
+*/
+flw::chart::PointVector flw::chart::Point::MovingAverage(const PointVector& in, size_t days) {
+    PointVector res;
+    auto        series = Series(in);
+
+    priv::_chart_indicator(series, Algorithm::MOVING_AVERAGE, days, [&](size_t f, double value) { res.push_back(Point(in[f].date, value)); });
+    return res;
+}
+
+/** @brief Convert data serie using moving average algorithm.
+*
+* @param[in] in    Data serie.
+* @param[in] days  Number of days.
+*
+* @return Result serie.
+*/
+flw::chart::Series flw::chart::Point::MovingAverage(const Series& in, size_t days) {
+    Series res;
+
+    priv::_chart_indicator(in, Algorithm::MOVING_AVERAGE, days, [&](size_t f, double value) { res.push_back(in.key(f), value); });
+    return res;
+}
+
+/** @brief Conmvert range value to a string.
+*
+* @param[in] range  Range value.
+*
+* @return String value, one of ("DAY", "WEEKDAY", "FRIDAY", "SUNDAY", "MONTH", "HOUR", "MIN", "SEC").
+*/
+std::string flw::chart::Point::RangeToString(DateRange range) {
+    static const std::string NAMES[] = { "DAY", "WEEKDAY", "FRIDAY", "SUNDAY", "MONTH", "HOUR", "MIN", "SEC", "", };
+    return NAMES[static_cast<unsigned>(range)];
+}
+
+/** @brief Convert data serie using rsi algorithm.
+*
+* @param[in] in    Vector with Point objects.
+* @param[in] days  Number of days.
+*
+* @return Result vector with Point objects.
+*/
+flw::chart::PointVector flw::chart::Point::RSI(const PointVector& in, size_t days) {
+    PointVector res;
+    auto        series = Series(in);
+
+    priv::_chart_indicator(series, Algorithm::RSI, days, [&](size_t f, double value) { res.push_back(Point(in[f].date, value)); });
+    return res;
+}
+
+/** @brief Convert data serie using rsi algorithm.
+*
+* @param[in] in    Data serie.
+* @param[in] days  Number of days.
+*
+* @return Result serie.
+*/
+flw::chart::Series flw::chart::Point::RSI(const Series& in, size_t days) {
+    Series res;
+
+    priv::_chart_indicator(in, Algorithm::RSI, days, [&](size_t f, double value) { res.push_back(in.key(f), value); });
+    return res;
+}
+
+/** @brief Save points to an csv file.
+*
+* @param[in] in        Vector with Point objects.
+* @param[in] filename  Result file name.
+* @param[in] sep       Column separator.
+*
+* @return True if ok.
+*/
+bool flw::chart::Point::SaveCSV(const PointVector& in, const std::string& filename, const std::string& sep) {
+    std::string csv;
+
+    csv.reserve(in.size() * 40 + 256);
+
+    for (const auto& data : in) {
+        char buffer[2'000];
+        snprintf(buffer, 2'000, "%s%s%s%s%s%s%s\n", data.date.c_str(), sep.c_str(), gnu::json::format_number(data.high).c_str(), sep.c_str(), gnu::json::format_number(data.low).c_str(), sep.c_str(), gnu::json::format_number(data.close).c_str());
+        csv += buffer;
+    }
+
+    return gnu::file::write(filename, csv.c_str(), csv.size());
+}
+
+/** @brief Convert data serie using standard deviation.
+*
+* @param[in] in    Vector with Point objects.
+* @param[in] days  Number of days.
+*
+* @return Result vector with Point objects.
+*/
+flw::chart::PointVector flw::chart::Point::StdDev(const PointVector& in, size_t days) {
+    PointVector res;
+    auto        series = Series(in);
+
+    priv::_chart_indicator(series, Algorithm::STD_DEV, days, [&](size_t f, double value) { res.push_back(Point(in[f].date, value)); });
+    return res;
+}
+
+/** @brief Convert data serie using standard deviation.
+*
+* @param[in] in    Data serie.
+* @param[in] days  Number of days.
+*
+* @return Result serie.
+*/
+flw::chart::Series flw::chart::Point::StdDev(const Series& in, size_t days) {
+    Series res;
+
+    priv::_chart_indicator(in, Algorithm::STD_DEV, days, [&](size_t f, double value) { res.push_back(in.key(f), value); });
+    return res;
+}
+
+/** @brief Convert data serie using stochastics algorithm.
+*
+* @param[in] in    Vector with Point objects.
+* @param[in] days  Number of days.
+*
+* @return Result vector with Point objects.
+*/
+flw::chart::PointVector flw::chart::Point::Stochastics(const PointVector& in, size_t days) {
+    PointVector res;
+    auto        series = Series(in);
+
+    priv::_chart_indicator(series, Algorithm::STOCHASTICS, days, [&](size_t f, double value) { res.push_back(Point(in[f].date, value)); });
+    return res;
+}
+
+/** @brief Convert data serie using stochastics algorithm.
+*
+* @param[in] in    Data serie.
+* @param[in] days  Number of days.
+*
+* @return Result serie.
+*/
+flw::chart::Series flw::chart::Point::Stochastics(const Series& in, size_t days) {
+    Series res;
+
+    priv::_chart_indicator(in, Algorithm::STOCHASTICS, days, [&](size_t f, double value) { res.push_back(in.key(f), value); });
+    return res;
+}
+
+/** @brief Convert string to range.
+*
+* @param[in] range  Range string.
+*
+* @return Range value or DateRange::DAY for invalid input string.
+*/
+flw::chart::DateRange flw::chart::Point::StringToRange(const std::string& range) {
+    if (range == "WEEKDAY")     return DateRange::WEEKDAY;
+    else if (range == "FRIDAY") return DateRange::FRIDAY;
+    else if (range == "SUNDAY") return DateRange::SUNDAY;
+    else if (range == "MONTH")  return DateRange::MONTH;
+    else if (range == "HOUR")   return DateRange::HOUR;
+    else if (range == "MIN")    return DateRange::MIN;
+    else if (range == "SEC")    return DateRange::SEC;
+    else                        return DateRange::DAY;
+}
+
 /*
- *           _____ _                _   _      _             _____      _               
- *          / ____| |              | | | |    (_)           / ____|    | |              
- *         | |    | |__   __ _ _ __| |_| |     _ _ __   ___| (___   ___| |_ _   _ _ __  
- *         | |    | '_ \ / _` | '__| __| |    | | '_ \ / _ \\___ \ / _ \ __| | | | '_ \ 
- *         | |____| | | | (_| | |  | |_| |____| | | | |  __/____) |  __/ |_| |_| | |_) |
- *          \_____|_| |_|\__,_|_|   \__|______|_|_| |_|\___|_____/ \___|\__|\__,_| .__/ 
- *      ______                                                                   | |    
- *     |______|                                                                  |_|    
+ *       _____           _
+ *      / ____|         (_)
+ *     | (___   ___ _ __ _  ___  ___
+ *      \___ \ / _ \ '__| |/ _ \/ __|
+ *      ____) |  __/ |  | |  __/\__ \
+ *     |_____/ \___|_|  |_|\___||___/
+ *
+ *
  */
 
-/** @brief Chart line settings dialog.
+namespace flw {
+namespace chart {
+
+/** @brief Memory mapped snapshot file that is shared by all series loaded from it.
 *
-* @private
+* Series only ask for the pages of visible data points and a margin on each side.\n
+* When more than the memory budget has been asked for, the least recently used ranges are dropped.\n
+* Dropped pages are read again from the file by the system if they are used.\n
 */
-class _ChartLineSetup : public Fl_Double_Window {
+class SeriesPages {
 public:
-    chart::Line&                _line;
-    Fl_Button*                  _close;
-    Fl_Button*                  _color;
-    Fl_Choice*                  _align;
-    Fl_Choice*                  _type;
-    Fl_Hor_Slider*              _width;
-    Fl_Input*                   _label;
-    GridGroup*                  _grid;
-    bool                        _run;
+    typedef std::pair<size_t, size_t> Range; ///< @brief Byte offset and size.
 
-public:
-    /** @brief Create dialog but don't show it.
-    *
-    */
-    _ChartLineSetup(Fl_Window* parent, chart::Line& line) :
-    Fl_Double_Window(0, 0, 10, 10, "Chart - Line Properties"),
-    _line(line) {
-        end();
+    SeriesPages(const std::string& filename, size_t budget) : _file(filename) {
+        _budget = budget;
+        _cold   = true;
+        _used   = 0;
+    }
+
+    const gnu::file::MMap& file() const {
+        return _file;
+    }
+
+    size_t offset(const void* data) const {
+        return static_cast<size_t>(static_cast<const char*>(data) - _file.data());
+    }
+
+    void use(const std::vector<Range>& ranges) {
+        for (auto it = _lru.begin(); it != _lru.end(); ++it) {
+            if (_contains(*it, ranges) == true) { // Already loaded, move it to the back.
+                auto used = *it;
+                _lru.erase(it);
+                _lru.push_back(used);
+                return;
+            }
+        }
+
+        for (const auto& range : ranges) {
+            _file.advise(range.first, range.second, true);
+            _used += range.second;
+        }
+
+        auto drop = _cold;
+
+        _lru.push_back(ranges);
+        _cold = false;
+
+        while (_used > _budget && _lru.size() > 1) {
+            for (const auto& range : _lru.front()) {
+                _used -= range.second;
+            }
+
+            _lru.pop_front();
+            drop = true;
+        }
+
+        if (drop == true) {
+            _drop();
+        }
+    }
+
+private:
+    static bool _contains(const std::vector<Range>& outer, const std::vector<Range>& inner) {
+        for (const auto& i : inner) {
+            auto found = false;
+
+            for (const auto& o : outer) {
+                if (i.first >= o.first && i.first + i.second <= o.first + o.second) {
+                    found = true;
+                    break;
+                }
+            }
+
+            if (found == false) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    void _drop() const { // Drop all pages except those in the kept ranges, this includes pages read when series were loaded.
+        std::vector<Range> keep;
+        size_t             pos = 0;
+
+        for (const auto& ranges : _lru) {
+            keep.insert(keep.end(), ranges.begin(), ranges.end());
+        }
+
+        std::sort(keep.begin(), keep.end());
+
+        for (const auto& range : keep) {
+            if (range.first > pos) {
+                _file.advise(pos, range.first - pos, false);
+            }
+
+            pos = std::max(pos, range.first + range.second);
+        }
+
+        if (pos < _file.size()) {
+            _file.advise(pos, _file.size() - pos, false);
+        }
+    }
+
+    gnu::file::MMap             _file;
+    std::deque<std::vector<Range>> _lru;
+    bool                        _cold;
+    size_t                      _budget;
+    size_t                      _used;
+};
+
+} // flw::chart
+} // flw
+
+/** @brief Create serie from points.
+*
+* Points with invalid dates are kept (with invalid date key) so index is same as in the input vector.
+*
+* @param[in] in  Vector with Point objects.
+*/
+flw::chart::Series::Series(const PointVector& in) {
+    reserve(in.size());
+
+    for (const auto& point : in) {
+        push_back(priv::_CHART_DATE_PARSER.parse(point.date), point.high, point.low, point.close);
+    }
+}
+
+/** @brief Load data from csv file.
+*
+* File is memory mapped and parsed in several threads for large files.\n
+* Date format is detected from the first rows and then used for all rows.\n
+* Rows with 2 columns are date and value, rows with 4 or more columns are date, high, low and close.\n
+*
+* @param[in] filename  Valid text file name.
+* @param[in] sep       Column separator.
+*
+* @return Data serie, empty if file could not be read.
+*/
+flw::chart::Series flw::chart::Series::LoadCSV(const std::string& filename, const std::string& sep) {
+    gnu::file::CSVReader reader(sep);
+    gnu::DateParser      parser;
+    priv::_ChartCSV      csv;
+    Series               res;
+    size_t               size = 0;
+
+    if (reader.open(filename) == false || reader.size() < 10) {
+        return res;
+    }
+
+    parser.parse(reader.column(0, 10)); // Detect date format once and use it for all rows.
+    csv.parser = &parser;
+    csv.series.resize(reader.split());
+
+    for (auto& series : csv.series) {
+        series.reserve(reader.size() / 20 / csv.series.size());
+    }
+
+    reader.parse(priv::_chart_csv_row, &csv);
+
+    for (const auto& series : csv.series) {
+        size += series.size();
+    }
+
+    res.reserve(size);
+
+    for (const auto& series : csv.series) {
+        res._key.vec().insert(res._key.vec().end(), series._key.begin(), series._key.end());
+        res._high.vec().insert(res._high.vec().end(), series._high.begin(), series._high.end());
+        res._low.vec().insert(res._low.vec().end(), series._low.begin(), series._low.end());
+        res._close.vec().insert(res._close.vec().end(), series._close.begin(), series._close.end());
+    }
+
+    return res;
+}
+
+/** @brief Aggregate data points into time buckets.
+*
+* All data points are read once in date order.\n
+* SEC, MIN, HOUR and DAY buckets are count units long and the date is the first second in the bucket.\n
+* WEEKDAY is the same as DAY.\n
+* FRIDAY and SUNDAY buckets are count weeks and the date is the last friday or sunday in the bucket.\n
+* MONTH buckets are count months and the date is the last day in the last month.\n
+* Dates for DAY and longer buckets are at 00:00:00.\n
+* Data points with invalid dates are skipped.\n
+*
+* @param[in] in     Input serie sorted by date.
+* @param[in] range  Bucket unit.
+* @param[in] count  Number of units in every bucket (0 is same as 1).
+* @param[in] sum    True to add values in a bucket, false to use highest/lowest and last close value.
+*
+* @return Result serie with one data point for every bucket that has data.
+*/
+flw::chart::Series flw::chart::Series::Resample(const Series& in, DateRange range, unsigned count, bool sum) {
+    auto res = Series();
+
+    priv::_chart_resample(in, range, count, (range == DateRange::FRIDAY) ? 4 : 6, sum, &res);
+    return res;
+}
+
+/** @brief Replace all data with values from arrays.
+*
+* Used for binary data where no parsing is needed.\n
+* Values are checked in the same way as for push_back(), an invalid key must have zero values.\n
+* Valid keys must be in ascending order without duplicates, invalid keys are skipped when comparing.\n
+* If pages is set then the arrays are used directly and not copied, they must be in the mapped file.\n
+* Mapped arrays are not read here, every block of chart::SERIES_BLOCK data points is checked by check() the first time it is used.\n
+*
+* @param[in] keys   Dates as seconds since 1970-01-01 00:00:00.
+* @param[in] high   High values.
+* @param[in] low    Low values.
+* @param[in] close  Close values.
+* @param[in] size   Number of values in every array.
+* @param[in] pages  Mapped file or NULL to copy values.
+*
+* @return True if all values were valid (always true for mapped arrays), if not the serie is empty.
+*/
+bool flw::chart::Series::assign(const int64_t* keys, const double* high, const double* low, const double* close, size_t size, std::shared_ptr<SeriesPages> pages) {
+    static_assert(sizeof(gnu::DateKey) == sizeof(int64_t), "DateKey must be a 64 bit integer");
+
+    clear();
+
+    if (pages != nullptr) {
+        _key.map(reinterpret_cast<const gnu::DateKey*>(keys), size);
+        _high.map(high, size);
+        _low.map(low, size);
+        _close.map(close, size);
+        _checked.assign((size + chart::SERIES_BLOCK - 1) / chart::SERIES_BLOCK, 0);
+        _pages = pages;
+        return true;
+    }
+    else if (priv::_chart_series_check(keys, high, low, close, 0, size, gnu::DateKey::INVALID) == false) {
+        return false;
+    }
+
+    auto& key = _key.vec();
+
+    key.resize(size);
+    _high.vec().assign(high, high + size);
+    _low.vec().assign(low, low + size);
+    _close.vec().assign(close, close + size);
+
+    for (size_t f = 0; f < size; f++) {
+        key[f] = gnu::DateKey::FromSeconds(keys[f]);
+    }
+
+    return true;
+}
+
+/** @brief Check mapped data points.
+*
+* Every block of chart::SERIES_BLOCK data points is only checked once, with the same rules as assign().\n
+* Keys in a block must also be later than the last valid key in the previous block.\n
+* Data points in illegal blocks are not drawn and they are replaced with invalid placeholders if the serie is copied into memory.\n
+* Data that is not mapped is always valid.\n
+*
+* @param[in] first  First index.
+* @param[in] last   Last index.
+*
+* @return True if all blocks from first to last are valid.
+*/
+bool flw::chart::Series::check(size_t first, size_t last) const {
+    if (_checked.size() == 0 || first > last || first >= size()) {
+        return true;
+    }
+
+    const auto* keys = reinterpret_cast<const int64_t*>(_key.data());
+    auto        res  = true;
+
+    last = std::min(last, size() - 1);
+
+    for (auto block = first / chart::SERIES_BLOCK; block <= last / chart::SERIES_BLOCK; block++) {
+        if (_checked[block] == 0) {
+            const auto START = block * chart::SERIES_BLOCK;
+            const auto END   = std::min(size(), START + chart::SERIES_BLOCK);
+            auto       prev  = gnu::DateKey::INVALID;
+
+            for (auto f = START; f > START - std::min(START, chart::SERIES_BLOCK) && prev == gnu::DateKey::INVALID; f--) {
+                prev = keys[f - 1];
+            }
+
+            _checked[block] = (priv::_chart_series_check(keys, _high.data(), _low.data(), _close.data(), START, END, prev) == true) ? 1 : 2;
+        }
+
+        if (_checked[block] != 1) {
+            res = false;
+        }
+    }
+
+    return res;
+}
+
+/** @brief Remove all data.
+*
+*/
+void flw::chart::Series::clear() {
+    _key.clear();
+    _high.clear();
+    _low.clear();
+    _close.clear();
+    _pages.reset();
+    _checked.clear();
+}
+
+/** @brief Get date string.
+*
+* @param[in] index  Valid index.
+*
+* @return Date as "YYYYMMDD HHMMSS" or "" for an invalid date.
+*/
+std::string flw::chart::Series::date(size_t index) const {
+    return priv::_chart_key_date(_key[index]);
+}
+
+/** @brief Get first valid date key.
+*
+* Invalid placeholders and illegal mapped blocks are skipped.
+*
+* @return Date key or an invalid key if there are no valid keys.
+*/
+gnu::DateKey flw::chart::Series::first_key() const {
+    for (size_t f = 0; f < _key.size(); f++) {
+        if (_key[f].is_invalid() == false && check(f, f) == true) {
+            return _key[f];
+        }
+    }
+
+    return gnu::DateKey();
+}
+
+/** @brief Do a binary search for a date/time.
+*
+* @param[in] key  Date to search for.
+*
+* @return Index or -1 if not found.
+*/
+size_t flw::chart::Series::find(const gnu::DateKey& key) const {
+    auto it = std::lower_bound(_key.begin(), _key.end(), key);
+
+    if (it == _key.end() || *it != key) {
+        return static_cast<size_t>(-1);
+    }
+    else {
+        return std::distance(_key.begin(), it);
+    }
+}
+
+/** @brief Copy mapped columns into memory before they are changed.
+*
+* Data points in illegal blocks are replaced with invalid placeholders.\n
+*/
+void flw::chart::Series::_own() {
+    if (_pages != nullptr) {
+        const auto SIZE = size();
+
+        check(0, SIZE);
+        _key.vec();
+        _high.vec();
+        _low.vec();
+        _close.vec();
+
+        for (size_t f = 0; f < SIZE; f++) {
+            if (_checked[f / chart::SERIES_BLOCK] != 1) {
+                _key.set(f, gnu::DateKey());
+                _high.set(f, 0.0);
+                _low.set(f, 0.0);
+                _close.set(f, 0.0);
+            }
+        }
+
+        _checked.clear();
+        _pages.reset();
+    }
+}
+
+/** @brief Get last valid date key.
+*
+* Invalid placeholders and illegal mapped blocks are skipped.
+*
+* @return Date key or an invalid key if there are no valid keys.
+*/
+gnu::DateKey flw::chart::Series::last_key() const {
+    for (auto f = _key.size(); f > 0; f--) {
+        if (_key[f - 1].is_invalid() == false && check(f - 1, f - 1) == true) {
+            return _key[f - 1];
+        }
+    }
+
+    return gnu::DateKey();
+}
+
+/** @brief Get one data point.
+*
+* @param[in] index  Valid index.
+*
+* @return Point object.
+*/
+flw::chart::Point flw::chart::Series::point(size_t index) const {
+    auto res = Point();
+
+    res.date  = date(index);
+    res.high  = _high[index];
+    res.low   = _low[index];
+    res.close = _close[index];
+
+    return res;
+}
+
+/** @brief Get all data as Point objects.
+*
+* @return Vector with Point objects.
+*/
+flw::chart::PointVector flw::chart::Series::points() const {
+    PointVector res;
+
+    res.reserve(size());
+
+    for (size_t f = 0; f < size(); f++) {
+        res.push_back(point(f));
+    }
+
+    return res;
+}
+
+/** @brief Remove latest data points.
+*
+* @param[in] count  Number of data points to remove from the end.
+*/
+void flw::chart::Series::pop_back(size_t count) {
+    _own();
+    _key.pop_back(count);
+    _high.pop_back(count);
+    _low.pop_back(count);
+    _close.pop_back(count);
+}
+
+/** @brief Remove oldest data points.
+*
+* Amortized O(count), memory is released when more than half of it is unused.\n
+*
+* @param[in] count  Number of data points to remove from the start.
+*/
+void flw::chart::Series::pop_front(size_t count) {
+    _own();
+    _key.pop_front(count);
+    _high.pop_front(count);
+    _low.pop_front(count);
+    _close.pop_front(count);
+}
+
+/** @brief Ask for data points that will be used soon.
+*
+* Only for mapped series, pages for first to last and the same number of data points on each side are loaded.\n
+* Old pages are dropped when the memory budget for the mapped file is used up.\n
+*
+* @param[in] first  First index.
+* @param[in] last   Last index.
+*/
+void flw::chart::Series::prefetch(size_t first, size_t last) const {
+    if (_pages == nullptr || size() == 0 || first > last || first >= size()) {
+        return;
+    }
 
-        _align  = new Fl_Choice(0, 0, 0, 0, "Align");
-        _close  = new Fl_Return_Button(0, 0, 0, 0, flw::labels::CLOSE.c_str());
-        _color  = new Fl_Button(0, 0, 0, 0, "Color");
-        _grid   = new GridGroup(0, 0, w(), h());
-        _label  = new Fl_Input(0, 0, 0, 0, "Label");
-        _type   = new Fl_Choice(0, 0, 0, 0, "Type");
-        _width  = new Fl_Hor_Slider(0, 0, 0, 0);
-        _line   = line;
-        _run    = false;
+    last = std::min(last, size() - 1);
 
-        _grid->add(_label,     12,   1,  -1,  4);
-        _grid->add(_type,      12,   6,  -1,  4);
-        _grid->add(_align,     12,  11,  -1,  4);
-        _grid->add(_color,     12,  16,  -1,  4);
-        _grid->add(_width,     12,  21,  -1,  4);
-        _grid->add(_close,    -17,  -5,  16,  4);
-        add(_grid);
+    const auto MARGIN = last - first + 1;
+    const auto START  = (first > MARGIN) ? first - MARGIN : 0;
+    const auto STOP   = std::min(size(), last + MARGIN + 1);
+    const auto COUNT  = STOP - START;
 
-        _align->add("Left");
-        _align->add("Right");
-        _align->textfont(flw::PREF_FONT);
-        _align->textsize(flw::PREF_FONTSIZE);
-        _close->callback(_ChartLineSetup::Callback, this);
-        _color->align(FL_ALIGN_LEFT);
-        _color->callback(_ChartLineSetup::Callback, this);
-        _label->textfont(flw::PREF_FONT);
-        _label->textsize(flw::PREF_FONTSIZE);
-        _type->add("Line");
-        _type->add("Dotted Line");
-        _type->add("Bar");
-        _type->add("Bar Clamp");
-        _type->add("Bar HLC");
-        _type->add("Horizontal");
-        _type->add("Expand All Horizontal Points");
-        _type->add("Expand First Horizontal Point");
-        _type->textfont(flw::PREF_FONT);
-        _type->textsize(flw::PREF_FONTSIZE);
-        _width->align(FL_ALIGN_LEFT);
-        _width->callback(_ChartLineSetup::Callback, this);
-        _width->precision(0);
-        _width->range(1, chart::MAX_LINE_WIDTH);
-        _width->value(_line.width());
-        _width->tooltip("Max Line Width.");
+    _pages->use({
+        SeriesPages::Range(_pages->offset(_key.data() + START), COUNT * sizeof(gnu::DateKey)),
+        SeriesPages::Range(_pages->offset(_high.data() + START), COUNT * sizeof(double)),
+        SeriesPages::Range(_pages->offset(_low.data() + START), COUNT * sizeof(double)),
+        SeriesPages::Range(_pages->offset(_close.data() + START), COUNT * sizeof(double)),
+    });
+}
 
-        resizable(_grid);
-        util::labelfont(this);
-        callback(_ChartLineSetup::Callback, this);
-        size(30 * flw::PREF_FONTSIZE, 16 * flw::PREF_FONTSIZE);
-        set_modal();
-        util::center_window(this, parent);
-        _grid->do_layout();
-        _ChartLineSetup::Callback(_width, this);
-        update_widgets();
-    }
+/** @brief Add data point.
+*
+* Same rules as for Point, values are moved if they are out of size order.\n
+* Invalid values sets date key to invalid and all values to 0.0.\n
+*
+* @param[in] key    Date key.
+* @param[in] high   High Y value.
+* @param[in] low    Low Y value.
+* @param[in] close  Close Y value.
+*/
+void flw::chart::Series::push_back(const gnu::DateKey& key, double high, double low, double close) {
+    _own();
 
-    /** @brief Callback for all widgets.
-    *
-    */
-    static void Callback(Fl_Widget* w, void* o) {
-        auto self = static_cast<_ChartLineSetup*>(o);
+    if (std::isfinite(high) == true &&
+        std::isfinite(low) == true &&
+        std::isfinite(close) == true &&
+        fabs(high) < chart::MAX_VALUE &&
+        fabs(low) < chart::MAX_VALUE &&
+        fabs(close) < chart::MAX_VALUE &&
+        key.is_invalid() == false) {
 
-        if (w == self) {
-        }
-        else if (w == self->_color) {
-            self->_color->color(fl_show_colormap(self->_line.color()));
-        }
-        else if (w == self->_width) {
-            auto l = util::format("Width %u", static_cast<unsigned>(static_cast<Fl_Hor_Slider*>(w)->value()));
-            w->copy_label(l.c_str());
-            self->redraw();
-        }
-        else if (w == self->_close) {
-            self->_run = false;
-            self->update_line();
-            self->hide();
+        if (low > high) {
+            std::swap(low, high);
         }
-    }
 
-    /** @brief Show dialog.
-    *
-    */
-    void run() {
-        _run = true;
-        show();
+        if (close > high) {
+            std::swap(close, high);
+        }
 
-        while (_run == true) {
-            Fl::wait();
-            Fl::flush();
+        if (close < low) {
+            std::swap(close, low);
         }
-    }
 
-    /** @brief Update input chart line.
-    *
-    */
-    void update_line() {
-        _line.set_label(_label->value());
-        _line.set_width(_width->value());
-        _line.set_color(_color->color());
+        _key.push_back(key);
+        _high.push_back(high);
+        _low.push_back(low);
+        _close.push_back(close);
+    }
+    else {
+        _key.push_back(gnu::DateKey());
+        _high.push_back(0.0);
+        _low.push_back(0.0);
+        _close.push_back(0.0);
+    }
+}
 
-        if (_type->value() == 0)      _line.set_type(chart::LineType::LINE);
-        else if (_type->value() == 1) _line.set_type(chart::LineType::LINE_DOT);
-        else if (_type->value() == 2) _line.set_type(chart::LineType::BAR);
-        else if (_type->value() == 3) _line.set_type(chart::LineType::BAR_CLAMP);
-        else if (_type->value() == 4) _line.set_type(chart::LineType::BAR_HLC);
-        else if (_type->value() == 5) _line.set_type(chart::LineType::HORIZONTAL);
-        else if (_type->value() == 6) _line.set_type(chart::LineType::EXPAND_HORIZONTAL_ALL);
-        else if (_type->value() == 7) _line.set_type(chart::LineType::EXPAND_HORIZONTAL_FIRST);
+/** @brief Reserve memory for data points.
+*
+* @param[in] size  Number of data points.
+*/
+void flw::chart::Series::reserve(size_t size) {
+    _own();
+    _key.vec().reserve(size);
+    _high.vec().reserve(size);
+    _low.vec().reserve(size);
+    _close.vec().reserve(size);
+}
 
-        if (_align->value() == 0) _line.set_align(FL_ALIGN_LEFT);
-        else                      _line.set_align(FL_ALIGN_RIGHT);
+/** @brief Change values for one data point.
+*
+* Same rules as for push_back() but invalid values are rejected.\n
+*
+* @param[in] index  Valid index.
+* @param[in] high   High Y value.
+* @param[in] low    Low Y value.
+* @param[in] close  Close Y value.
+*
+* @return True if values were changed.
+*/
+bool flw::chart::Series::set(size_t index, double high, double low, double close) {
+    if (index >= size() ||
+        priv::_chart_is_value(high) == false ||
+        priv::_chart_is_value(low) == false ||
+        priv::_chart_is_value(close) == false) {
+        return false;
     }
 
-    /** @brief Update widgets with chart line data.
-    *
-    */
-    void update_widgets() {
-        _label->value(_line.label().c_str());
-        _color->color(_line.color());
-        _ChartLineSetup::Callback(_width, this);
+    if (low > high) {
+        std::swap(low, high);
+    }
 
-        if (_line.type() == chart::LineType::LINE)                         _type->value(0);
-        else if (_line.type() == chart::LineType::LINE_DOT)                _type->value(1);
-        else if (_line.type() == chart::LineType::BAR)                     _type->value(2);
-        else if (_line.type() == chart::LineType::BAR_CLAMP)               _type->value(3);
-        else if (_line.type() == chart::LineType::BAR_HLC)                 _type->value(4);
-        else if (_line.type() == chart::LineType::HORIZONTAL)              _type->value(5);
-        else if (_line.type() == chart::LineType::EXPAND_HORIZONTAL_ALL)   _type->value(6);
-        else if (_line.type() == chart::LineType::EXPAND_HORIZONTAL_FIRST) _type->value(7);
+    if (close > high) {
+        std::swap(close, high);
+    }
 
-        if (_line.align() == FL_ALIGN_LEFT) _align->value(0);
-        else                                _align->value(1);
+    if (close < low) {
+        std::swap(close, low);
     }
-};
 
-} // flw::priv
-} // flw
+    _own();
+    _high.set(index, high);
+    _low.set(index, low);
+    _close.set(index, close);
+
+    return true;
+}
 
 /*
- *
- *         /\
- *        /  \   _ __ ___  __ _
- *       / /\ \ | '__/ _ \/ _` |
- *      / ____ \| | |  __/ (_| |
- *     /_/    \_\_|  \___|\__,_|
+ *      _____           _ _           _
+ *     |_   _|         | (_)         | |
+ *       | |  _ __   __| |_  ___ __ _| |_ ___  _ __
+ *       | | | '_ \ / _` | |/ __/ _` | __/ _ \| '__|
+ *      _| |_| | | | (_| | | (_| (_| | || (_) | |
+ *     |_____|_| |_|\__,_|_|\___\__,_|\__\___/|_|
  *
  *
  */
 
-/** @brief Add one chart line.
+/** @brief Create indicator.
 *
-* Max flw::chart::Area::MAX_LINES lines.
+* @param[in] formula  Algorithm.
+* @param[in] days     Number of days, used by all except FIXED and MODIFY.
+* @param[in] value    Value for FIXED and MODIFY.
+* @param[in] modify   Modifier for MODIFY.
+*/
+flw::chart::Indicator::Indicator(Algorithm formula, size_t days, double value, Modifier modify) {
+    _formula = formula;
+    _days    = days;
+    _value   = value;
+    _modify  = modify;
+
+    reset();
+}
+
+/** @brief Add one source data point.
 *
-* @param[in] chart_line  Line object.
+* @param[in]  key    Date key.
+* @param[in]  high   High Y value.
+* @param[in]  low    Low Y value.
+* @param[in]  close  Close Y value.
+* @param[out] out    Result is appended to this serie.
 *
-* @return True if added. false if there are to many already.
+* @return True if a result was appended.
 */
-bool flw::chart::Area::add_line(const Line& chart_line) {
-    if (_lines.size() >= flw::chart::Area::MAX_LINES) {
+bool flw::chart::Indicator::add(const gnu::DateKey& key, double high, double low, double close, Series& out) {
+    const auto f    = _count++;
+    const auto days = _days;
+    auto       res  = false;
+
+    if (is_valid() == false) {
         return false;
     }
+    else if (_formula == Algorithm::FIXED) {
+        out.push_back(key, _value);
+        return true;
+    }
+    else if (_formula == Algorithm::MODIFY) {
+        if (fabs(_value) < chart::MIN_VALUE) {
+            return false;
+        }
 
-    _lines.push_back(chart_line);
-    Fl::redraw();
+        switch (_modify) {
+            case Modifier::ADDITION:
+                out.push_back(key, high + _value, low + _value, close + _value);
+                break;
 
-    return true;
-}
+            case Modifier::SUBTRACTION:
+                out.push_back(key, high - _value, low - _value, close - _value);
+                break;
 
-/** @brief Return max clamp value.
-*
-* @return Value or nullopt.
-*/
-std::optional<double> flw::chart::Area::clamp_max() const {
-    if (std::isfinite(_clamp_max) == true) {
-        return _clamp_max;
-    }
+            case Modifier::MULTIPLICATION:
+                out.push_back(key, high * _value, low * _value, close * _value);
+                break;
 
-    return std::nullopt;
-}
+            case Modifier::DIVISION:
+                out.push_back(key, high / _value, low / _value, close / _value);
+                break;
+        }
 
-/** @brief Return min clamp value.
-*
-* @return Value or nullopt.
-*/
-std::optional<double> flw::chart::Area::clamp_min() const {
-    if (std::isfinite(_clamp_min) == true) {
-        return _clamp_min;
+        return true;
+    }
+    else if (days < 2) {
+        return false;
     }
+    else if (_formula == Algorithm::ATR) {
+        if (f == 0) {
+            _sum = high - low;
+        }
+        else {
+            double ra = priv::_chart_true_range(high, low, _prev_close);
 
-    return std::nullopt;
-}
+            if (f < days - 1) {
+                _sum += ra;
+            }
+            else if (f == days - 1) {
+                _prev = (_sum + ra) / days;
+                res   = true;
+            }
+            else {
+                _prev = ((_prev * (days - 1)) + ra) / days;
+                res   = true;
+            }
+        }
+    }
+    else if (_formula == Algorithm::EXP_MOVING_AVERAGE) {
+        if (f < (days - 1)) {
+            _sum += close;
+        }
+        else if (f == (days - 1)) {
+            _sum  += close;
+            _prev  = _sum / days;
+            res    = true;
+        }
+        else {
+            _prev = ((close - _prev) * (2.0 / static_cast<double>(days + 1.0))) + _prev;
+            res   = true;
+        }
+    }
+    else if (_formula == Algorithm::MOMENTUM) {
+        _win_close.push_back(close);
 
-/** @brief Print debug info to terminal.
-*/
-void flw::chart::Area::debug() const {
-#ifdef DEBUG
-    printf("\t--------------------------------------\n");
-    printf("\tArea: %d\n", static_cast<int>(_area));
+        if (_win_close.size() > days) {
+            _win_close.pop_front();
+        }
 
-    if (_percent >= priv::_CHART_MIN_AREA_SIZE) {
-        printf("\t\tx, y:       %12d, %4d\n", _rect.x(), _rect.y());
-        printf("\t\tw, h:       %12d, %4d\n", _rect.w(), _rect.h());
-        printf("\t\tclamp_max:  %18.4f\n", _clamp_max);
-        printf("\t\tclamp_min:  %18.4f\n", _clamp_min);
-        printf("\t\tpercent:    %18d\n", _percent);
-        printf("\t\tlines:      %18d\n", static_cast<int>(_lines.size()));
-        printf("\t\tselected:   %18d\n", static_cast<int>(_selected));
+        if (_win_close.size() == days) {
+            _prev = close - _win_close.front();
+            res   = true;
+        }
+    }
+    else if (_formula == Algorithm::MOVING_AVERAGE) {
+        if (_win_close.size() == days) { //  Remove oldest data in range.
+            _sum -= _win_close.front();
+            _win_close.pop_front();
+        }
 
-        _left.debug("left");
-        _right.debug("right");
-        auto c = 0;
+        _sum += close;
+        _win_close.push_back(close);
 
-        for (const auto& l : _lines) {
-            l.debug(c++);
+        if (_win_close.size() == days) {
+            _prev = _sum / days;
+            res   = true;
         }
+    }
+    else if (_formula == Algorithm::RSI) {
+        if (f > 0) {
+            double diff = close - _prev_close;
 
-        fflush(stdout);
+            if (f <= days) {
+                if (diff > 0) {
+                    _gain += diff;
+                }
+                else {
+                    _loss += fabs(diff);
+                }
+            }
+
+            if (f == days) {
+                _gain = _gain / days;
+                _loss = _loss / days;
+                _prev = 100 - (100 / (1 + (_gain / _loss)));
+                res   = true;
+            }
+            else if (f > days) {
+                _gain = ((_gain * (days - 1)) + ((diff > 0) ? fabs(diff) : 0)) / days;
+                _loss = ((_loss * (days - 1)) + ((diff < 0) ? fabs(diff) : 0)) / days;
+                _prev = 100 - (100 / (1 + (_gain / _loss)));
+                res   = true;
+            }
+        }
     }
-#endif
-}
+    else if (_formula == Algorithm::STD_DEV) { // _sum is used as mean value.
+        if (_win_close.size() < days) {
+            _win_close.push_back(close);
+            priv::_chart_variance_add(_sum, _m2, _win_close.size(), close);
 
-/** @brief Delete chart line
-*
-* @param[in] index  Line index.
-*/
-void flw::chart::Area::delete_line(size_t index) {
-    size_t count = 0;
+            if (_win_close.size() == days) {
+                _prev = sqrt(_m2 / days);
+                res   = true;
+            }
+        }
+        else {
+            auto old_val = _win_close.front();
 
-    for (auto it = _lines.begin(); it != _lines.end(); ++it) {
-        if (index == count) {
-            _lines.erase(it);
+            _win_close.pop_front();
+            _win_close.push_back(close);
 
-            if (_lines.size() == 0) {
-                _selected = 0;
+            if ((f + 1) % days == 0) {
+                _prev = sqrt(priv::_chart_variance_exact(_win_close.begin(), _win_close.end(), days, _sum, _m2));
             }
-            else if (_selected >= _lines.size()) {
-                _selected = _lines.size() - 1;
+            else {
+                _prev = sqrt(priv::_chart_variance_replace(_sum, _m2, days, old_val, close));
             }
 
-            break;
+            res = true;
         }
+    }
+    else if (_formula == Algorithm::STOCHASTICS) {
+        auto max = priv::_chart_extreme(_win_high, f, high, true, days);
+        auto min = priv::_chart_extreme(_win_low, f, low, false, days);
 
-        count++;
+        if (f + 1 >= days && max - min > chart::MIN_VALUE) {
+            _prev = 100.0 * ((close - min) / (max - min));
+            res   = true;
+        }
+    }
+
+    _prev_close = close;
+
+    if (res == true) {
+        out.push_back(key, _prev);
     }
+
+    return res;
 }
 
-/** @brief Reset all data and values to default value.
+/** @brief Check if algorithm can be used for streaming data.
 *
+* @return True if ok.
 */
-void flw::chart::Area::reset() {
-    _clamp_max = INFINITY;
-    _clamp_min = INFINITY;
-    _percent   = 0;
-    _rect      = Fl_Rect();
-    _selected  = 0;
+bool flw::chart::Indicator::is_valid() const {
+    return _formula != Algorithm::DAY_TO_WEEK && _formula != Algorithm::DAY_TO_MONTH;
+}
 
-    _left.reset();
-    _right.reset();
-    _lines.clear();
+/** @brief Clear all state.
+*
+*/
+void flw::chart::Indicator::reset() {
+    _count      = 0;
+    _sum        = 0.0;
+    _prev       = 0.0;
+    _prev_close = 0.0;
+    _gain       = 0.0;
+    _loss       = 0.0;
+    _m2         = 0.0;
+
+    _win_close.clear();
+    _win_high.clear();
+    _win_low.clear();
 }
 
-/** @brief Return current selected line.
+/** @brief Calculate result for a complete serie.
 *
-* @return Line or NULL.
+* State is cleared before and it is left so more data points can be added with add().
+*
+* @param[in] in  Source serie.
+*
+* @return Result serie.
 */
-flw::chart::Line* flw::chart::Area::selected_line() {
-    if (_selected >= _lines.size()) {
-        return nullptr;
+flw::chart::Series flw::chart::Indicator::run(const Series& in) {
+    Series res;
+
+    reset();
+
+    for (size_t f = 0; f < in.size(); f++) {
+        if (in.check(f, f) == true) {
+            add(in.key(f), in.high()[f], in.low()[f], in.close()[f], res);
+        }
     }
 
-    return &_lines[_selected];
+    return res;
 }
 
 /*
- *      _____      _       _
- *     |  __ \    (_)     | |
- *     | |__) |__  _ _ __ | |_
- *     |  ___/ _ \| | '_ \| __|
- *     | |  | (_) | | | | | |_
- *     |_|   \___/|_|_| |_|\__|
+ *      _____        _        _____                           _
+ *     |  __ \      | |      / ____|                         | |
+ *     | |  | | __ _| |_ ___| |  __  ___ _ __   ___ _ __ __ _| |_ ___  _ __
+ *     | |  | |/ _` | __/ _ \ | |_ |/ _ \ '_ \ / _ \ '__/ _` | __/ _ \| '__|
+ *     | |__| | (_| | ||  __/ |__| |  __/ | | |  __/ | | (_| | || (_) | |
+ *     |_____/ \__,_|\__\___|\_____|\___|_| |_|\___|_|  \__,_|\__\___/|_|
  *
  *
  */
 
-/** @brief Create empty point.
+/** @brief Create empty date serie.
 *
 */
-flw::chart::Point::Point() {
-    high = low = close = 0.0;
+flw::chart::DateGenerator::DateGenerator() {
+    clear();
 }
 
-/** @brief Create point.
+/** @brief Create date serie.
 *
-* @param[in] date   Valid date.
-* @param[in] value  Y value for high, low and close.
+* Dates are the same as Point::DateSerie() returns for the same input.
+*
+* @param[in] start_date  Start date.
+* @param[in] stop_date   Stop date.
+* @param[in] range       Date range.
+* @param[in] block       Optional list of dates to remove from reference date serie.
 */
-flw::chart::Point::Point(const std::string& date, double value) {
-    auto valid_date = gnu::Date(date.c_str());
+flw::chart::DateGenerator::DateGenerator(const std::string& start_date, const std::string& stop_date, DateRange range, const PointVector& block) {
+    clear();
 
-    if (std::isfinite(value) == true &&
-        fabs(value) < chart::MAX_VALUE &&
-        valid_date.is_invalid() == false) {
+    const auto START = gnu::Date(start_date);
+    const auto STOP  = gnu::Date(stop_date);
+    const auto KEY1  = START.key();
+    const auto KEY2  = STOP.key();
 
-        this->date = valid_date.format(gnu::Date::Format::ISO_TIME);
-        this->high = this->low = this->close = value;
-    }
-    else {
-        high = low = close = 0.0;
+    _range = range;
+
+    if (KEY1.is_invalid() == true || KEY2.is_invalid() == true || KEY1 > KEY2) {
+        return;
     }
-}
 
-/** @brief Create point.
-*
-* Values are moved if they are out of size order.\n
-* Invalid date sets all values to 0.0.\n
-*
-* @param[in] date   Valid date.
-* @param[in] high   High Y value.
-* @param[in] low    Low Y value.
-* @param[in] close  Close Y value.
-*/
-flw::chart::Point::Point(const std::string& date, double high, double low, double close) {
-    auto valid_date = gnu::Date(date.c_str());
+    if (range == DateRange::WEEKDAY) {
+        const auto DAYS1 = KEY1.days();
+        const auto DAYS2 = KEY2.days();
 
-    if (std::isfinite(high) == true &&
-        std::isfinite(low) == true &&
-        std::isfinite(close) == true &&
-        fabs(high) < chart::MAX_VALUE &&
-        fabs(low) < chart::MAX_VALUE &&
-        fabs(close) < chart::MAX_VALUE &&
-        valid_date.is_invalid() == false) {
+        _time     = KEY1.seconds() - DAYS1 * gnu::Date::SECS_PER_DAY;
+        _first    = priv::_chart_weekdays(DAYS1);
+        _raw_size = priv::_chart_weekdays((KEY2.seconds() - DAYS2 * gnu::Date::SECS_PER_DAY >= _time) ? DAYS2 + 1 : DAYS2) - _first;
+    }
+    else if (range == DateRange::MONTH) {
+        _time     = KEY1.seconds() - KEY1.days() * gnu::Date::SECS_PER_DAY;
+        _first    = START.year() * 12 + START.month() - 1;
+        _raw_size = (STOP.year() * 12 + STOP.month() - 1) - _first;
 
-        if (low > high) {
-            auto tmp = low;
-            low = high;
-            high = tmp;
-        }
+        if (_raw_size > 0) { // Month is compared after adding a month to the last day in previous month.
+            auto prev = gnu::Date(STOP.year(), STOP.month(), 1);
+            prev.add_months(-1);
 
-        if (close > high) {
-            auto tmp = high;
-            high = close;
-            close = tmp;
+            auto check = gnu::Date(STOP.year(), STOP.month(), std::min(prev.days_in_month(), STOP.days_in_month()), START.hour(), START.minute(), START.second());
+            _raw_size += (check <= STOP) ? 1 : 0;
         }
-
-        if (close < low) {
-            auto tmp = low;
-            low = close;
-            close = tmp;
+        else {
+            _raw_size = 1;
         }
-
-        this->date  = valid_date.format(gnu::Date::Format::ISO_TIME);
-        this->high  = high;
-        this->low   = low;
-        this->close = close;
     }
     else {
-        this->high = this->low = this->close = 0.0;
-    }
-}
-
-/** @brief Convert data serie using ATR algorithm.
-*
-* @param[in] in    Vector with Point objects.
-* @param[in] days  Number of days.
-*
-* @return Result vector with Point objects.
-*/
-flw::chart::PointVector flw::chart::Point::ATR(const PointVector& in, size_t days) {
-    PointVector res;
+        int64_t step = gnu::Date::SECS_PER_DAY;
 
-    if (days > 1 && days < in.size()) {
-        double tot        = 0.0;
-        double prev_close = 0.0;
-        double prev_range = 0.0;
-        size_t f          = 0;
+        _first = KEY1.seconds();
 
-        days--;
+        if (range == DateRange::FRIDAY || range == DateRange::SUNDAY) { // Move to first friday or sunday.
+            const auto DAY = (range == DateRange::FRIDAY) ? 4 : 6;
+            const auto WD  = (KEY1.days() + 3) - priv::_chart_floor_div(KEY1.days() + 3, 7) * 7;
 
-        for (const auto& data : in) {
-            if (f == 0) {
-                tot += data.high - data.low;
-            }
-            else {
-                double t1 = data.high - data.low;
-                double t2 = fabs(data.high - prev_close);
-                double t3 = fabs(data.low - prev_close);
-                double ra = 0.0;
+            _first += ((DAY - WD + 7) % 7) * gnu::Date::SECS_PER_DAY;
+            step    = gnu::Date::SECS_PER_WEEK;
+        }
+        else if (range == DateRange::HOUR) {
+            step = gnu::Date::SECS_PER_HOUR;
+        }
+        else if (range == DateRange::MIN) {
+            step = 60;
+        }
+        else if (range == DateRange::SEC) {
+            step = 1;
+        }
 
-                if (t1 > t2 && t1 > t3) {
-                    ra = t1;
-                }
-                else if (t2 > t1 && t2 > t3) {
-                    ra = t2;
-                }
-                else {
-                    ra = t3;
-                }
+        _time     = step;
+        _raw_size = (_first <= KEY2.seconds()) ? (KEY2.seconds() - _first) / step + 1 : 0;
+    }
 
-                tot += ra;
+    if (_raw_size < 0) {
+        _raw_size = 0;
+    }
 
-                if (f == days) {
-                    prev_range = tot / (days + 1);
-                    res.push_back(Point(data.date, prev_range));
-                }
-                else if (f > days) {
-                    prev_range = ((prev_range * days) + ra) / (days + 1);
-                    res.push_back(Point(data.date, prev_range));
-                }
-            }
+    for (const auto& b : block) {
+        auto raw = _raw_index(priv::_CHART_DATE_PARSER.parse(b.date));
 
-            prev_close = data.close;
-            f++;
+        if (raw >= 0) {
+            _block.push_back(raw);
         }
     }
 
-    return res;
+    std::sort(_block.begin(), _block.end());
+    _block.erase(std::unique(_block.begin(), _block.end()), _block.end());
+
+    for (size_t f = 0; f < _block.size(); f++) {
+        _shift.push_back(_block[f] - static_cast<int64_t>(f));
+    }
+
+    _size = static_cast<size_t>(_raw_size) - _block.size();
 }
 
-/** @brief Do a binary search for a date/time.
+/** @brief Remove all dates.
 *
-* @param[in] in   Vector with Point objects.
-* @param[in] key  Date to search for.
+*/
+void flw::chart::DateGenerator::clear() {
+    _range    = DateRange::DAY;
+    _first    = 0;
+    _raw_size = 0;
+    _time     = 0;
+    _size     = 0;
+
+    _block.clear();
+    _shift.clear();
+}
+
+/** @brief Get date string.
 *
-* @return Result vector with Point objects.
+* @param[in] index  Index in serie.
+*
+* @return Date as "YYYYMMDD HHMMSS" or "" for invalid index.
 */
-size_t flw::chart::Point::BinarySearch(const PointVector& in, const Point& key) {
-    auto it = std::lower_bound(in.begin(), in.end(), key);
+std::string flw::chart::DateGenerator::date(size_t index) const {
+    auto key = this->key(index);
+    char buffer[40];
 
-    if (it == in.end() || *it != key) {
-        return static_cast<size_t>(-1);
-    }
-    else {
-        return std::distance(in.begin(), it);
+    if (key.is_invalid() == true) {
+        return "";
     }
+
+    key.to_date().format_to(buffer, 40, gnu::Date::Format::ISO_TIME);
+    return buffer;
 }
 
-/** @brief Create date serie.
+/** @brief Add dates to the end of the serie.
 *
-* @param[in] start_date  Start date.
-* @param[in] stop_date   Stop date.
-* @param[in] range       Date range.
-* @param[in] block       Optional list of dates to remove from reference date serie.
+* First date is unchanged so all current indexes are still valid.\n
+* Only new dates are checked against the block list, old blocked dates are kept.\n
 *
-* @return Result vector with Point objects.
+* @param[in] last   New last date.
+* @param[in] block  Optional list of dates to remove from the new dates.
+*
+* @return True if dates were added, false if last date is not later or if serie is empty.
 */
-flw::chart::PointVector flw::chart::Point::DateSerie(const std::string& start_date, const std::string& stop_date, DateRange range, const PointVector& block) {
-    auto       month   = -1;
-    auto       current = gnu::Date(start_date.c_str());
-    auto const stop    = gnu::Date(stop_date.c_str());
-    auto       res     = PointVector();
-
-    if (range == DateRange::FRIDAY) {
-        while (current.weekday() != gnu::Date::Day::FRIDAY)
-            current.add_days(1);
+bool flw::chart::DateGenerator::extend(const gnu::DateKey& last, const PointVector& block) {
+    if (_raw_size == 0 || last.is_invalid() == true || last <= _raw_key(_raw_size - 1)) {
+        return false;
     }
-    else if (range == DateRange::SUNDAY) {
-        while (current.weekday() != gnu::Date::Day::SUNDAY) {
-            current.add_days(1);
-        }
+
+    const auto tmp = DateGenerator(priv::_chart_key_date(_raw_key(0)), priv::_chart_key_date(last), _range);
+
+    if (tmp._first != _first || tmp._time != _time || tmp._raw_size <= _raw_size) {
+        return false;
     }
 
-    while (current <= stop) {
-        gnu::Date date(1, 1, 1);
+    const auto OLD   = _raw_size;
+    auto       added = std::vector<int64_t>();
 
-        if (range == DateRange::DAY) {
-            date = gnu::Date(current);
-            current.add_days(1);
-        }
-        else if (range == DateRange::WEEKDAY) {
-            gnu::Date::Day weekday = current.weekday();
+    _raw_size = tmp._raw_size;
 
-            if (weekday >= gnu::Date::Day::MONDAY && weekday <= gnu::Date::Day::FRIDAY) {
-                date = gnu::Date(current);
-            }
+    for (const auto& b : block) {
+        auto raw = _raw_index(priv::_CHART_DATE_PARSER.parse(b.date));
 
-            current.add_days(1);
-        }
-        else if (range == DateRange::FRIDAY || range == DateRange::SUNDAY) {
-            date = gnu::Date(current);
-            current.add_days(7);
+        if (raw >= OLD) {
+            added.push_back(raw);
         }
-        else if (range == DateRange::MONTH) {
-            if (current.month() != month) {
-                current.set_day_to_last_in_month();
-                date = gnu::Date(current);
-                month = current.month();
-            }
+    }
 
-            current.add_months(1);
-        }
-        else if (range == DateRange::HOUR) {
-            date = gnu::Date(current);
-            current.add_seconds(3600);
-        }
-        else if (range == DateRange::MIN) {
-            date = gnu::Date(current);
-            current.add_seconds(60);
-        }
-        else if (range == DateRange::SEC) {
-            date = gnu::Date(current);
-            current.add_seconds(1);
-        }
+    std::sort(added.begin(), added.end());
+    added.erase(std::unique(added.begin(), added.end()), added.end());
+
+    for (auto raw : added) {
+        _shift.push_back(raw - static_cast<int64_t>(_block.size()));
+        _block.push_back(raw);
+    }
 
-        if (date.year() > 1) {
-            Point price(date.format(gnu::Date::Format::ISO_TIME_LONG));
+    _size = static_cast<size_t>(_raw_size) - _block.size();
 
-            if (block.size() == 0 || std::binary_search(block.begin(), block.end(), price) == false) {
-                res.push_back(price);
-            }
-        }
+    return true;
+}
+
+/** @brief Find index for a date.
+*
+* @param[in] key  Date key.
+*
+* @return Index or -1 if date is not in the serie.
+*/
+size_t flw::chart::DateGenerator::index(const gnu::DateKey& key) const {
+    auto raw = _raw_index(key);
+
+    if (raw < 0 || std::binary_search(_block.begin(), _block.end(), raw) == true) {
+        return static_cast<size_t>(-1);
     }
 
-    return res;
+    return static_cast<size_t>(raw - (std::lower_bound(_block.begin(), _block.end(), raw) - _block.begin()));
 }
 
-/** @brief Convert data serie to monthly data.
+/** @brief Find index for a date.
 *
-* @param[in] in   Vector with Point objects.
-* @param[in] sum  True to add values for a month, false to use highest/lowest and last close data.
+* @param[in] date  Date string.
 *
-* @return Result vector with Point objects.
+* @return Index or -1 if date is not in the serie.
 */
-flw::chart::PointVector flw::chart::Point::DayToMonth(const PointVector& in, bool sum) {
-    size_t          f = 0;
-    PointVector res;
-    Point       current;
-    gnu::Date       stop;
-    gnu::Date       pdate;
+size_t flw::chart::DateGenerator::index(const std::string& date) const {
+    return index(priv::_CHART_DATE_PARSER.parse(date));
+}
 
-    for (const auto& data : in) {
-        if (f == 0) {
-            current = data;
-            stop = gnu::Date(current.date.c_str());
-            stop.set_day_to_last_in_month();
-        }
-        else {
-            pdate = gnu::Date(data.date.c_str());
+/** @brief Get date key.
+*
+* @param[in] index  Index in serie.
+*
+* @return Key, invalid for invalid index.
+*/
+gnu::DateKey flw::chart::DateGenerator::key(size_t index) const {
+    if (index >= _size) {
+        return gnu::DateKey();
+    }
 
-            if (stop < pdate) {
-                current.date = stop.format(gnu::Date::Format::ISO_TIME);
-                res.push_back(current);
-                current = data;
-                stop = gnu::Date(current.date.c_str());
-                stop.set_day_to_last_in_month();
-            }
-            else if (sum == true) {
-                current.high  += data.high;
-                current.low   += data.low;
-                current.close += data.close;
-            }
-            else {
-                if (data.high > current.high) {
-                    current.high = data.high;
-                }
+    auto i   = static_cast<int64_t>(index);
+    auto raw = i + (std::upper_bound(_shift.begin(), _shift.end(), i) - _shift.begin());
 
-                if (data.low < current.low) {
-                    current.low = data.low;
-                }
+    return _raw_key(raw);
+}
 
-                current.close  = data.close;
-            }
-        }
+/** @brief Create all dates.
+*
+* @return Vector with Point objects.
+*/
+flw::chart::PointVector flw::chart::DateGenerator::points() const {
+    PointVector res;
 
-        if (f + 1 == in.size()) {
-            auto s = stop.format(gnu::Date::Format::ISO_TIME);
-            stop.set_day_to_last_in_month();
-            current.date = s;
-            res.push_back(current);
-        }
+    res.reserve(_size);
 
-        f++;
+    for (size_t f = 0; f < _size; f++) {
+        res.push_back(point(f));
     }
 
     return res;
 }
 
-/** @brief Convert data serie to weekly data.
+/** @brief Get raw index for a date (blocked dates are included).
 *
-* @param[in] in       Vector with Point objects.
-* @param[in] weekday  What day to use in week.
-* @param[in] sum      True to add values for a week, false to use highest/lowest and last close data.
+* @param[in] key  Date key.
 *
-* @return Result vector with Point objects.
+* @return Raw index or -1 if date is not in the serie.
 */
-flw::chart::PointVector flw::chart::Point::DayToWeek(const PointVector& in, gnu::Date::Day weekday, bool sum) {
-    size_t          f = 0;
-    PointVector res;
-    Point       current;
-    gnu::Date       stop;
-    gnu::Date       pdate;
+int64_t flw::chart::DateGenerator::_raw_index(const gnu::DateKey& key) const {
+    int64_t raw = -1;
 
-    for (const auto& data : in) {
-        if (f == 0) {
-            stop = gnu::Date(data.date.c_str());
+    if (key.is_invalid() == true || _raw_size == 0) {
+        return -1;
+    }
+    else if (_range == DateRange::WEEKDAY || _range == DateRange::MONTH) {
+        const auto DAYS = key.days();
 
-            if (weekday > stop.weekday()) {
-                stop.set_weekday(weekday);
-            }
-            else if (weekday < stop.weekday()) {
-                stop.set_weekday(weekday);
-                stop.add_days(7);
+        if (key.seconds() - DAYS * gnu::Date::SECS_PER_DAY != _time) {
+            return -1;
+        }
+        else if (_range == DateRange::WEEKDAY) {
+            if ((DAYS + 3) - priv::_chart_floor_div(DAYS + 3, 7) * 7 >= 5) {
+                return -1;
             }
 
-            current = data;
+            raw = priv::_chart_weekdays(DAYS) - _first;
         }
         else {
-            pdate = gnu::Date(data.date.c_str());
-
-            if (stop < pdate) {
-                current.date = stop.format(gnu::Date::Format::ISO_TIME);
-                res.push_back(current);
-                current = data;
-            }
-            else if (sum == true) {
-                current.high  += data.high;
-                current.low   += data.low;
-                current.close += data.close;
-            }
-            else {
-                if (data.high > current.high) {
-                    current.high = data.high;
-                }
-
-                if (data.low < current.low) {
-                    current.low = data.low;
-                }
-
-                current.close  = data.close;
-            }
+            const auto DATE = key.to_date();
 
-            while (stop < pdate) {
-                stop.add_days(7);
+            if (DATE.day() != DATE.days_in_month()) {
+                return -1;
             }
 
-            current.date = stop.format(gnu::Date::Format::ISO_TIME);
+            raw = DATE.year() * 12 + DATE.month() - 1 - _first;
         }
+    }
+    else {
+        const auto DIFF = key.seconds() - _first;
 
-        if (f + 1 == in.size()) {
-            current.date = stop.format(gnu::Date::Format::ISO_TIME);
-            res.push_back(current);
+        if (DIFF < 0 || DIFF % _time != 0) {
+            return -1;
         }
 
-        f++;
+        raw = DIFF / _time;
     }
 
-    return res;
+    return (raw >= 0 && raw < _raw_size) ? raw : -1;
 }
 
-/** @brief Print value.
+/** @brief Get date key for a raw index (blocked dates are included).
 *
-*/
-void flw::chart::Point::debug() const {
-#ifdef DEBUG
-    printf("%s, %20.8f, %20.8f, %20.8f\n", date.c_str(), high, low, close);
-#endif
-}
-
-/** @brief Print values.
+* @param[in] raw  Raw index.
 *
-* @param[in] in  Vector with Point objects.
+* @return Date key.
 */
-void flw::chart::Point::Debug(const PointVector& in) {
-#ifdef DEBUG
-    printf("\nPointVector(%u)\n", static_cast<unsigned>(in.size()));
+gnu::DateKey flw::chart::DateGenerator::_raw_key(int64_t raw) const {
+    if (_range == DateRange::WEEKDAY) {
+        return gnu::DateKey::FromSeconds(priv::_chart_weekday_to_days(_first + raw) * gnu::Date::SECS_PER_DAY + _time);
+    }
+    else if (_range == DateRange::MONTH) {
+        const auto MONTH = _first + raw;
+        auto       date  = gnu::Date(static_cast<int>(MONTH / 12), static_cast<int>(MONTH % 12) + 1, 1);
 
-    for (const auto& data : in) {
-        data.debug();
+        date.set_day_to_last_in_month();
+        return gnu::DateKey::FromSeconds(date.key().seconds() + _time);
     }
 
-    fflush(stdout);
-#else
-    (void) in;
-#endif
+    return gnu::DateKey::FromSeconds(_first + raw * _time);
 }
 
-/** @brief Convert data serie using exponential moving average algorithm.
+/*
+ *      _      _
+ *     | |    (_)
+ *     | |     _ _ __   ___
+ *     | |    | | '_ \ / _ \
+ *     | |____| | | | |  __/
+ *     |______|_|_| |_|\___|
+ *
+ *
+ */
+
+/** @brief Create a chart line.
 *
-* @param[in] in    Vector with Point objects.
-* @param[in] days  Number of days.
+* @param[in] data   Vector with Point objects.
+* @param[in] label  Line label.
+* @param[in] type   Line type.
+*/
+flw::chart::Line::Line(const PointVector& data, const std::string& label, LineType type) {
+    reset();
+    set_data(data);
+    set_label(label);
+    set_type(type);
+}
+
+/** @brief Update resampled data and reference index after new data points have been added.
 *
-* @return Result vector with Point objects.
+* Every resampled date range gets the new points, a date range that can not be updated is removed and calculated again by resample().\n
+* Reference index is cut at the first data point in view() that has changed so Chart only has to look up the new points.\n
+*
+* @param[in] first  First new data point in the line data.
 */
-flw::chart::PointVector flw::chart::Point::ExponentialMovingAverage(const PointVector& in, size_t days) {
-    PointVector res;
+void flw::chart::Line::_added(size_t first) {
+    const auto* view_before = &view();
+    const auto  changed     = (view_before == &_series) ? first : (view_before->size() > 0) ? view_before->size() - 1 : 0;
 
-    if (days > 1 && days < in.size()) {
-        double sma   = 0.0;
-        double prev  = 0.0;
-        double multi = 2.0 / static_cast<double>(days + 1.0);
-        size_t f     = 0;
+    for (auto it = _resampled.begin(); it != _resampled.end();) {
+        auto ok = true;
 
-        for (const auto& data : in) {
-            if (f < (days - 1)) {
-                sma += data.close;
-            }
-            else if (f == (days - 1)) {
-                sma += data.close;
-                prev = sma / days;
-                res.push_back(Point(data.date, prev));
-            }
-            else {
-                prev = ((data.close - prev) * multi) + prev;
-                res.push_back(Point(data.date, prev));
-            }
+        for (auto f = first; f < _series.size() && ok == true; f++) {
+            ok = priv::_chart_resample_append(_series, f, it->first, _aggregate == Aggregate::SUM, it->second);
+        }
 
-            f++;
+        if (ok == true) {
+            ++it;
+        }
+        else {
+            it = _resampled.erase(it);
         }
     }
 
-    return res;
+    if (&view() != view_before) {
+        _clear_index();
+    }
+    else if (_index.size() > changed) {
+        _index.pop_back(_index.size() - changed);
+    }
 }
 
-/** @brief Create a data serie with fixed Y value.
+/** @brief Calculate min and max value for one block of mapped data points.
 *
-* @param[in] in     Vector with Point objects (only date is used).
-* @param[in] value  Y values.
+* Only data points in the reference dates are used, nothing is used from illegal blocks.\n
+* Block ranges are calculated the first time minmax() needs them so pages are only read when they are shown.\n
 *
-* @return Result vector with Point objects.
+* @param[in] block  Block index.
 */
-flw::chart::PointVector flw::chart::Point::Fixed(const PointVector& in, double value) {
-    PointVector res;
+void flw::chart::Line::_block_range(size_t block) const {
+    if (std::isnan(_block_max[block]) == false) {
+        return;
+    }
 
-    for (const auto& data : in) {
-        res.push_back(Point(data.date, value));
+    const auto& series = view();
+    const auto& max    = (_range_hl == true) ? series.high() : series.close();
+    const auto& min    = (_range_hl == true) ? series.low() : series.close();
+    const auto  START  = block * SERIES_BLOCK;
+    const auto  END    = std::min(series.size(), START + SERIES_BLOCK);
+
+    _block_max[block] = -INFINITY;
+    _block_min[block] = INFINITY;
+
+    if (series.check(START, END - 1) == false) {
+        return;
     }
 
-    return res;
+    for (auto f = START; f < END; f++) {
+        if (_mapped_dates.index(series.key(f)) != static_cast<size_t>(-1)) {
+            _block_max[block] = std::max(_block_max[block], max[f]);
+            _block_min[block] = std::min(_block_min[block], min[f]);
+        }
+    }
 }
 
-/** @brief Load data from csv file.
+/** @brief Build segment trees for min and max values.
 *
-* @param[in] filename  Valid text file name.
-* @param[in] sep       Column separator.
+* Only data points in view() that are in the reference dates are used.\n
+* They are built when Chart sets the reference index and when line type changes between high/low and close values.\n
+* There is room for half as many leaves as data points after the last leaf so new points can be added with _update_range().\n
+* Mapped data has no segment trees, only a min and max value for every block of data points (see _block_range()).\n
 *
-* @return Result vector with Point objects.
+* @param[in] force  True to always rebuild.
 */
-flw::chart::PointVector flw::chart::Point::LoadCSV(const std::string& filename, const std::string& sep) {
-    auto buf = gnu::file::read(filename);
+void flw::chart::Line::_calc_range(bool force) {
+    const auto& series = view();
+    const auto  SIZE   = _index.size();
+    const auto  HL     = type_has_high_and_low();
+
+    if (series.is_mapped() == true) {
+        if (force == true || HL != _range_hl) {
+            _range_hl = HL;
+            std::fill(_block_max.begin(), _block_max.end(), NAN);
+            std::fill(_block_min.begin(), _block_min.end(), NAN);
+        }
 
-    if (buf.size() < 10) {
-        return PointVector();
+        return;
+    }
+    else if (SIZE == 0 || SIZE > series.size()) {
+        _range_max.clear();
+        _range_min.clear();
+        _range_first = 0;
+        return;
+    }
+    else if (force == false && HL == _range_hl && _range_min.size() > 0) {
+        return;
     }
 
-    std::string  str   = buf.c_str();
-    StringVector lines = util::split_string(str, "\n");
-    PointVector  res;
-
-    for (const auto& l : lines) {
-        StringVector line = util::split_string(l, sep);
-        Point    data;
+    const auto& max  = (HL == true) ? series.high() : series.close();
+    const auto& min  = (HL == true) ? series.low() : series.close();
+    const auto  LEAF = SIZE + SIZE / 2 + 16;
 
-        if (line.size() == 2) {
-            data = Point(line[0], util::to_double(line[1]));
-        }
-        else if (line.size() > 3) {
-            data = Point(line[0], util::to_double(line[1]), util::to_double(line[2]), util::to_double(line[3]));
-        }
+    _range_hl    = HL;
+    _range_first = 0;
+    _range_max.assign(LEAF * 2, -INFINITY);
+    _range_min.assign(LEAF * 2, INFINITY);
 
-        if (data.date != "") {
-            res.push_back(data);
+    for (size_t f = 0; f < SIZE; f++) {
+        if (_index[f] >= 0) {
+            _range_max[LEAF + f] = max[f];
+            _range_min[LEAF + f] = min[f];
         }
     }
 
-    return res;
+    for (size_t f = LEAF - 1; f > 0; f--) {
+        _range_max[f] = std::max(_range_max[f * 2], _range_max[f * 2 + 1]);
+        _range_min[f] = std::min(_range_min[f * 2], _range_min[f * 2 + 1]);
+    }
 }
 
-/** @brief Modify chart data.
+/** @brief Add one data point to the end of the line.
 *
-* @param[in] in      Vector with Point objects.
-* @param[in] modify  Type of modify.
-* @param[in] value   Value to use.
+* Date must be later than last date in the line and values must be finite and inside chart::MAX_VALUE.\n
+* Lines that are calculated from this line are updated with update().\n
+* Resampled data is updated with the new point if possible, otherwise it is calculated again by resample().\n
+* Only the new point has to be added to the reference index by calc_index().\n
 *
-* @return Result vector with Point objects.
+* @param[in] key    Date key.
+* @param[in] high   High Y value.
+* @param[in] low    Low Y value.
+* @param[in] close  Close Y value.
+*
+* @return True if point was added.
 */
-flw::chart::PointVector flw::chart::Point::Modify(const PointVector& in, Modifier modify, double value) {
-    PointVector res;
-
-    if (fabs(value) < chart::MIN_VALUE) {
-        return res;
+bool flw::chart::Line::append(const gnu::DateKey& key, double high, double low, double close) {
+    const auto last = _series.last_key();
+
+    if (key.is_invalid() == true ||
+        (last.is_invalid() == false && key <= last) ||
+        priv::_chart_is_value(high) == false ||
+        priv::_chart_is_value(low) == false ||
+        priv::_chart_is_value(close) == false) {
+        return false;
     }
 
-    for (const auto& data : in) {
-        switch (modify) {
-            case Modifier::ADDITION:
-                res.push_back(Point(data.date, data.high + value, data.low + value, data.close + value));
-                break;
-
-            case Modifier::SUBTRACTION:
-                res.push_back(Point(data.date, data.high - value, data.low - value, data.close - value));
-                break;
-
-            case Modifier::MULTIPLICATION:
-                res.push_back(Point(data.date, data.high * value, data.low * value, data.close * value));
-                break;
+    const auto SIZE = _series.size();
 
-            case Modifier::DIVISION:
-                res.push_back(Point(data.date, data.high / value, data.low / value, data.close / value));
-                break;
-        }
-    }
+    _series.push_back(key, high, low, close);
+    _added(SIZE);
+    _trim();
 
-    return res;
+    return true;
 }
 
-/** @brief Convert data serie using momentum algorithm.
+/** @brief Add reference date index for data points in view() that are missing one.
 *
-* @param[in] in    Vector with Point objects.
-* @param[in] days  Number of days.
+* Only data points that have been added since last call are looked up, so one new point costs O(log n).\n
+* Segment trees and levels of detail are updated for the new points.\n
+* Mapped data gets no index, the reference dates are stored instead and data points are searched by date when they are used.\n
+* Memory for mapped data is then one min and max value for every chart::SERIES_BLOCK data points.\n
 *
-* @return Result vector with Point objects.
+* @param[in] dates  Reference dates.
+* @param[in] all    True to calculate index for all data points.
 */
-flw::chart::PointVector flw::chart::Point::Momentum(const PointVector& in, size_t days) {
-    size_t          start = days - 1;
-    PointVector res;
+void flw::chart::Line::calc_index(const DateGenerator& dates, bool all) {
+    const auto& series = view();
+    const auto& keys   = series.keys();
+
+    if (series.is_mapped() == true) {
+        if (all == true || _block_max.size() == 0) {
+            const auto BLOCKS = (series.size() + SERIES_BLOCK - 1) / SERIES_BLOCK;
+
+            _clear_index();
+            _mapped_dates = dates;
+            _range_hl     = type_has_high_and_low();
+            _block_max.assign(BLOCKS, NAN);
+            _block_min.assign(BLOCKS, NAN);
+        }
+
+        return;
+    }
+    else if (all == true || _index.size() > keys.size() || _block_max.size() > 0) {
+        _clear_index();
+    }
 
-    if (days > 1 && days < in.size()) {
-        for (auto f = start; f < in.size(); f++) {
-            const auto& data1 = in[f];
-            const auto& data2 = in[f - start];
+    const auto FIRST = _index.size();
 
-            res.push_back(Point(data1.date, data1.close - data2.close));
-        }
+    if (FIRST == keys.size()) {
+        return;
+    }
 
+    for (auto f = FIRST; f < keys.size(); f++) {
+        _index.push_back(static_cast<int64_t>(dates.index(keys[f])));
     }
 
-    return res;
+    _update_range(FIRST);
+    _lod_added(FIRST);
 }
 
-/** @brief Convert data serie using moving average algorithm.
+/** @brief Build aggregated data for zoomed out views.
 *
-* @param[in] in    Vector with Point objects.
-* @param[in] days  Number of days.
+* Every level has one data point for every 2^level reference dates.\n
+* High is the highest value, low the lowest value and close the last close value in each bucket.\n
+* Date is the date of the last data point in the bucket.\n
+* Levels are built from the previous level so only missing levels are calculated.\n
+* Reference index must have been set by Chart, a new index removes all levels but new data points only changes the last buckets.\n
+* For mapped data only the requested level is built, directly from the mapped data, so changing level reads the data again.\n
 *
-* @return Result vector with Point objects.
+* @param[in] level  Max level of detail.
 */
-flw::chart::PointVector flw::chart::Point::MovingAverage(const PointVector& in, size_t days) {
-    PointVector res;
-
-    if (days > 1 && days < in.size()) {
-        size_t count = 0;
-        double sum   = 0.0;
-        auto   tmp   = new double[in.size() + 1];
-
-        for (const auto& data : in) {
-            count++;
-
-            if (count < days) { //  Add data until the first moving average price can be calculated.
-                tmp[count - 1] = data.close;
-                sum += data.close;
-            }
-            else if (count == days) { //  This is the first point.
-                tmp[count - 1] = data.close;
-                sum += data.close;
-                res.push_back(Point(data.date, sum / days));
-            }
-            else { //  Remove oldest data in range and add current to sum.
-                tmp[count - 1] = data.close;
-                sum -= tmp[count - (days + 1)];
-                sum += data.close;
-                res.push_back(Point(data.date, sum / days));
-            }
+void flw::chart::Line::calc_lod(int level) {
+    if (_has_index() == false || (view().is_mapped() == true && level <= 0)) {
+        _lod_index.clear();
+        _lod_series.clear();
+        return;
+    }
+    else if (view().is_mapped() == true) {
+        if (static_cast<int>(_lod_series.size()) != level) {
+            _lod_index.assign(level, SeriesColumn<int64_t>());
+            _lod_series.assign(level, Series());
+            priv::_chart_lod_mapped(view(), _mapped_dates, level, _lod_index.back(), _lod_series.back());
         }
 
-        delete []tmp;
+        return;
     }
 
-    return res;
+    while (static_cast<int>(_lod_series.size()) < level) {
+        auto index  = SeriesColumn<int64_t>();
+        auto series = Series();
+
+        priv::_chart_lod_add(lod_index(static_cast<int>(_lod_series.size())), lod_series(static_cast<int>(_lod_series.size())), 0, index, series);
+        _lod_index.push_back(std::move(index));
+        _lod_series.push_back(std::move(series));
+    }
 }
 
-/** @brief Conmvert range value to a string.
-*
-* @param[in] range  Range value.
+/** @brief Remove reference index, segment trees and levels of detail.
 *
-* @return String value, one of ("DAY", "WEEKDAY", "FRIDAY", "SUNDAY", "MONTH", "HOUR", "MIN", "SEC").
 */
-std::string flw::chart::Point::RangeToString(DateRange range) {
-    static const std::string NAMES[] = { "DAY", "WEEKDAY", "FRIDAY", "SUNDAY", "MONTH", "HOUR", "MIN", "SEC", "", };
-    return NAMES[static_cast<unsigned>(range)];
+void flw::chart::Line::_clear_index() {
+    _index.clear();
+    _lod_index.clear();
+    _lod_series.clear();
+    _range_max.clear();
+    _range_min.clear();
+    _range_first = 0;
+    _block_max.clear();
+    _block_min.clear();
+    _mapped_dates.clear();
 }
 
-/** @brief Convert data serie using rsi algorithm.
-*
-* @param[in] in    Vector with Point objects.
-* @param[in] days  Number of days.
+/** @brief Check if reference index is up to date.
 *
-* @return Result vector with Point objects.
+* @return True if index has been calculated for all data points in view(), or if reference dates has been set for mapped data.
 */
-flw::chart::PointVector flw::chart::Point::RSI(const PointVector& in, size_t days) {
-    PointVector res;
+bool flw::chart::Line::_has_index() const {
+    const auto& series = view();
 
-    if (days > 1 && days < in.size()) {
-        double avg_gain = 0.0;
-        double avg_loss = 0.0;
+    return (series.is_mapped() == true) ? _block_max.size() > 0 || series.size() == 0 : _index.size() == series.size();
+}
+
+/** @brief Print debug info to stdout.
+*
+* @param[in] num  Line index.
+*/
+void flw::chart::Line::debug(size_t num) const {
+#ifdef DEBUG
+    printf("\t\t---------------------------------------------\n");
+    printf("\t\tLine: %u\n", static_cast<unsigned>(num));
+    printf("\t\t\ttype:  %30s\n", type_to_string().c_str());
+    printf("\t\t\twidth:      %25u\n", _width);
+    printf("\t\t\talign:      %25s\n", (_align == FL_ALIGN_LEFT) ? "LEFT" : "RIGHT");
+    printf("\t\t\tlabel: %30s\n", _label.c_str());
+    printf("\t\t\trect:          %04d, %04d, %04d, %04d\n", _rect.x(), _rect.y(), _rect.w(), _rect.h());
+    printf("\t\t\tvisible:    %25s\n", _visible ? "YES" : "NO");
+    printf("\t\t\tprices:     %25d\n", static_cast<int>(size()));
 
-        for (size_t f = 1; f < in.size(); f++) {
-            double      diff = 0.0;
-            const auto& data = in[f];
-            const auto& prev = in[f - 1];
+    if (size() > 1) {
+        printf("\t\t\tfirst:      %25s\n", _series.date(0).c_str());
+        printf("\t\t\tfirst:      %25f\n", _series.close().front());
+        printf("\t\t\tlast:       %25s\n", _series.date(size() - 1).c_str());
+        printf("\t\t\tlast:       %25f\n", _series.close().back());
+    }
 
-            diff = data.close - prev.close;
+    fflush(stdout);
+#else
+    (void) num;
+#endif
+}
 
-            if (f <= days) {
-                if (diff > 0) {
-                    avg_gain += diff;
-                }
-                else {
-                    avg_loss += fabs(diff);
-                }
-            }
+/** @brief Get bucket index for a level of detail.
+*
+* Level 0 is the reference date index.\n
+*
+* @param[in] level  Level of detail.
+*
+* @return Index or an empty vector if level has not been calculated with calc_lod().
+*/
+const flw::chart::SeriesColumn<int64_t>& flw::chart::Line::lod_index(int level) const {
+    static const SeriesColumn<int64_t> EMPTY;
 
-            if (f == days) {
-                avg_gain = avg_gain / days;
-                avg_loss = avg_loss / days;
-                res.push_back(Point(data.date, 100 - (100 / (1 + (avg_gain / avg_loss)))));
-            }
-            else if (f > days) {
-                avg_gain = ((avg_gain * (days - 1)) + ((diff > 0) ? fabs(diff) : 0)) / days;
-                avg_loss = ((avg_loss * (days - 1)) + ((diff < 0) ? fabs(diff) : 0)) / days;
-                res.push_back(Point(data.date, 100 - (100 / (1 + (avg_gain / avg_loss)))));
-            }
-        }
+    if (level == 0) {
+        return _index;
+    }
+    else if (level < 0 || level > static_cast<int>(_lod_index.size()) || _has_index() == false) {
+        return EMPTY;
     }
 
-    return res;
+    return _lod_index[level - 1];
 }
 
-/** @brief Save points to an csv file.
+/** @brief Get aggregated data for a level of detail.
 *
-* @param[in] in        Vector with Point objects.
-* @param[in] filename  Result file name.
-* @param[in] sep       Column separator.
+* Level 0 is the same as view().\n
 *
-* @return True if ok.
+* @param[in] level  Level of detail.
+*
+* @return Data or an empty serie if level has not been calculated with calc_lod().
 */
-bool flw::chart::Point::SaveCSV(const PointVector& in, const std::string& filename, const std::string& sep) {
-    std::string csv;
-
-    csv.reserve(in.size() * 40 + 256);
+const flw::chart::Series& flw::chart::Line::lod_series(int level) const {
+    static const Series EMPTY;
 
-    for (const auto& data : in) {
-        char buffer[2'000];
-        snprintf(buffer, 2'000, "%s%s%s%s%s%s%s\n", data.date.c_str(), sep.c_str(), gnu::json::format_number(data.high).c_str(), sep.c_str(), gnu::json::format_number(data.low).c_str(), sep.c_str(), gnu::json::format_number(data.close).c_str());
-        csv += buffer;
+    if (level == 0) {
+        return view();
+    }
+    else if (level < 0 || level > static_cast<int>(_lod_series.size()) || _has_index() == false) {
+        return EMPTY;
     }
 
-    return gnu::file::write(filename, csv.c_str(), csv.size());
+    return _lod_series[level - 1];
 }
 
-/** @brief Convert data serie using standard deviation.
+/** @brief Update levels of detail after data points have been added to the reference index.
 *
-* @param[in] in    Vector with Point objects.
-* @param[in] days  Number of days.
+* Buckets from the last unchanged data point are removed and aggregated again, in every level.\n
+* Nothing changes if none of the new points are in the reference dates.\n
 *
-* @return Result vector with Point objects.
+* @param[in] first  First new data point in view().
 */
-flw::chart::PointVector flw::chart::Point::StdDev(const PointVector& in, size_t days) {
-    PointVector res;
+void flw::chart::Line::_lod_added(size_t first) {
+    if (std::all_of(_index.begin() + std::min(first, _index.size()), _index.end(), [](int64_t tick) { return tick < 0; }) == true) {
+        return;
+    }
+
+    for (size_t level = 0; level < _lod_series.size(); level++) {
+        const auto& prev_index = (level == 0) ? _index : _lod_index[level - 1];
+        const auto& prev       = (level == 0) ? view() : _lod_series[level - 1];
+        auto&       index      = _lod_index[level];
+        auto&       series     = _lod_series[level];
+        auto        last       = std::min(first, prev_index.size());
+
+        while (last > 0 && prev_index[last - 1] < 0) {
+            last--;
+        }
 
-    if (days > 1 && days < in.size()) {
-        size_t    count = 0;
-        double    sum   = 0.0;
-        Point data2;
+        if (last == 0) {
+            index.clear();
+            series.clear();
+            first = 0;
+            priv::_chart_lod_add(prev_index, prev, 0, index, series);
+            continue;
+        }
+
+        const auto BUCKET = prev_index[last - 1] >> 1;
+        auto       start  = last - 1;
+        size_t     count  = 0;
+
+        while (start > 0 && (prev_index[start - 1] < 0 || (prev_index[start - 1] >> 1) == BUCKET)) {
+            start--;
+        }
 
-        for (const auto& data : in) {
+        while (count < index.size() && index[index.size() - count - 1] >= BUCKET) {
             count++;
-            sum += data.close;
+        }
 
-            if (count >= days) {
-                double mean = sum / days;
-                double dev  = 0.0;
+        index.pop_back(count);
+        series.pop_back(count);
+        first = index.size();
+        priv::_chart_lod_add(prev_index, prev, start, index, series);
+    }
+}
 
-                for (size_t j = count - days; j < count; j++) {
-                    data2 = in[j];
-                    auto tmp = data2.close - mean;
+/** @brief Update levels of detail after data points have been removed from the start.
+*
+* Buckets before the last removed point are removed and the bucket for it is aggregated again from the remaining points, in every level.\n
+*
+* @param[in] tick  Reference index for last removed data point.
+*/
+void flw::chart::Line::_lod_trim(int64_t tick) {
+    for (size_t level = 0; level < _lod_series.size(); level++) {
+        const auto& prev_index = (level == 0) ? _index : _lod_index[level - 1];
+        const auto& prev       = (level == 0) ? view() : _lod_series[level - 1];
+        auto&       index      = _lod_index[level];
+        auto&       series     = _lod_series[level];
+        const auto  BUCKET     = tick >> (level + 1);
+        size_t      count      = 0;
+
+        while (count < index.size() && index[count] < BUCKET) {
+            count++;
+        }
 
-                    tmp *= tmp;
-                    dev  += tmp;
-                }
+        index.pop_front(count);
+        series.pop_front(count);
 
-                dev /= days;
-                dev = sqrt(dev);
+        if (index.size() == 0 || index.front() != BUCKET) {
+            continue;
+        }
 
-                data2 = in[count - days];
-                sum -= data2.close;
+        double h = -INFINITY;
+        double l = INFINITY;
+        double c = 0.0;
 
-                data2 = in[count - 1];
-                res.push_back(Point(data2.date, dev));
+        for (size_t f = 0; f < prev_index.size() && (prev_index[f] < 0 || (prev_index[f] >> 1) == BUCKET); f++) {
+            if (prev_index[f] >= 0) {
+                h = std::max(h, prev.high()[f]);
+                l = std::min(l, prev.low()[f]);
+                c = prev.close()[f];
             }
         }
-    }
 
-    return res;
+        if (series.set(0, h, l, c) == false) {
+            index.pop_front(1);
+            series.pop_front(1);
+        }
+    }
 }
 
-/** @brief Convert data serie using stochastics algorithm.
+/** @brief Get min and max value for data points between two dates.
 *
-* @param[in] in    Vector with Point objects.
-* @param[in] days  Number of days.
+* Only data points in view() that are in the reference dates are used.\n
+* Reference index must have been set by Chart.\n
+* It uses high and low values for bar types and close value for all other.\n
+* Mapped data uses the range for every whole block and only reads data points in the first and last block.\n
 *
-* @return Result vector with Point objects.
+* @param[in]  first  First date.
+* @param[in]  last   Last date (inclusive).
+* @param[out] min    Min value.
+* @param[out] max    Max value.
+*
+* @return True if there was at least one data point, false if not or if reference index has not been set.
 */
-flw::chart::PointVector flw::chart::Point::Stochastics(const PointVector& in, size_t days) {
-    double          high = 0.0;
-    double          low  = 0.0;
-    PointVector res;
+bool flw::chart::Line::minmax(const gnu::DateKey& first, const gnu::DateKey& last, double& min, double& max) const {
+    const auto& keys = view().keys();
+    const auto  SIZE = keys.size();
+    const auto  LEAF = _range_min.size() / 2 + _range_first;
 
-    if (days > 1 && days < in.size()) {
-        for (size_t f = 0; f < in.size(); f++) {
-            const auto& data = in[f];
+    if (view().is_mapped() == true) {
+        if (_block_max.size() == 0) {
+            return false;
+        }
 
-            if ((f + 1) >= days) {
-                high = data.high;
-                low  = data.low;
+        const auto& hi = (_range_hl == true) ? view().high() : view().close();
+        const auto& lo = (_range_hl == true) ? view().low() : view().close();
+        auto        l  = static_cast<size_t>(std::lower_bound(keys.begin(), keys.end(), first) - keys.begin());
+        const auto  r  = static_cast<size_t>(std::upper_bound(keys.begin(), keys.end(), last) - keys.begin());
 
-                for (size_t j = (f + 1) - days; j < (f + 1) - 1; j++) { //  Get max/min in for current range.
-                    const auto& data2 = in[j];
+        min = INFINITY;
+        max = -INFINITY;
 
-                    if (data2.high > high) {
-                        high = data2.high;
-                    }
+        while (l < r) {
+            const auto BLOCK = l / SERIES_BLOCK;
+            const auto END   = std::min(r, (BLOCK + 1) * SERIES_BLOCK);
 
-                    if (data2.low < low) {
-                        low = data2.low;
+            if (l == BLOCK * SERIES_BLOCK && END == std::min(SIZE, (BLOCK + 1) * SERIES_BLOCK)) {
+                _block_range(BLOCK);
+                min = std::min(min, _block_min[BLOCK]);
+                max = std::max(max, _block_max[BLOCK]);
+            }
+            else if (view().check(l, END - 1) == true) {
+                for (auto f = l; f < END; f++) {
+                    if (_mapped_dates.index(keys[f]) != static_cast<size_t>(-1)) {
+                        min = std::min(min, lo[f]);
+                        max = std::max(max, hi[f]);
                     }
                 }
+            }
 
-                double diff1 = data.close - low;
-                double diff2 = high - low;
+            l = END;
+        }
 
-                if (diff2 > chart::MIN_VALUE) {
-                    double kval  = 100.0 * (diff1 / diff2);
-                    res.push_back(Point(data.date, kval));
-                }
-            }
+        return min <= max;
+    }
+    else if (_index.size() != SIZE || _range_min.size() == 0) {
+        return false;
+    }
+
+    auto        l    = static_cast<size_t>(std::lower_bound(keys.begin(), keys.end(), first) - keys.begin()) + LEAF;
+    auto        r    = static_cast<size_t>(std::upper_bound(keys.begin(), keys.end(), last) - keys.begin()) + LEAF;
+
+    min = INFINITY;
+    max = -INFINITY;
+
+    while (l < r) {
+        if (l & 1) {
+            min = std::min(min, _range_min[l]);
+            max = std::max(max, _range_max[l]);
+            l++;
+        }
+
+        if (r & 1) {
+            r--;
+            min = std::min(min, _range_min[r]);
+            max = std::max(max, _range_max[r]);
         }
+
+        l /= 2;
+        r /= 2;
     }
 
-    return res;
+    return min <= max;
 }
 
-/** @brief Convert string to range.
+/** @brief Ask for data in a date range that will be drawn soon.
 *
-* @param[in] range  Range string.
+* Only used for lines with mapped data that are not resampled, see Series::prefetch().
 *
-* @return Range value or DateRange::DAY for invalid input string.
+* @param[in] first  First date.
+* @param[in] last   Last date.
 */
-flw::chart::DateRange flw::chart::Point::StringToRange(const std::string& range) {
-    if (range == "WEEKDAY")     return DateRange::WEEKDAY;
-    else if (range == "FRIDAY") return DateRange::FRIDAY;
-    else if (range == "SUNDAY") return DateRange::SUNDAY;
-    else if (range == "MONTH")  return DateRange::MONTH;
-    else if (range == "HOUR")   return DateRange::HOUR;
-    else if (range == "MIN")    return DateRange::MIN;
-    else if (range == "SEC")    return DateRange::SEC;
-    else                        return DateRange::DAY;
-}
+void flw::chart::Line::prefetch(const gnu::DateKey& first, const gnu::DateKey& last) const {
+    if (_series.is_mapped() == false || &view() != &_series) {
+        return;
+    }
 
-/*
- *      _      _
- *     | |    (_)
- *     | |     _ _ __   ___
- *     | |    | | '_ \ / _ \
- *     | |____| | | | |  __/
- *     |______|_|_| |_|\___|
- *
- *
- */
+    const auto& keys = _series.keys();
+    auto        l    = static_cast<size_t>(std::lower_bound(keys.begin(), keys.end(), first) - keys.begin());
+    auto        r    = static_cast<size_t>(std::upper_bound(keys.begin(), keys.end(), last) - keys.begin());
 
-/** @brief Create a chart line.
-*
-* @param[in] data   Vector with Point objects.
-* @param[in] label  Line label.
-* @param[in] type   Line type.
-*/
-flw::chart::Line::Line(const PointVector& data, const std::string& label, LineType type) {
-    reset();
-    set_data(data);
-    set_label(label);
-    set_type(type);
+    if (l < r) {
+        _series.prefetch(l, r - 1);
+    }
 }
 
-/** @brief Print debug info to stdout.
+/** @brief Select date range for view().
 *
-* @param[in] num  Line index.
+* Only lines with an aggregate mode other than Aggregate::NONE are resampled, see set_aggregate().\n
+* Data is aggregated with Series::Resample() into buckets for the date range.\n
+* Result is cached for every date range until line data changes.\n
+* Nothing is stored if every data point already has a bucket date, then view() returns the line data.\n
+* Reference index is cleared if view() changes.\n
+*
+* @param[in] range  Date range.
+*
+* @return True if view() has changed.
 */
-void flw::chart::Line::debug(size_t num) const {
-#ifdef DEBUG
-    printf("\t\t---------------------------------------------\n");
-    printf("\t\tLine: %u\n", static_cast<unsigned>(num));
-    printf("\t\t\ttype:  %30s\n", type_to_string().c_str());
-    printf("\t\t\twidth:      %25u\n", _width);
-    printf("\t\t\talign:      %25s\n", (_align == FL_ALIGN_LEFT) ? "LEFT" : "RIGHT");
-    printf("\t\t\tlabel: %30s\n", _label.c_str());
-    printf("\t\t\trect:          %04d, %04d, %04d, %04d\n", _rect.x(), _rect.y(), _rect.w(), _rect.h());
-    printf("\t\t\tvisible:    %25s\n", _visible ? "YES" : "NO");
-    printf("\t\t\tprices:     %25d\n", static_cast<int>(size()));
+bool flw::chart::Line::resample(DateRange range) {
+    auto changed = (_resample.has_value() == false || _resample.value() != range);
 
-    if (size() > 1) {
-        printf("\t\t\tfirst:      %25s\n", _data.front().date.c_str());
-        printf("\t\t\tfirst:      %25f\n", _data.front().close);
-        printf("\t\t\tlast:       %25s\n", _data.back().date.c_str());
-        printf("\t\t\tlast:       %25f\n", _data.back().close);
+    if (_aggregate == Aggregate::NONE) {
+        changed = _resample.has_value();
+        _resample.reset();
     }
+    else {
+        if (_resampled.find(range) == _resampled.end()) {
+            auto res = Series();
 
-    fflush(stdout);
-#else
-    (void) num;
-#endif
+            if (priv::_chart_resample(_series, range, 1, (range == DateRange::FRIDAY) ? 4 : 6, false, nullptr) == false) {
+                res = Series::Resample(_series, range, 1, _aggregate == Aggregate::SUM);
+            }
+
+            _resampled[range] = std::move(res);
+            changed           = true;
+        }
+
+        _resample = range;
+    }
+
+    if (changed == true) {
+        _clear_index();
+    }
+
+    return changed;
 }
 
 /** @brief Clear all data.
 *
 */
 void flw::chart::Line::reset() {
-    _data.clear();
-
+    _series.clear();
+    _source_key = gnu::DateKey();
+    _clear_index();
+    _resampled.clear();
+    _resample.reset();
+    _indicator.reset();
+
+    _id       = ++priv::_CHART_LINE_ID;
+    _max_size = 0;
+    _source   = 0;
+    _range_hl = false;
+    _aggregate = Aggregate::NONE;
     _align   = FL_ALIGN_LEFT;
     _color   = FL_FOREGROUND_COLOR;
     _label   = "";
@@ -1224,6 +3626,57 @@ void flw::chart::Line::reset() {
     _width   = 1;
 }
 
+/** @brief Set how line is resampled to the chart date range.
+*
+* With Aggregate::NONE (default) data points are drawn as they are and points without a reference date are not drawn.\n
+* Use Aggregate::OHLC for price data and Aggregate::SUM for data that should be added, like volume.\n
+*
+* @param[in] val  Aggregate mode.
+*
+* @return This line.
+*/
+flw::chart::Line& flw::chart::Line::set_aggregate(Aggregate val) {
+    if (val == _aggregate) {
+        return *this;
+    }
+
+    _aggregate = val;
+    _resampled.clear();
+    _resample.reset();
+    _clear_index();
+
+    return *this;
+}
+
+/** @brief Calculate line from another line.
+*
+* Data is replaced with the result from the indicator.\n
+* Later data points in the source line can then be added with update().\n
+* A source that is calculated from this line is rejected, longer circles are stopped by Chart::append().\n
+*
+* @param[in] indicator  Algorithm.
+* @param[in] source     Source line.
+*
+* @return True if indicator is valid and source is not this line or calculated from it.
+*/
+bool flw::chart::Line::set_indicator(const Indicator& indicator, const Line& source) {
+    if (indicator.is_valid() == false || source.id() == _id || source.source() == _id) {
+        return false;
+    }
+
+    auto ind = indicator;
+
+    _series = ind.run(source.series());
+    _clear_index();
+    _resampled.clear();
+    _indicator  = ind;
+    _source     = source.id();
+    _source_key = source.series().last_key();
+    _trim();
+
+    return true;
+}
+
 /** @brief Set line type from string.
 *
 * If input name is invalid it will set type to LineType::LINE.
@@ -1243,9 +3696,47 @@ flw::chart::Line& flw::chart::Line::set_type_from_string(const std::string&  val
     else if (val == "EXPAND_HORIZONTAL_FIRST") _type = LineType::EXPAND_HORIZONTAL_FIRST;
     else                                       _type = LineType::LINE;
 
+    _calc_range(false);
     return *this;
 }
 
+/** @brief Remove oldest data points if there are more than max_size().
+*
+* If view() is the line data then the reference index, segment trees and levels of detail are moved forward instead of calculated again.\n
+* Resampled data is removed, except for date ranges where it is the same as the line data.\n
+* If view() is resampled then Chart will calculate a new reference index.\n
+*/
+void flw::chart::Line::_trim() {
+    if (_max_size == 0 || _series.size() <= _max_size) {
+        return;
+    }
+
+    const auto COUNT = _series.size() - _max_size;
+    auto       tick  = static_cast<int64_t>(-1);
+
+    for (auto it = _resampled.begin(); it != _resampled.end();) {
+        it = (it->second.size() > 0) ? _resampled.erase(it) : std::next(it);
+    }
+
+    if (&view() != &_series || _index.size() < COUNT) {
+        _clear_index();
+    }
+    else {
+        for (size_t f = 0; f < COUNT; f++) {
+            tick = (_index[f] >= 0) ? _index[f] : tick;
+        }
+
+        _index.pop_front(COUNT);
+        _range_first += COUNT;
+    }
+
+    _series.pop_front(COUNT);
+
+    if (tick >= 0) {
+        _lod_trim(tick);
+    }
+}
+
 /** @brief Return line type as a string.
 *
 * @return Line type name, one of ("LINE", "LINE_DOT", "BAR", "BAR_CLAMP", "BAR_HLC", "HORIZONTAL", "EXPAND_VERTICAL", "EXPAND_HORIZONTAL_ALL", "EXPAND_HORIZONTAL_FIRST").
@@ -1255,6 +3746,87 @@ std::string flw::chart::Line::type_to_string() const {
     return NAMES[static_cast<unsigned>(_type)];
 }
 
+/** @brief Add new data points from source line.
+*
+* Only lines with an indicator that has been set with set_indicator() are updated.\n
+* Source points after the last added date are used so it works even if old points have been removed from the source.\n
+*
+* @param[in] source  Source line.
+*
+* @return True if one or more data points were added.
+*/
+bool flw::chart::Line::update(const Line& source) {
+    if (_indicator.has_value() == false || source.id() != _source) {
+        return false;
+    }
+
+    auto&       ind    = _indicator.value();
+    const auto& series = source.series();
+    const auto& keys   = series.keys();
+    const auto  last   = _series.last_key();
+    const auto  SIZE   = _series.size();
+    auto        f      = (_source_key.is_invalid() == true) ? 0 : static_cast<size_t>(std::upper_bound(keys.begin(), keys.end(), _source_key) - keys.begin());
+
+    for (; f < series.size(); f++) {
+        if (series.check(f, f) == true) {
+            ind.add(series.key(f), series.high()[f], series.low()[f], series.close()[f], _series);
+            _source_key = series.key(f);
+        }
+    }
+
+    _added(SIZE);
+    _trim();
+
+    return _series.last_key().is_invalid() == false && (last.is_invalid() == true || _series.last_key() > last);
+}
+
+/** @brief Update segment trees for data points that have been added to the reference index.
+*
+* Each point costs O(log n), trees are built again when there is no room left for new leaves.\n
+*
+* @param[in] first  First new data point in view().
+*/
+void flw::chart::Line::_update_range(size_t first) {
+    const auto LEAF = _range_min.size() / 2;
+
+    if (LEAF == 0 || _range_first + _index.size() > LEAF || _range_hl != type_has_high_and_low()) {
+        _calc_range(true);
+        return;
+    }
+
+    const auto& series = view();
+    const auto& max    = (_range_hl == true) ? series.high() : series.close();
+    const auto& min    = (_range_hl == true) ? series.low() : series.close();
+
+    for (auto f = first; f < _index.size(); f++) {
+        auto leaf = LEAF + _range_first + f;
+
+        _range_max[leaf] = (_index[f] >= 0) ? max[f] : -INFINITY;
+        _range_min[leaf] = (_index[f] >= 0) ? min[f] : INFINITY;
+
+        for (leaf /= 2; leaf > 0; leaf /= 2) {
+            _range_max[leaf] = std::max(_range_max[leaf * 2], _range_max[leaf * 2 + 1]);
+            _range_min[leaf] = std::min(_range_min[leaf * 2], _range_min[leaf * 2 + 1]);
+        }
+    }
+}
+
+/** @brief Get data that is drawn.
+*
+* @return Data resampled to date range set with resample() or line data.
+*/
+const flw::chart::Series& flw::chart::Line::view() const {
+    if (_resample.has_value() == true) {
+        auto it = _resampled.find(_resample.value());
+
+        if (it != _resampled.end() && it->second.size() > 0) {
+            return it->second;
+        }
+    }
+
+    return _series;
+}
+
 /*
  *       _____           _
  *      / ____|         | |
@@ -1469,7 +4041,7 @@ _CW(14) {
     labelcolor(FL_FOREGROUND_COLOR);
     box(FL_BORDER_BOX);
     tooltip(
-        "Press ctrl + scroll wheel to change tick width.\n"
+        "Press ctrl + scroll wheel to change tick width (or level of detail if it is turned on).\n"
         "Press ctrl + left button to show value for selected line.\n"
         "Press left button to show Y value.\n"
         "Press middle button on label to select that line.\n"
@@ -1487,7 +4059,8 @@ _CW(14) {
 
     _menu->add(priv::_CHART_LABEL_SHOW_LABELS,      0, _FLW_CHART_CB(setup_view_options()), FL_MENU_TOGGLE);
     _menu->add(priv::_CHART_LABEL_SHOW_HLINES,      0, _FLW_CHART_CB(setup_view_options()), FL_MENU_TOGGLE);
-    _menu->add(priv::_CHART_LABEL_SHOW_VLINES,      0, _FLW_CHART_CB(setup_view_options()), FL_MENU_TOGGLE | FL_MENU_DIVIDER);
+    _menu->add(priv::_CHART_LABEL_SHOW_VLINES,      0, _FLW_CHART_CB(setup_view_options()), FL_MENU_TOGGLE);
+    _menu->add(priv::_CHART_LABEL_SHOW_LOD,         0, _FLW_CHART_CB(setup_view_options()), FL_MENU_TOGGLE | FL_MENU_DIVIDER);
     _menu->add(priv::_CHART_LABEL_CLEAR,            0, _FLW_CHART_CB(reset()));
     _menu->add(priv::_CHART_LABEL_SETUP_LABEL,      0, _FLW_CHART_CB(setup_label()));
     _menu->add(priv::_CHART_LABEL_SETUP_AREA,       0, _FLW_CHART_CB(setup_area()));
@@ -1502,7 +4075,9 @@ _CW(14) {
     _menu->add(priv::_CHART_LABEL_SAVE_CSV,         0, _FLW_CHART_CB(save_line_to_csv()), FL_MENU_DIVIDER);
     _menu->add(priv::_CHART_LABEL_ADD_CSV,          0, _FLW_CHART_CB(load_line_from_csv()));
     _menu->add(priv::_CHART_LABEL_LOAD_JSON,        0, _FLW_CHART_CB(load_json()));
-    _menu->add(priv::_CHART_LABEL_SAVE_JSON,        0, _FLW_CHART_CB(save_json()), FL_MENU_DIVIDER);
+    _menu->add(priv::_CHART_LABEL_SAVE_JSON,        0, _FLW_CHART_CB(save_json()));
+    _menu->add(priv::_CHART_LABEL_LOAD_SNAPSHOT,    0, _FLW_CHART_CB(load_snapshot()));
+    _menu->add(priv::_CHART_LABEL_SAVE_SNAPSHOT,    0, _FLW_CHART_CB(save_snapshot()), FL_MENU_DIVIDER);
     _menu->add(priv::_CHART_LABEL_PRINT,            0, _FLW_CHART_CB(print_to_postscript()));
     _menu->add(priv::_CHART_LABEL_SAVE_PNG,         0, _FLW_CHART_CB(save_png()));
 #ifdef DEBUG
@@ -1522,11 +4097,104 @@ _CW(14) {
     _areas.push_back(Area(AreaNum::FIVE));
 
     _disable_menu = false;
+    _offscreen    = 0;
 
     reset();
     update_pref();
 }
 
+/** @brief Delete offscreen image.
+*
+*/
+flw::chart::Chart::~Chart() {
+    if (_offscreen != 0) {
+        fl_delete_offscreen(_offscreen);
+    }
+}
+
+/** @brief Add one data point to a line and update the view.
+*
+* Lines in all areas that are calculated from the line are also updated.\n
+* Reference dates are extended instead of created again if the new date is after the last date.\n
+* They are only created again if data starts before the first date or if old data points,
+* removed by Line::set_max_size(), leaves more than half of the dates unused.\n
+* If last date was visible then the view is scrolled to the new date.\n
+*
+* @param[in] area   Area.
+* @param[in] line   Line index in area.
+* @param[in] point  Data point, date must be later than last date in the line.
+*
+* @return True if point was added.
+*/
+bool flw::chart::Chart::append(AreaNum area, size_t line, const Point& point) {
+    const auto key    = priv::_CHART_DATE_PARSER.parse(point.date);
+    const bool follow = _date_start + _ticks >= _tick_count() - 1;
+
+    auto changed = _areas[static_cast<size_t>(area)].line(line);
+
+    if (changed == nullptr || changed->append(key, point.high, point.low, point.close) == false) {
+        return false;
+    }
+
+    std::vector<Line*> lines;
+
+    for (auto& a : _areas) {
+        for (size_t f = 0; f < a.size(); f++) {
+            lines.push_back(a.line(f));
+        }
+    }
+
+    priv::_chart_update_lines(lines, changed);
+
+    gnu::DateKey min;
+    gnu::DateKey max;
+
+    for (auto& a : _areas) {
+        for (size_t f = 0; f < a.size(); f++) {
+            auto line = a.line(f);
+
+            line->resample(_date_range);
+
+            const auto first = line->view().first_key();
+            const auto last  = line->view().last_key();
+
+            if (first.is_invalid() == false && line->is_visible() == true) {
+
+                if (min.is_invalid() == true || first < min) {
+                    min = first;
+                }
+
+                if (max.is_invalid() == true || last > max) {
+                    max = last;
+                }
+            }
+        }
+    }
+
+    if (min.is_invalid() == true) {
+        return true;
+    }
+    else if (_dates.size() == 0 ||
+        min < _dates.key(0) ||
+        min > _dates.key(_dates.size() / 2) ||
+        _dates_block != _block_dates) {
+
+        if (_calc_dates() == true) {
+            _calc_index(true);
+        }
+    }
+    else if (max > _dates_max && _dates.extend(max, _block_dates) == true) {
+        _dates_max = max;
+    }
+
+    if (follow == true) {
+        static_cast<Fl_Slider*>(_scroll)->value(_tick_count());
+    }
+
+    init();
+    return true;
+}
+
 /** @brief Calculate area height for all areas.
 *
 */
@@ -1575,16 +4243,29 @@ void flw::chart::Chart::_calc_area_width() {
 
     _ticks = static_cast<int>(width / _tick_width);
 
-    if (static_cast<int>(_dates.size()) > _ticks) {
-        const double slider_size = _ticks / (_dates.size() + 1.0);
+    if (_lod == false) {
+        _lod_level = 0;
+    }
+    else if (_lod_fit == true) {
+        _lod_level = 0;
+
+        while (_tick_count() > _ticks && _ticks > 0) {
+            _lod_level++;
+        }
+    }
+
+    const int count = _tick_count();
+
+    if (count > _ticks) {
+        const double slider_size = _ticks / (count + 1.0);
 
         _scroll->activate();
         _scroll->slider_size((slider_size > 0.05) ? slider_size : 0.05);
-        _scroll->range(0, _dates.size() - _ticks);
+        _scroll->range(0, count - _ticks);
 
         if (_scroll->value() > _scroll->maximum()) {
             static_cast<Fl_Slider*>(_scroll)->value(_scroll->maximum());
-            _date_start = _dates.size() - _ticks - 1;
+            _date_start = count - _ticks - 1;
         }
     }
     else {
@@ -1603,39 +4284,94 @@ void flw::chart::Chart::_calc_area_width() {
 
 /** @brief Create date serie which are used to search for data points.
 *
-* It takes min and max date from all areas and all lines.
+* It takes min and max date from all areas and all lines.\n
+* Lines are resampled to the date range first so the dates are the bucket dates.\n
+* Date serie is kept if first date, last date, date range and block dates are the same as last time.\n
+* If only the last date is later then the date serie is extended.\n
+*
+* @return True if a new date serie has been created and all reference indexes must be calculated again.
 */
-void flw::chart::Chart::_calc_dates() {
-    std::string min;
-    std::string max;
+bool flw::chart::Chart::_calc_dates() {
+    gnu::DateKey min;
+    gnu::DateKey max;
 
     for (auto& area : _areas) {
-        for (auto& line : area.lines()) {
-            if (line.size() > 0 && line.is_visible() == true) {
-                const auto& first = line.data().front();
-                const auto& last  = line.data().back();
+        for (size_t f = 0; f < area.size(); f++) {
+            auto line = area.line(f);
+
+            line->resample(_date_range);
+
+            const auto first = line->view().first_key();
+            const auto last  = line->view().last_key();
+
+            if (first.is_invalid() == false && line->is_visible() == true) {
 
-                if (min == "") {
-                    min = "99991231 232359";
-                    max = "01010101 000000";
+                if (min.is_invalid() == true || first < min) {
+                    min = first;
                 }
 
-                if (first.date < min) {
-                    min = first.date;
+                if (max.is_invalid() == true || last > max) {
+                    max = last;
                 }
+            }
+        }
+    }
+
+    if (min.is_invalid() == true) {
+        _dates.clear();
+        _dates_block.clear();
+        _dates_max = gnu::DateKey();
+        _dates_min = gnu::DateKey();
+        return true;
+    }
+    else if (_dates.size() > 0 && _dates.range() == _date_range && min == _dates_min && max >= _dates_max && _dates_block == _block_dates) {
+        if (max == _dates_max) {
+            return false;
+        }
+        else if (_dates.extend(max, _block_dates) == true) {
+            _dates_max = max;
+            redraw();
+            return false;
+        }
+    }
+
+    _dates       = DateGenerator(priv::_chart_key_date(min), priv::_chart_key_date(max), _date_range, _block_dates);
+    _dates_block = _block_dates;
+    _dates_max   = max;
+    _dates_min   = min;
+    redraw();
+
+    return true;
+}
+
+/** @brief Calculate reference date index for every data point in all lines.
+*
+* Drawing and scale calculations can then walk through data instead of searching for every date.\n
+* Index is for the resampled data in Line::view().\n
+*
+* @param[in] all  True to recalculate all lines, false to only add data points that are new since last call.
+*/
+void flw::chart::Chart::_calc_index(bool all) {
+    for (auto& area : _areas) {
+        for (size_t f = 0; f < area.size(); f++) {
+            auto line = area.line(f);
 
-                if (last.date > max) {
-                    max = last.date;
-                }
-            }
+            line->resample(_date_range);
+            line->calc_index(_dates, all);
         }
     }
+}
 
-    _dates.clear();
-
-    if (min != "") {
-        _dates = Point::DateSerie(min, max, _date_range, _block_dates);
-        redraw();
+/** @brief Calculate aggregated data for current level of detail in all lines.
+*
+* Only missing levels are calculated, they are removed when reference index changes.\n
+* Lines with mapped data only keeps current level, nothing at level 0.\n
+*/
+void flw::chart::Chart::_calc_lod() {
+    for (auto& area : _areas) {
+        for (size_t f = 0; f < area.size(); f++) {
+            area.line(f)->calc_lod(_lod_level);
+        }
     }
 }
 
@@ -1701,6 +4437,9 @@ void flw::chart::Chart::_calc_margins() {
 * Clamp values does override dataset.\n
 */
 void flw::chart::Chart::_calc_ymin_ymax() {
+    const int start = _date_start << _lod_level;
+    const int stop  = _last_date(_date_start + _ticks);
+
     for (auto& area : _areas) {
         auto min_clamp = area.clamp_min();
         auto max_clamp = area.clamp_max();
@@ -1709,76 +4448,39 @@ void flw::chart::Chart::_calc_ymin_ymax() {
         area.right_scale().reset();
 
         for (const auto& line : area.lines()) {
-            if (line.size() == 0 || line.is_visible() == false) {
+            if (line.size() == 0 || line.is_visible() == false || start > stop) {
                 continue;
             }
 
-            const int stop    = _date_start + _ticks;
-            int       current = _date_start;
-            double    minimum = INFINITY;
-            double    maximum = INFINITY;
-            double    max     = 0.0;
-            double    min     = 0.0;
+            double max = 0.0;
+            double min = 0.0;
 
-            if (min_clamp.has_value() == true) {
-                minimum = min_clamp.value();
+            if (_lod_level == 0) {
+                line.prefetch(_dates.key(start), _dates.key(stop));
             }
 
-            if (max_clamp.has_value() == true) {
-                maximum = max_clamp.value();
+            if (line.minmax(_dates.key(start), _dates.key(stop), min, max) == false) {
+                continue;
             }
 
-            while (current <= stop && current < static_cast<int>(_dates.size())) {
-                const Point& date  = _dates[current];
-                const size_t     index = Point::BinarySearch(line.data(), date);
-
-                if (index != static_cast<size_t>(-1)) {
-                    const Point& data = line.data()[index];
-
-                    if (line.type_has_high_and_low() == true) {
-                        min = data.low;
-                        max = data.high;
-                    }
-                    else {
-                        min = data.close;
-                        max = data.close;
-                    }
-
-                    if (std::isfinite(minimum) == true) {
-                        min = minimum;
-                    }
-
-                    if (std::isfinite(maximum) == true) {
-                        max = maximum;
-                    }
-
-                    if (line.align() == FL_ALIGN_LEFT) {
-                        auto scale_min = area.left_scale().min();
-                        auto scale_max = area.left_scale().max();
-
-                        if (scale_min.has_value() == false || min < scale_min.value()) {
-                            area.left_scale().set_min(min);
-                        }
+            if (min_clamp.has_value() == true) {
+                min = min_clamp.value();
+            }
 
-                        if (scale_max.has_value() == false || max > scale_max.value()) {
-                            area.left_scale().set_max(max);
-                        }
-                    }
-                    else {
-                        auto scale_min = area.right_scale().min();
-                        auto scale_max = area.right_scale().max();
+            if (max_clamp.has_value() == true) {
+                max = max_clamp.value();
+            }
 
-                        if (scale_min.has_value() == false || min < scale_min.value()) {
-                            area.right_scale().set_min(min);
-                        }
+            auto& scale     = (line.align() == FL_ALIGN_LEFT) ? area.left_scale() : area.right_scale();
+            auto  scale_min = scale.min();
+            auto  scale_max = scale.max();
 
-                        if (scale_max.has_value() == false || max > scale_max.value()) {
-                            area.right_scale().set_max(max);
-                        }
-                    }
-                }
+            if (scale_min.has_value() == false || min < scale_min.value()) {
+                scale.set_min(min);
+            }
 
-                current++;
+            if (scale_max.has_value() == false || max > scale_max.value()) {
+                scale.set_max(max);
             }
         }
 
@@ -1854,9 +4556,10 @@ bool flw::chart::Chart::create_line(Algorithm formula, bool support) {
     auto line1  = Line();
     auto line2  = Line();
     auto line3  = Line();
-    auto vec1   = PointVector();
-    auto vec2   = PointVector();
-    auto vec3   = PointVector();
+    auto vec1   = Series();
+    auto ind1   = std::optional<Indicator>();
+    auto ind2   = std::optional<Indicator>();
+    auto ind3   = std::optional<Indicator>();
     auto label1 = std::string();
     auto label2 = std::string();
     auto label3 = std::string();
@@ -1876,20 +4579,20 @@ bool flw::chart::Chart::create_line(Algorithm formula, bool support) {
             return false;
         }
 
-        vec1   = Point::ATR(line0->data(), days);
+        ind1   = Indicator(Algorithm::ATR, days);
         label1 = util::format("ATR %d Days", days);
     }
     else if (formula == Algorithm::DAY_TO_WEEK) {
         auto answer = dlg::msg_ask("Chart", "Would you like to use highest/lowest and last close value per week?\nOr sum values per week?", "Sum", "High/Low");
 
-        vec1   = Point::DayToWeek(line0->data(), gnu::Date::Day::SUNDAY, answer == "Sum");
+        vec1   = Series::Resample(line0->series(), DateRange::SUNDAY, 1, answer == "Sum");
         label1 = "Weekly (Sunday)";
         type1  = line0->type();
     }
     else if (formula == Algorithm::DAY_TO_MONTH) {
         auto answer = dlg::msg_ask("Chart", "Would you like to use highest/lowest and last close value per month?\nOr sum values per month?", "Sum", "High/Low");
 
-        vec1   = Point::DayToMonth(line0->data(), answer == "Sum");
+        vec1   = Series::Resample(line0->series(), DateRange::MONTH, 1, answer == "Sum");
         label1 = "Monthly";
         type1  = line0->type();
     }
@@ -1901,7 +4604,7 @@ bool flw::chart::Chart::create_line(Algorithm formula, bool support) {
             return false;
         }
 
-        vec1   = Point::ExponentialMovingAverage(line0->data(), days);
+        ind1   = Indicator(Algorithm::EXP_MOVING_AVERAGE, days);
         label1 = util::format("Exponential Moving Average %d Days", days);
     }
     else if (formula == Algorithm::FIXED) {
@@ -1912,7 +4615,7 @@ bool flw::chart::Chart::create_line(Algorithm formula, bool support) {
             return false;
         }
 
-        vec1   = Point::Fixed(line0->data(), value);
+        ind1   = Indicator(Algorithm::FIXED, 0, value);
         label1 = util::format("Horizontal %f", value);
         type1  = LineType::EXPAND_HORIZONTAL_FIRST;
     }
@@ -1936,7 +4639,7 @@ bool flw::chart::Chart::create_line(Algorithm formula, bool support) {
             return false;
         }
 
-        vec1   = Point::Modify(line0->data(), modify, value);
+        ind1   = Indicator(Algorithm::MODIFY, 0, value, modify);
         label1 = util::format("Modified %s", line0->label().c_str());
         type1  = line0->type();
     }
@@ -1948,11 +4651,11 @@ bool flw::chart::Chart::create_line(Algorithm formula, bool support) {
             return false;
         }
 
-        vec1   = Point::Momentum(line0->data(), days);
+        ind1   = Indicator(Algorithm::MOMENTUM, days);
         label1 = util::format("Momentum %d Days", days);
 
         if (support == true) {
-            vec2   = Point::Fixed(line0->data(), 0.0);
+            ind2   = Indicator(Algorithm::FIXED, 0, 0.0);
             label2 = "Momentum Zero";
             type2  = LineType::EXPAND_HORIZONTAL_FIRST;
         }
@@ -1965,7 +4668,7 @@ bool flw::chart::Chart::create_line(Algorithm formula, bool support) {
             return false;
         }
 
-        vec1   = Point::MovingAverage(line0->data(), days);
+        ind1   = Indicator(Algorithm::MOVING_AVERAGE, days);
         label1 = util::format("Moving Average %d Days", days);
     }
     else if (formula == Algorithm::RSI) {
@@ -1976,14 +4679,14 @@ bool flw::chart::Chart::create_line(Algorithm formula, bool support) {
             return false;
         }
 
-        vec1   = Point::RSI(line0->data(), days);
+        ind1   = Indicator(Algorithm::RSI, days);
         label1 = util::format("RSI %d Days", days);
 
         if (support == true) {
-            vec2   = Point::Fixed(line0->data(), 30.0);
+            ind2   = Indicator(Algorithm::FIXED, 0, 30.0);
             label2 = "RSI 30";
             type2  = LineType::EXPAND_HORIZONTAL_FIRST;
-            vec3   = Point::Fixed(line0->data(), 70.0);
+            ind3   = Indicator(Algorithm::FIXED, 0, 70.0);
             label3 = "RSI 70";
             type3  = LineType::EXPAND_HORIZONTAL_FIRST;
         }
@@ -1996,7 +4699,7 @@ bool flw::chart::Chart::create_line(Algorithm formula, bool support) {
             return false;
         }
 
-        vec1   = Point::StdDev(line0->data(), days);
+        ind1   = Indicator(Algorithm::STD_DEV, days);
         label1 = util::format("Std. dev. %d Days", days);
     }
     else if (formula == Algorithm::STOCHASTICS) {
@@ -2007,35 +4710,51 @@ bool flw::chart::Chart::create_line(Algorithm formula, bool support) {
             return false;
         }
 
-        vec1   = Point::Stochastics(line0->data(), days);
+        ind1   = Indicator(Algorithm::STOCHASTICS, days);
         label1 = util::format("Stochastics %d Days", days);
 
         if (support == true) {
-            vec2   = Point::Fixed(line0->data(), 20.0);
+            ind2   = Indicator(Algorithm::FIXED, 0, 20.0);
             label2 = "Stochastics 20";
             type2  = LineType::EXPAND_HORIZONTAL_FIRST;
-            vec3   = Point::Fixed(line0->data(), 80.0);
+            ind3   = Indicator(Algorithm::FIXED, 0, 80.0);
             label3 = "Stochastics 80";
             type3  = LineType::EXPAND_HORIZONTAL_FIRST;
         }
     }
 
-    if (vec1.size() == 0) {
+    if (ind1.has_value() == true) { // New line is updated when data is appended to source line.
+        line1.set_indicator(ind1.value(), *line0);
+    }
+    else {
+        line1.set_data(std::move(vec1));
+    }
+
+    if (line1.size() == 0) {
         dlg::msg_alert("Chart", "No data!");
         return false;
     }
 
-    line1.set_data(vec1).set_label(label1).set_type(type1).set_align(line0->align()).set_color(FL_BLUE);
+    line1.set_label(label1).set_type(type1).set_align(line0->align()).set_color(FL_BLUE);
     priv::_ChartLineSetup(top_window(), line1).run();
-    _area->add_line(line1);
 
-    if (vec2.size() > 0) {
-        line2.set_data(vec2).set_label(label2).set_type(type2).set_align(line1.align()).set_color(FL_BLACK);
+    if (ind2.has_value() == true) {
+        line2.set_indicator(ind2.value(), *line0);
+        line2.set_label(label2).set_type(type2).set_align(line1.align()).set_color(FL_BLACK);
+    }
+
+    if (ind3.has_value() == true) {
+        line3.set_indicator(ind3.value(), *line0);
+        line3.set_label(label3).set_type(type3).set_align(line1.align()).set_color(FL_BLACK);
+    }
+
+    _area->add_line(line1); // Add lines after line0 is not used any more.
+
+    if (line2.size() > 0) {
         _area->add_line(line2);
     }
 
-    if (vec3.size() > 0) {
-        line3.set_data(vec3).set_label(label3).set_type(type3).set_align(line1.align()).set_color(FL_BLACK);
+    if (line3.size() > 0) {
         _area->add_line(line3);
     }
 
@@ -2076,14 +4795,15 @@ void flw::chart::Chart::_create_tooltip(bool ctrl) {
         right_dec = util::count_decimals(_area->right_scale().tick()) + 1;
     }
 
-    while (start <= STOP && start < static_cast<int>(_dates.size())) {
+    while (start <= STOP && start < _tick_count()) {
         if (X >= x1 && X <= x1 + _tick_width - 1) { // Is mouse x pos inside current tick?
             const Line* LINE = _area->selected_line();
-            const auto       DATE = gnu::Date(_dates[start].date);
-            std::string      date = DATE.format(gnu::Date::Format::DAY_MONTH_YEAR);
+            const auto       KEY  = _dates.key(start << _lod_level);
+            std::string      date = _date_cache.format(KEY, gnu::Date::Format::DAY_MONTH_YEAR);
 
             if (_date_range == DateRange::HOUR || _date_range == DateRange::MIN || _date_range == DateRange::SEC) {
-                 date += " - " + DATE.format(gnu::Date::Format::TIME_LONG);
+                 date += " - ";
+                 date += _date_cache.format(KEY, gnu::Date::Format::TIME_LONG);
             }
 
             _tooltip = date + "\n \n \n ";
@@ -2116,11 +4836,12 @@ void flw::chart::Chart::_create_tooltip(bool ctrl) {
                 }
             }
             else { // Use actual chart data.
-                const size_t index = Point::BinarySearch(LINE->data(), _dates[start]);
+                auto         walk  = priv::_ChartWalk(*LINE, _dates, start, _lod_level);
+                const size_t index = walk.find(start);
 
                 if (index != static_cast<size_t>(-1)) {
                     const int         DEC   = (LINE->align() == FL_ALIGN_RIGHT) ? right_dec : left_dec;
-                    const Point&  DATA  = LINE->data()[index];
+                    const Point       DATA  = walk.series().point(index);
                     const std::string HIGH  = util::format_double(DATA.high, DEC, '\'');
                     const std::string LOW   = util::format_double(DATA.low, DEC, '\'');
                     const std::string CLOSE = util::format_double(DATA.close, DEC, '\'');
@@ -2138,7 +4859,7 @@ void flw::chart::Chart::_create_tooltip(bool ctrl) {
     }
 
     if (_tooltip != "" || old != "") {
-        redraw();
+        damage(FL_DAMAGE_USER1);
     }
 }
 
@@ -2151,19 +4872,16 @@ void flw::chart::Chart::debug() const {
     Point first, last, start, end;
 
     if (_dates.size() > 0) {
-        first = _dates.front();
+        first = _dates.point(0);
     }
 
     if (_dates.size() > 1) {
-        last = _dates.back();
-    }
-
-    if (static_cast<int>(_dates.size()) > _date_start) {
-        start = _dates[_date_start];
+        last = _dates.point(_dates.size() - 1);
     }
 
-    if (_ticks >= 0 && static_cast<int>(_dates.size()) > (_date_start + _ticks)) {
-        end = _dates[_date_start + _ticks];
+    if (_tick_count() > _date_start) {
+        start = _dates.point(_date_start << _lod_level);
+        end   = _dates.point(_last_date(_date_start + _ticks));
     }
 
     printf("\n");
@@ -2180,6 +4898,8 @@ void flw::chart::Chart::debug() const {
     printf("\tblock_dates:     %19d\n", static_cast<int>(_block_dates.size()));
     printf("\tdate_start:      %19d\n", _date_start);
     printf("\tdate_end:        %19d\n", _date_start + _ticks);
+    printf("\tlod:             %19s\n", _lod ? "YES" : "NO");
+    printf("\tlod_level:       %19d\n", _lod_level);
     printf("\tlabels:          %19s\n", _labels ? "YES" : "NO");
     printf("\thorizontal:      %19s\n", _horizontal ? "YES" : "NO");
     printf("\tvertical:        %19s\n", _vertical ? "YES" : "NO");
@@ -2208,22 +4928,23 @@ void flw::chart::Chart::debug_line() const {
     }
 
     const auto* line = _area->selected_line();
-    const auto& data = line->data();
-    int         curr = _date_start;
-    const int   stop = _date_start + _ticks;
+    const auto& data = line->view();
+    int         curr = _date_start << _lod_level;
+    const int   stop = _last_date(_date_start + _ticks);
     double      min  = 999'999'999'999'999;
     double      max  = -999'999'999'999'999;
 
     puts("");
     printf("%5s: %15s %23s %23s %23s\n", "COUNT", "DATE", "HIGH", "LOW", "CLOSE");
 
+    auto walk = priv::_ChartWalk(*line, _dates, curr);
+
     while (curr <= stop && curr < static_cast<int>(_dates.size())) {
-        auto& date  = _dates[curr];
-        auto  index = Point::BinarySearch(data, date);
+        auto index = walk.find(curr);
 
         if (index != static_cast<size_t>(-1)) {
-            auto& d = line->data()[index];
-            printf("%5d: %15s %23.8f %23.8f %23.8f\n", curr, date.date.c_str(), d.high, d.low, d.close);
+            auto d = data.point(index);
+            printf("%5d: %15s %23.8f %23.8f %23.8f\n", curr, d.date.c_str(), d.high, d.low, d.close);
 
             if (d.high > max) {
                 max = d.high;
@@ -2257,39 +4978,50 @@ void flw::chart::Chart::draw() {
     if (_printing == true) {
         fl_line_style(FL_SOLID, 1);
         fl_rectf(x(), y(), w(), h(), FL_BACKGROUND2_COLOR);
-    }
-    else {
-        Fl_Group::draw();
+        _draw_layer();
+        _draw_tooltip();
+        fl_line_style(0);
+        return;
     }
 
-    if (_areas[0].rect().w() < 40 || h() < _top_space + _bottom_space + _CH) {
-        fl_line_style(FL_SOLID, 1);
-        fl_rect(x() + 12, y() + 12, w() - 24, h() - 36, FL_FOREGROUND_COLOR);
+    const auto rect = Fl_Rect(x(), y(), w(), h() - _scroll->h());
+
+    if (rect.w() < 1 || rect.h() < 1) {
+        draw_children();
         return;
     }
 
-    _FLW_CHART_CLIP(fl_push_clip(x(), y(), w(), h() - _scroll->h()))
-    _draw_label();
-    _draw_xlabels();
-    _FLW_CHART_CLIP(fl_pop_clip())
+    if (_offscreen == 0 ||
+        (damage() & FL_DAMAGE_ALL) != 0 ||
+        rect.x() != _offscreen_rect.x() ||
+        rect.y() != _offscreen_rect.y() ||
+        rect.w() != _offscreen_rect.w() ||
+        rect.h() != _offscreen_rect.h()) { // Draw everything to the offscreen image.
 
-    for (auto& area : _areas) {
-        if (area.percent() >= priv::_CHART_MIN_AREA_SIZE) {
-            _FLW_CHART_CLIP(fl_push_clip(x(), y(), w(), h() - _scroll->h()))
-            _draw_ver_lines(area);
-            _draw_ylabels(area, FL_ALIGN_LEFT);
-            _draw_ylabels(area, FL_ALIGN_RIGHT);
-            _FLW_CHART_CLIP(fl_pop_clip())
+        if (_offscreen != 0 && (rect.w() != _offscreen_rect.w() || rect.h() != _offscreen_rect.h())) {
+            fl_delete_offscreen(_offscreen);
+            _offscreen = 0;
+        }
 
-            _FLW_CHART_CLIP(fl_push_clip(x() + area.rect().x(), y() + area.rect().y() - 1, area.rect().w() + 1, area.rect().h() + 2))
-            _draw_lines(area);
-            _draw_line_labels(area);
-            fl_line_style(FL_SOLID, 1);
-            fl_rect(x() + area.rect().x(), y() + area.rect().y() - 1, area.rect().w() + 1, area.rect().h() + 2, labelcolor());
-            _FLW_CHART_CLIP(fl_pop_clip())
+        Fl_Image_Surface surface(rect.w(), rect.h(), 1, _offscreen); // Image is widget size, origin is moved so window coordinates can be used.
+
+        if (_offscreen != 0) {
+            surface.rescale();
         }
+
+        Fl_Surface_Device::push_current(&surface);
+        surface.origin(-rect.x(), -rect.y());
+        draw_box();
+        draw_label();
+        _draw_layer();
+        Fl_Surface_Device::pop_current();
+
+        _offscreen      = surface.get_offscreen_before_delete();
+        _offscreen_rect = rect;
     }
 
+    fl_copy_offscreen(rect.x(), rect.y(), rect.w(), rect.h(), _offscreen, 0, 0);
+    draw_children();
     _draw_tooltip();
     fl_line_style(0);
 
@@ -2313,6 +5045,43 @@ void flw::chart::Chart::_draw_label() {
     _FLW_CHART_DEBUG(fl_rect(x() + _areas[0].rect().x(), y(), _areas[0].rect().w() + 1, _top_space))
 }
 
+/** @brief Draw labels, scales, support lines and chart lines for all areas.
+*
+* Everything except the tooltip.\n
+* When not printing it is drawn to an offscreen image.\n
+* The image is only redrawn after a redraw() call or if widget size has changed.\n
+* Tooltip changes are using FL_DAMAGE_USER1 so they only copy the image and draw the tooltip on top of it.\n
+*/
+void flw::chart::Chart::_draw_layer() {
+    if (_areas[0].rect().w() < 40 || h() < _top_space + _bottom_space + _CH) {
+        fl_line_style(FL_SOLID, 1);
+        fl_rect(x() + 12, y() + 12, w() - 24, h() - 36, FL_FOREGROUND_COLOR);
+        return;
+    }
+
+    _FLW_CHART_CLIP(fl_push_clip(x(), y(), w(), h() - _scroll->h()))
+    _draw_label();
+    _draw_xlabels();
+    _FLW_CHART_CLIP(fl_pop_clip())
+
+    for (auto& area : _areas) {
+        if (area.percent() >= priv::_CHART_MIN_AREA_SIZE) {
+            _FLW_CHART_CLIP(fl_push_clip(x(), y(), w(), h() - _scroll->h()))
+            _draw_ver_lines(area);
+            _draw_ylabels(area, FL_ALIGN_LEFT);
+            _draw_ylabels(area, FL_ALIGN_RIGHT);
+            _FLW_CHART_CLIP(fl_pop_clip())
+
+            _FLW_CHART_CLIP(fl_push_clip(x() + area.rect().x(), y() + area.rect().y() - 1, area.rect().w() + 1, area.rect().h() + 2))
+            _draw_lines(area);
+            _draw_line_labels(area);
+            fl_line_style(FL_SOLID, 1);
+            fl_rect(x() + area.rect().x(), y() + area.rect().y() - 1, area.rect().w() + 1, area.rect().h() + 2, labelcolor());
+            _FLW_CHART_CLIP(fl_pop_clip())
+        }
+    }
+}
+
 /** @brief Draw all chart lines for input area.
 *
 * @param[in] area  Area with lines.
@@ -2356,14 +5125,19 @@ void flw::chart::Chart::_draw_lines(Area& area) {
             fl_line_style(style, width);
             width2 = (width > 1) ? width / 2 : width2;
 
-            while (date_c <= DATE_END && date_c < static_cast<int>(_dates.size())) {
-                const size_t INDEX = Point::BinarySearch(line.data(), _dates[date_c]);
+            auto        walk  = priv::_ChartWalk(line, _dates, date_c, _lod_level);
+            const auto& HIGH  = walk.series().high();
+            const auto& LOW   = walk.series().low();
+            const auto& CLOSE = walk.series().close();
+            const int   COUNT = _tick_count();
+
+            while (date_c <= DATE_END && date_c < COUNT) {
+                const size_t INDEX = walk.find(date_c);
 
                 if (INDEX != static_cast<size_t>(-1)) {
-                    const auto&  DATA = line.data()[INDEX];
-                    const double YH   = (DATA.high - SCALE_MIN) * SCALE_PIXEL;
-                    const double YL   = (DATA.low - SCALE_MIN) * SCALE_PIXEL;
-                    const double YC   = (DATA.close - SCALE_MIN) * SCALE_PIXEL;
+                    const double YH   = (HIGH[INDEX] - SCALE_MIN) * SCALE_PIXEL;
+                    const double YL   = (LOW[INDEX] - SCALE_MIN) * SCALE_PIXEL;
+                    const double YC   = (CLOSE[INDEX] - SCALE_MIN) * SCALE_PIXEL;
                     const int    YH2  = static_cast<int>(B1 - YH);
                     const int    YL2  = static_cast<int>(B1 - YL);
                     const int    YC2  = static_cast<int>(B1 - YC);
@@ -2594,8 +5368,10 @@ void flw::chart::Chart::_draw_xlabels() {
     fl_font(flw::PREF_FIXED_FONT, CH2);
     cw2 = fl_width("X");
 
-    while (date_c <= DATE_END && date_c < static_cast<int>(_dates.size())) {
-        const auto date  = gnu::Date(_dates[date_c].date.c_str());
+    const int  COUNT    = _tick_count();
+
+    while (date_c <= DATE_END && date_c < COUNT) {
+        const auto date  = _dates.key(date_c << _lod_level).to_date();
         bool       addv  = false;
         int        month = 1;
 
@@ -2640,7 +5416,7 @@ void flw::chart::Chart::_draw_xlabels() {
                 last = date.day();
 
                 if (x1 >= x_last) {
-                    snprintf(buffer1, 100, "%04d-%02d-%02d", date.year(), date.month(), date.day());
+                    date.format_to(buffer1, 100, gnu::Date::Format::ISO_LONG);
                 }
                 else {
                     month = 3;
@@ -2871,11 +5647,11 @@ int flw::chart::Chart::handle(int event) {
     else if (event == FL_MOVE) { // Erase tooltip.
         if (_tooltip != "") {
             _tooltip = "";
-            redraw();
+            damage(FL_DAMAGE_USER1);
         }
     }
     else if (event == FL_MOUSEWHEEL) { // Change tick value.
-        const double size = _dates.size() - _ticks;
+        const double size = _tick_count() - _ticks;
         const double pos  = _scroll->value();
         const double dy   = (Fl::event_dy() * 10.0);
         const double dx   = (Fl::event_dx() * 10.0);
@@ -2888,10 +5664,22 @@ int flw::chart::Chart::handle(int event) {
         else if (Fl::event_ctrl() > 0) {
             const int width = (adj > 0.0) ? _tick_width + 1 : _tick_width - 1;
 
-            if (width >= chart::MIN_TICK && width <= chart::MAX_TICK) {
+            if (_lod == true && adj > 0.0 && _lod_level > 0) { // Zoom in to previous level of detail.
+                _lod_level--;
+                _date_start *= 2;
+                static_cast<Fl_Slider*>(_scroll)->value(_date_start);
+                init();
+            }
+            else if (width >= chart::MIN_TICK && width <= chart::MAX_TICK) {
                 set_tick_width(width);
                 init();
             }
+            else if (_lod == true && width < chart::MIN_TICK && _tick_count() > _ticks) { // Zoom out to next level of detail.
+                _lod_level++;
+                _date_start /= 2;
+                static_cast<Fl_Slider*>(_scroll)->value(_date_start);
+                init();
+            }
 
             return 1;
         }
@@ -2939,12 +5727,21 @@ void flw::chart::Chart::_init(bool calc_dates) {
     if (calc_dates == true) {
         WaitCursor wc;
 
-        _calc_dates();
+        if (_calc_dates() == true) {
+            _calc_index(true);
+        }
+
         _margin_left  = priv::_CHART_MIN_MARGIN;
         _margin_right = priv::_CHART_MIN_MARGIN;
         kludge++;
     }
 
+    _calc_index(false);
+
+    if (calc_dates == true && _lod == true) {
+        _lod_fit = true;
+    }
+
     while (kludge <= 1) { // To improve margins calculations.
         _calc_area_width();
         _calc_area_height();
@@ -2955,6 +5752,9 @@ void flw::chart::Chart::_init(bool calc_dates) {
         kludge--;
     }
 
+    _lod_fit = false;
+    _calc_lod();
+
     redraw();
 
 #ifdef DEBUG
@@ -2996,6 +5796,17 @@ flw::StringVector flw::chart::Chart::_label_array(const Area& area, LabelType la
     return res;
 }
 
+/** @brief Get last reference date index for a tick.
+*
+* @param[in] tick  Tick index.
+*
+* @return Index in _dates, it is clamped to last date.
+*/
+int flw::chart::Chart::_last_date(int tick) const {
+    const int64_t last = ((static_cast<int64_t>(tick) + 1) << _lod_level) - 1;
+    return static_cast<int>(std::min(last, static_cast<int64_t>(_dates.size()) - 1));
+}
+
 /** @brief Show file dialog and select a json file.
 *
 * @return False for no file or return value from flw::chart::Chart::load_json(std::string).
@@ -3055,6 +5866,7 @@ bool flw::chart::Chart::load_json(const std::string& filename) {
                 else if (j2->name() == "labels" && j2->is_bool() == true)       set_line_labels(j2->vb());
                 else if (j2->name() == "horizontal" && j2->is_bool() == true)   set_hor_lines(j2->vb());
                 else if (j2->name() == "vertical" && j2->is_bool() == true)     set_ver_lines(j2->vb());
+                else if (j2->name() == "lod" && j2->is_bool() == true)          set_lod(j2->vb());
                 else _FLW_CHART_ERROR(j2)
             }
         }
@@ -3085,7 +5897,7 @@ bool flw::chart::Chart::load_json(const std::string& filename) {
         }
         else if (j->name() == "flw::chart::lines" && j->is_array() == true) {
             for (const auto j2 : *j->va()) {
-                int             line[5]  = { 0, 0, 0, 0, 1 };
+                int             line[6]  = { 0, 0, 0, 0, 1, 0 };
                 std::string     label;
                 std::string     type;
                 PointVector vec;
@@ -3096,6 +5908,10 @@ bool flw::chart::Chart::load_json(const std::string& filename) {
                             line[1] = l->vn_i();
                             if (line[1] < 0 || line[1] > static_cast<int>(AreaNum::LAST)) _FLW_CHART_ERROR(l)
                         }
+                        else if (l->name() == "aggregate" && l->is_number() == true) {
+                            line[5] = l->vn_i();
+                            if (line[5] < 0 || line[5] > static_cast<int>(Aggregate::LAST)) _FLW_CHART_ERROR(l)
+                        }
                         else if (l->name() == "align" && l->is_number() == true)      line[0]  = l->vn_i();
                         else if (l->name() == "color" && l->is_number() == true)      line[2]  = l->vn_i();
                         else if (l->name() == "label" && l->is_string() == true)      label    = l->vs_u();
@@ -3117,6 +5933,7 @@ bool flw::chart::Chart::load_json(const std::string& filename) {
                 auto l = Line(vec, label);
                 auto a = static_cast<AreaNum>(line[1]);
                 l.set_align(line[0]).set_color(line[2]).set_label(label).set_width(line[3]).set_type_from_string(type).set_visible(line[4]);
+                l.set_aggregate(static_cast<Aggregate>(line[5]));
                 area(a).add_line(l);
             }
         }
@@ -3155,15 +5972,16 @@ bool flw::chart::Chart::load_line_from_csv() {
         return false;
     }
 
-    auto vec = Point::LoadCSV(filename);
+    auto series = Series::LoadCSV(filename);
 
-    if (vec.size() == 0) {
+    if (series.size() == 0) {
         dlg::msg_alert("Chart", "No data!");
         return false;
     }
 
-    auto line = Line(vec, filename);
+    auto line = Line();
 
+    line.set_data(std::move(series)).set_label(filename);
     line.set_color(FL_BLUE);
     priv::_ChartLineSetup(top_window(), line).run();
     _area->add_line(line);
@@ -3172,6 +5990,140 @@ bool flw::chart::Chart::load_line_from_csv() {
     return true;
 }
 
+/** @brief Show file dialog and select a snapshot file.
+*
+* @return False for no file or return value from flw::chart::Chart::load_snapshot(std::string).
+*/
+bool flw::chart::Chart::load_snapshot() {
+    auto filename = util::to_string(fl_file_chooser("Select Snapshot File", "All Files (*)\tSnapshot Files (*.flwc)", ""));
+
+    if (util::is_empty(filename) == true) {
+        return false;
+    }
+
+    return load_snapshot(filename);
+}
+
+/** @brief Load a complete chart from a binary snapshot file.
+*
+* File is memory mapped and data columns are copied directly into the line series without parsing.\n
+* If page_budget is set then the columns are not copied, instead the lines use the mapped file.\n
+* Only pages for the visible dates are then kept in memory and old pages are dropped when the budget is used up.\n
+* Mapped data points are not read when loading, each block is checked the first time it is used and illegal blocks are not drawn (see Series::check()).\n
+* Lines with mapped data keep no index for every data point, see Line::calc_index().\n
+* See save_snapshot() for file format.\n
+*
+* @param[in] filename     File saved with save_snapshot().
+* @param[in] page_budget  Max number of bytes for data in memory, 0 to load all data.
+*
+* @return True if ok.
+*/
+bool flw::chart::Chart::load_snapshot(const std::string& filename, size_t page_budget) {
+    #define _FLW_CHART_SNAPSHOT_ERROR() { dlg::msg_alert("Chart", util::format("Illegal chart snapshot %s", filename.c_str())); reset(); return false; }
+
+    _filename = "";
+
+    reset();
+    redraw();
+
+    auto wc    = WaitCursor();
+    auto pages = std::make_shared<SeriesPages>(filename, page_budget);
+
+    if (pages->file().is_open() == false) {
+        dlg::msg_alert("Chart", util::format("Failed to load %s", filename.c_str()));
+        return false;
+    }
+
+    auto reader = priv::_ChartSnapshotReader(pages->file().data(), pages->file().size());
+    auto magic  = reader.array<char>(sizeof(priv::_CHART_SNAPSHOT_MAGIC));
+
+    if (magic == nullptr || memcmp(magic, priv::_CHART_SNAPSHOT_MAGIC, sizeof(priv::_CHART_SNAPSHOT_MAGIC)) != 0) _FLW_CHART_SNAPSHOT_ERROR()
+
+    auto version = reader.get<uint32_t>();
+
+    if (reader.get<uint32_t>() != priv::_CHART_SNAPSHOT_ORDER) _FLW_CHART_SNAPSHOT_ERROR()
+    else if (version != chart::SNAPSHOT_VERSION) { dlg::msg_alert("Chart", util::format("Wrong chart version!\nI expected version %d but the snapshot file had version %u!", chart::SNAPSHOT_VERSION, version)); reset(); return false; }
+
+    auto tick_width = reader.get<int32_t>();
+    auto range      = reader.get<int32_t>();
+
+    if (range < 0 || range > static_cast<int>(DateRange::LAST)) _FLW_CHART_SNAPSHOT_ERROR()
+
+    set_tick_width(tick_width);
+    set_date_range(static_cast<DateRange>(range));
+    set_line_labels(reader.get<uint8_t>() != 0);
+    set_hor_lines(reader.get<uint8_t>() != 0);
+    set_ver_lines(reader.get<uint8_t>() != 0);
+    set_lod(reader.get<uint8_t>() != 0);
+    set_main_label(reader.str());
+
+    unsigned percent[5] = { 0 };
+
+    if (reader.get<uint32_t>() != _areas.size()) _FLW_CHART_SNAPSHOT_ERROR()
+
+    for (size_t f = 0; f < _areas.size(); f++) {
+        percent[f] = reader.get<uint32_t>();
+
+        auto has_min = reader.get<uint8_t>();
+        auto min     = reader.get<double>();
+        auto has_max = reader.get<uint8_t>();
+        auto max     = reader.get<double>();
+
+        if (has_min != 0) _areas[f].set_min_clamp(min);
+        if (has_max != 0) _areas[f].set_max_clamp(max);
+    }
+
+    if (reader.err() == true || set_area_size(percent[0], percent[1], percent[2], percent[3], percent[4]) == false) _FLW_CHART_SNAPSHOT_ERROR()
+
+    auto lines = reader.get<uint32_t>();
+
+    for (uint32_t f = 0; f < lines && reader.err() == false; f++) {
+        auto area    = reader.get<int32_t>();
+        auto align   = reader.get<int32_t>();
+        auto color   = reader.get<uint32_t>();
+        auto width   = reader.get<uint32_t>();
+        auto visible = reader.get<uint8_t>();
+        auto resamp  = reader.get<uint8_t>();
+        auto label   = reader.str();
+        auto type    = reader.str();
+        auto size    = reader.get<uint64_t>();
+        auto keys    = reader.array<int64_t>(size);
+        auto high    = reader.array<double>(size);
+        auto low     = reader.array<double>(size);
+        auto close   = reader.array<double>(size);
+        auto series  = Series();
+
+        if (reader.err() == true || area < 0 || area > static_cast<int>(AreaNum::LAST) || resamp > static_cast<int>(Aggregate::LAST)) _FLW_CHART_SNAPSHOT_ERROR()
+        else if (series.assign(keys, high, low, close, size, (page_budget > 0) ? pages : nullptr) == false) _FLW_CHART_SNAPSHOT_ERROR()
+
+        auto line = Line();
+        line.set_data(std::move(series)).set_align(align).set_color(color).set_label(label).set_width(width).set_type_from_string(type).set_visible(visible != 0);
+        line.set_aggregate(static_cast<Aggregate>(resamp));
+        this->area(static_cast<AreaNum>(area)).add_line(line);
+    }
+
+    auto blocks = reader.get<uint64_t>();
+    auto keys   = reader.array<int64_t>(blocks);
+    auto dates  = PointVector();
+
+    if (reader.err() == true) _FLW_CHART_SNAPSHOT_ERROR()
+
+    for (uint64_t f = 0; f < blocks; f++) {
+        auto date = priv::_chart_key_date(gnu::DateKey::FromSeconds(keys[f]));
+
+        if (date == "") _FLW_CHART_SNAPSHOT_ERROR()
+        dates.push_back(Point(date));
+    }
+
+    set_block_dates(dates);
+    init_new_data();
+    _filename = filename;
+
+    return true;
+
+    #undef _FLW_CHART_SNAPSHOT_ERROR
+}
+
 /** @brief Move line between two chart areas or delete line.
 *
 * @param[in] area          Current area.
@@ -3228,6 +6180,7 @@ void flw::chart::Chart::reset() {
 
     _block_dates.clear();
     _dates.clear();
+    _dates_block.clear();
 
     for (auto& area : _areas) {
         area.reset();
@@ -3255,6 +6208,7 @@ void flw::chart::Chart::reset() {
     set_hor_lines();
     set_main_label();
     set_line_labels();
+    set_lod(false);
     set_tick_width();
     set_ver_lines();
     init();
@@ -3313,6 +6267,7 @@ bool flw::chart::Chart::save_json(const std::string& filename, double max_diff_h
                 jsb << gnu::json::Builder::MakeBool(_labels, "labels");
                 jsb << gnu::json::Builder::MakeBool(_horizontal, "horizontal");
                 jsb << gnu::json::Builder::MakeBool(_vertical, "vertical");
+                jsb << gnu::json::Builder::MakeBool(_lod, "lod");
             jsb.end();
 
             jsb << gnu::json::Builder::MakeObject("flw::chart::areas");
@@ -3342,8 +6297,10 @@ bool flw::chart::Chart::save_json(const std::string& filename, double max_diff_h
                                 jsb << gnu::json::Builder::MakeNumber(line.color(), "color");
                                 jsb << gnu::json::Builder::MakeNumber(line.width(), "width");
                                 jsb << gnu::json::Builder::MakeBool(line.is_visible(), "visible");
+                                if (line.aggregate() != Aggregate::NONE) jsb << gnu::json::Builder::MakeNumber(static_cast<int>(line.aggregate()), "aggregate");
                                 jsb << gnu::json::Builder::MakeArray("yx");
-                                for (const auto& data : line.data()) {
+                                for (size_t f = 0; f < line.size(); f++) {
+                                    const auto data = line.series().point(f);
                                     jsb << gnu::json::Builder::MakeArrayInline();
                                         jsb << gnu::json::Builder::MakeString(data.date);
                                         if (fabs(data.close - data.low) > max_diff_high_low || fabs(data.close - data.high) > max_diff_high_low) {
@@ -3399,25 +6356,26 @@ bool flw::chart::Chart::save_line_to_csv() {
     const auto* line   = _area->selected_line();
     const auto  answer = dlg::msg_ask("Chart", "Select range.\nSave all data or only those in view?", "View", "All");
     auto        data   = PointVector();
-    const auto& ldata  = line->data();
+    const auto& ldata  = line->view();
 
     if (answer == "View") {
-        auto curr = _date_start;
-        auto stop = _date_start + _ticks;
+        auto curr = _date_start << _lod_level;
+        auto stop = _last_date(_date_start + _ticks);
+
+        auto walk = priv::_ChartWalk(*line, _dates, curr);
 
         while (curr <= stop && curr < static_cast<int>(_dates.size())) {
-            auto& date  = _dates[curr];
-            auto  index = Point::BinarySearch(ldata, date);
+            auto index = walk.find(curr);
 
             if (index != static_cast<size_t>(-1)) {
-                data.push_back(ldata[index]);
+                data.push_back(ldata.point(index));
             }
 
             curr++;
         }
     }
     else {
-        data = ldata;
+        data = line->points();
     }
 
     if (data.size() == 0) {
@@ -3437,6 +6395,132 @@ bool flw::chart::Chart::save_png() {
     return util::png_save(top_window(), "", x() + 1,  y() + 1,  w() - 2,  h() - _scroll->h() - 1);
 }
 
+/** @brief Ask for filename and save complete chart to a binary snapshot file.
+*
+* @return True if ok.
+*/
+bool flw::chart::Chart::save_snapshot() {
+    auto filename = util::to_string(fl_file_chooser("Save To Snapshot File", "All Files (*)\tSnapshot Files (*.flwc)", ""));
+
+    if (util::is_empty(filename) == true) {
+        return false;
+    }
+
+    return save_snapshot(filename);
+}
+
+/** @brief Save complete chart to a binary snapshot file.
+*
+* Same content as save_json() but values are stored in native little endian byte order.\n
+* Dates are 64 bit seconds and every line has four 8 byte aligned columns (dates, high, low and close).\n
+* Strings have a 32 bit length prefix.\n
+*
+* @code
+* "FLWCHART" u32 version, u32 byte order
+* i32 tick width, i32 date range, u8 labels, u8 horizontal, u8 vertical, u8 lod, str label
+* u32 area count, for every area: u32 percent, u8 has min, f64 min, u8 has max, f64 max
+* u32 line count, for every line: i32 area, i32 align, u32 color, u32 width, u8 visible, u8 aggregate, str label, str type,
+*                                 u64 size, i64 dates[size], f64 high[size], f64 low[size], f64 close[size]
+* u64 block date count, i64 block dates[count]
+* @endcode
+*
+* @param[in] filename  Destination filename.
+*
+* @return True if ok.
+*/
+bool flw::chart::Chart::save_snapshot(const std::string& filename) {
+    auto     wc    = WaitCursor();
+    auto     buf   = std::string();
+    size_t   size  = 256;
+    uint32_t lines = 0;
+
+    for (const auto& area : _areas) {
+        for (const auto& line : area.lines()) {
+            if (line.size() > 0) {
+                size += line.size() * 32 + line.label().length() + 64;
+                lines++;
+            }
+        }
+    }
+
+    buf.reserve(size + _block_dates.size() * 8);
+
+    priv::_chart_snapshot_put(buf, priv::_CHART_SNAPSHOT_MAGIC, sizeof(priv::_CHART_SNAPSHOT_MAGIC));
+    priv::_chart_snapshot_put(buf, static_cast<uint32_t>(chart::SNAPSHOT_VERSION));
+    priv::_chart_snapshot_put(buf, priv::_CHART_SNAPSHOT_ORDER);
+    priv::_chart_snapshot_put(buf, static_cast<int32_t>(_tick_width));
+    priv::_chart_snapshot_put(buf, static_cast<int32_t>(_date_range));
+    priv::_chart_snapshot_put(buf, static_cast<uint8_t>(_labels));
+    priv::_chart_snapshot_put(buf, static_cast<uint8_t>(_horizontal));
+    priv::_chart_snapshot_put(buf, static_cast<uint8_t>(_vertical));
+    priv::_chart_snapshot_put(buf, static_cast<uint8_t>(_lod));
+    priv::_chart_snapshot_put(buf, _label);
+    priv::_chart_snapshot_put(buf, static_cast<uint32_t>(_areas.size()));
+
+    for (const auto& area : _areas) {
+        auto min = area.clamp_min();
+        auto max = area.clamp_max();
+
+        priv::_chart_snapshot_put(buf, static_cast<uint32_t>(area.percent()));
+        priv::_chart_snapshot_put(buf, static_cast<uint8_t>(min.has_value()));
+        priv::_chart_snapshot_put(buf, min.value_or(0.0));
+        priv::_chart_snapshot_put(buf, static_cast<uint8_t>(max.has_value()));
+        priv::_chart_snapshot_put(buf, max.value_or(0.0));
+    }
+
+    priv::_chart_snapshot_put(buf, lines);
+
+    for (const auto& area : _areas) {
+        for (const auto& line : area.lines()) {
+            if (line.size() == 0) {
+                continue;
+            }
+
+            const auto& series = line.series();
+
+            priv::_chart_snapshot_put(buf, static_cast<int32_t>(area.area()));
+            priv::_chart_snapshot_put(buf, static_cast<int32_t>(line.align()));
+            priv::_chart_snapshot_put(buf, static_cast<uint32_t>(line.color()));
+            priv::_chart_snapshot_put(buf, static_cast<uint32_t>(line.width()));
+            priv::_chart_snapshot_put(buf, static_cast<uint8_t>(line.is_visible()));
+            priv::_chart_snapshot_put(buf, static_cast<uint8_t>(line.aggregate()));
+            priv::_chart_snapshot_put(buf, line.label());
+            priv::_chart_snapshot_put(buf, line.type_to_string());
+            priv::_chart_snapshot_put(buf, static_cast<uint64_t>(series.size()));
+            priv::_chart_snapshot_align(buf);
+            priv::_chart_snapshot_put(buf, series.keys().data(), series.size() * sizeof(int64_t));
+            priv::_chart_snapshot_put(buf, series.high().data(), series.size() * sizeof(double));
+            priv::_chart_snapshot_put(buf, series.low().data(), series.size() * sizeof(double));
+            priv::_chart_snapshot_put(buf, series.close().data(), series.size() * sizeof(double));
+        }
+    }
+
+    std::vector<int64_t> blocks;
+
+    for (const auto& block : _block_dates) { // Invalid block dates are ignored by DateGenerator so they are not stored.
+        auto key = priv::_CHART_DATE_PARSER.parse(block.date);
+
+        if (key.is_invalid() == false) {
+            blocks.push_back(key.seconds());
+        }
+    }
+
+    priv::_chart_snapshot_put(buf, static_cast<uint64_t>(blocks.size()));
+    priv::_chart_snapshot_align(buf);
+
+    for (auto key : blocks) {
+        priv::_chart_snapshot_put(buf, key);
+    }
+
+    auto res = gnu::file::write(filename, buf.c_str(), buf.length());
+
+    if (res == true) {
+        _filename = filename;
+    }
+
+    return res;
+}
+
 /** @brief Set size for all chart areas
 *
 * Total area size must be 100.\n
@@ -3493,6 +6577,23 @@ bool flw::chart::Chart::set_area_size(unsigned area1, unsigned area2, unsigned a
     return false;
 }
 
+/** @brief Turn on/off level of detail mode.
+*
+* When turned on, dates are aggregated into buckets when zooming out past MIN_TICK.\n
+* At next init the level of detail is selected so all dates fit in the view.\n
+* Call init() after this.\n
+*
+* @param[in] val  True to turn on.
+*/
+void flw::chart::Chart::set_lod(bool val) {
+    static_cast<Fl_Valuator*>(_scroll)->value(0);
+
+    _date_start = 0;
+    _lod        = val;
+    _lod_fit    = val;
+    _lod_level  = 0;
+}
+
 /** @brief Show and dialog and select an area layout.
 *
 */
@@ -3792,13 +6893,22 @@ void flw::chart::Chart::setup_show_or_hide_lines() {
 * Show/hide labels.
 * Show/hide vertical lines.
 * Show/hide horizontal lines.
+* Turn on/off level of detail mode.
 */
 void flw::chart::Chart::setup_view_options() {
+    const bool lod = menu::item_value(_menu, priv::_CHART_LABEL_SHOW_LOD);
+
     _labels     = menu::item_value(_menu, priv::_CHART_LABEL_SHOW_LABELS);
     _vertical   = menu::item_value(_menu, priv::_CHART_LABEL_SHOW_VLINES);
     _horizontal = menu::item_value(_menu, priv::_CHART_LABEL_SHOW_HLINES);
 
-    redraw();
+    if (lod != _lod) {
+        set_lod(lod);
+        init();
+    }
+    else {
+        redraw();
+    }
 }
 
 /** @brief Show menu
@@ -3824,6 +6934,7 @@ void flw::chart::Chart::_show_menu() {
 
     menu::set_item(_menu, priv::_CHART_LABEL_SHOW_HLINES, _horizontal);
     menu::set_item(_menu, priv::_CHART_LABEL_SHOW_LABELS, _labels);
+    menu::set_item(_menu, priv::_CHART_LABEL_SHOW_LOD, _lod);
     menu::set_item(_menu, priv::_CHART_LABEL_SHOW_VLINES, _vertical);
 
     if (_area != nullptr) {
@@ -3850,6 +6961,15 @@ void flw::chart::Chart::_show_menu() {
     _menu->popup();
 }
 
+/** @brief Get number of ticks for all reference dates.
+*
+* @return Number of dates for level of detail 0 or number of buckets.
+*/
+int flw::chart::Chart::_tick_count() const {
+    const int64_t size = static_cast<int64_t>(_dates.size());
+    return static_cast<int>((size + (static_cast<int64_t>(1) << _lod_level) - 1) >> _lod_level);
+}
+
 /** @brief Update font properties
 *
 */
@@ -18,8 +18,12 @@ class Fl_Menu_Button;
 class Fl_Scrollbar;
 
 #include <cmath>
+#include <deque>
+#include <map>
+#include <memory>
 #include <FL/Fl_Group.H>
 #include <FL/Fl_Rect.H>
+#include <FL/platform_types.h>
 #include <optional>
 
 namespace flw {
@@ -32,17 +36,31 @@ namespace chart {
 class  Area;
 struct Point;
 class  Line;
+class  Series;
+class  SeriesPages;
 
 typedef std::vector<Point> PointVector;     ///< @brief A vector with data points.
 typedef std::vector<Line>  LineVector;      ///< @brief A vector with chart lines.
 typedef std::vector<Area>  AreaVector;      ///< @brief A vector with chart areas.
 
-static constexpr const double MAX_VALUE      = 9223372036854775807.0;   ///< @brief Max number value.
-static constexpr const double MIN_VALUE      = 0.0000001;               ///< @brief Min (abs) number value.
-static constexpr const int    MAX_LINE_WIDTH = 14;                      ///< @brief Max line width (pixels).
-static constexpr const int    VERSION        = 6;                       ///< @brief JSON version.
-static constexpr const int    MIN_TICK       = 3;                       ///< @brief Min tick size.
-static constexpr const int    MAX_TICK       = MAX_LINE_WIDTH * 5;      ///< @brief Max tick size.
+static constexpr const double MAX_VALUE        = 9223372036854775807.0;     ///< @brief Max number value.
+static constexpr const double MIN_VALUE        = 0.0000001;                 ///< @brief Min (abs) number value.
+static constexpr const int    MAX_LINE_WIDTH   = 14;                        ///< @brief Max line width (pixels).
+static constexpr const int    VERSION          = 6;                         ///< @brief JSON version.
+static constexpr const int    SNAPSHOT_VERSION = 2;                         ///< @brief Binary snapshot version.
+static constexpr const int    MIN_TICK         = 3;                         ///< @brief Min tick size.
+static constexpr const int    MAX_TICK         = MAX_LINE_WIDTH * 5;        ///< @brief Max tick size.
+static constexpr const size_t SERIES_BLOCK     = 4096;                      ///< @brief Number of mapped data points that are checked and summarized together.
+
+/** @brief How a line is resampled to the chart date range before it is drawn.
+*
+*/
+enum class Aggregate {
+    NONE,                   ///< @brief Draw data points as they are.
+    OHLC,                   ///< @brief Highest high, lowest low and last close value in every bucket.
+    SUM,                    ///< @brief Sum of values in every bucket, for example volume.
+    LAST = SUM,             ///< @brief Same as SUM.
+};
 
 /** @brief Algorithms that can be used to generate new data series.
 *
@@ -149,25 +167,256 @@ struct Point {
     bool                        operator!=(const Point& other) const { return date != other.date; } ///< @brief Compare date.
 
     static PointVector          ATR(const PointVector& in, size_t days);
+    static Series               ATR(const Series& in, size_t days);
     static size_t               BinarySearch(const PointVector& in, const Point& key);
     static PointVector          DateSerie(const std::string& start_date, const std::string& stop_date, DateRange range, const PointVector& block = PointVector());
     static PointVector          DayToMonth(const PointVector& in, bool sum = false);
     static PointVector          DayToWeek(const PointVector& in, gnu::Date::Day weekday, bool sum = false);
     static void                 Debug(const PointVector& in);
     static PointVector          ExponentialMovingAverage(const PointVector& in, size_t days);
+    static Series               ExponentialMovingAverage(const Series& in, size_t days);
     static PointVector          Fixed(const PointVector& in, double value);
+    static Series               Fixed(const Series& in, double value);
     static PointVector          LoadCSV(const std::string& filename, const std::string& sep = ",");
     static PointVector          Modify(const PointVector& in, Modifier modify, double value);
+    static Series               Modify(const Series& in, Modifier modify, double value);
     static PointVector          Momentum(const PointVector& in, size_t days);
+    static Series               Momentum(const Series& in, size_t days);
     static PointVector          MovingAverage(const PointVector& in, size_t days);
+    static Series               MovingAverage(const Series& in, size_t days);
     static std::string          RangeToString(DateRange range);
     static PointVector          RSI(const PointVector& in, size_t days);
+    static Series               RSI(const Series& in, size_t days);
     static bool                 SaveCSV(const PointVector& in, const std::string& filename, const std::string& sep = ",");
     static PointVector          StdDev(const PointVector& in, size_t days);
+    static Series               StdDev(const Series& in, size_t days);
     static PointVector          Stochastics(const PointVector& in, size_t days);
+    static Series               Stochastics(const Series& in, size_t days);
     static DateRange            StringToRange(const std::string& range);
 };
 
+/*
+ *       _____           _
+ *      / ____|         (_)
+ *     | (___   ___ _ __ _  ___  ___
+ *      \___ \ / _ \ '__| |/ _ \/ __|
+ *      ____) |  __/ |  | |  __/\__ \
+ *     |_____/ \___|_|  |_|\___||___/
+ *
+ *
+ */
+
+/** @brief One value column in a Series.
+*
+* Values are either owned by the column or read from a memory mapped file.\n
+* A mapped column is copied into memory the first time it is changed.\n
+* Values removed from the start are only skipped until they are more than half of the memory, so pop_front() is amortized O(1).\n
+* Read only interface is the same as for a const std::vector.\n
+*/
+template<typename T>
+class SeriesColumn {
+public:
+                                SeriesColumn()
+                                    { _map = nullptr; _map_size = 0; _start = 0; } ///< @brief Create empty column.
+    explicit                    SeriesColumn(std::vector<T>&& values)
+                                    { _vec = std::move(values); _map = nullptr; _map_size = 0; _start = 0; } ///< @brief Create column that owns values.
+    const T&                    back() const
+                                    { return data()[size() - 1]; } ///< @brief Get last value.
+    const T*                    begin() const
+                                    { return data(); } ///< @brief Get pointer to first value.
+    void                        clear()
+                                    { _vec.clear(); _map = nullptr; _map_size = 0; _start = 0; } ///< @brief Remove all values.
+    const T*                    data() const
+                                    { return (_map != nullptr) ? _map : _vec.data() + _start; } ///< @brief Get all values.
+    bool                        empty() const
+                                    { return size() == 0; } ///< @brief Is column empty?
+    const T*                    end() const
+                                    { return data() + size(); } ///< @brief Get pointer after last value.
+    const T&                    front() const
+                                    { return data()[0]; } ///< @brief Get first value.
+    bool                        is_mapped() const
+                                    { return _map != nullptr; } ///< @brief Are values read from a mapped file?
+    void                        map(const T* values, size_t size)
+                                    { _vec = std::vector<T>(); _map = values; _map_size = size; _start = 0; } ///< @brief Use values in mapped memory, values must be valid as long as the column is used.
+    void                        pop_back(size_t count)
+                                    { _own(); _vec.resize(_vec.size() - std::min(count, size())); } ///< @brief Remove values from the end.
+    void                        pop_front(size_t count)
+                                    { _own(); _start += std::min(count, size()); if (_start > _vec.size() / 2) vec(); } ///< @brief Remove values from the start, memory is released when more than half is unused.
+    void                        push_back(const T& value)
+                                    { _own(); _vec.push_back(value); } ///< @brief Add value.
+    void                        set(size_t index, const T& value)
+                                    { _own(); _vec[_start + index] = value; } ///< @brief Change value. @param[in] index  Valid index. @param[in] value  New value.
+    size_t                      size() const
+                                    { return (_map != nullptr) ? _map_size : _vec.size() - _start; } ///< @brief Get number of values.
+    std::vector<T>&             vec()
+                                    { _own(); if (_start > 0) { _vec.erase(_vec.begin(), _vec.begin() + _start); _start = 0; } return _vec; } ///< @brief Get values for changing, mapped values are copied first.
+    const T&                    operator[](size_t index) const
+                                    { return data()[index]; } ///< @brief Get value. @param[in] index  Valid index.
+
+private:
+    void                        _own()
+                                    { if (_map != nullptr) { _vec.assign(_map, _map + _map_size); _map = nullptr; _map_size = 0; _start = 0; } } ///< @brief Copy mapped values into memory.
+
+    std::vector<T>              _vec;       ///< @brief Owned values.
+    const T*                    _map;       ///< @brief Mapped values or NULL.
+    size_t                      _map_size;  ///< @brief Number of mapped values.
+    size_t                      _start;     ///< @brief Number of removed values at the start of _vec.
+};
+
+/** @brief Columnar data serie.
+*
+* Same data as a PointVector but stored as one array for each value and dates as gnu::DateKey.\n
+* It uses 32 bytes for every data point instead of 56 for a Point and algorithms only touch the arrays they need.\n
+* PointVector is used for import and export.\n
+* Columns can also be read directly from a memory mapped snapshot file, see Chart::load_snapshot().\n
+* Mapped data points are checked in blocks of chart::SERIES_BLOCK points the first time they are used, see check().\n
+*/
+class Series {
+public:
+    explicit                    Series()
+                                    { } ///< @brief Create empty serie.
+    explicit                    Series(const PointVector& in);
+    bool                        assign(const int64_t* keys, const double* high, const double* low, const double* close, size_t size, std::shared_ptr<SeriesPages> pages = nullptr);
+    static Series               LoadCSV(const std::string& filename, const std::string& sep = ",");
+    static Series               Resample(const Series& in, DateRange range, unsigned count = 1, bool sum = false);
+    bool                        check(size_t first, size_t last) const;
+    void                        clear();
+    const SeriesColumn<double>& close() const
+                                    { return _close; } ///< @brief Get close values.
+    std::string                 date(size_t index) const;
+    size_t                      find(const gnu::DateKey& key) const;
+    gnu::DateKey                first_key() const;
+    const SeriesColumn<double>& high() const
+                                    { return _high; } ///< @brief Get high values.
+    bool                        is_mapped() const
+                                    { return _pages != nullptr; } ///< @brief Are values read from a mapped file?
+    gnu::DateKey                key(size_t index) const
+                                    { return _key[index]; } ///< @brief Get date key. @param[in] index  Valid index. @return Date key.
+    const SeriesColumn<gnu::DateKey>& keys() const
+                                    { return _key; } ///< @brief Get all date keys.
+    gnu::DateKey                last_key() const;
+    const SeriesColumn<double>& low() const
+                                    { return _low; } ///< @brief Get low values.
+    Point                       point(size_t index) const;
+    PointVector                 points() const;
+    void                        pop_back(size_t count);
+    void                        pop_front(size_t count);
+    void                        prefetch(size_t first, size_t last) const;
+    void                        push_back(const gnu::DateKey& key, double value)
+                                    { push_back(key, value, value, value); } ///< @brief Add data point with same high, low and close value. @param[in] key  Date key. @param[in] value  Y value.
+    void                        push_back(const gnu::DateKey& key, double high, double low, double close);
+    void                        reserve(size_t size);
+    bool                        set(size_t index, double high, double low, double close);
+    size_t                      size() const
+                                    { return _key.size(); } ///< @brief Get number of data points.
+
+private:
+    void                        _own();
+
+    SeriesColumn<gnu::DateKey>  _key;       ///< @brief Dates.
+    SeriesColumn<double>        _high;      ///< @brief High values.
+    SeriesColumn<double>        _low;       ///< @brief Low values.
+    SeriesColumn<double>        _close;     ///< @brief Close values.
+    std::shared_ptr<SeriesPages> _pages;    ///< @brief Mapped file for mapped columns.
+    mutable std::vector<uint8_t> _checked;  ///< @brief State for every block of mapped data points (0 = not checked, 1 = ok, 2 = illegal).
+};
+
+/*
+ *      _____           _ _           _
+ *     |_   _|         | (_)         | |
+ *       | |  _ __   __| |_  ___ __ _| |_ ___  _ __
+ *       | | | '_ \ / _` | |/ __/ _` | __/ _ \| '__|
+ *      _| |_| | | | (_| | | (_| (_| | || (_) | |
+ *     |_____|_| |_|\__,_|_|\___\__,_|\__\___/|_|
+ *
+ *
+ */
+
+/** @brief Streaming version of the Point algorithms.
+*
+* Source data points are added one at a time and every new result is appended to an output serie.\n
+* Each point costs O(1) (amortized for STOCHASTICS).\n
+* Result is the same as for the Point algorithms as soon as there are more source points than days.\n
+* DAY_TO_WEEK and DAY_TO_MONTH are not supported (is_valid() returns false).\n
+*/
+class Indicator {
+public:
+    explicit                    Indicator(Algorithm formula = Algorithm::FIXED, size_t days = 14, double value = 0.0, Modifier modify = Modifier::ADDITION);
+    bool                        add(const gnu::DateKey& key, double high, double low, double close, Series& out);
+    size_t                      count() const
+                                    { return _count; } ///< @brief Number of source points that has been added.
+    size_t                      days() const
+                                    { return _days; } ///< @brief Get number of days.
+    Algorithm                   formula() const
+                                    { return _formula; } ///< @brief Get algorithm.
+    bool                        is_valid() const;
+    void                        reset();
+    Series                      run(const Series& in);
+
+private:
+    Algorithm                   _formula;   ///< @brief Algorithm.
+    Modifier                    _modify;    ///< @brief Modifier for MODIFY.
+    double                      _value;     ///< @brief Value for FIXED and MODIFY.
+    size_t                      _days;      ///< @brief Number of days.
+    size_t                      _count;     ///< @brief Number of added source points.
+    double                      _sum;       ///< @brief Running sum.
+    double                      _prev;      ///< @brief Previous result.
+    double                      _prev_close; ///< @brief Previous close value.
+    double                      _gain;      ///< @brief Average gain for RSI.
+    double                      _loss;      ///< @brief Average loss for RSI.
+    double                      _m2;        ///< @brief Sum of squared differences from mean for STD_DEV.
+    std::deque<double>          _win_close; ///< @brief Close values in current window.
+    std::deque<std::pair<size_t, double>> _win_high; ///< @brief Monotonic window with high values for STOCHASTICS.
+    std::deque<std::pair<size_t, double>> _win_low;  ///< @brief Monotonic window with low values for STOCHASTICS.
+};
+
+/*
+ *      _____        _        _____                           _
+ *     |  __ \      | |      / ____|                         | |
+ *     | |  | | __ _| |_ ___| |  __  ___ _ __   ___ _ __ __ _| |_ ___  _ __
+ *     | |  | |/ _` | __/ _ \ | |_ |/ _ \ '_ \ / _ \ '__/ _` | __/ _ \| '__|
+ *     | |__| | (_| | ||  __/ |__| |  __/ | | |  __/ | | (_| | || (_) | |
+ *     |_____/ \__,_|\__\___|\_____|\___|_| |_|\___|_|  \__,_|\__\___/|_|
+ *
+ *
+ */
+
+/** @brief Lazy reference date serie.
+*
+* Same dates as Point::DateSerie() but no dates are stored, only a sorted list of blocked dates.\n
+* Index to date and date to index are calculated arithmetically so even a SEC range over years is cheap.\n
+*/
+class DateGenerator {
+public:
+    explicit                    DateGenerator();
+    explicit                    DateGenerator(const std::string& start_date, const std::string& stop_date, DateRange range, const PointVector& block = PointVector());
+    void                        clear();
+    std::string                 date(size_t index) const;
+    bool                        extend(const gnu::DateKey& last, const PointVector& block = PointVector());
+    size_t                      index(const gnu::DateKey& key) const;
+    size_t                      index(const std::string& date) const;
+    gnu::DateKey                key(size_t index) const;
+    Point                       point(size_t index) const
+                                    { return Point(date(index)); } ///< @brief Get point with date only. @param[in] index  Valid index. @return Point object.
+    PointVector                 points() const;
+    DateRange                   range() const
+                                    { return _range; } ///< @brief Get date range.
+    size_t                      size() const
+                                    { return _size; } ///< @brief Number of dates.
+
+private:
+    int64_t                     _raw_index(const gnu::DateKey& key) const;
+    gnu::DateKey                _raw_key(int64_t raw) const;
+
+    DateRange                   _range;     ///< @brief Date range.
+    int64_t                     _first;     ///< @brief First date in seconds, weekday count for WEEKDAY or month count for MONTH.
+    int64_t                     _raw_size;  ///< @brief Number of dates including blocked dates.
+    int64_t                     _time;      ///< @brief Time of day in seconds for WEEKDAY and MONTH, step in seconds for all other.
+    size_t                      _size;      ///< @brief Number of dates.
+    std::vector<int64_t>        _block;     ///< @brief Sorted raw indexes for blocked dates.
+    std::vector<int64_t>        _shift;     ///< @brief _block[n] - n, used to map index to raw index.
+};
+
 /*
  *      _      _
  *     | |    (_)
@@ -186,55 +435,118 @@ public:
     explicit                    Line()
                                     { reset(); } ///< @brief Create empty chart line.
     explicit                    Line(const PointVector& data, const std::string& label = "", LineType type = LineType::LINE);
+    Aggregate                   aggregate() const
+                                    { return _aggregate; } ///< @brief Get how line is resampled to the chart date range.
     Fl_Align                    align() const
                                     { return _align; } ///< @brief Return what side its y scale is on.
     Fl_Color                    color() const
                                     { return _color; } ///< @brief Get line color.
-    const PointVector&          data() const
-                                    { return _data; } ///< @brief Get chart data.
+    [[deprecated("use points() for a copy or series() to read data without copying")]]
+    PointVector                 data() const
+                                    { return _series.points(); } ///< @brief Deprecated, use points() or series(). @return Copy of chart data as Point objects, O(n).
+    bool                        append(const gnu::DateKey& key, double high, double low, double close);
+    void                        calc_index(const DateGenerator& dates, bool all = false);
+    void                        calc_lod(int level);
     void                        debug(size_t num) const;
+    bool                        has_indicator() const
+                                    { return _indicator.has_value(); } ///< @brief Is line calculated from another line?
+    unsigned                    id() const
+                                    { return _id; } ///< @brief Unique line id, copies of a line have the same id.
+    const SeriesColumn<int64_t>& index() const
+                                    { return _index; } ///< @brief Get reference date index for every data point in view() (-1 if date is not in the reference dates), set by Chart, always empty for mapped data.
     bool                        is_visible() const
                                     { return _visible; } ///< @brief Is line visible?
     std::string                 label() const
                                     { return _label; } ///< @brief Get line label.
+    bool                        minmax(const gnu::DateKey& first, const gnu::DateKey& last, double& min, double& max) const;
+    void                        prefetch(const gnu::DateKey& first, const gnu::DateKey& last) const;
     const Fl_Rect&              label_rect() const
                                     { return _rect; } ///< @brief Get line label rectangle.
+    const SeriesColumn<int64_t>& lod_index(int level) const;
+    const Series&               lod_series(int level) const;
+    size_t                      max_size() const
+                                    { return _max_size; } ///< @brief Max number of data points that are kept by append() and update(), 0 for no limit.
+    PointVector                 points() const
+                                    { return _series.points(); } ///< @brief Get a new vector with chart data as Point objects, costs O(n), use series() to read data without copying.
+    bool                        resample(DateRange range);
     void                        reset();
+    Line&                       set_aggregate(Aggregate val);
     Line&                       set_align(Fl_Align val)
                                     { if (val == FL_ALIGN_LEFT || val == FL_ALIGN_RIGHT) _align = val; return *this; } ///< @brief Set scale side (only FL_ALIGN_LEFT or FL_ALIGN_RIGHT).
     Line&                       set_color(Fl_Color val)
                                     { _color = val; return *this; } ///< @brief Set line color.
     Line&                       set_data(const PointVector& val)
-                                    { _data = val; return *this; } ///< @brief Set chart data.
+                                    { _series = Series(val); _clear_index(); _resampled.clear(); _indicator.reset(); _source = 0; return *this; } ///< @brief Set chart data, removes indicator.
+    Line&                       set_data(Series&& val)
+                                    { _series = std::move(val); _clear_index(); _resampled.clear(); _indicator.reset(); _source = 0; return *this; } ///< @brief Set chart data, removes indicator.
+    bool                        set_indicator(const Indicator& indicator, const Line& source);
+    Line&                       set_index(std::vector<int64_t>&& val)
+                                    { _index = SeriesColumn<int64_t>(std::move(val)); _lod_index.clear(); _lod_series.clear(); _calc_range(true); return *this; } ///< @brief Set reference date index for every data point.
     Line&                       set_label(const std::string& val)
                                     { _label = val; return *this; } ///< @brief Set line label.
     Line&                       set_label_rect(int x, int y, int w, int h)
                                     { _rect = Fl_Rect(x, y, w, h); return *this; } ///< @brief Set line label rectangle.
+    Line&                       set_max_size(size_t val = 0)
+                                    { _max_size = val; _trim(); return *this; } ///< @brief Set max number of data points, oldest points are removed when new are added (0 for no limit).
     Line&                       set_type(LineType val)
-                                    { _type = val; return *this; }
+                                    { _type = val; _calc_range(false); return *this; } ///< @brief Set line type.
     Line&                       set_type_from_string(const std::string& val);
     Line&                       set_visible(bool val)
                                     { _visible = val; return *this; } ///< @brief Set visibilty.
     Line&                       set_width(unsigned val = 1)
                                     { if (val > 0 && val <= chart::MAX_LINE_WIDTH) _width = val; return *this; } ///< @brief Set line size.
+    const Series&               series() const
+                                    { return _series; } ///< @brief Get chart data.
     size_t                      size() const
-                                    { return _data.size(); } ///< @brief Get number of data points.
+                                    { return _series.size(); } ///< @brief Get number of data points.
+    unsigned                    source() const
+                                    { return _source; } ///< @brief Id of source line for an indicator line or 0.
     LineType                    type() const
                                     { return _type; } ///< @brief Get line type.
     bool                        type_has_high_and_low() const
                                     { return _type == LineType::BAR || _type == LineType::BAR_CLAMP || _type == LineType::BAR_HLC; } ///< @brief Check if line type are using high and low values.
     std::string                 type_to_string() const;
+    bool                        update(const Line& source);
+    const Series&               view() const;
     unsigned                    width() const
                                     { return _width; } ///< @brief Get line width.
 
 private:
-    PointVector                 _data;      ///< @brief Vector with data points.
+    void                        _added(size_t first);
+    void                        _block_range(size_t block) const;
+    void                        _calc_range(bool force);
+    void                        _clear_index();
+    bool                        _has_index() const;
+    void                        _lod_added(size_t first);
+    void                        _lod_trim(int64_t tick);
+    void                        _trim();
+    void                        _update_range(size_t first);
+
+    Series                      _series;    ///< @brief Data points.
     Fl_Align                    _align;     ///< @brief Side of scale, left or right.
     Fl_Color                    _color;     ///< @brief Line color.
     Fl_Rect                     _rect;      ///< @brief Label rectangle.
     LineType                    _type;      ///< @brief What line type to draw.
     bool                        _visible;   ///< @brief Visible or not.
     std::string                 _label;     ///< @brief Line label.
+    SeriesColumn<int64_t>       _index;     ///< @brief Reference date index for every data point, shorter than view() until Chart has added new points.
+    std::vector<double>         _range_max; ///< @brief Segment tree with max values for points in reference dates, leaves start at _range_max.size() / 2.
+    std::vector<double>         _range_min; ///< @brief Segment tree with min values for points in reference dates, leaves start at _range_min.size() / 2.
+    size_t                      _range_first; ///< @brief Leaf offset for first data point, leaves before it belongs to removed data points.
+    bool                        _range_hl;  ///< @brief True if segment trees are using high and low values.
+    DateGenerator               _mapped_dates; ///< @brief Reference dates for mapped data, used when block ranges are calculated.
+    mutable std::vector<double> _block_max; ///< @brief Max value for every block of mapped data points in reference dates (NAN if not calculated yet).
+    mutable std::vector<double> _block_min; ///< @brief Min value for every block of mapped data points in reference dates (NAN if not calculated yet).
+    std::vector<SeriesColumn<int64_t>> _lod_index; ///< @brief Bucket index for every level of detail (level 1 is in _lod_index[0]).
+    std::vector<Series>         _lod_series;       ///< @brief Aggregated data for every level of detail.
+    std::map<DateRange, Series> _resampled; ///< @brief Data resampled to date range buckets, empty if it is the same as the line data.
+    std::optional<DateRange>    _resample;  ///< @brief Date range for view().
+    Aggregate                   _aggregate; ///< @brief How data is resampled for view().
+    std::optional<Indicator>    _indicator; ///< @brief Algorithm for lines that are calculated from another line.
+    gnu::DateKey                _source_key; ///< @brief Date of last source data point that has been added to the indicator.
+    size_t                      _max_size;  ///< @brief Max number of data points or 0.
+    unsigned                    _id;        ///< @brief Unique line id.
+    unsigned                    _source;    ///< @brief Source line id or 0.
     unsigned                    _width;     ///< @brief Line size.
 };
 
@@ -304,6 +616,7 @@ public:
     explicit                    Area(AreaNum area)
                                     { _area = area; reset(); } ///< @brief Create chart area. @param[in] area  Area index.
     bool                        add_line(const Line& chart_line);
+    bool                        append(size_t index, const gnu::DateKey& key, double high, double low, double close);
     AreaNum                     area() const
                                     { return _area; } ///< @brief Get area index.
     std::optional<double>       clamp_max() const;
@@ -378,8 +691,10 @@ class Chart : public Fl_Group {
 
 public:
     explicit                    Chart(int X = 0, int Y = 0, int W = 0, int H = 0, const char* l = nullptr);
+                                ~Chart();
     double                      alt_size() const
                                     { return _alt_size; } ///< @brief Get tweaked x label font size (for days and time).
+    bool                        append(AreaNum area, size_t line, const Point& point);
     Area&                       area(AreaNum area)
                                     { return _areas[static_cast<size_t>(area)]; } ///< @brief Get chart area object.
     bool                        create_line(Algorithm formula, bool support = false);
@@ -403,9 +718,15 @@ public:
                                     { _init(true); } ///< @brief Initiate chart and create new date serie.
     bool                        line_labels() const
                                     { return _labels; } ///< @brief Are labels shown?.
+    bool                        lod() const
+                                    { return _lod; } ///< @brief Is level of detail mode on?
+    int                         lod_level() const
+                                    { return _lod_level; } ///< @brief Current level of detail, every tick is 2^level dates.
     bool                        load_json();
     bool                        load_json(const std::string& filename);
     bool                        load_line_from_csv();
+    bool                        load_snapshot();
+    bool                        load_snapshot(const std::string& filename, size_t page_budget = 0);
     std::string                 main_label() const
                                     { return _label; } ///< @brief Get main label.
     void                        print_to_postscript();
@@ -415,6 +736,8 @@ public:
     bool                        save_json(const std::string& filename, double max_diff_high_low = 0.001);
     bool                        save_line_to_csv();
     bool                        save_png();
+    bool                        save_snapshot();
+    bool                        save_snapshot(const std::string& filename);
     void                        set_alt_size(double val = 0.8)
                                     { if (val >= 0.6 && val <= 1.2) _alt_size = val; } ///< @brief Tweak fontsize for x labels  (for days and time). @param[in] val  Valid number is 0.6 to 1.2 (default 0.8).
     bool                        set_area_size(unsigned area1 = 100, unsigned area2 = 0, unsigned area3 = 0, unsigned area4 = 0, unsigned area5 = 0);
@@ -426,6 +749,7 @@ public:
                                     { _horizontal = val; } ///< @brief Show/hide horisontal lines.
     void                        set_line_labels(bool val = true)
                                     { _labels = val; } ///< @brief Show/hide line labels.
+    void                        set_lod(bool val = true);
     void                        set_main_label(std::string label = "")
                                     { _label = label; } ///< @brief Set main chart label.
     void                        set_tick_width(int val = chart::MIN_TICK)
@@ -459,12 +783,15 @@ private:
 
     void                        _calc_area_height();
     void                        _calc_area_width();
-    void                        _calc_dates();
+    bool                        _calc_dates();
+    void                        _calc_index(bool all);
+    void                        _calc_lod();
     void                        _calc_margins();
     void                        _calc_ymin_ymax();
     void                        _calc_yscale();
     void                        _create_tooltip(bool ctrl);
     void                        _draw_label();
+    void                        _draw_layer();
     void                        _draw_lines(Area& area);
     void                        _draw_line_labels(Area& area);
     void                        _draw_tooltip();
@@ -474,8 +801,10 @@ private:
     Area*                       _get_active_area(int X, int Y);
     void                        _init(bool calc_dates);
     StringVector                _label_array(const Area& area, LabelType labeltype) const;
+    int                         _last_date(int tick) const;
     bool                        _move_or_delete_line(Area* area, size_t index, bool move, AreaNum destination = AreaNum::ONE);
     void                        _show_menu();
+    int                         _tick_count() const;
 
     static bool                 _CallbackPrinter(void* data, int pw, int ph, unsigned page);
     static void                 _CallbackScrollbar(Fl_Widget*, void* widget);
@@ -484,20 +813,29 @@ private:
     AreaVector                  _areas;                 ///< @brief Area objects, all are using same DateRange.
     DateRange                   _date_range;            ///< @brief What kind of date serie that are generated.
     PointVector                 _block_dates;           ///< @brief Vector with dates that are removed from the date list.
-    PointVector                 _dates;                 ///< @brief Vector with dates from first to last date according to _date_range.
+    DateGenerator               _dates;                 ///< @brief Reference dates from first to last date according to _date_range.
+    PointVector                 _dates_block;           ///< @brief Block dates that was used for _dates.
+    gnu::DateKey                _dates_max;             ///< @brief Last line date that was used for _dates.
+    gnu::DateKey                _dates_min;             ///< @brief First line date that was used for _dates.
+    gnu::DateCache              _date_cache;            ///< @brief Cache for formatted dates in the tooltip.
     Fl_Menu_Button*             _menu;                  ///< @brief Popup menu.
     Fl_Rect                     _old;                   ///< @brief Block resizes.
+    Fl_Offscreen                _offscreen;             ///< @brief Cached image of everything except tooltip and children.
+    Fl_Rect                     _offscreen_rect;        ///< @brief Widget area when _offscreen was drawn.
     Fl_Scrollbar*               _scroll;                ///< @brief Horizontal scroll bar.
     bool                        _disable_menu;          ///< @brief Flag to disable popup menu.
     bool                        _horizontal;            ///< @brief Horizontal support lines.
     bool                        _labels;                ///< @brief Line labels.
+    bool                        _lod;                   ///< @brief Level of detail mode, zooming out past MIN_TICK aggregates dates.
+    bool                        _lod_fit;               ///< @brief Select level of detail so all dates fit in the view at next init.
     bool                        _printing;              ///< @brief Used when printing.
     bool                        _vertical;              ///< @brief Vertical support lines.
     const int                   _CH;                    ///< @brief Font height.
     const int                   _CW;                    ///< @brief Font width.
     double                      _alt_size;              ///< @brief Alternative size for day labels.
     int                         _bottom_space;          ///< @brief Bottom space from last area to h() in pixels.
-    int                         _date_start;            ///< @brief Index in _dates vector for first date to display, changed by the scrollbar.
+    int                         _date_start;            ///< @brief First tick to display, changed by the scrollbar (same as index in _dates if _lod_level is 0).
+    int                         _lod_level;             ///< @brief Level of detail, every tick is 2^_lod_level dates.
     int                         _margin_left;           ///< @brief Width of left y scale in characters.
     int                         _margin_right;          ///< @brief Width of right y scale in characters.
     int                         _tick_width;            ///< @brief Number of pixels for every tick.
@@ -10,9 +10,12 @@
 
 // MKALGAM_ON
 
+#include <atomic>
 #include <cassert>
+#include <climits>
 #include <cstring>
 #include <ctime>
+#include <mutex>
 
 namespace gnu {
 
@@ -32,6 +35,9 @@ namespace priv {
  *
  */
 
+static void         _date_civil_from_days(int64_t days, int& year, int& month, int& day);
+static int64_t      _date_days_from_civil(int year, int month, int day);
+
 static int          _DATE_DAYS_MONTH[]      = {0, 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
 static int          _DATE_DAYS_MONTH_LEAP[] = {0, 31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
 static const char*  _DATE_WEEKDAYS[]        = {"", "Monday", "Tuesday", "Wednesday", "Thursday", "Friday", "Saturday", "Sunday", ""};
@@ -39,6 +45,28 @@ static const char*  _DATE_WEEKDAYS_SHORT[]  = {"", "Mon", "Tue", "Wed", "Thu", "
 static const char*  _DATE_MONTHS[]          = {"", "January", "February", "Mars", "April", "May", "June", "July", "August", "September", "October", "November", "December", ""};
 static const char*  _DATE_MONTHS_SHORT[]    = {"", "Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec", ""};
 
+/** @brief Fixed width date layout for DateParser.
+*
+*/
+struct _DateLayout {
+    const char*     layout;     ///< @brief Layout string, letters are digits and all other characters must match.
+    size_t          len;        ///< @brief Length of layout.
+    int             count;      ///< @brief Number of digits, 8 for date only and 14 for date and time.
+    unsigned char   digit[14];  ///< @brief Digit positions for YYYYMMDDHHMMSS.
+    int             seps;       ///< @brief Number of separators.
+    unsigned char   sep[5];     ///< @brief Separator positions.
+};
+
+static const _DateLayout _DATE_LAYOUTS[] = {
+    { "YYYYMMDD HHMMSS",     15, 14, { 0, 1, 2, 3, 4, 5, 6, 7, 9, 10, 11, 12, 13, 14 }, 1, { 8 } },
+    { "YYYY-MM-DD HH:MM:SS", 19, 14, { 0, 1, 2, 3, 5, 6, 8, 9, 11, 12, 14, 15, 17, 18 }, 5, { 4, 7, 10, 13, 16 } },
+    { "YYYYMMDD HH:MM:SS",   17, 14, { 0, 1, 2, 3, 4, 5, 6, 7, 9, 10, 12, 13, 15, 16 }, 3, { 8, 11, 14 } },
+    { "YYYY-MM-DD",          10,  8, { 0, 1, 2, 3, 5, 6, 8, 9 }, 2, { 4, 7 } },
+    { "YYYYMMDD",             8,  8, { 0, 1, 2, 3, 4, 5, 6, 7 }, 0, { 0 } },
+};
+
+static const int _DATE_LAYOUTS_SIZE = static_cast<int>(sizeof(_DATE_LAYOUTS) / sizeof(_DATE_LAYOUTS[0]));
+
 /** @brief Get number of days in a month.
 *
 */
@@ -53,8 +81,288 @@ static int _date_days_in_month(int year, int month) {
     return _DATE_DAYS_MONTH[month];
 }
 
+/** @brief Parse a fixed width date string.
+*
+* All digits and separators are checked without branching and then values are range checked once.\n
+* String length must be the same as layout length.\n
+*
+* @param[in] layout  Date layout.
+* @param[in] string  Date string.
+*
+* @return Seconds since 1970-01-01 00:00:00 or DateKey::INVALID.
+*/
+static int64_t _date_parse_fixed(const _DateLayout& layout, const char* string) {
+    unsigned val[14] = { 0 };
+    unsigned bad     = 0;
+
+    for (int f = 0; f < layout.count; f++) {
+        val[f] = static_cast<unsigned>(static_cast<unsigned char>(string[layout.digit[f]])) - '0';
+        bad   |= (val[f] > 9);
+    }
+
+    for (int f = 0; f < layout.seps; f++) {
+        bad |= (string[layout.sep[f]] != layout.layout[layout.sep[f]]);
+    }
+
+    if (bad != 0) {
+        return DateKey::INVALID;
+    }
+
+    auto year  = static_cast<int>(val[0] * 1000 + val[1] * 100 + val[2] * 10 + val[3]);
+    auto month = static_cast<int>(val[4] * 10 + val[5]);
+    auto day   = static_cast<int>(val[6] * 10 + val[7]);
+    auto hour  = static_cast<int>(val[8] * 10 + val[9]);
+    auto min   = static_cast<int>(val[10] * 10 + val[11]);
+    auto sec   = static_cast<int>(val[12] * 10 + val[13]);
+
+    auto leap  = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+
+    bad |= (year < 1);
+    bad |= (month < 1 || month > 12);
+    bad |= (day < 1 || day > (leap ? _DATE_DAYS_MONTH_LEAP[month % 13] : _DATE_DAYS_MONTH[month % 13]));
+    bad |= (hour > 23 || min > 59 || sec > 59);
+
+    if (bad != 0) {
+        return DateKey::INVALID;
+    }
+
+    return _date_days_from_civil(year, month, day) * Date::SECS_PER_DAY + hour * 3600 + min * 60 + sec;
+}
+
+/** @brief Write a zero padded number.
+*
+* @param[in] buffer  Output buffer with room for width characters.
+* @param[in] value   Positive number.
+* @param[in] width   Number of digits, 2 or 4.
+*
+* @return Pointer after last digit.
+*/
+static inline char* _date_put_digits(char* buffer, int value, int width) {
+    if (width == 4) {
+        buffer[0] = '0' + (value / 1000) % 10;
+        buffer[1] = '0' + (value / 100) % 10;
+        buffer += 2;
+    }
+
+    buffer[0] = '0' + (value / 10) % 10;
+    buffer[1] = '0' + value % 10;
+    return buffer + 2;
+}
+
+/** @brief Convert days since 1970-01-01 to date.
+*
+* Uses the proleptic gregorian calendar, same as the rest of Date.\n
+* Algorithm from Howard Hinnant, "chrono-Compatible Low-Level Date Algorithms".\n
+*/
+static void _date_civil_from_days(int64_t days, int& year, int& month, int& day) {
+    days += 719468;
+
+    auto era = (days >= 0 ? days : days - 146096) / 146097;
+    auto doe = days - era * 146097;
+    auto yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    auto doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    auto mp  = (5 * doy + 2) / 153;
+
+    day   = static_cast<int>(doy - (153 * mp + 2) / 5 + 1);
+    month = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+    year  = static_cast<int>(yoe + era * 400 + (month <= 2));
+}
+
+/** @brief Convert date to days since 1970-01-01.
+*
+* Input must be a valid date.
+*/
+static int64_t _date_days_from_civil(int year, int month, int day) {
+    int64_t y   = year - (month <= 2);
+    auto    era = (y >= 0 ? y : y - 399) / 400;
+    auto    yoe = y - era * 400;
+    auto    doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    auto    doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+
+    return era * 146097 + doe - 719468;
+}
+
+/** @brief Local time offset for one period in a year.
+*
+*/
+struct _DateZone {
+    int64_t         start;      ///< @brief Start of period in seconds since 1970 (UTC or local time).
+    int             offset;     ///< @brief Seconds to add to UTC time to get local time.
+};
+
+static const int                _DATE_ZONE_FIRST = 1970;
+static const int                _DATE_ZONE_LAST  = 2199;
+static const int                _DATE_ZONE_YEARS = _DATE_ZONE_LAST - _DATE_ZONE_FIRST + 1;
+static std::atomic<bool>        _DATE_ZONE_READY[_DATE_ZONE_YEARS];     // Set when tables for a year has been built.
+static std::mutex               _DATE_ZONE_MUTEX;
+static std::vector<_DateZone>   _DATE_ZONE_LOCAL[_DATE_ZONE_YEARS];     // Periods in UTC time, used for UTC -> local time.
+static std::vector<_DateZone>   _DATE_ZONE_UNIX[_DATE_ZONE_YEARS];      // Periods in local time, used for local time -> UTC (same as mktime() with tm_isdst = 0).
+
+/** @brief Thread safe localtime().
+*
+*/
+static bool _date_localtime(time_t seconds, tm& res) {
+#ifdef _WIN32
+    return localtime_s(&res, &seconds) == 0;
+#else
+    return localtime_r(&seconds, &res) != nullptr;
+#endif
+}
+
+/** @brief Get local time offset from libc for an UTC time.
+*
+* @return Offset in seconds or INT_MIN for error.
+*/
+static int _date_zone_local_offset(int64_t utc) {
+    tm t;
+
+    if (_date_localtime(static_cast<time_t>(utc), t) == false) {
+        return INT_MIN;
+    }
+
+    auto local = _date_days_from_civil(t.tm_year + 1900, t.tm_mon + 1, t.tm_mday) * 86400 + t.tm_hour * 3600 + t.tm_min * 60 + t.tm_sec;
+    return static_cast<int>(local - utc);
+}
+
+/** @brief Get local time offset that mktime() uses for a local time.
+*
+* @return Offset in seconds or INT_MIN for error.
+*/
+static int _date_zone_unix_offset(int64_t local) {
+    auto days = local / 86400;
+    auto secs = static_cast<int>(local - days * 86400);
+    int  year, month, day;
+    tm   t;
+
+    _date_civil_from_days(days, year, month, day);
+    memset(&t, '\0', sizeof(t));
+    t.tm_year = year - 1900;
+    t.tm_mon  = month - 1;
+    t.tm_mday = day;
+    t.tm_hour = secs / 3600;
+    t.tm_min  = (secs / 60) % 60;
+    t.tm_sec  = secs % 60;
+
+    auto utc = static_cast<int64_t>(mktime(&t));
+    return (utc == -1) ? INT_MIN : static_cast<int>(local - utc);
+}
+
+/** @brief Find all offset changes in a time range.
+*
+* Offset is sampled once every day and every change is located to the second with a binary search.
+*
+* @param[out] table   Result periods.
+* @param[in]  start   Start time.
+* @param[in]  stop    Stop time (exclusive).
+* @param[in]  offset  Function that returns offset for a time.
+*
+* @return True if ok.
+*/
+static bool _date_zone_scan(std::vector<_DateZone>& table, int64_t start, int64_t stop, int (*offset)(int64_t)) {
+    auto prev     = start;
+    auto prev_off = offset(start);
+
+    if (prev_off == INT_MIN) {
+        return false;
+    }
+
+    table.push_back({start, prev_off});
+
+    for (auto next = start + 86400; prev < stop - 1; next += 86400) {
+        next = (next < stop - 1) ? next : stop - 1;
+
+        auto next_off = offset(next);
+
+        if (next_off == INT_MIN) {
+            return false;
+        }
+
+        while (next_off != prev_off) { // Find first second with a new offset.
+            auto lo = prev;
+            auto hi = next;
+
+            while (hi - lo > 1) {
+                auto mid = lo + (hi - lo) / 2;
+
+                if (offset(mid) == prev_off) {
+                    lo = mid;
+                }
+                else {
+                    hi = mid;
+                }
+            }
+
+            prev     = hi;
+            prev_off = offset(hi);
+            table.push_back({prev, prev_off});
+        }
+
+        prev = next;
+    }
+
+    return true;
+}
+
+/** @brief Build local time tables for a year.
+*
+* Tables are built once for every year and then only read.\n
+* Changes to the time zone after that are not seen.\n
+*
+* @param[in] year  Year.
+*
+* @return True if tables for the year can be used, false to use libc.
+*/
+static bool _date_zone_year(int year) {
+    if (year < _DATE_ZONE_FIRST || year > _DATE_ZONE_LAST) {
+        return false;
+    }
+
+    auto index = year - _DATE_ZONE_FIRST;
+
+    if (_DATE_ZONE_READY[index].load(std::memory_order_acquire) == false) {
+        std::lock_guard<std::mutex> lock(_DATE_ZONE_MUTEX);
+
+        if (_DATE_ZONE_READY[index].load(std::memory_order_relaxed) == false) {
+            auto  start = _date_days_from_civil(year, 1, 1) * 86400;
+            auto  stop  = _date_days_from_civil(year + 1, 1, 1) * 86400;
+            auto& to_local = _DATE_ZONE_LOCAL[index];
+            auto& to_unix  = _DATE_ZONE_UNIX[index];
+
+#ifdef _WIN32
+            _tzset();
+#else
+            tzset();
+#endif
+
+            if (_date_zone_scan(to_local, start, stop, _date_zone_local_offset) == false || _date_zone_scan(to_unix, start, stop, _date_zone_unix_offset) == false) {
+                to_local.clear();
+                to_unix.clear();
+            }
+
+            _DATE_ZONE_READY[index].store(true, std::memory_order_release);
+        }
+    }
+
+    return _DATE_ZONE_LOCAL[index].size() > 0;
+}
+
+/** @brief Find offset for a time in a table.
+*
+* @return Offset in seconds.
+*/
+static int _date_zone_find(const std::vector<_DateZone>& table, int64_t seconds) {
+    for (auto it = table.rbegin(); it != table.rend(); ++it) {
+        if (seconds >= it->start) {
+            return it->offset;
+        }
+    }
+
+    return table.front().offset;
+}
+
 /** @brief Create date fields from unix time.
 *
+* Local time is converted with cached offset tables for years 1970 - 2199 and libc for other years.
 */
 static void _date_from_time(int64_t seconds, gnu::Date::UTC utc, int& year, int& month, int& day, int& hour, int& min, int& sec) {
     year = month = day = 1;
@@ -64,19 +372,38 @@ static void _date_from_time(int64_t seconds, gnu::Date::UTC utc, int& year, int&
         return;
     }
 
-    time_t    rawtime  = seconds;
-    const tm* timeinfo = (utc == gnu::Date::UTC::ON) ? gmtime(&rawtime) : localtime(&rawtime);
+    if (utc == gnu::Date::UTC::OFF) {
+        int utc_year, utc_month, utc_day;
 
-    if (timeinfo == nullptr) {
-        return;
+        _date_civil_from_days(seconds / 86400, utc_year, utc_month, utc_day);
+
+        if (_date_zone_year(utc_year) == false) {
+            time_t rawtime = seconds;
+            tm     timeinfo;
+
+            if (_date_localtime(rawtime, timeinfo) == false) {
+                return;
+            }
+
+            year  = timeinfo.tm_year + 1900;
+            month = timeinfo.tm_mon + 1;
+            day   = timeinfo.tm_mday;
+            hour  = timeinfo.tm_hour;
+            min   = timeinfo.tm_min;
+            sec   = timeinfo.tm_sec;
+            return;
+        }
+
+        seconds += _date_zone_find(_DATE_ZONE_LOCAL[utc_year - _DATE_ZONE_FIRST], seconds);
     }
 
-    year  = timeinfo->tm_year + 1900;
-    month = timeinfo->tm_mon + 1;
-    day   = timeinfo->tm_mday;
-    hour  = timeinfo->tm_hour;
-    min   = timeinfo->tm_min;
-    sec   = timeinfo->tm_sec;
+    auto days = (seconds >= 0) ? seconds / 86400 : (seconds - 86399) / 86400;
+    auto secs = static_cast<int>(seconds - days * 86400);
+
+    _date_civil_from_days(days, year, month, day);
+    hour = secs / 3600;
+    min  = (secs / 60) % 60;
+    sec  = secs % 60;
 }
 
 /** @brief Get day of week.
@@ -228,60 +555,17 @@ gnu::Date::Date(const std::string& date, gnu::Date::US us) {
 */
 bool gnu::Date::add_days(const int days) {
     if (days == 0) {
-        return 0;
+        return false;
     }
-
-    int daym = priv::_date_days_in_month(_year, _month);
-
-    if (daym == 0) {
+    else if (priv::_date_days_in_month(_year, _month) == 0) {
         return false;
     }
 
-    int inc = days > 0 ? 1 : -1;
-    int y   = _year;
-    int m   = _month;
-    int d   = _day;
-
-    for (int f = 0; f < abs(days); f++) {
-        d += inc;
-
-        if (inc < 0 && d == 0) {
-            m--;
+    int y, m, d;
+    priv::_date_civil_from_days(priv::_date_days_from_civil(_year, _month, _day) + days, y, m, d);
 
-            if (m == 0) {
-                m = 12;
-                y--;
-
-                if (y < 1) {
-                    return false;
-                }
-            }
-
-            d = priv::_date_days_in_month(y, m);
-
-            if (d == 0) {
-                return false;
-            }
-        }
-        else if (inc > 0 && d > daym) {
-            d = 1;
-            m++;
-
-            if (m == 13) {
-                m = 1;
-                y++;
-
-                if (y > 9999) {
-                    return false;
-                }
-            }
-
-            daym = priv::_date_days_in_month(y, m);
-
-            if (daym == 0) {
-                return false;
-            }
-        }
+    if (y < 1 || y > 9999) {
+        return false;
     }
 
     _year  = y;
@@ -302,32 +586,15 @@ bool gnu::Date::add_months(const int months) {
         return false;
     }
 
-    int inc = months > 0 ? 1 : -1;
-    int m   = _month;
-    int y   = _year;
-
-    for (int f = 0; f < abs(months); f++) {
-        m += inc;
-
-        if (m == 0) {
-            m = 12;
-            y--;
-
-            if (y < 1) {
-                return false;
-            }
-        }
-        else if (m > 12) {
-            m = 1;
-            y++;
+    auto total = static_cast<int64_t>(_year) * 12 + (_month - 1) + months;
 
-            if (y > 9999) {
-                return false;
-            }
-        }
+    if (total < 12 || total >= 10000 * 12) {
+        return false;
     }
 
-    const int days = priv::_date_days_in_month(y, m);
+    auto y    = static_cast<int>(total / 12);
+    auto m    = static_cast<int>(total % 12) + 1;
+    auto days = priv::_date_days_in_month(y, m);
 
     if (days <= 0) {
         return false;
@@ -350,59 +617,21 @@ bool gnu::Date::add_months(const int months) {
 * @return True if changed.
 */
 bool gnu::Date::add_seconds(const int64_t seconds) {
-    if (seconds == 0) {
+    if (seconds == 0 || seconds > 10000LL * 366 * SECS_PER_DAY || seconds < -10000LL * 366 * SECS_PER_DAY) {
         return false;
     }
 
-    int inc = seconds > 0 ? 1 : -1;
-    int h   = _hour;
-    int m   = _min;
-    int s   = _sec;
-
-    for (int64_t f = 0; f < llabs(seconds); f++) {
-        s += inc;
+    auto total = static_cast<int64_t>(_hour) * 3600 + _min * 60 + _sec + seconds;
+    auto days  = (total >= 0) ? total / SECS_PER_DAY : (total - (SECS_PER_DAY - 1)) / SECS_PER_DAY;
+    auto secs  = static_cast<int>(total - days * SECS_PER_DAY);
 
-        if (inc < 0 && s == -1) {
-            m--;
-
-            if (m == -1) {
-                m = 59;
-                h--;
-
-                if (h == -1) {
-                    h = 23;
-
-                    if (add_days(-1) == false) {
-                        return false;
-                    }
-                }
-            }
-
-            s = 59;
-        }
-        else if (inc > 0 && s == 60) {
-            m++;
-
-            if (m == 60) {
-                m = 0;
-                h++;
-
-                if (h == 24) {
-                    h = 0;
-
-                    if (add_days(1) == false) {
-                        return false;
-                    }
-                }
-            }
-
-            s = 0;
-        }
+    if (days != 0 && add_days(static_cast<int>(days)) == false) {
+        return false;
     }
 
-    _hour = h;
-    _min  = m;
-    _sec  = s;
+    _hour = secs / 3600;
+    _min  = (secs / 60) % 60;
+    _sec  = secs % 60;
 
     return true;
 }
@@ -513,23 +742,11 @@ void gnu::Date::debug() const {
 * @return Day count.
 */
 int gnu::Date::diff_days(const Date& date) const {
-    Date d(date);
-    int  res = 0;
-
-    if (compare(d, Compare::YYYYMMDD) < 0) {
-        while (compare(d, Compare::YYYYMMDD) != 0) {
-            d.add_days(-1);
-            res++;
-        }
-    }
-    else if (compare(d, Compare::YYYYMMDD) > 0) {
-        while (compare(d, Compare::YYYYMMDD) != 0) {
-            d.add_days(1);
-            res--;
-        }
+    if (is_invalid() == true || date.is_invalid() == true) {
+        return 0;
     }
 
-    return res;
+    return static_cast<int>(priv::_date_days_from_civil(date._year, date._month, date._day) - priv::_date_days_from_civil(_year, _month, _day));
 }
 
 /** @brief Get number of months between two dates.
@@ -539,23 +756,7 @@ int gnu::Date::diff_days(const Date& date) const {
 * @return Month count.
 */
 int gnu::Date::diff_months(const Date& date) const {
-    Date d(date);
-    int  res = 0;
-
-    if (compare(d, Compare::YYYYMM) < 0) {
-        while (compare(d, Compare::YYYYMM)) {
-            d.add_months(-1);
-            res++;
-        }
-    }
-    else if (compare(d, Compare::YYYYMM) > 0) {
-        while (compare(d, Compare::YYYYMM)) {
-            d.add_months(1);
-            res--;
-        }
-    }
-
-    return res;
+    return (date._year * 12 + date._month) - (_year * 12 + _month);
 }
 
 /** @brief Get number of seconds between two dates.
@@ -583,62 +784,121 @@ int64_t gnu::Date::diff_seconds(const Date& date) const {
 */
 std::string gnu::Date::format(Format format) const {
     char tmp[100];
-    int  n = 0;
 
-    if (format == Format::ISO) {
-        n = snprintf(tmp, 100, "%04d%02d%02d", _year, _month, _day);
-    }
-    else if (format == Format::ISO_LONG) {
-        n = snprintf(tmp, 100, "%04d-%02d-%02d", _year, _month, _day);
-    }
-    else if (format == Format::ISO_TIME) {
-        n = snprintf(tmp, 100, "%04d%02d%02d %02d%02d%02d", _year, _month, _day, _hour, _min, _sec);
-    }
-    else if (format == Format::ISO_TIME_LONG) {
-        n = snprintf(tmp, 100, "%04d-%02d-%02d %02d:%02d:%02d", _year, _month, _day, _hour, _min, _sec);
+    format_to(tmp, 100, format);
+    return tmp;
+}
+
+/** @brief Format a string about the date into a caller buffer.
+*
+* No memory is allocated.\n
+* The numeric ISO and TIME formats are written digit by digit, the rest are using snprintf().\n
+*
+* @param[out] buffer  Output buffer, it is always terminated with a 0 if size is greater than 0.
+* @param[in]  size    Size of buffer including space for the terminating 0.
+* @param[in]  format  Format specifier.
+*
+* @return Length of string, 0 if buffer is too small.
+*/
+size_t gnu::Date::format_to(char* buffer, size_t size, Format format) const {
+    if (buffer == nullptr || size == 0) {
+        return 0;
     }
-    else if (format == Format::TIME) {
-        n = snprintf(tmp, 100, "%02d%02d%02d", _hour, _min, _sec);
+
+    int n = 0;
+
+    if (format == Format::ISO || format == Format::ISO_LONG || format == Format::ISO_TIME || format == Format::ISO_TIME_LONG) {
+        auto sep = (format == Format::ISO_LONG || format == Format::ISO_TIME_LONG);
+        auto tim = (format == Format::ISO_TIME || format == Format::ISO_TIME_LONG);
+        n        = 8 + (sep == true ? 2 : 0) + (tim == true ? (sep == true ? 9 : 7) : 0);
+
+        if (static_cast<size_t>(n) >= size) {
+            *buffer = 0;
+            return 0;
+        }
+
+        auto p = buffer;
+        p = priv::_date_put_digits(p, _year, 4);
+        if (sep == true) *p++ = '-';
+        p = priv::_date_put_digits(p, _month, 2);
+        if (sep == true) *p++ = '-';
+        p = priv::_date_put_digits(p, _day, 2);
+
+        if (tim == true) {
+            *p++ = ' ';
+            p = priv::_date_put_digits(p, _hour, 2);
+            if (sep == true) *p++ = ':';
+            p = priv::_date_put_digits(p, _min, 2);
+            if (sep == true) *p++ = ':';
+            p = priv::_date_put_digits(p, _sec, 2);
+        }
+
+        *p = 0;
+        return n;
     }
-    else if (format == Format::TIME_LONG) {
-        n = snprintf(tmp, 100, "%02d:%02d:%02d", _hour, _min, _sec);
+    else if (format == Format::TIME || format == Format::TIME_LONG) {
+        auto sep = (format == Format::TIME_LONG);
+        n        = (sep == true) ? 8 : 6;
+
+        if (static_cast<size_t>(n) >= size) {
+            *buffer = 0;
+            return 0;
+        }
+
+        auto p = buffer;
+        p = priv::_date_put_digits(p, _hour, 2);
+        if (sep == true) *p++ = ':';
+        p = priv::_date_put_digits(p, _min, 2);
+        if (sep == true) *p++ = ':';
+        p = priv::_date_put_digits(p, _sec, 2);
+        *p = 0;
+        return n;
     }
     else if (format == Format::US) {
-        n = snprintf(tmp, 100, "%d/%d/%04d", _month, _day, _year);
+        n = snprintf(buffer, size, "%d/%d/%04d", _month, _day, _year);
     }
     else if (format == Format::WORLD) {
-        n = snprintf(tmp, 100, "%d/%d/%04d", _day, _month, _year);
+        n = snprintf(buffer, size, "%d/%d/%04d", _day, _month, _year);
     }
     else if (format == Format::DAY_MONTH_YEAR) {
-        n = snprintf(tmp, 100, "%d %s %04d", _day, month_name(), _year);
+        n = snprintf(buffer, size, "%d %s %04d", _day, month_name(), _year);
     }
     else if (format == Format::DAY_MONTH_YEAR_SHORT) {
-        n = snprintf(tmp, 100, "%d %s, %04d", _day, month_name_short(), _year);
+        n = snprintf(buffer, size, "%d %s, %04d", _day, month_name_short(), _year);
     }
     else if (format == Format::WEEKDAY_MONTH_YEAR) {
-        n = snprintf(tmp, 100, "%s %d %s %04d", weekday_name(), _day, month_name(), _year);
+        n = snprintf(buffer, size, "%s %d %s %04d", weekday_name(), _day, month_name(), _year);
     }
     else if (format == Format::WEEKDAY_MONTH_YEAR_SHORT) {
-        n = snprintf(tmp, 100, "%s, %d %s, %04d", weekday_name_short(), _day, month_name_short(), _year);
+        n = snprintf(buffer, size, "%s, %d %s, %04d", weekday_name_short(), _day, month_name_short(), _year);
     }
     else if (format == Format::WEEKDAY) {
-        n = snprintf(tmp, 100, "%s", weekday_name());
+        n = snprintf(buffer, size, "%s", weekday_name());
     }
     else if (format == Format::WEEKDAY_SHORT) {
-        n = snprintf(tmp, 100, "%s", weekday_name_short());
+        n = snprintf(buffer, size, "%s", weekday_name_short());
     }
     else if (format == Format::MONTH) {
-        n = snprintf(tmp, 100, "%s", month_name());
+        n = snprintf(buffer, size, "%s", month_name());
     }
     else if (format == Format::MONTH_SHORT) {
-        n = snprintf(tmp, 100, "%s", month_name_short());
+        n = snprintf(buffer, size, "%s", month_name_short());
     }
 
-    if (n < 0 || n >= 100) {
-        *tmp = 0;
+    if (n < 0 || static_cast<size_t>(n) >= size) {
+        *buffer = 0;
+        return 0;
     }
 
-    return tmp;
+    return n;
+}
+
+/** @brief Get compact key for this date.
+*
+* @return Key, invalid if date is invalid.
+*/
+gnu::DateKey gnu::Date::key() const {
+    return DateKey(*this);
 }
 
 /** @brief Is current year a leap year?
@@ -996,6 +1256,9 @@ gnu::Date& gnu::Date::set_year(int year) {
 
 /** @brief Get date and time as seconds since 1970.
 *
+* Date is local time and it is converted like mktime() with tm_isdst set to 0.\n
+* Years 1970 - 2199 are using cached offset tables, the first call for a year builds the table.\n
+*
 * @return Seconds or -1 for any error.
 */
 int64_t gnu::Date::time() const {
@@ -1005,6 +1268,11 @@ int64_t gnu::Date::time() const {
         return -1;
     }
 
+    if (priv::_date_zone_year(_year) == true) {
+        auto local = priv::_date_days_from_civil(_year, _month, _day) * SECS_PER_DAY + _hour * 3600 + _min * 60 + _sec;
+        return local - priv::_date_zone_find(priv::_DATE_ZONE_UNIX[_year - priv::_DATE_ZONE_FIRST], local);
+    }
+
     memset(&t, '\0', sizeof(t));
     t.tm_year = _year - 1900;
     t.tm_mon  = _month - 1;
@@ -1088,4 +1356,398 @@ const char* gnu::Date::weekday_name_short() const {
     return priv::_DATE_WEEKDAYS_SHORT[static_cast<int>(priv::_date_weekday(_year, _month, _day))];
 }
 
+/** @brief Add days to all dates.
+*
+* @param[in,out] dates  Dates to change.
+* @param[in]     days   Number of days, negative are ok.
+*
+* @return Number of changed dates.
+*/
+size_t gnu::Date::AddDays(std::vector<Date>& dates, int days) {
+    auto res = (size_t) 0;
+
+    for (auto& date : dates) {
+        res += date.add_days(days);
+    }
+
+    return res;
+}
+
+/** @brief Add months to all dates.
+*
+* @param[in,out] dates   Dates to change.
+* @param[in]     months  Number of months, negative are ok.
+*
+* @return Number of changed dates.
+*/
+size_t gnu::Date::AddMonths(std::vector<Date>& dates, int months) {
+    auto res = (size_t) 0;
+
+    for (auto& date : dates) {
+        res += date.add_months(months);
+    }
+
+    return res;
+}
+
+/** @brief Add seconds to all dates.
+*
+* @param[in,out] dates    Dates to change.
+* @param[in]     seconds  Number of seconds, negative are ok.
+*
+* @return Number of changed dates.
+*/
+size_t gnu::Date::AddSeconds(std::vector<Date>& dates, int64_t seconds) {
+    auto res = (size_t) 0;
+
+    for (auto& date : dates) {
+        res += date.add_seconds(seconds);
+    }
+
+    return res;
+}
+
+/** @brief Get number of days from one date to every date in a vector.
+*
+* @param[in] from   Start date.
+* @param[in] dates  Dates to compare with.
+*
+* @return Day count for every date.
+*/
+std::vector<int> gnu::Date::DiffDays(const Date& from, const std::vector<Date>& dates) {
+    auto res = std::vector<int>();
+
+    res.reserve(dates.size());
+
+    for (const auto& date : dates) {
+        res.push_back(from.diff_days(date));
+    }
+
+    return res;
+}
+
+/** @brief Create dates from start to stop (inclusive).
+*
+* @param[in] start  Start date.
+* @param[in] stop   Stop date.
+* @param[in] days   Days between dates, must be 1 or more.
+*
+* @return Dates, empty if input is invalid.
+*/
+std::vector<gnu::Date> gnu::Date::Serie(const Date& start, const Date& stop, int days) {
+    auto res = std::vector<Date>();
+
+    if (days < 1 || start.is_invalid() == true || stop.is_invalid() == true || stop < start) {
+        return res;
+    }
+
+    auto first = priv::_date_days_from_civil(start._year, start._month, start._day);
+    auto last  = priv::_date_days_from_civil(stop._year, stop._month, stop._day);
+    int  y, m, d;
+
+    res.reserve((last - first) / days + 1);
+
+    for (auto day = first; day <= last; day += days) {
+        priv::_date_civil_from_days(day, y, m, d);
+        res.push_back(Date(y, m, d, start._hour, start._min, start._sec));
+    }
+
+    if (res.size() > 0 && res.back() > stop) {
+        res.pop_back();
+    }
+
+    return res;
+}
+
+/*
+ *      _____        _       _  __
+ *     |  __ \      | |     | |/ /
+ *     | |  | | __ _| |_ ___| ' / ___ _   _
+ *     | |  | |/ _` | __/ _ \  < / _ \ | | |
+ *     | |__| | (_| | ||  __/ . \  __/ |_| |
+ *     |_____/ \__,_|\__\___|_|\_\___|\__, |
+ *                                     __/ |
+ *                                    |___/
+ */
+
+/** @brief Create key from date.
+*
+* @param[in] date  Date object, invalid date creates an invalid key.
+*/
+gnu::DateKey::DateKey(const Date& date) {
+    _sec = DateKey::INVALID;
+
+    if (date.is_invalid() == false) {
+        _sec = priv::_date_days_from_civil(date.year(), date.month(), date.day()) * Date::SECS_PER_DAY + date.hour() * 3600 + date.minute() * 60 + date.second();
+    }
+}
+
+/** @brief Create key from date values.
+*
+* Same range checks as Date::set().
+*
+* @param[in] year   Year from 1 to 9999.
+* @param[in] month  Month from 1 - 12.
+* @param[in] day    Day from 1 - 31.
+* @param[in] hour   Hour from 0 - 23.
+* @param[in] min    Minute from 0 - 59.
+* @param[in] sec    Second from 0 - 59.
+*/
+gnu::DateKey::DateKey(int year, int month, int day, int hour, int min, int sec) {
+    _sec = DateKey::INVALID;
+
+    if (year < 1 || year > 9999 ||
+        month < 1 || month > 12 ||
+        day < 1 || day > priv::_date_days_in_month(year, month) ||
+        hour < 0 || hour > 23 ||
+        min < 0 || min > 59 ||
+        sec < 0 || sec > 59) {
+        return;
+    }
+
+    _sec = priv::_date_days_from_civil(year, month, day) * Date::SECS_PER_DAY + hour * 3600 + min * 60 + sec;
+}
+
+/** @brief Get number of whole days since 1970-01-01.
+*
+* @return Days, negative for earlier dates.
+*/
+int64_t gnu::DateKey::days() const {
+    return (_sec >= 0) ? _sec / Date::SECS_PER_DAY : (_sec - (Date::SECS_PER_DAY - 1)) / Date::SECS_PER_DAY;
+}
+
+/** @brief Convert key to a date object.
+*
+* @return Date, invalid if key is invalid or out of range.
+*/
+gnu::Date gnu::DateKey::to_date() const {
+    if (is_invalid() == true) {
+        return Date(0, 0, 0);
+    }
+
+    auto days = this->days();
+    auto secs = static_cast<int>(_sec - days * Date::SECS_PER_DAY);
+    int  y, m, d;
+
+    priv::_date_civil_from_days(days, y, m, d);
+    return Date(y, m, d, secs / 3600, (secs / 60) % 60, secs % 60);
+}
+
+/*
+ *      _____        _       _____
+ *     |  __ \      | |     |  __ \
+ *     | |  | | __ _| |_ ___| |__) |_ _ _ __ ___  ___ _ __
+ *     | |  | |/ _` | __/ _ \  ___/ _` | '__/ __|/ _ \ '__|
+ *     | |__| | (_| | ||  __/ |  | (_| | |  \__ \  __/ |
+ *     |_____/ \__,_|\__\___|_|   \__,_|_|  |___/\___|_|
+ *
+ *
+ */
+
+/** @brief Create parser that detects format from first string.
+*
+* @param[in] us  US date or world date for formats that are parsed by Date::set().
+*/
+gnu::DateParser::DateParser(Date::US us) {
+    _layout   = -1;
+    _us       = us;
+    _detected = false;
+}
+
+/** @brief Create parser with a known format.
+*
+* @param[in] format  Date::Format::ISO, Date::Format::ISO_LONG, Date::Format::ISO_TIME or Date::Format::ISO_TIME_LONG use the fast path, all others use Date::set().
+* @param[in] us      US date or world date for formats that are parsed by Date::set().
+*/
+gnu::DateParser::DateParser(Date::Format format, Date::US us) {
+    _layout   = -1;
+    _us       = us;
+    _detected = true;
+
+    if (format == Date::Format::ISO_TIME) {
+        _layout = 0;
+    }
+    else if (format == Date::Format::ISO_TIME_LONG) {
+        _layout = 1;
+    }
+    else if (format == Date::Format::ISO_LONG) {
+        _layout = 3;
+    }
+    else if (format == Date::Format::ISO) {
+        _layout = 4;
+    }
+}
+
+/** @brief Detect format from a sample string.
+*
+* @param[in] sample  Date string.
+* @param[in] len     Length of string.
+*
+* @return True if a fixed width format was found, false if Date::set() will be used.
+*/
+bool gnu::DateParser::detect(const char* sample, size_t len) {
+    _layout   = -1;
+    _detected = true;
+
+    while (len > 0 && static_cast<unsigned char>(sample[len - 1]) <= ' ') {
+        len--;
+    }
+
+    for (int f = 0; f < priv::_DATE_LAYOUTS_SIZE; f++) {
+        const auto& layout = priv::_DATE_LAYOUTS[f];
+
+        if (layout.len == len && priv::_date_parse_fixed(layout, sample) != DateKey::INVALID) {
+            _layout = f;
+            break;
+        }
+    }
+
+    return _layout >= 0;
+}
+
+/** @brief Get detected layout.
+*
+* @return Layout string like "YYYYMMDD HHMMSS" or "" if Date::set() is used.
+*/
+const char* gnu::DateParser::layout() const {
+    return (_layout >= 0) ? priv::_DATE_LAYOUTS[_layout].layout : "";
+}
+
+/** @brief Parse one date string.
+*
+* @param[in] string  Date string.
+* @param[in] len     Length of string.
+*
+* @return Key, invalid if string is not a date.
+*/
+gnu::DateKey gnu::DateParser::parse(const char* string, size_t len) const {
+    auto res = parse_fixed(string, len);
+
+    if (res.is_invalid() == false) {
+        return res;
+    }
+
+    return Date(std::string(string, len), _us).key();
+}
+
+/** @brief Parse a column of date strings.
+*
+* If format has not been detected then it is detected from the first strings in the column.\n
+* A few broken strings at the start (like a header line) will not disable the fast path.\n
+*
+* @param[in] column  Vector with date strings.
+*
+* @return Vector with keys, same size as input, invalid keys for strings that are not dates.
+*/
+std::vector<gnu::DateKey> gnu::DateParser::parse(const std::vector<std::string>& column) {
+    std::vector<DateKey> res;
+    size_t               tries = 0;
+
+    res.reserve(column.size());
+
+    for (const auto& string : column) {
+        if (_detected == false && string != "") {
+            if (detect(string) == false && ++tries < 10) {
+                _detected = false;
+            }
+        }
+
+        res.push_back(parse(string.c_str(), string.length()));
+    }
+
+    return res;
+}
+
+/** @brief Parse one date string using only the fixed width format.
+*
+* Strings that are valid for Date::set() but don't match the detected format returns an invalid key.
+*
+* @param[in] string  Date string.
+* @param[in] len     Length of string.
+*
+* @return Key, invalid if string does not match the fixed width format or there is no fixed width format.
+*/
+gnu::DateKey gnu::DateParser::parse_fixed(const char* string, size_t len) const {
+    if (_layout < 0) {
+        return DateKey();
+    }
+
+    const auto& layout = priv::_DATE_LAYOUTS[_layout];
+
+    while (len > 0 && static_cast<unsigned char>(string[len - 1]) <= ' ') {
+        len--;
+    }
+
+    if (len != layout.len) {
+        return DateKey();
+    }
+
+    return DateKey::FromSeconds(priv::_date_parse_fixed(layout, string));
+}
+
+/*
+ *      _____        _        _____           _
+ *     |  __ \      | |      / ____|         | |
+ *     | |  | | __ _| |_ ___| |     __ _  ___| |__   ___
+ *     | |  | |/ _` | __/ _ \ |    / _` |/ __| '_ \ / _ \
+ *     | |__| | (_| | ||  __/ |___| (_| | (__| | | |  __/
+ *     |_____/ \__,_|\__\___|\_____\__,_|\___|_| |_|\___|
+ *
+ *
+ */
+
+/** @brief Create cache.
+*
+* @param[in] size  Number of slots, it is rounded up to a power of 2 (min 16).
+*/
+gnu::DateCache::DateCache(size_t size) {
+    size_t slots = 16;
+
+    while (slots < size) {
+        slots *= 2;
+    }
+
+    _slots.resize(slots);
+    clear();
+}
+
+/** @brief Remove all cached strings.
+*
+*/
+void gnu::DateCache::clear() {
+    for (auto& slot : _slots) {
+        slot.key     = DateKey::INVALID;
+        slot.format  = -1;
+        slot.text[0] = 0;
+    }
+
+    _hits   = 0;
+    _misses = 0;
+}
+
+/** @brief Format date.
+*
+* @param[in] key     Date key.
+* @param[in] format  Format specifier.
+*
+* @return Formatted string, valid until next call.
+*/
+const char* gnu::DateCache::format(const DateKey& key, Date::Format format) {
+    auto hash  = static_cast<uint64_t>(key.seconds()) * 0x9E3779B97F4A7C15ULL + static_cast<uint64_t>(format);
+    auto index = static_cast<size_t>(hash ^ (hash >> 32)) & (_slots.size() - 1);
+    auto& slot = _slots[index];
+
+    if (slot.key == key.seconds() && slot.format == static_cast<int>(format)) {
+        _hits++;
+        return slot.text;
+    }
+
+    _misses++;
+    key.to_date().format_to(slot.text, DateCache::TEXT_SIZE, format);
+    slot.key    = key.seconds();
+    slot.format = static_cast<int>(format);
+
+    return slot.text;
+}
+
 // MKALGAM_OFF
@@ -12,10 +12,14 @@
 // MKALGAM_ON
 
 #include <cstdint>
+#include <functional>
 #include <string>
+#include <vector>
 
 namespace gnu {
 
+class DateKey;
+
 /*
  *      _____        _
  *     |  __ \      | |
@@ -140,8 +144,10 @@ public:
     int                         diff_months(const Date& other) const;
     int64_t                     diff_seconds(const Date& other) const;
     std::string                 format(Format format = Format::ISO) const;
+    size_t                      format_to(char* buffer, size_t size, Format format = Format::ISO) const;
     int                         hour() const
                                     { return _hour; } ///< @brief Get hour.
+    DateKey                     key() const;
     bool                        is_invalid() const
                                     { return _year == 0 || _month == 0 || _day == 0; } ///< @brief Test if date is invalid.
     bool                        is_leapyear() const;
@@ -173,8 +179,13 @@ public:
     int                         year() const
                                     { return _year; } ///< @brief Get current year.
 
+    static size_t               AddDays(std::vector<Date>& dates, int days);
+    static size_t               AddMonths(std::vector<Date>& dates, int months);
+    static size_t               AddSeconds(std::vector<Date>& dates, int64_t seconds);
     static inline bool          CompareDates(const Date& a, const Date& b)
                                     { return a.compare(b) < 0; } ///< @brief Compare two dates.
+    static std::vector<int>     DiffDays(const Date& from, const std::vector<Date>& dates);
+    static std::vector<Date>    Serie(const Date& start, const Date& stop, int days = 1);
 
 private:
     short                       _year;      ///< @brief Year from 1 - 9999.
@@ -185,8 +196,165 @@ private:
     char                        _sec;       ///< @brief Second from 0 - 59.
 };
 
+/*
+ *      _____        _       _  __
+ *     |  __ \      | |     | |/ /
+ *     | |  | | __ _| |_ ___| ' / ___ _   _
+ *     | |  | |/ _` | __/ _ \  < / _ \ | | |
+ *     | |__| | (_| | ||  __/ . \  __/ |_| |
+ *     |_____/ \__,_|\__\___|_|\_\___|\__, |
+ *                                     __/ |
+ *                                    |___/
+ */
+
+/** @brief Compact date and time value.
+*
+* Stored as seconds since 1970-01-01 00:00:00 in the same calendar as gnu::Date (no time zone).\n
+* It compares and hashes as an integer so it can be used as key in sorted vectors and hash maps.\n
+* Default object is invalid and is less than all valid dates.\n
+*/
+class DateKey {
+public:
+    static const int64_t        INVALID = INT64_MIN;
+
+                                DateKey()
+                                    { _sec = DateKey::INVALID; } ///< @brief Create invalid key.
+    explicit                    DateKey(const Date& date);
+                                DateKey(int year, int month, int day, int hour = 0, int min = 0, int sec = 0);
+    bool                        operator<(const DateKey& other) const
+                                    { return _sec < other._sec; } ///< @brief Compare keys.
+    bool                        operator<=(const DateKey& other) const
+                                    { return _sec <= other._sec; } ///< @brief Compare keys.
+    bool                        operator>(const DateKey& other) const
+                                    { return _sec > other._sec; } ///< @brief Compare keys.
+    bool                        operator>=(const DateKey& other) const
+                                    { return _sec >= other._sec; } ///< @brief Compare keys.
+    bool                        operator==(const DateKey& other) const
+                                    { return _sec == other._sec; } ///< @brief Compare keys.
+    bool                        operator!=(const DateKey& other) const
+                                    { return _sec != other._sec; } ///< @brief Compare keys.
+    int64_t                     days() const;
+    size_t                      hash() const
+                                    { return std::hash<int64_t>()(_sec); } ///< @brief Return hash value.
+    bool                        is_invalid() const
+                                    { return _sec == DateKey::INVALID; } ///< @brief Is key invalid?
+    int64_t                     seconds() const
+                                    { return _sec; } ///< @brief Return seconds since 1970-01-01 00:00:00.
+    Date                        to_date() const;
+
+    static inline DateKey       FromSeconds(int64_t seconds)
+                                    { auto res = DateKey(); res._sec = seconds; return res; } ///< @brief Create key from seconds since 1970-01-01 00:00:00, no range check.
+
+private:
+    int64_t                     _sec;       ///< @brief Seconds since 1970-01-01 00:00:00.
+};
+
+/*
+ *      _____        _       _____
+ *     |  __ \      | |     |  __ \
+ *     | |  | | __ _| |_ ___| |__) |_ _ _ __ ___  ___ _ __
+ *     | |  | |/ _` | __/ _ \  ___/ _` | '__/ __|/ _ \ '__|
+ *     | |__| | (_| | ||  __/ |  | (_| | |  \__ \  __/ |
+ *     |_____/ \__,_|\__\___|_|   \__,_|_|  |___/\___|_|
+ *
+ *
+ */
+
+/** @brief Parse many date strings with the same format.
+*
+* Format is detected once, from a sample string or the first string in a column.\n
+* Fixed width formats ("YYYYMMDD", "YYYY-MM-DD", "YYYYMMDD HHMMSS", "YYYYMMDD HH:MM:SS" and "YYYY-MM-DD HH:MM:SS")\n
+* are parsed with a fast path that converts all digits before doing any range check.\n
+* Strings that don't match the detected format are parsed with Date::set() so the result is always the same as for Date(string).\n
+* Trailing white space is ignored.\n
+*/
+class DateParser {
+public:
+    explicit                    DateParser(Date::US us = Date::US::OFF);
+    explicit                    DateParser(Date::Format format, Date::US us = Date::US::OFF);
+    bool                        detect(const std::string& sample)
+                                    { return detect(sample.c_str(), sample.length()); } ///< @brief Detect format from sample string. @param[in] sample  Date string. @return True if a fixed width format was found.
+    bool                        detect(const char* sample, size_t len);
+    bool                        is_fixed() const
+                                    { return _layout >= 0; } ///< @brief Is a fixed width format in use?
+    const char*                 layout() const;
+    DateKey                     parse(const std::string& string) const
+                                    { return parse(string.c_str(), string.length()); } ///< @brief Parse one date string. @param[in] string  Date string. @return Key, invalid if string is not a date.
+    DateKey                     parse(const char* string, size_t len) const;
+    std::vector<DateKey>        parse(const std::vector<std::string>& column);
+    DateKey                     parse_fixed(const std::string& string) const
+                                    { return parse_fixed(string.c_str(), string.length()); } ///< @brief Parse one date string with fixed width format only. @param[in] string  Date string. @return Key, invalid if string does not match the fixed width format.
+    DateKey                     parse_fixed(const char* string, size_t len) const;
+    void                        reset()
+                                    { _layout = -1; _detected = false; } ///< @brief Forget detected format.
+
+private:
+    int                         _layout;    ///< @brief Index of fixed width layout or -1.
+    Date::US                    _us;        ///< @brief US or world format for generic parsing.
+    bool                        _detected;  ///< @brief True if format has been detected or set.
+};
+
+/*
+ *      _____        _        _____           _
+ *     |  __ \      | |      / ____|         | |
+ *     | |  | | __ _| |_ ___| |     __ _  ___| |__   ___
+ *     | |  | |/ _` | __/ _ \ |    / _` |/ __| '_ \ / _ \
+ *     | |__| | (_| | ||  __/ |___| (_| | (__| | | |  __/
+ *     |_____/ \__,_|\__\___|\_____\__,_|\___|_| |_|\___|
+ *
+ *
+ */
+
+/** @brief Small cache for formatted date strings.
+*
+* Direct mapped cache keyed by DateKey and Date::Format.\n
+* All memory is allocated in the constructor so format() never allocates.\n
+* Returned string is valid until next call to format() or clear().\n
+*/
+class DateCache {
+public:
+    static const size_t         TEXT_SIZE = 40;
+
+    explicit                    DateCache(size_t size = 256);
+    void                        clear();
+    const char*                 format(const DateKey& key, Date::Format format = Date::Format::ISO);
+    const char*                 format(const Date& date, Date::Format format = Date::Format::ISO)
+                                    { return this->format(date.key(), format); } ///< @brief Format date. @param[in] date  Date. @param[in] format  Format specifier. @return Formatted string.
+    size_t                      hits() const
+                                    { return _hits; } ///< @brief Number of cache hits.
+    size_t                      misses() const
+                                    { return _misses; } ///< @brief Number of cache misses.
+    size_t                      size() const
+                                    { return _slots.size(); } ///< @brief Number of slots.
+
+private:
+    /** @brief One cached string.
+    *
+    */
+    struct Slot {
+        int64_t                 key;                ///< @brief Key seconds.
+        int                     format;             ///< @brief Format or -1 for empty slot.
+        char                    text[TEXT_SIZE];    ///< @brief Formatted string.
+    };
+
+    size_t                      _hits;      ///< @brief Number of cache hits.
+    size_t                      _misses;    ///< @brief Number of cache misses.
+    std::vector<Slot>           _slots;     ///< @brief Cache slots, size is a power of 2.
+};
+
 } // gnu
 
+/** @brief Hash function so gnu::DateKey can be used in std::unordered_map.
+*
+*/
+namespace std {
+    template<>
+    struct hash<gnu::DateKey> {
+        size_t operator()(const gnu::DateKey& key) const
+            { return key.hash(); } ///< @brief Return hash value.
+    };
+} // std
+
 // MKALGAM_OFF
 
 #endif // GNU_DATE_H
@@ -5,6 +5,11 @@
 * gnu::file namespace has general functions for files and directories.\n
 * gnu::file::Buf class is a simple buffer container.\n
 * gnu::file::File class has common file info data such as name, size, type.\n
+* gnu::file::AsyncWriter class writes files in a background thread.\n
+* gnu::file::Watcher class reports changes for files and directories.\n
+* gnu::file::Process class runs a command and streams its output.\n
+* gnu::file::MMap class maps a file into memory (read only).\n
+* gnu::file::CSVReader class parses CSV data in place, optionally in several threads.\n
 *
 * @author gnuwimp@gmail.com
 * @copyright Released under the GNU General Public License v3.0
@@ -15,21 +20,37 @@
 // MKALGAM_ON
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <filesystem>
 #include <climits>
+#include <cmath>
+#include <cerrno>
 #include <ctime>
 #include <assert.h>
 #include <dirent.h>
 #include <unistd.h>
 
 #ifdef _WIN32
+    #include <fcntl.h>
+    #include <io.h>
     #include <shlobj.h>
     #include <time.h>
 #else
+    #include <errno.h>
+    #include <fcntl.h>
+    #include <poll.h>
+    #include <signal.h>
+    #include <sys/mman.h>
     #include <sys/stat.h>
+    #include <sys/wait.h>
     #include <utime.h>
 #endif
 
+#ifdef __linux__
+    #include <sys/inotify.h>
+#endif
+
 #ifndef PATH_MAX
     #define PATH_MAX 1050
 #endif
@@ -43,6 +64,37 @@ namespace priv {
 
 static std::string          _FILE_STDOUT_NAME = "";
 static std::string          _FILE_STDERR_NAME = "";
+static const size_t         _FILE_CACHE_MAX   = 100000;
+
+/** @brief Cached file info.
+*
+*/
+struct _FileCache {
+    file::File              file;   ///< @brief File info.
+    int64_t                 time;   ///< @brief Time in milliseconds when info was read.
+};
+
+/** @brief Pipe capture state for stdout or stderr.
+*
+* Output is kept in a ring buffer, oldest bytes are dropped when it is full.
+*/
+struct _FilePipe {
+    file::CallbackLine      callback;   ///< @brief Optional line callback, called from the reader thread.
+    void*                   data;       ///< @brief Callback data.
+    int                     fd_orig;    ///< @brief Copy of the original descriptor.
+    int                     fd_read;    ///< @brief Read end of the pipe.
+    std::string             line;       ///< @brief Current line for the callback.
+    std::vector<char>       ring;       ///< @brief Ring buffer.
+    size_t                  start;      ///< @brief Oldest byte in ring buffer.
+    std::atomic<bool>       stop;       ///< @brief Set by close, reader stops when the pipe is idle.
+    size_t                  used;       ///< @brief Number of bytes in ring buffer.
+    std::thread             thread;     ///< @brief Reader thread.
+};
+
+static std::map<std::string, _FileCache> _FILE_CACHE;
+static std::mutex                        _FILE_CACHE_MUTEX;
+static std::atomic<unsigned>             _FILE_CACHE_TTL(0);
+static _FilePipe*                        _FILE_PIPE[3] = { nullptr, nullptr, nullptr };
 
 #ifdef _WIN32
 static char*                _file_from_wide(const wchar_t* wstring);
@@ -50,8 +102,17 @@ static int64_t              _file_time(FILETIME* ft);
 static wchar_t*             _file_to_wide(const char* string);
 #endif
 
+static void                 _file_cache_erase(const std::string& path);
+static bool                 _file_cache_get(const std::string& filename, file::File& file);
+static void                 _file_cache_put(const std::string& filename, const file::File& file);
 static file::Buf            _file_close_redirect(int type);
+#ifndef _WIN32
+static void                 _file_kill(pid_t pid);
+#endif
 static bool                 _file_open_redirect(int type);
+static file::Buf            _file_pipe_close(int type);
+static bool                 _file_pipe_open(int type, size_t max_size, file::CallbackLine callback, void* data);
+static void                 _file_pipe_read(_FilePipe* pipe);
 static unsigned             _file_rand();
 static void                 _file_read(const std::string& path, file::Buf& buf);
 static std::string&         _file_replace_all(std::string& string, const std::string& find, const std::string& replace);
@@ -59,7 +120,82 @@ static void                 _file_read_dir_rec(file::Files& res, file::Files& fi
 static std::string&         _file_replace_all(std::string& string, const std::string& find, const std::string& replace);
 static void                 _file_split_paths(const std::string& filename, std::string& path, std::string& name, std::string& ext);
 static std::string          _file_substr(const std::string& in, std::string::size_type pos, std::string::size_type size = std::string::npos);
+static void                 _file_sync_dir(const std::string& path);
 static std::string          _file_to_absolute_path(const std::string& filename, bool realpath);
+static std::string          _file_work_dir();
+static size_t               _file_write_batch(std::map<std::string, file::Buf>& jobs, bool atomic, bool flush);
+
+/** @brief Remove cached file info.
+*
+* Called by functions that change files.\n
+* Both the given path and the resolved path are removed so info cached for the link target is also dropped.\n
+*
+* @param[in] path  Path to file.
+*/
+static void _file_cache_erase(const std::string& path) {
+    if (_FILE_CACHE_TTL == 0 || path == "") {
+        return;
+    }
+
+    auto filename = _file_to_absolute_path(path, false);
+    auto resolved = _file_to_absolute_path(path, true);
+    std::lock_guard<std::mutex> lock(_FILE_CACHE_MUTEX);
+    _FILE_CACHE.erase(filename);
+    _FILE_CACHE.erase(resolved);
+}
+
+/** @brief Get cached file info.
+*
+* @param[in]  filename  Absolute filename.
+* @param[out] file      Cached info.
+*
+* @return True if found and not too old.
+*/
+static bool _file_cache_get(const std::string& filename, file::File& file) {
+    auto ttl = _FILE_CACHE_TTL.load();
+
+    if (ttl == 0) {
+        return false;
+    }
+
+    auto now = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    std::lock_guard<std::mutex> lock(_FILE_CACHE_MUTEX);
+    auto it = _FILE_CACHE.find(filename);
+
+    if (it == _FILE_CACHE.end()) {
+        return false;
+    }
+    else if (now - it->second.time > static_cast<int64_t>(ttl)) {
+        _FILE_CACHE.erase(it);
+        return false;
+    }
+
+    file = it->second.file;
+    return true;
+}
+
+/** @brief Save file info in cache.
+*
+* Cache is cleared if it gets too large.\n
+* Missing files are not cached so a file created by another process is seen at once.\n
+*
+* @param[in] filename  Absolute filename.
+* @param[in] file      File info.
+*/
+static void _file_cache_put(const std::string& filename, const file::File& file) {
+    if (_FILE_CACHE_TTL == 0 || file.type() == file::Type::MISSING) {
+        return;
+    }
+
+    auto now = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    std::lock_guard<std::mutex> lock(_FILE_CACHE_MUTEX);
+
+    if (_FILE_CACHE.size() >= _FILE_CACHE_MAX) {
+        _FILE_CACHE.clear();
+    }
+
+    _FILE_CACHE[filename] = _FileCache{file, now};
+}
 
 /** @brief Close redirect.
 *
@@ -68,6 +204,10 @@ static std::string          _file_to_absolute_path(const std::string& filename,
 * @return Read bytes from file.
 */
 static file::Buf _file_close_redirect(int type) {
+    if (priv::_FILE_PIPE[type] != nullptr) {
+        return priv::_file_pipe_close(type);
+    }
+
     std::string fname;
     FILE* fhandle;
 
@@ -116,6 +256,20 @@ static char* _file_from_wide(const wchar_t* wstring) {
 }
 #endif
 
+#ifndef _WIN32
+/** @brief Kill process group.
+*
+* Kills only the process if the group does not exist.
+*
+* @param[in] pid  Process id and process group id.
+*/
+static void _file_kill(pid_t pid) {
+    if (::kill(-pid, SIGKILL) != 0) {
+        ::kill(pid, SIGKILL);
+    }
+}
+#endif
+
 /** @brief Open redirect.
 *
 * Open result file.
@@ -129,6 +283,10 @@ static bool _file_open_redirect(int type) {
     std::string fname;
     FILE* fhandle = nullptr;
 
+    if (priv::_FILE_PIPE[type] != nullptr) {
+        return res;
+    }
+
     if (type == 2) {
         if (priv::_FILE_STDERR_NAME != "") return res;
         fname = priv::_FILE_STDERR_NAME = file::tmp_file("stderr_").filename();
@@ -161,6 +319,211 @@ static bool _file_open_redirect(int type) {
     return res;
 }
 
+/** @brief Stop pipe capture and restore descriptor.
+*
+* Restoring the descriptor closes our write end of the pipe.\n
+* If another process still holds a write end the reader stops when the pipe has been idle for a short time.\n
+*
+* @param[in] type  1 (stdout) or 2 (stderr).
+*
+* @return Captured bytes, at most max_size bytes.
+*/
+static file::Buf _file_pipe_close(int type) {
+    auto pipe = priv::_FILE_PIPE[type];
+
+    if (pipe == nullptr) {
+        return file::Buf();
+    }
+
+    fflush((type == 2) ? stderr : stdout);
+    ::dup2(pipe->fd_orig, type); // Closes write end of pipe so reader gets end of file.
+    pipe->stop = true;
+    pipe->thread.join();
+    ::close(pipe->fd_orig);
+    ::close(pipe->fd_read);
+
+    auto res = file::Buf(pipe->used);
+
+    for (size_t f = 0; f < pipe->used; f++) {
+        res.str()[f] = pipe->ring[(pipe->start + f) % pipe->ring.size()];
+    }
+
+    priv::_FILE_PIPE[type] = nullptr;
+    delete pipe;
+
+    return res;
+}
+
+/** @brief Redirect stdout or stderr to a pipe.
+*
+* A thread reads the pipe and saves data in a ring buffer.
+*
+* @param[in] type      1 (stdout) or 2 (stderr).
+* @param[in] max_size  Size of ring buffer.
+* @param[in] callback  Optional line callback.
+* @param[in] data      Callback data.
+*
+* @return True if ok.
+*/
+static bool _file_pipe_open(int type, size_t max_size, file::CallbackLine callback, void* data) {
+    auto fhandle = (type == 2) ? stderr : stdout;
+    int  fds[2];
+
+    if (max_size == 0 || priv::_FILE_PIPE[type] != nullptr || (type == 1 && priv::_FILE_STDOUT_NAME != "") || (type == 2 && priv::_FILE_STDERR_NAME != "")) {
+        return false;
+    }
+
+    fflush(fhandle);
+
+#ifdef _WIN32
+    if (_pipe(fds, 65536, _O_BINARY | _O_NOINHERIT) != 0) {
+        return false;
+    }
+#else
+    if (::pipe(fds) != 0) {
+        return false;
+    }
+
+    ::fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+    ::fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+#endif
+
+    auto fd_orig = ::dup(type);
+
+#ifndef _WIN32
+    if (fd_orig >= 0) {
+        ::fcntl(fd_orig, F_SETFD, FD_CLOEXEC);
+    }
+#endif
+
+    if (fd_orig < 0 || ::dup2(fds[1], type) < 0) {
+        if (fd_orig >= 0) {
+            ::close(fd_orig);
+        }
+
+        ::close(fds[0]);
+        ::close(fds[1]);
+        return false;
+    }
+
+    ::close(fds[1]);
+
+    auto pipe = new _FilePipe();
+
+    pipe->callback = callback;
+    pipe->data     = data;
+    pipe->fd_orig  = fd_orig;
+    pipe->fd_read  = fds[0];
+    pipe->start    = 0;
+    pipe->stop     = false;
+    pipe->used     = 0;
+    pipe->ring.resize(max_size);
+    pipe->thread   = std::thread(priv::_file_pipe_read, pipe);
+
+    priv::_FILE_PIPE[type] = pipe;
+    return true;
+}
+
+/** @brief Read pipe until it is closed.
+*
+* After close has been requested it also stops when no data has arrived for 100 ms,\n
+* or after 2 seconds, so a child process that inherited stdout can not block it.\n
+* Windows has no poll() for pipes so PeekNamedPipe() is called every 10 ms instead.\n
+*
+* @param[in] pipe  Pipe state.
+*/
+static void _file_pipe_read(_FilePipe* pipe) {
+    char    buf[4096];
+    auto    size = pipe->ring.size();
+    int64_t stop = 0;
+#ifdef _WIN32
+    int     idle = 0;
+#endif
+
+    while (true) {
+#ifdef _WIN32
+        DWORD avail = 0;
+
+        if (PeekNamedPipe((HANDLE) _get_osfhandle(pipe->fd_read), nullptr, 0, nullptr, &avail, nullptr) == FALSE) {
+            break; // All write handles has been closed.
+        }
+        else if (avail == 0) {
+            if (pipe->stop == true) {
+                if (idle >= 100) {
+                    break;
+                }
+
+                idle += 10;
+            }
+
+            Sleep(10);
+            continue;
+        }
+
+        idle = 0;
+#else
+        struct pollfd pfd = { pipe->fd_read, POLLIN, 0 };
+        auto          ready = ::poll(&pfd, 1, 100);
+
+        if (ready < 0 && errno == EINTR) {
+            continue;
+        }
+        else if (ready == 0) {
+            if (pipe->stop == true) {
+                break;
+            }
+
+            continue;
+        }
+#endif
+
+        if (pipe->stop == true) {
+            auto now = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+
+            if (stop == 0) {
+                stop = now;
+            }
+            else if (now - stop > 2000) {
+                break;
+            }
+        }
+
+        auto len = ::read(pipe->fd_read, buf, sizeof(buf));
+
+        if (len <= 0) {
+            break;
+        }
+
+        for (auto f = 0; f < len; f++) {
+            auto c = buf[f];
+
+            if (pipe->used < size) {
+                pipe->ring[(pipe->start + pipe->used) % size] = c;
+                pipe->used++;
+            }
+            else {
+                pipe->ring[pipe->start] = c;
+                pipe->start = (pipe->start + 1) % size;
+            }
+
+            if (pipe->callback != nullptr) {
+                if (c == '\n') {
+                    pipe->callback(pipe->line.c_str(), pipe->line.size(), pipe->data);
+                    pipe->line.clear();
+                }
+                else if (c != '\r') {
+                    pipe->line += c;
+                }
+            }
+        }
+    }
+
+    if (pipe->callback != nullptr && pipe->line.size() > 0) {
+        pipe->callback(pipe->line.c_str(), pipe->line.size(), pipe->data);
+        pipe->line.clear();
+    }
+}
+
 /** @brief Generate random number.
 *
 * @return Random number.
@@ -347,6 +710,25 @@ static std::string _file_substr(const std::string& string, std::string::size_typ
     }
 }
 
+/** @brief Sync directory entries to disk.
+*
+* Makes a rename in the directory durable, does nothing on windows.
+*
+* @param[in] path  Path to directory.
+*/
+static void _file_sync_dir(const std::string& path) {
+#ifdef _WIN32
+    (void) path;
+#else
+    auto fd = ::open(path.c_str(), O_RDONLY);
+
+    if (fd >= 0) {
+        fsync(fd);
+        ::close(fd);
+    }
+#endif
+}
+
 #ifdef _WIN32
 /** @brief Convert FILETIME to seconds.
 *
@@ -387,9 +769,7 @@ static std::string _file_to_absolute_path(const std::string& filename, bool real
         return name;
     }
     else if (name.size() < 2 || name[1] != ':') {
-        auto work = file::File(file::work_dir());
-
-        res = work.filename();
+        res = priv::_file_work_dir();
         res += "\\";
         res += name;
     }
@@ -412,8 +792,7 @@ static std::string _file_to_absolute_path(const std::string& filename, bool real
     }
 #else
     if (name[0] != '/') {
-        auto work = file::File(file::work_dir());
-        res = work.filename();
+        res = priv::_file_work_dir();
         res += "/";
         res += name;
     }
@@ -432,11 +811,51 @@ static std::string _file_to_absolute_path(const std::string& filename, bool real
     while (res.size() > 1 && res.back() == '/') {
         res.pop_back();
     }
+
+    if (realpath == true) {
+        auto tmp = ::realpath(res.c_str(), nullptr);
+
+        if (tmp != nullptr) {
+            res = tmp;
+            free(tmp);
+        }
+
+        return res;
+    }
 #endif
 
     return (realpath == true) ? file::canonical(res).filename() : res;
 }
 
+/** @brief Get current working directory without reading any file info.
+*
+* @return Working directory or "." for any error.
+*/
+static std::string _file_work_dir() {
+    auto res = std::string(".");
+
+#ifdef _WIN32
+    auto wpath = _wgetcwd(nullptr, 0);
+
+    if (wpath != nullptr) {
+        auto path = priv::_file_from_wide(wpath);
+
+        res = path;
+        free(wpath);
+        free(path);
+    }
+#else
+    auto path = getcwd(nullptr, 0);
+
+    if (path != nullptr) {
+        res = path;
+        free(path);
+    }
+#endif
+
+    return res;
+}
+
 #ifdef _WIN32
 /** @brief Convert utf to wide.
 *
@@ -454,6 +873,84 @@ static wchar_t* _file_to_wide(const char* string) {
 }
 #endif
 
+/** @brief Write a batch of files.
+*
+* All files are written and flushed first, then they are renamed (in atomic mode).\n
+* Last step is to sync every changed directory once.\n
+*
+* @param[in] jobs    Path and buffer for every file.
+* @param[in] atomic  True to write to a temporary file and rename it.
+* @param[in] flush   True to flush files and directories to disk.
+*
+* @return Number of failed writes.
+*/
+static size_t _file_write_batch(std::map<std::string, file::Buf>& jobs, bool atomic, bool flush) {
+    auto dirs    = std::vector<std::string>();
+    auto renames = std::vector<std::string>();
+    auto res     = (size_t) 0;
+
+    for (auto& job : jobs) {
+        auto dest = file::File(job.first);
+
+        if (dest.type() == file::Type::DIR) {
+            res++;
+            continue;
+        }
+
+        auto tmpfile = (atomic == true) ? dest.filename() + ".~tmp" : dest.filename();
+        auto file    = file::open(tmpfile, "wb");
+
+        if (file == nullptr) {
+            res++;
+            continue;
+        }
+
+        auto size  = job.second.size();
+        auto wrote = (size > 0) ? fwrite(job.second.c_str(), 1, size, file) : 0;
+
+        if (flush == true) {
+            file::flush(file);
+        }
+
+        fclose(file);
+        priv::_file_cache_erase(tmpfile);
+
+        if (wrote != size) {
+            if (atomic == true) { // Never remove the destination file.
+                file::remove(tmpfile);
+            }
+
+            res++;
+            continue;
+        }
+
+        if (atomic == true) {
+            renames.push_back(dest.filename());
+        }
+
+        if (std::find(dirs.begin(), dirs.end(), dest.path()) == dirs.end()) {
+            dirs.push_back(dest.path());
+        }
+    }
+
+    for (const auto& path : renames) {
+        auto tmpfile = path + ".~tmp";
+
+        if (file::rename(tmpfile, path) == false) {
+            file::remove(tmpfile);
+            res++;
+        }
+    }
+
+    if (flush == true) {
+        for (const auto& dir : dirs) {
+            priv::_file_sync_dir(dir);
+        }
+    }
+
+    return res;
+}
+
 } // gnu::priv
 } // gnu
 
@@ -591,6 +1088,8 @@ bool gnu::file::chmod(const std::string& path, int mode) {
     res = ::chmod(path.c_str(), mode) == 0;
 #endif
 
+    priv::_file_cache_erase(path);
+
     return res;
 }
 
@@ -632,11 +1131,15 @@ bool gnu::file::chtime(const std::string& path, int64_t time) {
     res        = utime(path.c_str(), &ut) == 0;
 #endif
 
+    priv::_file_cache_erase(path);
+
     return res;
 }
 
 /** @brief Close redirect.
 *
+* Works for both file and pipe redirection.
+*
 * @return Data from stderr.
 */
 gnu::file::Buf gnu::file::close_stderr() {
@@ -645,6 +1148,8 @@ gnu::file::Buf gnu::file::close_stderr() {
 
 /** @brief Close redirect.
 *
+* Works for both file and pipe redirection.
+*
 * @return Data from stdout.
 */
 gnu::file::Buf gnu::file::close_stdout() {
@@ -891,26 +1396,66 @@ gnu::file::File gnu::file::linkname(const std::string& path) {
 #endif
 }
 
-/** @brief Create a directory.
+/**
+* @brief Create file info objects for many paths.
 *
-* Default file mode is file::DEFAULT_DIR_MODE.
+* Working directory is only read once for relative paths.
 *
-* @param[in] path  Path to directory.
+* @param[in] paths     Paths to files or directories.
+* @param[in] realpath  True to find the canonical path to the files.
 *
-* @return True if ok.
+* @return Vector with files, same order as input.
 */
-bool gnu::file::mkdir(const std::string& path) {
-    bool res = false;
+gnu::file::Files gnu::file::make_files(const std::vector<std::string>& paths, bool realpath) {
+    auto res  = Files();
+    auto work = std::string();
 
-#ifdef _WIN32
-    auto wpath = priv::_file_to_wide(path.c_str());
+    res.reserve(paths.size());
 
-    res = _wmkdir(wpath) == 0;
-    free(wpath);
+    for (const auto& path : paths) {
+#ifdef _WIN32
+        auto relative = path.size() > 0 && (path.size() < 2 || path[1] != ':') && path.find("\\\\") != 0;
 #else
-    res = ::mkdir(path.c_str(), file::DEFAULT_DIR_MODE) == 0;
+        auto relative = path.size() > 0 && path[0] != '/';
 #endif
 
+        if (relative == true) {
+            if (work == "") {
+                work = priv::_file_work_dir();
+            }
+
+            res.push_back(File(work + "/" + path, realpath));
+        }
+        else {
+            res.push_back(File(path, realpath));
+        }
+    }
+
+    return res;
+}
+
+/** @brief Create a directory.
+*
+* Default file mode is file::DEFAULT_DIR_MODE.
+*
+* @param[in] path  Path to directory.
+*
+* @return True if ok.
+*/
+bool gnu::file::mkdir(const std::string& path) {
+    bool res = false;
+
+#ifdef _WIN32
+    auto wpath = priv::_file_to_wide(path.c_str());
+
+    res = _wmkdir(wpath) == 0;
+    free(wpath);
+#else
+    res = ::mkdir(path.c_str(), file::DEFAULT_DIR_MODE) == 0;
+#endif
+
+    priv::_file_cache_erase(path);
+
     return res;
 }
 
@@ -1020,7 +1565,7 @@ gnu::file::Files gnu::file::read_dir(const std::string& path) {
     auto file = File(path, false);
     auto res  = Files();
 
-    if (file.type() != Type::DIR || file::is_circular(path) == true) {
+    if (file.type() != Type::DIR || (file.is_link() == true && file::is_circular(path) == true)) {
         return res;
     }
 
@@ -1097,6 +1642,23 @@ bool gnu::file::redirect_stderr() {
     return priv::_file_open_redirect(2);
 }
 
+/** @brief Redirect stderr to a pipe that is read by a background thread.
+*
+* No file is used, output is kept in memory and is returned by close_stderr().\n
+* Only the last max_size bytes are kept.\n
+* The callback is called from the reader thread for every line, so it must be thread safe.\n
+* From a FLTK program use Fl::lock()/Fl::unlock() or Fl::awake() in the callback before touching any widget.\n
+*
+* @param[in] max_size  Max number of bytes to keep.
+* @param[in] callback  Optional callback for every line of output.
+* @param[in] data      Callback data.
+*
+* @return True if ok.
+*/
+bool gnu::file::redirect_stderr(size_t max_size, CallbackLine callback, void* data) {
+    return priv::_file_pipe_open(2, max_size, callback, data);
+}
+
 /** @brief Redirecting stdout to file.
 *
 * @return True if ok.
@@ -1105,6 +1667,22 @@ bool gnu::file::redirect_stdout() {
     return priv::_file_open_redirect(1);
 }
 
+/** @brief Redirect stdout to a pipe that is read by a background thread.
+*
+* No file is used, output is kept in memory and is returned by close_stdout().\n
+* The buffering mode of stdout is not changed, call fflush(stdout) if lines must reach the callback at once.\n
+* See redirect_stderr(size_t, CallbackLine, void*).\n
+*
+* @param[in] max_size  Max number of bytes to keep.
+* @param[in] callback  Optional callback for every line of output.
+* @param[in] data      Callback data.
+*
+* @return True if ok.
+*/
+bool gnu::file::redirect_stdout(size_t max_size, CallbackLine callback, void* data) {
+    return priv::_file_pipe_open(1, max_size, callback, data);
+}
+
 /** @brief Remove file or directory.
 *
 * @param[in] path  Path to file/directory.
@@ -1155,6 +1733,8 @@ bool gnu::file::remove(const std::string& path) {
     }
 #endif
 
+    priv::_file_cache_erase(path);
+
     return res;
 }
 
@@ -1225,6 +1805,9 @@ bool gnu::file::rename(const std::string& from, const std::string& to) {
     res = ::rename(from_f.filename().c_str(), to_f.filename().c_str()) == 0;
 #endif
 
+    priv::_file_cache_erase(from);
+    priv::_file_cache_erase(to);
+
     return res;
 }
 
@@ -1279,6 +1862,39 @@ int gnu::file::run(const std::string& cmd, bool background, bool hide_win32_wind
 #endif
 }
 
+/**
+* @brief Turn on or off caching of file info.
+*
+* When it is on, File objects for the same path share the info for ttl_ms milliseconds.\n
+* Functions in this namespace that change files remove their cached info.\n
+* Changes by other processes are seen when the info has expired.\n
+* Cache is off by default.\n
+*
+* @param[in] ttl_ms  Time to keep file info, 0 to turn off cache and clear it.
+*/
+void gnu::file::stat_cache(unsigned ttl_ms) {
+    priv::_FILE_CACHE_TTL = ttl_ms;
+
+    if (ttl_ms == 0) {
+        file::stat_cache_clear();
+    }
+}
+
+/**
+* @brief Remove cached file info.
+*
+* @param[in] path  Path to remove, empty string to clear all.
+*/
+void gnu::file::stat_cache_clear(const std::string& path) {
+    if (path == "") {
+        std::lock_guard<std::mutex> lock(priv::_FILE_CACHE_MUTEX);
+        priv::_FILE_CACHE.clear();
+    }
+    else {
+        priv::_file_cache_erase(path);
+    }
+}
+
 /** @brief Get temp directory.
 *
 * @return Tmp path.
@@ -1738,12 +2354,19 @@ gnu::file::File::File(const std::string& path, bool realpath) {
 
     if (path != "") {
         _filename = priv::_file_to_absolute_path(path, realpath);
+
+        if (priv::_file_cache_get(_filename, *this) == true) {
+            return;
+        }
+
         priv::_file_split_paths(_filename, _path, _name, _ext);
     }
     else {
         return;
     }
 
+    auto key = _filename;
+
 #ifdef _WIN32
     auto wpath = priv::_file_to_wide(_filename.c_str());
 
@@ -1796,12 +2419,18 @@ gnu::file::File::File(const std::string& path, bool realpath) {
     free(wpath);
 #else
     struct stat st;
-    char        tmp[PATH_MAX + 1];
+    auto        found = ::lstat(_filename.c_str(), &st) == 0;
+
+    if (found == true && S_ISLNK(st.st_mode)) { // Only links need a second call.
+        _link = true;
+        found = ::stat(_filename.c_str(), &st) == 0;
+    }
 
-    if (::stat(_filename.c_str(), &st) == 0) {
+    if (found == true) {
         _size  = st.st_size;
         _ctime = st.st_ctime;
         _mtime = st.st_mtime;
+        _mode  = st.st_mode & 0777;
 
         if (S_ISDIR(st.st_mode)) {
             _type = Type::DIR;
@@ -1812,30 +2441,14 @@ gnu::file::File::File(const std::string& path, bool realpath) {
         else {
             _type = Type::OTHER;
         }
-
-        snprintf(tmp, PATH_MAX, "%o", st.st_mode);
-        auto l = strlen(tmp);
-
-        if (l > 2) {
-            _mode = strtol(tmp + (l - 3), nullptr, 8);
-        }
-
-        if (lstat(_filename.c_str(), &st) == 0 && S_ISLNK(st.st_mode)) {
-            _link = true;
-        }
-    }
-    else {
-        auto tmp_size = readlink(_filename.c_str(), tmp, PATH_MAX);
-
-        if (tmp_size > 0 && tmp_size < PATH_MAX) {
-            _link = true;
-        }
     }
 #endif
 
     if (_type == Type::DIR) {
         _ext = "";
     }
+
+    priv::_file_cache_put(key, *this);
 }
 
 /**
@@ -1903,4 +2516,1478 @@ std::string gnu::file::File::type_name() const {
     return NAMES[static_cast<size_t>(_type)];
 }
 
+/*
+ *                                __          __   _ _
+ *         /\                     \ \        / /  (_) |
+ *        /  \   ___ _   _ _ __   __\ \  /\  / / __ _| |_ ___ _ __
+ *       / /\ \ / __| | | | '_ \ / __\ \/  \/ / '__| | __/ _ \ '__|
+ *      / ____ \\__ \ |_| | | | | (__ \  /\  /| |  | | ||  __/ |
+ *     /_/    \_\___/\__, |_| |_|\___| \/  \/ |_|  |_|\__\___|_|
+ *                    __/ |
+ *                   |___/
+ */
+
+/**
+* @brief Create writer and start the worker thread.
+*
+* @param[in] atomic  True to write to a temporary file and rename it when it has been written.
+* @param[in] flush   True to flush data to disk.
+*/
+gnu::file::AsyncWriter::AsyncWriter(bool atomic, bool flush) {
+    _atomic = atomic;
+    _busy   = 0;
+    _errors = 0;
+    _flush  = flush;
+    _stop   = false;
+    _thread = std::thread(&AsyncWriter::_run, this);
+}
+
+/**
+* @brief Write all pending jobs and stop worker thread.
+*
+*/
+gnu::file::AsyncWriter::~AsyncWriter() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+
+    _work.notify_one();
+    _thread.join();
+}
+
+/**
+* @brief Worker thread loop.
+*
+* Takes up to MAX_BATCH jobs from the queue and writes them as one batch.\n
+* Exits when the writer is stopped and the queue is empty.\n
+*/
+void gnu::file::AsyncWriter::_run() {
+    while (true) {
+        auto jobs = std::map<std::string, Buf>();
+
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+
+            _work.wait(lock, [this] { return _stop == true || _jobs.empty() == false; });
+
+            if (_jobs.empty() == true) {
+                return;
+            }
+
+            while (_jobs.empty() == false && jobs.size() < AsyncWriter::MAX_BATCH) {
+                jobs.insert(_jobs.extract(_jobs.begin()));
+            }
+
+            _busy = jobs.size();
+        }
+
+        auto failed = priv::_file_write_batch(jobs, _atomic, _flush);
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _busy    = 0;
+            _errors += failed;
+        }
+
+        _done.notify_all();
+    }
+}
+
+/**
+* @brief Wait until all queued jobs has been written.
+*
+*/
+void gnu::file::AsyncWriter::wait() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _done.wait(lock, [this] { return _jobs.empty() == true && _busy == 0; });
+}
+
+/**
+* @brief Queue buffer for writing.
+*
+* If path is already in the queue the old buffer is replaced.
+*
+* @param[in] path  Destination filename.
+* @param[in] buf   Buffer to write, it is moved to the queue.
+*
+* @return True if job was queued, false if writer is stopping.
+*/
+bool gnu::file::AsyncWriter::write(const std::string& path, Buf&& buf) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        if (_stop == true || path == "") {
+            return false;
+        }
+
+        _jobs[path] = std::move(buf);
+    }
+
+    _work.notify_one();
+    return true;
+}
+
+/*
+ *     __          __   _       _
+ *     \ \        / /  | |     | |
+ *      \ \  /\  / /_ _| |_ ___| |__   ___ _ __
+ *       \ \/  \/ / _` | __/ __| '_ \ / _ \ '__|
+ *        \  /\  / (_| | || (__| | | |  __/ |
+ *         \/  \/ \__,_|\__\___|_| |_|\___|_|
+ *
+ *
+ */
+
+/**
+* @brief Create watcher.
+*
+* @param[in] callback  Callback for events.
+* @param[in] data      Callback data.
+* @param[in] polling   True to compare file time and size even if inotify is available.
+*/
+gnu::file::Watcher::Watcher(CallbackWatch callback, void* data, bool polling) {
+    _callback = callback;
+    _data     = data;
+    _fd       = -1;
+
+#ifdef __linux__
+    if (polling == false) {
+        _fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    }
+#else
+    (void) polling;
+#endif
+}
+
+/**
+* @brief Close inotify descriptor.
+*
+*/
+gnu::file::Watcher::~Watcher() {
+    if (_fd >= 0) {
+        ::close(_fd);
+    }
+}
+
+/**
+* @brief Call callback.
+*
+* @param[in] event  Event type.
+* @param[in] path   Changed file.
+* @param[in] from   Old name for Event::RENAMED.
+*
+* @return 1.
+*/
+size_t gnu::file::Watcher::_emit(Event event, const std::string& path, const std::string& from) {
+    if (_callback != nullptr) {
+        _callback(event, path, from, _data);
+    }
+
+    return 1;
+}
+
+/**
+* @brief Check if file is watched, either by itself or by its parent directory.
+*
+* @param[in] path  Absolute filename.
+*
+* @return True if it is watched.
+*/
+bool gnu::file::Watcher::_is_watched(const std::string& path) const {
+    if (_paths.find(path) != _paths.end()) {
+        return true;
+    }
+
+    auto slash = path.find_last_of('/');
+
+    if (slash == std::string::npos) {
+        return false;
+    }
+
+    auto parent = _paths.find(path.substr(0, slash));
+    return parent != _paths.end() && parent->second == true;
+}
+
+/**
+* @brief Read all pending inotify events.
+*
+* A move inside watched directories is reported as Event::RENAMED.\n
+* Repeated modify events for the same file are merged into one.\n
+*
+* @return Number of delivered events.
+*/
+size_t gnu::file::Watcher::_poll_inotify() {
+    auto res = (size_t) 0;
+
+#ifdef __linux__
+    auto last  = std::string();
+    auto moved = std::map<uint32_t, std::string>();
+
+    alignas(struct inotify_event) char buf[8192];
+
+    while (true) {
+        auto len = ::read(_fd, buf, sizeof(buf));
+
+        if (len <= 0) {
+            break;
+        }
+
+        for (auto p = buf; p < buf + len; ) {
+            auto ev = reinterpret_cast<const struct inotify_event*>(p);
+            p += sizeof(struct inotify_event) + ev->len;
+
+            if (ev->mask & IN_Q_OVERFLOW) {
+                for (const auto& path : _paths) {
+                    res += _emit(Event::MODIFIED, path.first);
+                }
+
+                continue;
+            }
+
+            auto wd = _wds.find(ev->wd);
+
+            if (wd == _wds.end()) {
+                continue;
+            }
+            else if (ev->mask & IN_IGNORED) {
+                _wds.erase(wd);
+                continue;
+            }
+
+            auto dir = wd->second;
+
+            if (ev->mask & (IN_DELETE_SELF | IN_MOVE_SELF)) {
+                if (_paths.find(dir) != _paths.end()) {
+                    res += _emit(Event::DELETED, dir);
+                }
+
+                continue;
+            }
+            else if (ev->len == 0) {
+                continue;
+            }
+
+            auto path    = dir + "/" + ev->name;
+            auto watched = _is_watched(path);
+
+            if (ev->mask & IN_MODIFY) {
+                if (watched == true && path != last) {
+                    res += _emit(Event::MODIFIED, path);
+                    last = path;
+                }
+
+                continue;
+            }
+
+            last = "";
+
+            if (ev->mask & IN_MOVED_FROM) {
+                if (watched == true) {
+                    moved[ev->cookie] = path;
+                }
+            }
+            else if (ev->mask & IN_MOVED_TO) {
+                auto from = moved.find(ev->cookie);
+
+                if (from == moved.end()) {
+                    if (watched == true) {
+                        res += _emit(Event::CREATED, path);
+                    }
+                }
+                else {
+                    if (watched == true) {
+                        res += _emit(Event::RENAMED, path, from->second);
+                    }
+                    else {
+                        res += _emit(Event::DELETED, from->second);
+                    }
+
+                    moved.erase(from);
+                }
+            }
+            else if (watched == false) {
+            }
+            else if (ev->mask & IN_CREATE) {
+                res += _emit(Event::CREATED, path);
+            }
+            else if (ev->mask & IN_DELETE) {
+                res += _emit(Event::DELETED, path);
+            }
+        }
+    }
+
+    for (const auto& from : moved) {
+        res += _emit(Event::DELETED, from.second);
+    }
+#endif
+
+    return res;
+}
+
+/**
+* @brief Compare file time and size for all watched files.
+*
+* Directories are only reported when they are created or deleted.
+*
+* @return Number of delivered events.
+*/
+size_t gnu::file::Watcher::_poll_stat() {
+    auto res   = (size_t) 0;
+    auto stats = std::map<std::string, Stat>();
+
+    for (const auto& path : _paths) {
+        _scan(path.first, path.second, stats);
+    }
+
+    for (const auto& now : stats) {
+        auto old = _stats.find(now.first);
+
+        if (old == _stats.end()) {
+            res += _emit(Event::CREATED, now.first);
+        }
+        else if (now.second.type != Type::DIR && (now.second.mtime != old->second.mtime || now.second.size != old->second.size || now.second.type != old->second.type)) {
+            res += _emit(Event::MODIFIED, now.first);
+        }
+    }
+
+    for (const auto& old : _stats) {
+        if (stats.find(old.first) == stats.end()) {
+            res += _emit(Event::DELETED, old.first);
+        }
+    }
+
+    _stats = std::move(stats);
+    return res;
+}
+
+/**
+* @brief Save current state for a watched file or directory.
+*
+* @param[in]  path    Absolute filename.
+* @param[in]  is_dir  True to save state for all files in directory.
+* @param[out] stats   Result map.
+*/
+void gnu::file::Watcher::_scan(const std::string& path, bool is_dir, std::map<std::string, Stat>& stats) const {
+    auto file = File(path);
+
+    if (file.is_missing() == true) {
+        return;
+    }
+
+    stats[path] = Stat{file.type(), file.mtime(), file.size()};
+
+    if (is_dir == true && file.is_dir() == true) {
+        for (const auto& child : file::read_dir(path)) {
+            stats[child.filename()] = Stat{child.type(), child.mtime(), child.size()};
+        }
+    }
+}
+
+/**
+* @brief Start watching a file or directory.
+*
+* A missing file can be watched if its parent directory exists.
+*
+* @param[in] path  Path to file or directory.
+*
+* @return True if ok.
+*/
+bool gnu::file::Watcher::add(const std::string& path) {
+    auto file = File(path);
+
+    if (file.filename() == "") {
+        return false;
+    }
+    else if (file.is_missing() == true && File(file.path()).is_dir() == false) {
+        return false;
+    }
+    else if (_paths.find(file.filename()) != _paths.end()) {
+        return true;
+    }
+
+    auto is_dir = file.is_dir();
+
+#ifdef __linux__
+    if (_fd >= 0) {
+        auto dir = (is_dir == true) ? file.filename() : file.path();
+        auto wd  = inotify_add_watch(_fd, dir.c_str(), IN_CREATE | IN_DELETE | IN_MODIFY | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF);
+
+        if (wd < 0) {
+            return false;
+        }
+
+        _wds[wd] = dir;
+        _paths[file.filename()] = is_dir;
+        return true;
+    }
+#endif
+
+    _paths[file.filename()] = is_dir;
+    _scan(file.filename(), is_dir, _stats);
+    return true;
+}
+
+/**
+* @brief Return all watched paths.
+*
+* @return Absolute filenames.
+*/
+std::vector<std::string> gnu::file::Watcher::paths() const {
+    auto res = std::vector<std::string>();
+
+    for (const auto& path : _paths) {
+        res.push_back(path.first);
+    }
+
+    return res;
+}
+
+/**
+* @brief Read changes and call callback for every event.
+*
+* Does not block.
+*
+* @return Number of delivered events.
+*/
+size_t gnu::file::Watcher::poll() {
+    return (_fd >= 0) ? _poll_inotify() : _poll_stat();
+}
+
+/**
+* @brief Stop watching a file or directory.
+*
+* @param[in] path  Path to file or directory.
+*
+* @return True if path was watched.
+*/
+bool gnu::file::Watcher::remove(const std::string& path) {
+    auto filename = File(path).filename();
+    auto it       = _paths.find(filename);
+
+    if (it == _paths.end()) {
+        return false;
+    }
+
+    auto is_dir = it->second;
+    _paths.erase(it);
+
+#ifdef __linux__
+    if (_fd >= 0) {
+        auto dir = (is_dir == true) ? filename : filename.substr(0, filename.find_last_of('/'));
+
+        for (const auto& p : _paths) {
+            if ((p.second == true && p.first == dir) || (p.second == false && p.first.substr(0, p.first.find_last_of('/')) == dir)) {
+                return true;
+            }
+        }
+
+        for (auto wd = _wds.begin(); wd != _wds.end(); ++wd) {
+            if (wd->second == dir) {
+                inotify_rm_watch(_fd, wd->first);
+                _wds.erase(wd);
+                break;
+            }
+        }
+
+        return true;
+    }
+#endif
+
+    (void) is_dir;
+
+    for (auto st = _stats.begin(); st != _stats.end(); ) {
+        if (_is_watched(st->first) == false) {
+            st = _stats.erase(st);
+        }
+        else {
+            ++st;
+        }
+    }
+
+    return true;
+}
+
+/*
+ *      _____
+ *     |  __ \
+ *     | |__) | __ ___   ___ ___  ___ ___
+ *     |  ___/ '__/ _ \ / __/ _ \/ __/ __|
+ *     | |   | | | (_) | (_|  __/\__ \__ \
+ *     |_|   |_|  \___/ \___\___||___/___/
+ *
+ *
+ */
+
+/**
+* @brief Create process object, use start() to run a command.
+*
+*/
+gnu::file::Process::Process() {
+    _cancel  = false;
+    _cb_err  = nullptr;
+    _cb_out  = nullptr;
+    _data    = nullptr;
+    _exit    = -1;
+    _lines   = true;
+    _status  = ProcessStatus::READY;
+    _timeout = 0;
+    _wake[0] = -1;
+    _wake[1] = -1;
+}
+
+/**
+* @brief Cancel command and wait for reactor thread.
+*
+*/
+gnu::file::Process::~Process() {
+    cancel();
+    wait();
+}
+
+/**
+* @brief Send output to callback or save it.
+*
+* @param[in] is_err  True for stderr.
+* @param[in] buffer  Output data.
+* @param[in] size    Size of data.
+*/
+void gnu::file::Process::_deliver(bool is_err, const char* buffer, size_t size) {
+    auto  cb  = (is_err == true) ? _cb_err : _cb_out;
+    auto& str = (is_err == true) ? _err : _out;
+
+    if (cb == nullptr) {
+        str.append(buffer, size);
+    }
+    else if (_lines == false) {
+        cb(buffer, size, _data);
+    }
+    else {
+        for (size_t f = 0; f < size; f++) {
+            auto c = buffer[f];
+
+            if (c == '\n') {
+                cb(str.c_str(), str.size(), _data);
+                str.clear();
+            }
+            else if (c != '\r') {
+                str += c;
+            }
+        }
+    }
+}
+
+/**
+* @brief Deliver last lines that did not end with a newline.
+*
+*/
+void gnu::file::Process::_flush() {
+    if (_lines == true && _cb_out != nullptr && _out.size() > 0) {
+        _cb_out(_out.c_str(), _out.size(), _data);
+        _out.clear();
+    }
+
+    if (_lines == true && _cb_err != nullptr && _err.size() > 0) {
+        _cb_err(_err.c_str(), _err.size(), _data);
+        _err.clear();
+    }
+}
+
+/**
+* @brief Reactor thread.
+*
+* Starts command and reads from both pipes until they are closed.\n
+* Kills command on timeout or cancel.\n
+*
+* @param[in] cmd  Command line.
+*/
+void gnu::file::Process::_run(std::string cmd) {
+    char buf[16384];
+    auto start = std::chrono::steady_clock::now();
+    auto state = ProcessStatus::DONE;
+
+#ifdef _WIN32
+    SECURITY_ATTRIBUTES sa;
+    STARTUPINFOW        startup_info;
+    PROCESS_INFORMATION process_info;
+    HANDLE              pipes[2] = { nullptr, nullptr };
+    HANDLE              writes[2] = { nullptr, nullptr };
+
+    ZeroMemory(&sa, sizeof(SECURITY_ATTRIBUTES));
+    ZeroMemory(&startup_info, sizeof(STARTUPINFOW));
+    ZeroMemory(&process_info, sizeof(PROCESS_INFORMATION));
+
+    sa.nLength        = sizeof(SECURITY_ATTRIBUTES);
+    sa.bInheritHandle = TRUE;
+
+    for (auto f = 0; f < 2; f++) {
+        if (CreatePipe(&pipes[f], &writes[f], &sa, 0) == 0) {
+            pipes[f] = writes[f] = nullptr;
+        }
+        else {
+            SetHandleInformation(pipes[f], HANDLE_FLAG_INHERIT, 0);
+        }
+    }
+
+    auto null  = CreateFileW(L"NUL", GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, &sa, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    auto cmd_w = priv::_file_to_wide(cmd.c_str());
+
+    startup_info.cb          = sizeof(STARTUPINFOW);
+    startup_info.dwFlags     = STARTF_USESTDHANDLES | STARTF_USESHOWWINDOW;
+    startup_info.wShowWindow = SW_HIDE;
+    startup_info.hStdInput   = null;
+    startup_info.hStdOutput  = writes[0];
+    startup_info.hStdError   = writes[1];
+
+    auto started = pipes[0] != nullptr && pipes[1] != nullptr && CreateProcessW(nullptr, cmd_w, nullptr, nullptr, TRUE, CREATE_NO_WINDOW, nullptr, nullptr, &startup_info, &process_info) != 0;
+
+    free(cmd_w);
+
+    if (null != INVALID_HANDLE_VALUE) {
+        CloseHandle(null);
+    }
+
+    for (auto f = 0; f < 2; f++) {
+        if (writes[f] != nullptr) {
+            CloseHandle(writes[f]);
+        }
+    }
+
+    if (started == false) {
+        for (auto f = 0; f < 2; f++) {
+            if (pipes[f] != nullptr) {
+                CloseHandle(pipes[f]);
+            }
+        }
+
+        _status = ProcessStatus::FAILED;
+        return;
+    }
+
+    auto open = 2;
+
+    while (open > 0) {
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+        if (_cancel == true || (_timeout > 0 && elapsed >= _timeout)) {
+            state = (_cancel == true) ? ProcessStatus::CANCELED : ProcessStatus::TIMEOUT;
+            TerminateProcess(process_info.hProcess, 1);
+            break;
+        }
+
+        auto got = false;
+
+        for (auto f = 0; f < 2; f++) {
+            DWORD avail = 0;
+            DWORD read  = 0;
+
+            if (pipes[f] == nullptr) {
+                continue;
+            }
+            else if (PeekNamedPipe(pipes[f], nullptr, 0, nullptr, &avail, nullptr) == 0) {
+                CloseHandle(pipes[f]);
+                pipes[f] = nullptr;
+                open--;
+            }
+            else if (avail > 0 && ReadFile(pipes[f], buf, (avail < sizeof(buf)) ? avail : sizeof(buf), &read, nullptr) != 0 && read > 0) {
+                _deliver(f == 1, buf, read);
+                got = true;
+            }
+        }
+
+        if (got == false && open > 0) {
+            Sleep(10);
+        }
+    }
+
+    for (auto f = 0; f < 2; f++) {
+        if (pipes[f] != nullptr) {
+            CloseHandle(pipes[f]);
+        }
+    }
+
+    DWORD rc = 0;
+
+    while (WaitForSingleObject(process_info.hProcess, 10) == WAIT_TIMEOUT) {
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+        if (_cancel == true || (_timeout > 0 && elapsed >= _timeout)) {
+            state = (_cancel == true) ? ProcessStatus::CANCELED : ProcessStatus::TIMEOUT;
+            TerminateProcess(process_info.hProcess, 1);
+            WaitForSingleObject(process_info.hProcess, INFINITE);
+            break;
+        }
+    }
+
+    GetExitCodeProcess(process_info.hProcess, &rc);
+    CloseHandle(process_info.hThread);
+    CloseHandle(process_info.hProcess);
+
+    _exit = (int) rc;
+#else
+    int out[2] = { -1, -1 };
+    int err[2] = { -1, -1 };
+
+    if (::pipe(out) != 0 || ::pipe(err) != 0) {
+        for (auto fd : { out[0], out[1], err[0], err[1] }) {
+            if (fd >= 0) {
+                ::close(fd);
+            }
+        }
+
+        _status = ProcessStatus::FAILED;
+        return;
+    }
+
+    for (auto fd : { out[0], out[1], err[0], err[1] }) {
+        ::fcntl(fd, F_SETFD, FD_CLOEXEC); // Other threads that fork must not inherit the write ends.
+    }
+
+    auto pid = fork();
+
+    if (pid == 0) {
+        auto null = ::open("/dev/null", O_RDONLY);
+
+        setpgid(0, 0);
+        ::dup2(null, 0);
+        ::dup2(out[1], 1);
+        ::dup2(err[1], 2);
+
+        for (auto fd : { null, out[0], out[1], err[0], err[1], _wake[0], _wake[1] }) {
+            ::close(fd);
+        }
+
+        execl("/bin/sh", "sh", "-c", cmd.c_str(), (char*) nullptr);
+        ::_exit(127);
+    }
+
+    ::close(out[1]);
+    ::close(err[1]);
+
+    if (pid < 0) {
+        ::close(out[0]);
+        ::close(err[0]);
+        _status = ProcessStatus::FAILED;
+        return;
+    }
+
+    setpgid(pid, pid); // Also set in parent so kill(-pid) works even if the child has not run yet.
+
+    struct pollfd fds[3];
+
+    fds[0].fd     = out[0];
+    fds[0].events = POLLIN;
+    fds[1].fd     = err[0];
+    fds[1].events = POLLIN;
+    fds[2].fd     = _wake[0];
+    fds[2].events = POLLIN;
+
+    for (auto& fd : fds) {
+        ::fcntl(fd.fd, F_SETFL, ::fcntl(fd.fd, F_GETFL) | O_NONBLOCK);
+    }
+
+    auto open = 2;
+
+    while (open > 0) {
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+        auto wait    = -1;
+
+        if (_timeout > 0) {
+            wait = (elapsed >= _timeout) ? 0 : static_cast<int>(_timeout - elapsed);
+        }
+
+        if (_cancel == true || (_timeout > 0 && elapsed >= _timeout)) {
+            state = (_cancel == true) ? ProcessStatus::CANCELED : ProcessStatus::TIMEOUT;
+            priv::_file_kill(pid);
+            break;
+        }
+
+        auto n = ::poll(fds, 3, wait);
+
+        if (n < 0 && errno != EINTR) {
+            break;
+        }
+        else if (n <= 0) {
+            continue;
+        }
+
+        if (fds[2].revents != 0) {
+            while (::read(_wake[0], buf, sizeof(buf)) > 0) {
+            }
+        }
+
+        for (auto f = 0; f < 2; f++) {
+            if (fds[f].fd < 0 || fds[f].revents == 0) {
+                continue;
+            }
+
+            while (true) {
+                auto len = ::read(fds[f].fd, buf, sizeof(buf));
+
+                if (len > 0) {
+                    _deliver(f == 1, buf, len);
+                }
+                else if (len < 0 && (errno == EAGAIN || errno == EINTR)) {
+                    break;
+                }
+                else {
+                    ::close(fds[f].fd);
+                    fds[f].fd = -1;
+                    open--;
+                    break;
+                }
+            }
+        }
+    }
+
+    for (auto f = 0; f < 2; f++) {
+        if (fds[f].fd >= 0) {
+            ::close(fds[f].fd);
+        }
+    }
+
+    auto rc     = 0;
+    auto killed = state != ProcessStatus::DONE;
+
+    while (true) { // Command can live on after closing its output, so keep checking timeout and cancel.
+        auto res = waitpid(pid, &rc, (killed == true) ? 0 : WNOHANG);
+
+        if (res == pid || (res < 0 && errno != EINTR)) {
+            break;
+        }
+        else if (res < 0) {
+            continue;
+        }
+
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+        if (_cancel == true || (_timeout > 0 && elapsed >= _timeout)) {
+            state  = (_cancel == true) ? ProcessStatus::CANCELED : ProcessStatus::TIMEOUT;
+            killed = true;
+            priv::_file_kill(pid);
+            continue;
+        }
+
+        if (::poll(&fds[2], 1, 10) > 0) {
+            while (::read(_wake[0], buf, sizeof(buf)) > 0) {
+            }
+        }
+    }
+
+    _exit = (WIFEXITED(rc) != 0) ? WEXITSTATUS(rc) : -1;
+#endif
+
+    _flush();
+    _status = state;
+}
+
+/**
+* @brief Stop running command.
+*
+* Command is killed and status is set to ProcessStatus::CANCELED.
+*/
+void gnu::file::Process::cancel() {
+    if (is_running() == false) {
+        return;
+    }
+
+    _cancel = true;
+
+#ifndef _WIN32
+    if (_wake[1] >= 0) {
+        auto r = ::write(_wake[1], "x", 1);
+        (void) r;
+    }
+#endif
+}
+
+/**
+* @brief Start command.
+*
+* @param[in] cmd         Command line.
+* @param[in] cb_out      Callback for stdout, NULL to save it.
+* @param[in] cb_err      Callback for stderr, NULL to save it.
+* @param[in] data        Callback data.
+* @param[in] timeout_ms  Kill command after this time, 0 to wait forever.
+* @param[in] lines       True to deliver lines, false to deliver chunks as they are read.
+*
+* @return True if reactor thread was started, false if a command is already running.
+*/
+bool gnu::file::Process::start(const std::string& cmd, CallbackLine cb_out, CallbackLine cb_err, void* data, unsigned timeout_ms, bool lines) {
+    if (is_running() == true) {
+        return false;
+    }
+
+    wait();
+
+    _cancel  = false;
+    _cb_err  = cb_err;
+    _cb_out  = cb_out;
+    _data    = data;
+    _err     = "";
+    _exit    = -1;
+    _lines   = lines;
+    _out     = "";
+    _timeout = timeout_ms;
+
+#ifndef _WIN32
+    if (::pipe(_wake) != 0) {
+        _wake[0] = _wake[1] = -1;
+        _status  = ProcessStatus::FAILED;
+        return false;
+    }
+
+    ::fcntl(_wake[0], F_SETFL, ::fcntl(_wake[0], F_GETFL) | O_NONBLOCK);
+    ::fcntl(_wake[0], F_SETFD, FD_CLOEXEC);
+    ::fcntl(_wake[1], F_SETFD, FD_CLOEXEC);
+#endif
+
+    _status = ProcessStatus::RUNNING;
+    _thread = std::thread(&Process::_run, this, cmd);
+    return true;
+}
+
+/**
+* @brief Wait for command to finish.
+*
+* @return Status.
+*/
+gnu::file::ProcessStatus gnu::file::Process::wait() {
+    if (_thread.joinable() == true) {
+        _thread.join();
+    }
+
+#ifndef _WIN32
+    for (auto& fd : _wake) {
+        if (fd >= 0) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+#endif
+
+    return _status;
+}
+
+/*
+ *      __  __  __  __
+ *     |  \/  ||  \/  |
+ *     | \  / || \  / |  __ _  _ __
+ *     | |\/| || |\/| | / _` || '_ \
+ *     | |  | || |  | || (_| || |_) |
+ *     |_|  |_||_|  |_| \__,_|| .__/
+ *                            | |
+ *                            |_|
+ */
+
+/**
+* @brief Create object and map file.
+*
+* @param[in] path  File to map, empty string for no file.
+*/
+gnu::file::MMap::MMap(const std::string& path) {
+    _open = false;
+    _data = nullptr;
+    _size = 0;
+    _file = nullptr;
+    _map  = nullptr;
+
+    if (path != "") {
+        open(path);
+    }
+}
+
+/**
+* @brief Tell the system which part of the file will be used.
+*
+* Range is expanded to whole pages.\n
+* Pages that are not needed are dropped from memory and will be read again from the file if they are used.\n
+* On windows only dropping pages is supported.\n
+*
+* @param[in] offset  Start offset.
+* @param[in] size    Number of bytes.
+* @param[in] need    True to start reading pages, false to drop them.
+*/
+void gnu::file::MMap::advise(size_t offset, size_t size, bool need) const {
+    if (_data == nullptr || offset >= _size || size == 0) {
+        return;
+    }
+
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    const size_t PAGE = info.dwPageSize;
+#else
+    const size_t PAGE = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+    const size_t START = offset / PAGE * PAGE;
+    const size_t STOP  = std::min(_size, offset + size);
+    auto         addr  = const_cast<char*>(_data) + START;
+
+#ifdef _WIN32
+    if (need == false) {
+        VirtualUnlock(addr, STOP - START);
+    }
+#else
+    madvise(addr, STOP - START, (need == true) ? MADV_WILLNEED : MADV_DONTNEED);
+#endif
+}
+
+/**
+* @brief Unmap file.
+*
+*/
+void gnu::file::MMap::close() {
+#ifdef _WIN32
+    if (_data != nullptr) {
+        UnmapViewOfFile(_data);
+    }
+
+    if (_map != nullptr) {
+        CloseHandle(_map);
+    }
+
+    if (_file != nullptr) {
+        CloseHandle(_file);
+    }
+#else
+    if (_data != nullptr) {
+        munmap(const_cast<char*>(_data), _size);
+    }
+#endif
+
+    _open = false;
+    _data = nullptr;
+    _size = 0;
+    _file = nullptr;
+    _map  = nullptr;
+}
+
+/**
+* @brief Map file into memory.
+*
+* Previous file is unmapped first.
+*
+* @param[in] path  File to map.
+*
+* @return True if file was mapped (or is empty).
+*/
+bool gnu::file::MMap::open(const std::string& path) {
+    close();
+
+#ifdef _WIN32
+    auto wpath = priv::_file_to_wide(path.c_str());
+    auto file  = CreateFileW(wpath, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    LARGE_INTEGER size;
+
+    free(wpath);
+
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    else if (GetFileSizeEx(file, &size) == 0) {
+        CloseHandle(file);
+        return false;
+    }
+
+    _file = file;
+    _size = static_cast<size_t>(size.QuadPart);
+    _open = true;
+
+    if (_size == 0) {
+        return true;
+    }
+
+    _map = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+    if (_map == nullptr) {
+        close();
+        return false;
+    }
+
+    _data = static_cast<const char*>(MapViewOfFile(_map, FILE_MAP_READ, 0, 0, 0));
+
+    if (_data == nullptr) {
+        close();
+        return false;
+    }
+#else
+    auto fd = ::open(path.c_str(), O_RDONLY);
+    struct stat st;
+
+    if (fd < 0) {
+        return false;
+    }
+    else if (fstat(fd, &st) != 0 || S_ISREG(st.st_mode) == 0) {
+        ::close(fd);
+        return false;
+    }
+
+    _size = static_cast<size_t>(st.st_size);
+    _open = true;
+
+    if (_size > 0) {
+        auto data = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (data == MAP_FAILED) {
+            ::close(fd);
+            close();
+            return false;
+        }
+
+        _data = static_cast<const char*>(data);
+        madvise(data, _size, MADV_SEQUENTIAL);
+    }
+
+    ::close(fd);
+#endif
+
+    return true;
+}
+
+/*
+ *       _____   _____ __      __ _____                    _
+ *      / ____| / ____|\ \    / /|  __ \                  | |
+ *     | |     | (___   \ \  / / | |__) |  ___   __ _   __| |  ___  _ __
+ *     | |      \___ \   \ \/ /  |  _  /  / _ \ / _` | / _` | / _ \| '__|
+ *     | |____  ____) |   \  /   | | \ \ |  __/| (_| || (_| ||  __/| |
+ *      \_____||_____/     \/    |_|  \_\ \___| \__,_| \__,_| \___||_|
+ *
+ *
+ */
+
+/**
+* @brief Convert field to a number.
+*
+* Same result as std::stod() but without creating a string.
+*
+* @return Number or INFINITY if field is not a number.
+*/
+double gnu::file::CSVField::to_double() const {
+    char  buf[64];
+    char* end = nullptr;
+
+    if (len == 0) {
+        return INFINITY;
+    }
+    else if (len >= sizeof(buf)) {
+        auto tmp = to_string();
+        errno = 0;
+        auto res = strtod(tmp.c_str(), &end);
+        return (end == tmp.c_str() || errno == ERANGE) ? INFINITY : res;
+    }
+
+    memcpy(buf, str, len);
+    buf[len] = 0;
+    errno    = 0;
+
+    auto res = strtod(buf, &end);
+    return (end == buf || errno == ERANGE) ? INFINITY : res;
+}
+
+/**
+* @brief Convert field to an integer.
+*
+* @param[in] def  Default value if field is not a number.
+*
+* @return Number or def.
+*/
+int64_t gnu::file::CSVField::to_int(int64_t def) const {
+    char  buf[64];
+    char* end = nullptr;
+
+    if (len == 0 || len >= sizeof(buf)) {
+        return def;
+    }
+
+    memcpy(buf, str, len);
+    buf[len] = 0;
+    errno    = 0;
+
+    auto res = strtoll(buf, &end, 10);
+    return (end == buf || errno == ERANGE) ? def : static_cast<int64_t>(res);
+}
+
+/**
+* @brief Copy field to a string.
+*
+* Doubled quotes are replaced with one quote.
+*
+* @return Field text.
+*/
+std::string gnu::file::CSVField::to_string() const {
+    if (quote == 0) {
+        return std::string(str, len);
+    }
+
+    std::string res;
+
+    res.reserve(len);
+
+    for (size_t f = 0; f < len; f++) {
+        res += str[f];
+
+        if (str[f] == quote && f + 1 < len && str[f + 1] == quote) {
+            f++;
+        }
+    }
+
+    return res;
+}
+
+/**
+* @brief Create CSV reader.
+*
+* @param[in] sep    Field separator, if it is empty then "," is used.
+* @param[in] quote  Quote character, 0 to turn off quoting.
+*/
+gnu::file::CSVReader::CSVReader(const std::string& sep, char quote) {
+    _buf   = nullptr;
+    _quote = quote;
+    _sep   = (sep == "") ? "," : sep;
+    _size  = 0;
+}
+
+/**
+* @brief Get one column from the first rows.
+*
+* Can be used to detect formats before calling parse().
+*
+* @param[in] column    Column index.
+* @param[in] max_rows  Max number of rows to check.
+*
+* @return Column values, rows without that column are not included.
+*/
+std::vector<std::string> gnu::file::CSVReader::column(size_t column, size_t max_rows) const {
+    std::vector<std::string> res;
+    std::vector<CSVField>    fields;
+    size_t                   pos = 0;
+
+    while (pos < _size && max_rows > 0) {
+        auto end = static_cast<const char*>(memchr(_buf + pos, '\n', _size - pos));
+        auto len = (end != nullptr) ? static_cast<size_t>(end - (_buf + pos)) : _size - pos;
+
+        if (_row(_buf + pos, len, fields) > column) {
+            res.push_back(fields[column].to_string());
+        }
+
+        pos += len + 1;
+        max_rows--;
+    }
+
+    return res;
+}
+
+/**
+* @brief Map file.
+*
+* Data is split into one chunk.
+*
+* @param[in] path  CSV file.
+*
+* @return True if file was mapped.
+*/
+bool gnu::file::CSVReader::open(const std::string& path) {
+    if (_mmap.open(path) == false) {
+        set_buffer(nullptr, 0);
+        return false;
+    }
+
+    set_buffer(_mmap.data(), _mmap.size());
+    return true;
+}
+
+/**
+* @brief Parse all chunks.
+*
+* Chunk 0 is parsed in the calling thread and every other chunk in a new thread.\n
+* It returns when all chunks have been parsed.\n
+*
+* @param[in] callback  Callback for every row, must not throw an exception.
+* @param[in] data      Callback data.
+*/
+void gnu::file::CSVReader::parse(CallbackCSV callback, void* data) {
+    std::vector<std::thread> threads;
+
+    if (_chunks.size() == 0) {
+        split(1);
+    }
+
+    for (size_t f = 1; f < _chunks.size(); f++) {
+        threads.push_back(std::thread(&CSVReader::_parse, this, f, callback, data));
+    }
+
+    if (_chunks.size() > 0) {
+        _parse(0, callback, data);
+    }
+
+    for (auto& t : threads) {
+        t.join();
+    }
+}
+
+/**
+* @brief Parse one chunk.
+*
+* @param[in] chunk     Chunk index.
+* @param[in] callback  Row callback.
+* @param[in] data      Callback data.
+*/
+void gnu::file::CSVReader::_parse(size_t chunk, CallbackCSV callback, void* data) const {
+    std::vector<CSVField> fields;
+    size_t                pos  = _chunks[chunk].first;
+    const size_t          stop = _chunks[chunk].second;
+
+    while (pos < stop) {
+        auto end = static_cast<const char*>(memchr(_buf + pos, '\n', stop - pos));
+        auto len = (end != nullptr) ? static_cast<size_t>(end - (_buf + pos)) : stop - pos;
+        auto num = _row(_buf + pos, len, fields);
+
+        if (num > 0) {
+            callback(chunk, fields.data(), num, data);
+        }
+
+        pos += len + 1;
+    }
+}
+
+/**
+* @brief Split one row into fields.
+*
+* @param[in]  row     Start of row.
+* @param[in]  len     Length of row without newline.
+* @param[out] fields  Fields, vector is reused between rows.
+*
+* @return Number of fields, 0 for an empty row.
+*/
+size_t gnu::file::CSVReader::_row(const char* row, size_t len, std::vector<CSVField>& fields) const {
+    const char*  end  = row + len;
+    const char*  pos  = row;
+    const char   SEP  = _sep[0];
+    const size_t SLEN = _sep.length();
+
+    fields.clear();
+
+    if (len > 0 && row[len - 1] == '\r') {
+        end--;
+    }
+
+    if (pos == end) {
+        return 0;
+    }
+
+    while (true) {
+        CSVField field  = { pos, 0, 0 };
+        bool     quoted = false;
+
+        if (_quote != 0 && pos < end && *pos == _quote) { // Find closing quote, doubled quotes are part of the text.
+            auto stop = ++pos;
+
+            while (stop < end) {
+                if (*stop != _quote) {
+                    stop++;
+                }
+                else if (stop + 1 < end && stop[1] == _quote) {
+                    field.quote = _quote;
+                    stop += 2;
+                }
+                else {
+                    break;
+                }
+            }
+
+            field.str = pos;
+            field.len = static_cast<size_t>(stop - pos);
+            pos       = (stop < end) ? stop + 1 : end;
+            quoted    = true;
+        }
+
+        auto next = pos;
+
+        while (next < end) { // Find next separator.
+            next = static_cast<const char*>(memchr(next, SEP, static_cast<size_t>(end - next)));
+
+            if (next == nullptr) {
+                next = end;
+            }
+            else if (SLEN == 1 || (static_cast<size_t>(end - next) >= SLEN && memcmp(next, _sep.c_str(), SLEN) == 0)) {
+                break;
+            }
+            else {
+                next++;
+            }
+        }
+
+        if (quoted == false) {
+            field.len = static_cast<size_t>(next - pos);
+        }
+
+        fields.push_back(field);
+
+        if (next >= end) {
+            break;
+        }
+
+        pos = next + SLEN;
+    }
+
+    return fields.size();
+}
+
+/**
+* @brief Use a buffer owned by the caller.
+*
+* Buffer must be valid until parsing is done.\n
+* Data is split into one chunk.\n
+*
+* @param[in] buffer  CSV data.
+* @param[in] size    Size of data.
+*/
+void gnu::file::CSVReader::set_buffer(const char* buffer, size_t size) {
+    _buf  = buffer;
+    _size = (buffer != nullptr) ? size : 0;
+
+    if (_size >= 3 && memcmp(_buf, "\xEF\xBB\xBF", 3) == 0) {
+        _buf  += 3;
+        _size -= 3;
+    }
+
+    split(1);
+}
+
+/**
+* @brief Split data into chunks at row boundaries.
+*
+* Every chunk is at least MIN_CHUNK bytes, except when there is only one chunk.
+*
+* @param[in] threads  Max number of chunks, 0 for number of cpu cores.
+*
+* @return Number of chunks.
+*/
+size_t gnu::file::CSVReader::split(unsigned threads) {
+    size_t count = (threads == 0) ? std::thread::hardware_concurrency() : threads;
+    size_t pos   = 0;
+
+    count = std::max(static_cast<size_t>(1), std::min(count, _size / MIN_CHUNK));
+    _chunks.clear();
+
+    for (size_t f = 1; f <= count && pos < _size; f++) {
+        auto stop = (f == count) ? _size : _size / count * f;
+
+        if (stop < pos) {
+            stop = pos;
+        }
+
+        if (stop < _size) { // Move stop to after next newline.
+            auto nl = static_cast<const char*>(memchr(_buf + stop, '\n', _size - stop));
+            stop = (nl != nullptr) ? static_cast<size_t>(nl - _buf) + 1 : _size;
+        }
+
+        _chunks.push_back(std::make_pair(pos, stop));
+        pos = stop;
+    }
+
+    return _chunks.size();
+}
+
 // MKALGAM_OFF
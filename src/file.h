@@ -5,6 +5,11 @@
 * gnu::file namespace has general functions for files and directories.\n
 * gnu::file::Buf class is a simple buffer container.\n
 * gnu::file::File class has common file info data such as name, size, type.\n
+* gnu::file::AsyncWriter class writes files in a background thread.\n
+* gnu::file::Watcher class reports changes for files and directories.\n
+* gnu::file::Process class runs a command and streams its output.\n
+* gnu::file::MMap class maps a file into memory (read only).\n
+* gnu::file::CSVReader class parses CSV data in place, optionally in several threads.\n
 *
 * @author gnuwimp@gmail.com
 * @copyright Released under the GNU General Public License v3.0
@@ -21,6 +26,11 @@
 #include <string>
 #include <vector>
 #include <array>
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
 
 /** @brief Classes unrelated to FLTK.
 */
@@ -32,10 +42,41 @@ namespace gnu {
 */
 namespace file {
 
+class AsyncWriter;
+class CSVReader;
 class File;
 class Buf;
+class MMap;
+class Process;
+class Watcher;
+struct CSVField;
+
+/** @brief File change event for Watcher.
+*
+*/
+enum class Event {
+    CREATED,    ///< @brief File was created (or moved into a watched directory).
+    MODIFIED,   ///< @brief File was changed.
+    DELETED,    ///< @brief File was deleted (or moved out from a watched directory).
+    RENAMED,    ///< @brief File was renamed, both old and new name are known.
+};
+
+/** @brief State of a Process.
+*
+*/
+enum class ProcessStatus {
+    READY,      ///< @brief Not started.
+    RUNNING,    ///< @brief Command is running.
+    DONE,       ///< @brief Command has finished, see Process::exit_code().
+    TIMEOUT,    ///< @brief Command was killed because it took too long.
+    CANCELED,   ///< @brief Command was killed by Process::cancel().
+    FAILED,     ///< @brief Command could not be started.
+};
 
 typedef bool (*CallbackCopy)(int64_t size, int64_t copied, void* data); ///< @brief Callback for file copy.
+typedef void (*CallbackLine)(const char* line, size_t size, void* data); ///< @brief Callback for captured output, line is without newline.
+typedef void (*CallbackWatch)(Event event, const std::string& path, const std::string& from, void* data); ///< @brief Callback for file changes, from is only set for Event::RENAMED.
+typedef void (*CallbackCSV)(size_t chunk, const CSVField* fields, size_t count, void* data); ///< @brief Callback for one CSV row, called from a worker thread for chunk > 0.
 typedef std::vector<File> Files;
 
 /*
@@ -81,6 +122,7 @@ void                            flush(FILE* file);
 File                            home_dir();
 bool                            is_circular(const std::string& path);
 File                            linkname(const std::string& path);
+Files                           make_files(const std::vector<std::string>& paths, bool realpath = false);
 bool                            mkdir(const std::string& path);
 FILE*                           open(const std::string& path, const std::string& mode);
 std::string                     os();
@@ -90,11 +132,15 @@ Buf*                            read2(const std::string& path);
 Files                           read_dir(const std::string& path);
 Files                           read_dir_rec(const std::string& path);
 bool                            redirect_stderr();
+bool                            redirect_stderr(size_t max_size, CallbackLine callback = nullptr, void* data = nullptr);
 bool                            redirect_stdout();
+bool                            redirect_stdout(size_t max_size, CallbackLine callback = nullptr, void* data = nullptr);
 bool                            remove(const std::string& path);
 bool                            remove_rec(const std::string& path);
 bool                            rename(const std::string& from, const std::string& to);
 int                             run(const std::string& cmd, bool background, bool hide_win32_window = false);
+void                            stat_cache(unsigned ttl_ms);
+void                            stat_cache_clear(const std::string& path = "");
 File                            tmp_dir();
 File                            tmp_file(const std::string& prepend = "");
 File                            work_dir();
@@ -202,6 +248,7 @@ private:
 /** @brief Portable file information class.
 *
 * Paths in windows are always slashes.\n
+* File info can be cached between objects, see file::stat_cache().\n
 *
 * @snippet file.cpp gnu::file example
 */
@@ -273,6 +320,297 @@ private:
     std::string                 _path;          ///< @brief Path to file, empty if root.
 };
 
+/*
+ *                                __          __   _ _
+ *         /\                     \ \        / /  (_) |
+ *        /  \   ___ _   _ _ __   __\ \  /\  / / __ _| |_ ___ _ __
+ *       / /\ \ / __| | | | '_ \ / __\ \/  \/ / '__| | __/ _ \ '__|
+ *      / ____ \\__ \ |_| | | | | (__ \  /\  /| |  | | ||  __/ |
+ *     /_/    \_\___/\__, |_| |_|\___| \/  \/ |_|  |_|\__\___|_|
+ *                    __/ |
+ *                   |___/
+ */
+
+/** @brief Write files in a background thread.
+*
+* write() puts the buffer in a queue and returns at once, the worker thread does the disk work.\n
+* If the same path is queued again before it has been written, only the last buffer is written.\n
+* In atomic mode data is first written to a temporary file in the same directory, flushed and then renamed over the destination.\n
+* Jobs taken from the queue at the same time are written as one batch.\n
+* Every file is flushed once per batch and every changed directory is synced once per batch (not on windows).\n
+* Destructor writes all pending jobs before it returns.\n
+*/
+class AsyncWriter {
+public:
+    static const size_t         MAX_BATCH = 64;
+
+    explicit                    AsyncWriter(bool atomic = true, bool flush = true);
+                                ~AsyncWriter();
+                                AsyncWriter(const AsyncWriter&) = delete;
+                                AsyncWriter(AsyncWriter&&) = delete;
+    AsyncWriter&                operator=(const AsyncWriter&) = delete;
+    AsyncWriter&                operator=(AsyncWriter&&) = delete;
+    bool                        atomic() const
+                                    { return _atomic; } ///< @brief Is atomic replace turned on?
+    size_t                      errors() const
+                                    { std::lock_guard<std::mutex> lock(_mutex); return _errors; } ///< @brief Return number of failed writes.
+    size_t                      pending() const
+                                    { std::lock_guard<std::mutex> lock(_mutex); return _jobs.size() + _busy; } ///< @brief Return number of jobs that has not been written yet.
+    void                        wait();
+    bool                        write(const std::string& path, Buf&& buf);
+    bool                        write(const std::string& path, const char* buffer, size_t size)
+                                    { return write(path, Buf(buffer, size)); } ///< @brief Copy buffer and queue it for writing. @throws std::string exception on error.
+
+private:
+    void                        _run();
+
+    bool                        _atomic;        ///< @brief Write to temporary file and rename it.
+    bool                        _flush;         ///< @brief Flush files to disk.
+    bool                        _stop;          ///< @brief Stop worker when queue is empty.
+    mutable std::mutex          _mutex;         ///< @brief Lock for queue and state.
+    size_t                      _busy;          ///< @brief Number of jobs in the batch that the worker is writing.
+    size_t                      _errors;        ///< @brief Number of failed writes.
+    std::condition_variable     _done;          ///< @brief Signaled when a batch has been written.
+    std::condition_variable     _work;          ///< @brief Signaled when a job has been queued.
+    std::map<std::string, Buf>  _jobs;          ///< @brief Queued jobs, one per path.
+    std::thread                 _thread;        ///< @brief Worker thread.
+};
+
+/*
+ *      _____
+ *     |  __ \
+ *     | |__) | __ ___   ___ ___  ___ ___
+ *     |  ___/ '__/ _ \ / __/ _ \/ __/ __|
+ *     | |   | | | (_) | (_|  __/\__ \__ \
+ *     |_|   |_|  \___/ \___\___||___/___/
+ *
+ *
+ */
+
+/** @brief Run a command and read stdout and stderr separately.
+*
+* start() returns at once, a reactor thread waits for output with non-blocking reads and delivers it.\n
+* Output is sent to the callbacks either as lines (without newline) or as raw chunks.\n
+* If a callback is NULL that output is saved and can be read with out() or err() after wait().\n
+* Callbacks are called from the reactor thread, in a FLTK program use Fl::lock()/Fl::unlock() or Fl::awake() before touching any widget.\n
+* On unix the command is run with "/bin/sh -c" in its own process group, which is killed on timeout or cancel.\n
+* Destructor cancels a running command and waits for the thread.\n
+*/
+class Process {
+public:
+                                Process();
+                                ~Process();
+                                Process(const Process&) = delete;
+                                Process(Process&&) = delete;
+    Process&                    operator=(const Process&) = delete;
+    Process&                    operator=(Process&&) = delete;
+    void                        cancel();
+    std::string                 err() const
+                                    { return (is_running() == false) ? _err : ""; } ///< @brief Return saved stderr output, only if there is no stderr callback.
+    int                         exit_code() const
+                                    { return _exit; } ///< @brief Return exit code or -1.
+    bool                        is_running() const
+                                    { return _status == ProcessStatus::RUNNING; } ///< @brief Is command running?
+    std::string                 out() const
+                                    { return (is_running() == false) ? _out : ""; } ///< @brief Return saved stdout output, only if there is no stdout callback.
+    bool                        start(const std::string& cmd, CallbackLine cb_out = nullptr, CallbackLine cb_err = nullptr, void* data = nullptr, unsigned timeout_ms = 0, bool lines = true);
+    ProcessStatus               status() const
+                                    { return _status; } ///< @brief Return current state.
+    ProcessStatus               wait();
+
+private:
+    void                        _deliver(bool is_err, const char* buffer, size_t size);
+    void                        _flush();
+    void                        _run(std::string cmd);
+
+    CallbackLine                _cb_err;        ///< @brief Callback for stderr.
+    CallbackLine                _cb_out;        ///< @brief Callback for stdout.
+    bool                        _lines;         ///< @brief Deliver lines instead of chunks.
+    int                         _exit;          ///< @brief Exit code.
+    int                         _wake[2];       ///< @brief Pipe to wake the reactor (unix).
+    std::atomic<bool>           _cancel;        ///< @brief Cancel requested.
+    std::atomic<ProcessStatus>  _status;        ///< @brief Current state.
+    std::string                 _err;           ///< @brief Saved stderr or current stderr line.
+    std::string                 _out;           ///< @brief Saved stdout or current stdout line.
+    std::thread                 _thread;        ///< @brief Reactor thread.
+    unsigned                    _timeout;       ///< @brief Timeout in milliseconds, 0 for none.
+    void*                       _data;          ///< @brief Callback data.
+};
+
+/*
+ *     __          __   _       _
+ *     \ \        / /  | |     | |
+ *      \ \  /\  / /_ _| |_ ___| |__   ___ _ __
+ *       \ \/  \/ / _` | __/ __| '_ \ / _ \ '__|
+ *        \  /\  / (_| | || (__| | | |  __/ |
+ *         \/  \/ \__,_|\__\___|_| |_|\___|_|
+ *
+ *
+ */
+
+/** @brief Report created/modified/deleted/renamed files.
+*
+* Add files or directories with add(), for a directory all its children are reported (not recursive).\n
+* On linux inotify is used, on other systems (or if polling is requested) file time and size are compared.\n
+* Events are delivered from poll(), in the thread that calls it, so no locking is needed.\n
+* For FLTK, register fd() with Fl::add_fd(watcher.fd(), FL_READ, cb, data) and call poll() in the callback.\n
+* In polling mode fd() returns -1, then call poll() from a timer with Fl::repeat_timeout().\n
+* Renames can only be detected with inotify, polling reports them as DELETED and CREATED.\n
+* A file that is atomically replaced (written to a temporary file and renamed) is reported as CREATED.\n
+*/
+class Watcher {
+public:
+    explicit                    Watcher(CallbackWatch callback, void* data = nullptr, bool polling = false);
+                                ~Watcher();
+                                Watcher(const Watcher&) = delete;
+                                Watcher(Watcher&&) = delete;
+    Watcher&                    operator=(const Watcher&) = delete;
+    Watcher&                    operator=(Watcher&&) = delete;
+    bool                        add(const std::string& path);
+    int                         fd() const
+                                    { return _fd; } ///< @brief Return file descriptor to wait on or -1 if polling is used.
+    bool                        is_polling() const
+                                    { return _fd < 0; } ///< @brief Is polling used?
+    std::vector<std::string>    paths() const;
+    size_t                      poll();
+    bool                        remove(const std::string& path);
+
+private:
+    /** @brief File state used for polling.
+    *
+    */
+    struct Stat {
+        Type                    type;
+        int64_t                 mtime;
+        int64_t                 size;
+    };
+
+    size_t                      _emit(Event event, const std::string& path, const std::string& from = "");
+    bool                        _is_watched(const std::string& path) const;
+    size_t                      _poll_inotify();
+    size_t                      _poll_stat();
+    void                        _scan(const std::string& path, bool is_dir, std::map<std::string, Stat>& stats) const;
+
+    CallbackWatch               _callback;      ///< @brief Event callback.
+    int                         _fd;            ///< @brief inotify descriptor or -1.
+    void*                       _data;          ///< @brief Callback data.
+    std::map<std::string, bool> _paths;         ///< @brief Watched paths, value is true for directories.
+    std::map<std::string, Stat> _stats;         ///< @brief Last known state for all watched files (polling).
+    std::map<int, std::string>  _wds;           ///< @brief inotify watch descriptors and their directories.
+};
+
+/*
+ *      __  __  __  __
+ *     |  \/  ||  \/  |
+ *     | \  / || \  / |  __ _  _ __
+ *     | |\/| || |\/| | / _` || '_ \
+ *     | |  | || |  | || (_| || |_) |
+ *     |_|  |_||_|  |_| \__,_|| .__/
+ *                            | |
+ *                            |_|
+ */
+
+/** @brief Read only memory mapped file.
+*
+* File data is not copied, pages are read by the system when they are used.\n
+* An empty file is opened but data() returns NULL.\n
+*/
+class MMap {
+public:
+    explicit                    MMap(const std::string& path = "");
+                                ~MMap()
+                                    { close(); } ///< @brief Unmap file.
+                                MMap(const MMap&) = delete;
+                                MMap(MMap&&) = delete;
+    MMap&                       operator=(const MMap&) = delete;
+    MMap&                       operator=(MMap&&) = delete;
+    void                        advise(size_t offset, size_t size, bool need) const;
+    void                        close();
+    const char*                 data() const
+                                    { return _data; } ///< @brief Return file data, can be NULL.
+    bool                        is_open() const
+                                    { return _open; } ///< @brief Is a file mapped?
+    bool                        open(const std::string& path);
+    size_t                      size() const
+                                    { return _size; } ///< @brief Return file size.
+
+private:
+    bool                        _open;          ///< @brief File is open.
+    const char*                 _data;          ///< @brief Mapped data or NULL.
+    size_t                      _size;          ///< @brief Size of data.
+    void*                       _file;          ///< @brief File handle (windows).
+    void*                       _map;           ///< @brief Mapping handle (windows).
+};
+
+/*
+ *       _____   _____ __      __ _____                    _
+ *      / ____| / ____|\ \    / /|  __ \                  | |
+ *     | |     | (___   \ \  / / | |__) |  ___   __ _   __| |  ___  _ __
+ *     | |      \___ \   \ \/ /  |  _  /  / _ \ / _` | / _` | / _ \| '__|
+ *     | |____  ____) |   \  /   | | \ \ |  __/| (_| || (_| ||  __/| |
+ *      \_____||_____/     \/    |_|  \_\ \___| \__,_| \__,_| \___||_|
+ *
+ *
+ */
+
+/** @brief One field in a CSV row.
+*
+* Text points into the parsed data, quotes are not included.\n
+* Doubled quotes inside a quoted field are only removed by to_string().\n
+*/
+struct CSVField {
+    const char*                 str;            ///< @brief Start of text.
+    size_t                      len;            ///< @brief Length of text.
+    char                        quote;          ///< @brief Quote character if text has doubled quotes, otherwise 0.
+
+    double                      to_double() const;
+    int64_t                     to_int(int64_t def = 0) const;
+    std::string                 to_string() const;
+};
+
+/** @brief Parse CSV data without copying it.
+*
+* Data is either a memory mapped file (open()) or a buffer owned by the caller (set_buffer()).\n
+* split() divides the data into chunks at row boundaries and parse() parses every chunk in its own thread.\n
+* Fields are sent to a callback as CSVField objects that points into the data, so no strings are created.\n
+* Rows in a chunk are sent in file order, chunks are sent concurrently so use chunk index to store result in separate containers.\n
+* Fields can be quoted to include separators, a quote inside a quoted field is written as two quotes.\n
+* Every line is one row, so a quoted field can't contain a newline.\n
+* "\r\n" line endings and an UTF-8 BOM are handled, empty lines are skipped.\n
+*/
+class CSVReader {
+public:
+    static const size_t         MIN_CHUNK = 1 << 20;
+
+    explicit                    CSVReader(const std::string& sep = ",", char quote = '"');
+                                CSVReader(const CSVReader&) = delete;
+                                CSVReader(CSVReader&&) = delete;
+    CSVReader&                  operator=(const CSVReader&) = delete;
+    CSVReader&                  operator=(CSVReader&&) = delete;
+    size_t                      chunks() const
+                                    { return _chunks.size(); } ///< @brief Number of chunks from split().
+    std::vector<std::string>    column(size_t column, size_t max_rows) const;
+    const char*                 data() const
+                                    { return _buf; } ///< @brief Return data that is parsed.
+    bool                        open(const std::string& path);
+    void                        parse(CallbackCSV callback, void* data = nullptr);
+    void                        set_buffer(const char* buffer, size_t size);
+    size_t                      size() const
+                                    { return _size; } ///< @brief Return size of data.
+    size_t                      split(unsigned threads = 0);
+
+private:
+    void                        _parse(size_t chunk, CallbackCSV callback, void* data) const;
+    size_t                      _row(const char* row, size_t len, std::vector<CSVField>& fields) const;
+
+    MMap                        _mmap;          ///< @brief Mapped file.
+    char                        _quote;         ///< @brief Quote character.
+    const char*                 _buf;           ///< @brief Data.
+    size_t                      _size;          ///< @brief Size of data.
+    std::string                 _sep;           ///< @brief Field separator, one or more characters.
+    std::vector<std::pair<size_t, size_t>> _chunks; ///< @brief Start and stop offset for every chunk.
+};
+
 } // file
 } // gnu
 
@@ -60,6 +60,25 @@ static const char* const _PLOT_LABEL_DEBUG        = "Debug";
 static const char* const _PLOT_LABEL_DEBUG_LINE   = "Debug Line";
 #endif
 
+/** @brief Add one CSV row with x and y values to the vector for current chunk.
+*
+* Rows that don't have exactly 2 columns or have invalid values are skipped.
+*
+* @private
+*/
+static void _plot_csv_row(size_t chunk, const gnu::file::CSVField* fields, size_t count, void* data) {
+    if (count != 2) {
+        return;
+    }
+
+    auto vec   = static_cast<std::vector<plot::PointVector>*>(data);
+    auto point = plot::Point(fields[0].to_double(), fields[1].to_double());
+
+    if (point.is_valid() == true) {
+        (*vec)[chunk].push_back(point);
+    }
+}
+
 /*
  *           _____  _       _   _      _             _____      _               
  *          |  __ \| |     | | | |    (_)           / ____|    | |              
@@ -293,32 +312,34 @@ void flw::plot::Point::Debug(const PointVector& in) {
 
 /** @brief Load data from csv file.
 *
+* File is memory mapped and parsed in several threads for large files.
+*
 * @param[in] filename  Valid text file name.
 * @param[in] sep       Column separator.
 *
 * @return Result vector with Point objects.
 */
 flw::plot::PointVector flw::plot::Point::LoadCSV(const std::string& filename, const std::string& sep) {
-    auto buf = gnu::file::read(filename);
+    gnu::file::CSVReader     reader(sep);
+    std::vector<PointVector> chunks;
+    PointVector              res;
+    size_t                   size = 0;
 
-    if (buf.size() < 3) {
-        return PointVector();
+    if (reader.open(filename) == false || reader.size() < 3) {
+        return res;
     }
 
-    std::string  str   = buf.c_str();
-    StringVector lines = util::split_string(str, "\n");
-    PointVector  res;
+    chunks.resize(reader.split());
+    reader.parse(priv::_plot_csv_row, &chunks);
 
-    for (const auto& l : lines) {
-        StringVector line = util::split_string(l, sep);
+    for (const auto& chunk : chunks) {
+        size += chunk.size();
+    }
 
-        if (line.size() == 2) {
-            auto data = Point(util::to_double(line[0]), util::to_double(line[1]));
+    res.reserve(size);
 
-            if (data.is_valid() == true) {
-                res.push_back(data);
-            }
-        }
+    for (const auto& chunk : chunks) {
+        res.insert(res.end(), chunk.begin(), chunk.end());
     }
 
     return res;
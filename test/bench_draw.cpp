@@ -0,0 +1,450 @@
+// Copyright gnuwimp@gmail.com
+// Released under the GNU General Public License v3.0
+
+// Headless draw benchmark for Chart and Plot.
+// Widgets are drawn into an Fl_Image_Surface so it only needs a display connection (a virtual X server works).
+// Result is printed as JSON to stdout.
+//
+// Usage: bench_draw.exe [lines=4] [points=10000] [areas=1] [tick=3] [frames=50] [width=1200] [height=800] [range=DAY] [lod=0]
+// Example: xvfb-run -a ./bench_draw.exe lines=10 points=100000 areas=2
+
+#include "flw.h"
+
+FL_EXPORT bool fl_disable_wayland = true;
+
+#ifndef FLW_AMALGAM
+    #include "chart.h"
+    #include "plot.h"
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <new>
+#include <random>
+#include <stdlib.h>
+#include <FL/Fl.H>
+#include <FL/Fl_Double_Window.H>
+#include <FL/Fl_Image_Surface.H>
+#include <FL/Fl_Scrollbar.H>
+#include <FL/platform.H>
+
+using namespace flw;
+
+static std::atomic<size_t> BENCH_ALLOCS(0);
+static std::atomic<size_t> BENCH_BYTES(0);
+
+//------------------------------------------------------------------------------
+void* operator new(size_t size) {
+    BENCH_ALLOCS++;
+    BENCH_BYTES += size;
+
+    if (auto p = malloc(size > 0 ? size : 1)) {
+        return p;
+    }
+
+    throw std::bad_alloc();
+}
+
+//------------------------------------------------------------------------------
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+//------------------------------------------------------------------------------
+void operator delete(void* p) noexcept {
+    free(p);
+}
+
+//------------------------------------------------------------------------------
+void operator delete[](void* p) noexcept {
+    free(p);
+}
+
+//------------------------------------------------------------------------------
+void operator delete(void* p, size_t) noexcept {
+    free(p);
+}
+
+//------------------------------------------------------------------------------
+void operator delete[](void* p, size_t) noexcept {
+    free(p);
+}
+
+/*
+ *      ____                  _
+ *     |  _ \                | |
+ *     | |_) | ___ _ __   ___| |__
+ *     |  _ < / _ \ '_ \ / __| '_ \
+ *     | |_) |  __/ | | | (__| | | |
+ *     |____/ \___|_| |_|\___|_| |_|
+ *
+ *
+ */
+
+//------------------------------------------------------------------------------
+struct Param {
+    int                         areas   = 1;
+    int                         frames  = 50;
+    int                         height  = 800;
+    int                         lines   = 4;
+    int                         lod     = 0;
+    int                         points  = 10'000;
+    int                         tick    = chart::MIN_TICK;
+    int                         width   = 1200;
+    std::string                 range   = "DAY";
+};
+
+//------------------------------------------------------------------------------
+struct Stat {
+    std::vector<int64_t>        time;
+    std::vector<size_t>         allocs;
+    std::vector<size_t>         bytes;
+
+    //--------------------------------------------------------------------------
+    // Start one frame and return a token for stop().
+    //
+    int64_t start() {
+        _allocs = BENCH_ALLOCS;
+        _bytes  = BENCH_BYTES;
+        return util::microseconds();
+    }
+
+    //--------------------------------------------------------------------------
+    void stop(int64_t start) {
+        const auto   TIME   = util::microseconds() - start;
+        const size_t ALLOCS = BENCH_ALLOCS - _allocs;
+        const size_t BYTES  = BENCH_BYTES - _bytes;
+
+        time.push_back(TIME);
+        allocs.push_back(ALLOCS);
+        bytes.push_back(BYTES);
+    }
+
+    //--------------------------------------------------------------------------
+    std::string json() const {
+        if (time.size() == 0) {
+            return "null";
+        }
+
+        auto sorted = time;
+        auto sum    = 0.0;
+        auto nalloc = 0.0;
+        auto nbytes = 0.0;
+
+        std::sort(sorted.begin(), sorted.end());
+
+        for (size_t f = 0; f < time.size(); f++) {
+            sum    += time[f];
+            nalloc += allocs[f];
+            nbytes += bytes[f];
+        }
+
+        const auto COUNT = static_cast<double>(time.size());
+
+        return util::format("{\"frames\": %d, \"min_ms\": %.3f, \"median_ms\": %.3f, \"mean_ms\": %.3f, \"p95_ms\": %.3f, \"max_ms\": %.3f, \"allocs_per_frame\": %.1f, \"bytes_per_frame\": %.0f}",
+            static_cast<int>(time.size()),
+            sorted.front() / 1000.0,
+            sorted[sorted.size() / 2] / 1000.0,
+            sum / COUNT / 1000.0,
+            sorted[std::min(sorted.size() - 1, static_cast<size_t>(COUNT * 0.95))] / 1000.0,
+            sorted.back() / 1000.0,
+            nalloc / COUNT,
+            nbytes / COUNT);
+    }
+
+private:
+    size_t                      _allocs = 0;
+    size_t                      _bytes  = 0;
+};
+
+//------------------------------------------------------------------------------
+// Draw widget into the image surface.
+// Damage is FL_DAMAGE_ALL for a full redraw or 0 for the cached path (chart offscreen + tooltip).
+//
+template<typename T>
+static void bench_frame(T* widget, Fl_Image_Surface& surface, uchar damage) {
+    Fl_Surface_Device::push_current(&surface);
+    widget->clear_damage(damage);
+    widget->draw();
+    widget->clear_damage();
+    Fl_Surface_Device::pop_current();
+}
+
+//------------------------------------------------------------------------------
+// Simulate a left mouse button press.
+//
+static void bench_push(Fl_Widget* widget, int X, int Y) {
+    Fl::e_x      = X;
+    Fl::e_y      = Y;
+    Fl::e_state  = FL_BUTTON1;
+    Fl::e_keysym = FL_Button + FL_LEFT_MOUSE;
+    widget->handle(FL_PUSH);
+    Fl::e_state  = 0;
+    widget->handle(FL_RELEASE);
+}
+
+//------------------------------------------------------------------------------
+static Param bench_param(int argc, const char** argv) {
+    Param param;
+
+    for (int f = 1; f < argc; f++) {
+        const auto arg = std::string(argv[f]);
+        const auto pos = arg.find('=');
+
+        if (pos == std::string::npos) {
+            fprintf(stderr, "error: invalid argument '%s'\n", arg.c_str());
+            exit(1);
+        }
+
+        const auto name  = arg.substr(0, pos);
+        const auto value = arg.substr(pos + 1);
+        const auto num   = static_cast<int>(util::to_int(value));
+
+        if (name == "areas")       param.areas  = std::clamp(num, 1, 5);
+        else if (name == "frames") param.frames = std::max(num, 1);
+        else if (name == "height") param.height = std::max(num, 100);
+        else if (name == "lines")  param.lines  = std::max(num, 1);
+        else if (name == "lod")    param.lod    = (num != 0) ? 1 : 0;
+        else if (name == "points") param.points = std::max(num, 2);
+        else if (name == "range")  param.range  = value;
+        else if (name == "tick")   param.tick   = std::clamp(num, chart::MIN_TICK, chart::MAX_TICK);
+        else if (name == "width")  param.width  = std::max(num, 100);
+        else {
+            fprintf(stderr, "error: unknown argument '%s'\n", name.c_str());
+            exit(1);
+        }
+    }
+
+    return param;
+}
+
+/*
+ *       _____ _                _
+ *      / ____| |              | |
+ *     | |    | |__   __ _ _ __| |_
+ *     | |    | '_ \ / _` | '__| __|
+ *     | |____| | | | (_| | |  | |_
+ *      \_____|_| |_|\__,_|_|   \__|
+ *
+ *
+ */
+
+//------------------------------------------------------------------------------
+static std::string bench_chart(const Param& param) {
+    auto win   = new Fl_Double_Window(param.width, param.height);
+    auto chart = new chart::Chart(0, 0, param.width, param.height);
+    auto rng   = std::mt19937(1);
+    auto range = chart::Point::StringToRange(param.range);
+    auto step  = static_cast<int64_t>(gnu::Date::SECS_PER_DAY);
+    auto lines = std::min(param.lines, param.areas * static_cast<int>(chart::Area::MAX_LINES));
+    auto sizes = std::vector<unsigned>(5, 0);
+
+    win->end();
+
+    if (range == chart::DateRange::HOUR) {
+        step = gnu::Date::SECS_PER_HOUR;
+    }
+    else if (range == chart::DateRange::MIN) {
+        step = 60;
+    }
+    else if (range == chart::DateRange::SEC) {
+        step = 1;
+    }
+
+    for (int f = 0; f < param.areas; f++) {
+        sizes[f] = 100 / param.areas + ((f == 0) ? 100 % param.areas : 0);
+    }
+
+    chart->set_area_size(sizes[0], sizes[1], sizes[2], sizes[3], sizes[4]);
+    chart->set_date_range(range);
+    chart->set_tick_width(param.tick);
+    chart->set_lod(param.lod == 1);
+    chart->disable_menu();
+
+    for (int l = 0; l < lines; l++) {
+        auto series = chart::Series();
+        auto key    = gnu::Date(1980, 1, 1).key().seconds();
+        auto value  = 1000.0;
+
+        series.reserve(param.points);
+
+        for (int f = 0; f < param.points; f++) {
+            value += std::uniform_real_distribution<double>(-10.0, 10.0)(rng);
+            value  = std::max(value, 1.0);
+            series.push_back(gnu::DateKey::FromSeconds(key + f * step), value + 5.0, value - 5.0, value);
+        }
+
+        auto line = chart::Line();
+        line.set_data(std::move(series)).set_label(util::format("Line %d", l + 1)).set_type((l % 2 == 0) ? chart::LineType::LINE : chart::LineType::BAR_HLC);
+        chart->area(static_cast<chart::AreaNum>(l % param.areas)).add_line(line);
+    }
+
+    chart->init_new_data();
+
+    Fl_Image_Surface surface(param.width, param.height);
+    Fl_Scrollbar*    scroll = nullptr;
+    Stat             draw;
+    Stat             move;
+    Stat             hover;
+
+    for (int f = 0; f < chart->children(); f++) {
+        if (scroll == nullptr) {
+            scroll = dynamic_cast<Fl_Scrollbar*>(chart->child(f));
+        }
+    }
+
+    bench_frame(chart, surface, FL_DAMAGE_ALL); // Warm up.
+
+    for (int f = 0; f < param.frames; f++) {
+        auto t = draw.start();
+        bench_frame(chart, surface, FL_DAMAGE_ALL);
+        draw.stop(t);
+    }
+
+    if (scroll != nullptr && scroll->maximum() > scroll->minimum()) {
+        const auto MIN  = scroll->minimum();
+        const auto MAX  = scroll->maximum();
+        const auto STEP = std::max((MAX - MIN) / param.frames, 1.0);
+
+        for (int f = 0; f < param.frames; f++) {
+            auto t = move.start();
+            static_cast<Fl_Slider*>(scroll)->value(MIN + std::fmod(f * STEP, MAX - MIN));
+            scroll->do_callback();
+            bench_frame(chart, surface, FL_DAMAGE_ALL);
+            move.stop(t);
+        }
+    }
+
+    const auto& rect = chart->area(chart::AreaNum::ONE).rect();
+
+    bench_frame(chart, surface, FL_DAMAGE_ALL);
+
+    for (int f = 0; f < param.frames; f++) {
+        auto t = hover.start();
+        bench_push(chart, rect.x() + 1 + (rect.w() - 2) * f / param.frames, rect.y() + rect.h() / 2);
+        bench_frame(chart, surface, 0);
+        hover.stop(t);
+    }
+
+    auto res = util::format("{\"lines\": %d, \"points\": %d, \"lod_level\": %d, \"draw\": %s, \"scroll\": %s, \"tooltip\": %s}",
+        lines,
+        param.points,
+        chart->lod_level(),
+        draw.json().c_str(),
+        move.json().c_str(),
+        hover.json().c_str());
+
+    delete win;
+    return res;
+}
+
+/*
+ *      _____  _       _
+ *     |  __ \| |     | |
+ *     | |__) | | ___ | |_
+ *     |  ___/| |/ _ \| __|
+ *     | |    | | (_) | |_
+ *     |_|    |_|\___/ \__|
+ *
+ *
+ */
+
+//------------------------------------------------------------------------------
+static std::string bench_plot(const Param& param) {
+    auto win   = new Fl_Double_Window(param.width, param.height);
+    auto plot  = new plot::Plot(0, 0, param.width, param.height);
+    auto rng   = std::mt19937(1);
+    auto lines = std::min(param.lines, static_cast<int>(plot::MAX_LINES));
+
+    win->end();
+    plot->disable_menu();
+
+    for (int l = 0; l < lines; l++) {
+        auto data  = plot::PointVector();
+        auto value = 0.0;
+
+        data.reserve(param.points);
+
+        for (int f = 0; f < param.points; f++) {
+            value += std::uniform_real_distribution<double>(-1.0, 1.0)(rng);
+            data.push_back(plot::Point(f, value));
+        }
+
+        plot->add_line(plot::Line(data, util::format("Line %d", l + 1)));
+    }
+
+    plot->init_new_data();
+
+    Fl_Image_Surface surface(param.width, param.height);
+    Stat             draw;
+    Stat             move;
+    Stat             hover;
+
+    bench_frame(plot, surface, FL_DAMAGE_ALL); // Warm up.
+
+    for (int f = 0; f < param.frames; f++) {
+        auto t = draw.start();
+        bench_frame(plot, surface, FL_DAMAGE_ALL);
+        draw.stop(t);
+    }
+
+    const auto WINDOW = param.points / 2.0;
+
+    for (int f = 0; f < param.frames; f++) { // Plot has no scrollbar so x range is moved instead.
+        auto t = move.start();
+        plot->set_min_x(WINDOW * f / param.frames);
+        plot->set_max_x(WINDOW * f / param.frames + WINDOW);
+        plot->init_new_data();
+        bench_frame(plot, surface, FL_DAMAGE_ALL);
+        move.stop(t);
+    }
+
+    plot->set_min_x();
+    plot->set_max_x();
+    plot->init_new_data();
+
+    for (int f = 0; f < param.frames; f++) {
+        auto t = hover.start();
+        bench_push(plot, plot->x() + plot->w() * (f + 1) / (param.frames + 2), plot->y() + plot->h() / 2);
+        bench_frame(plot, surface, FL_DAMAGE_ALL);
+        hover.stop(t);
+    }
+
+    auto res = util::format("{\"lines\": %d, \"points\": %d, \"draw\": %s, \"scroll\": %s, \"tooltip\": %s}",
+        lines,
+        param.points,
+        draw.json().c_str(),
+        move.json().c_str(),
+        hover.json().c_str());
+
+    delete win;
+    return res;
+}
+
+//------------------------------------------------------------------------------
+int main(int argc, const char** argv) {
+    auto param = bench_param(argc, argv);
+
+    fl_open_display();
+
+    auto chart = bench_chart(param);
+    auto plot  = bench_plot(param);
+
+    printf("{\n");
+    printf("    \"param\": {\"lines\": %d, \"points\": %d, \"areas\": %d, \"tick\": %d, \"frames\": %d, \"width\": %d, \"height\": %d, \"range\": \"%s\", \"lod\": %d},\n",
+        param.lines,
+        param.points,
+        param.areas,
+        param.tick,
+        param.frames,
+        param.width,
+        param.height,
+        param.range.c_str(),
+        param.lod);
+    printf("    \"chart\": %s,\n", chart.c_str());
+    printf("    \"plot\": %s\n", plot.c_str());
+    printf("}\n");
+
+    return 0;
+}
@@ -57,12 +57,16 @@ using namespace flw;
 #define TEST_AREA4              "4 chart areas"
 #define TEST_AREA5              "5 chart areas"
 
+#define TEST_APPEND             "Append with timer"
+
 #define TEST_EMPTY              "Empty"
 #define TEST_FIRST              TEST_RANGE_DAY
 #define TEST_LAST               TEST_EMPTY
 
-std::string TEST = TEST_FIRST;
-int         RAND = 0;
+std::string        TEST = TEST_FIRST;
+int                RAND = 0;
+chart::PointVector APPEND_DATA;
+size_t             APPEND_POS = 0;
 
 //------------------------------------------------------------------------------
 chart::PointVector create_serie1(const char* start, const char* stop, double value, double change, const chart::DateRange range, double divide = 0.0) {
@@ -219,6 +223,7 @@ void test3(chart::Chart* chart, std::string label, const chart::DateRange range,
         vec3.push_back(chart::Point("20140105"));
         vec3.push_back(chart::Point("20140111"));
         vec3.push_back(chart::Point("20140319"));
+        vec3.push_back(chart::Point("bad")); // Invalid block date must not break snapshot.
         chart->set_main_label("Dates 01/05, 01/11, 03/19 has been blocked");
     }
 
@@ -246,6 +251,11 @@ void test3(chart::Chart* chart, std::string label, const chart::DateRange range,
     chart->set_date_range(range);
     chart->set_block_dates(vec3);
     chart->init_new_data();
+
+    if (block == true) {
+        assert(chart->save_snapshot("chart_test.snapshot") == true);
+        assert(chart->load_snapshot("chart_test.snapshot") == true);
+    }
 }
 
 //------------------------------------------------------------------------------
@@ -489,6 +499,77 @@ void test10(chart::Chart* chart) {
     chart->init_new_data();
 }
 
+//------------------------------------------------------------------------------
+// Compare lines that have been updated with append() against a full rebuild of all appended points.
+void test11_check(chart::Chart* chart) {
+    auto  source = chart::Series(chart::PointVector(APPEND_DATA.begin(), APPEND_DATA.begin() + APPEND_POS));
+    auto  ma     = chart::Point::MovingAverage(source, 20);
+    auto  rsi    = chart::Point::RSI(source, 14);
+    auto& line1  = chart->area(chart::AreaNum::ONE).lines()[0];
+    auto& line2  = chart->area(chart::AreaNum::ONE).lines()[1];
+    auto& line3  = chart->area(chart::AreaNum::TWO).lines()[0];
+
+    assert(line1.size() == std::min(source.size(), line1.max_size()));
+    assert(line1.series().last_key() == source.last_key());
+    assert(line1.index().size() == line1.view().size());
+    assert(line1.index().back() >= 0); // Reference dates has been extended.
+
+    assert(line2.size() == ma.size());
+    assert(line2.series().last_key() == ma.last_key());
+    assert(line2.series().close().back() == ma.close().back());
+
+    assert(line3.size() == rsi.size());
+    assert(line3.series().last_key() == rsi.last_key());
+    assert(line3.series().close().back() == rsi.close().back());
+}
+
+//------------------------------------------------------------------------------
+void test11_timer(void* data) {
+    auto chart = static_cast<chart::Chart*>(data);
+
+    for (auto f = 0; f < 10 && APPEND_POS < APPEND_DATA.size(); f++) {
+        auto res = chart->append(chart::AreaNum::ONE, 0, APPEND_DATA[APPEND_POS]);
+        assert(res == true);
+        (void) res;
+        APPEND_POS++;
+    }
+
+    test11_check(chart);
+    chart->redraw();
+
+    if (APPEND_POS < APPEND_DATA.size()) {
+        Fl::repeat_timeout(0.05, test11_timer, data);
+    }
+}
+
+//------------------------------------------------------------------------------
+void test11(chart::Chart* chart) {
+    APPEND_DATA = create_serie1("20200101", "20210131", 100.0, 2.0, chart::DateRange::DAY);
+    APPEND_POS  = 100;
+
+    auto line1 = chart::Line(chart::PointVector(APPEND_DATA.begin(), APPEND_DATA.begin() + APPEND_POS), "Source (max 200)", chart::LineType::BAR_HLC);
+    auto line2 = chart::Line();
+    auto line3 = chart::Line();
+
+    line1.set_color(color::ROYALBLUE).set_width(3).set_max_size(200);
+    line2.set_indicator(chart::Indicator(chart::Algorithm::MOVING_AVERAGE, 20), line1);
+    line2.set_label("Moving Average 20").set_color(color::CRIMSON).set_width(2);
+    line3.set_indicator(chart::Indicator(chart::Algorithm::RSI, 14), line1);
+    line3.set_label("RSI 14").set_color(color::OLIVE).set_width(2);
+
+    chart->set_area_size(70, 30);
+    chart->area(chart::AreaNum::ONE).add_line(line1);
+    chart->area(chart::AreaNum::ONE).add_line(line2);
+    chart->area(chart::AreaNum::TWO).add_line(line3);
+    chart->set_date_range(chart::DateRange::DAY);
+    chart->set_tick_width(6);
+    chart->set_main_label("Append 10 points every 50 ms");
+    chart->init_new_data();
+
+    test11_check(chart);
+    Fl::add_timeout(0.05, test11_timer, chart);
+}
+
 /*
  *      _______        _
  *     |__   __|      | |
@@ -552,6 +633,7 @@ public:
         menu->add("&Test/" TEST_AREA3,            0, Test::CallbackTest, this);
         menu->add("&Test/" TEST_AREA4,            0, Test::CallbackTest, this);
         menu->add("&Test/" TEST_AREA5,            0, Test::CallbackTest, this, FL_MENU_DIVIDER);
+        menu->add("&Test/" TEST_APPEND,           0, Test::CallbackTest, this, FL_MENU_DIVIDER);
         menu->add("&Test/" TEST_EMPTY,            0, Test::CallbackTest, this);
 
         menu->add("&Settings/srand(time)",        0, Test::CallbackRandTime, this, FL_MENU_RADIO);
@@ -724,7 +806,8 @@ public:
             else if (TEST == TEST_AREA2)            TEST = TEST_AREA3;
             else if (TEST == TEST_AREA3)            TEST = TEST_AREA4;
             else if (TEST == TEST_AREA4)            TEST = TEST_AREA5;
-            else if (TEST == TEST_AREA5)            TEST = TEST_EMPTY;
+            else if (TEST == TEST_AREA5)            TEST = TEST_APPEND;
+            else if (TEST == TEST_APPEND)           TEST = TEST_EMPTY;
 
             Fl::repeat_timeout(2.0, CallbackTimer, data);
         }
@@ -748,6 +831,7 @@ public:
             srand(RAND);
         }
 
+        Fl::remove_timeout(test11_timer);
         chart->reset();
 
 
@@ -785,6 +869,8 @@ public:
         else if (TEST == TEST_AREA4)            test5(chart, "Four Chart Areas", 4);
         else if (TEST == TEST_AREA5)            test5(chart, "Five Chart Areas", 5);
 
+        else if (TEST == TEST_APPEND)           test11(chart);
+
         else if (TEST == TEST_EMPTY)            { chart->set_main_label("Empty"); chart->init_new_data(); }
 
         chart->take_focus();